@@ -42,8 +42,9 @@
 //			header attributes, allows accessing optional attributes (analyzed and found inside .exr file)
 //	[  ] 6b. OpenEXR attributes: implement check of attributes' firstByteIndex() and lastByteIndex() -es to search for byte gaps left after analysis 
 //			to locate missed an unread attributes.
-//	[  ] 6c. (maybe) for OpenEXR attributes, improve algorithm by reading through .exr byte-by-byte and search for null-terminated strings (attributes names), then
-//			pass found attributes names strings into AttribX constructor to try reading the attribute assumed to have the name found earlier.
+///	[OK] 6c. (maybe) for OpenEXR attributes, improve algorithm by reading through .exr byte-by-byte and search for null-terminated strings (attributes names), then
+///			pass found attributes names strings into AttribX constructor to try reading the attribute assumed to have the name found earlier.
+///			Done by exrTypes::HeaderIndex (single pass over header attribute list, AttribX constructors look up their name in it).
 // [  ] 7. Implement input .exr file reader as a singleton class.
 // 
 // 
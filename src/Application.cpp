@@ -1,9 +1,9 @@
-/// !note: this program can read only single-part EXR files.
+/// !note: this program can read single-part and multi-part EXR files (deep data: scanline only).
 /*
 	USER MANUAL: (Release build)
 	1. Find .exe of this program in File Explorer of your OS.
 	2. Find .exr (your OpenEXR image) to analyse.
-		Note: program works only with single-part RGBA 32-bit float per channel images (yet)
+		Note: program works only with single-part and multi-part images: scanline, tiled (all levels) or deep scanline, channels of any names and types (HALF, FLOAT, UINT)
 	3. Drag & drop your OpenEXR image over the program's .exe file inside File Explorer.
 	4. Look at the console window to check the analysis results (program does not lock the image file).
 	5. Press any button or close the window to quit the program.
@@ -22,6 +22,8 @@
 // t_name = template argument
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <cstring>
 #include <exception>
 #include <filesystem>
@@ -29,9 +31,15 @@ namespace fs = std::filesystem;
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <string>
 #include <vector>
+#include "DumpWriter.h"
 #include "ExeParams.h"
+#include "FileBytes.h"
+#include "JsonWriter.h"
+#include "ThreadPool.h"
 #include "exrData/exrConsta.h"
 #include "exrData/exrTypes.h"
 #include "exrData/MagicNumber.h"
@@ -59,6 +67,93 @@ const fs::path g_debugFilepath = g_assetsDir / fs::path(g_debugImage);
 
 #endif
 
+// program options (see _docs/user/MANUAL_FOR_USER.txt)
+const std::string g_c_optionLazy = "lazy";						// --lazy[=N]: decode scanlines on access, keep N most recently used decoded
+const uint32_t g_c_lazyCacheScanlinesNumDefault = 16;
+const std::string g_c_optionThreads = "threads";				// --threads=N: decode pixel data on N threads (0 = one per hardware thread)
+const std::string g_c_optionDump = "dump";						// --dump=block|printf: how char and hex views of file bytes are written
+const std::string g_c_dumpBlock = "block";						// rows formatted into large buffer, written by blocks (default)
+const std::string g_c_dumpPrintf = "printf";					// printf() per byte
+const std::string g_c_optionBytes = "bytes";					// --bytes=FIRST-LAST: char and hex views show only bytes [FIRST; LAST] of file
+const std::string g_c_optionRows = "rows";						// --rows=FIRST-LAST: pixel data is decoded and printed only for image rows [FIRST; LAST]
+const std::string g_c_optionColumns = "cols";					// --cols=FIRST-LAST: pixel data is printed only for image columns [FIRST; LAST]
+const std::string g_c_optionCheckOffsets = "check-offsets";		// --check-offsets: cross-check offset tables against chunks (order, overlaps, gaps)
+const std::string g_c_optionStream = "stream";					// --stream[=MB]: read file chunk by chunk, using up to MB megabytes for pixel data, print statistics only (not with --lazy, --dump, --bytes, --rows, --cols, --check-offsets, --batch, --json, --write)
+const uint32_t g_c_streamMemoryLimitMBDefault = 256;
+const std::string g_c_optionBatch = "batch";					// --batch: analyse all files / directories / patterns given, one result line per file
+const std::string g_c_optionJson = "json";						// --json: write analysis results as JSON (one object per file, NDJSON in batch mode)
+const std::string g_c_optionQuiet = "quiet";					// --quiet: batch mode prints only files that are not OK and the totals
+const std::string g_c_optionWrite = "write";					// --write=PATH: write analysed file as single-part scanline .exr into PATH (--batch: into directory PATH, same file name)
+const std::string g_c_optionCompression = "compression";		// --compression=NAME: compression of files written by --write (NO, RLE, ZIPS, ZIP, DWAA, DWAB)
+const std::string g_c_compressionDefault = "ZIP";
+const std::string g_c_batchExtension = ".exr";					// files taken from directories given in batch mode
+
+/// <returns> value of "--(optionName)=N" option as integer, (defaultValue) if option has no value </returns>
+uint32_t uintOptionValue(const exe::ExeParams& app, const std::string& optionName, const uint32_t defaultValue, const uint32_t minValue)
+{
+	const std::string value = app.optionValue(optionName, std::to_string(defaultValue));
+	uint32_t result = 0;
+	try
+	{
+		std::size_t charsParsed = 0;
+		const unsigned long parsed = std::stoul(value, &charsParsed);
+		if (charsParsed != value.size() or parsed < minValue or UINT32_MAX < parsed)
+		{
+			throw std::out_of_range(value);
+		}
+		result = uint32_t(parsed);
+	}
+	catch(const std::exception&)
+	{
+		throw std::runtime_error("ERROR: --" + optionName + "=" + value + " is invalid. Integer >= " + std::to_string(minValue) + " is expected.\n");
+	}
+	return result;
+}
+
+/// <summary>
+///		Parse "--(optionName)=FIRST-LAST" option. FIRST and LAST are decimal or hexadecimal (0x...) integers, both inclusive.
+///		"N" means [N; N], "FIRST-" means [FIRST; UINT64_MAX] (to the end).
+/// </summary>
+utils::Range<uint64_t> rangeOptionValue(const exe::ExeParams& app, const std::string& optionName)
+{
+	const std::string value = app.optionValue(optionName);
+	const auto parseNumber = [](const std::string& number) -> uint64_t
+	{
+		const bool isHex = number.size() > 2 and number[0] == '0' and (number[1] == 'x' or number[1] == 'X');
+		std::size_t charsParsed = 0;
+		const uint64_t parsed = std::stoull(number, &charsParsed, isHex ? 16 : 10);
+		if (charsParsed != number.size() or number[0] == '-' or number[0] == '+')
+		{
+			throw std::invalid_argument(number);
+		}
+		return parsed;
+	};
+	try
+	{
+		const std::size_t delimiterIndex = value.find('-');
+		const uint64_t first = parseNumber(value.substr(0, delimiterIndex));
+		uint64_t last = first;
+		if (delimiterIndex != std::string::npos)
+		{
+			const std::string lastStr = value.substr(delimiterIndex + 1);
+			last = lastStr.empty() ? UINT64_MAX : parseNumber(lastStr);
+		}
+		if (last < first)
+		{
+			throw std::invalid_argument(value);
+		}
+		return utils::Range<uint64_t>(first, last);
+	}
+	catch(const std::exception&)
+	{
+		throw std::runtime_error("ERROR: --" + optionName + "=" + value + " is invalid. FIRST-LAST range of integers (FIRST <= LAST) is expected, e.g. --" + optionName + "=16-0x3F.\n");
+	}
+}
+utils::Range<uint32_t> toUint32Range(const utils::Range<uint64_t>& range)
+{
+	return utils::Range<uint32_t>(uint32_t(std::min<uint64_t>(range.first(), UINT32_MAX)), uint32_t(std::min<uint64_t>(range.last(), UINT32_MAX)));
+}
+
 void Application(const int argc, char* argv[])
 {
 	#if not ASSET_INPUT_MODE__DEBUG
@@ -68,48 +163,402 @@ void Application(const int argc, char* argv[])
 	{
 		app = std::make_unique<exe::ExeParams>(argc, (const char**)argv);
 	}
-	catch(std::exception e)
+	catch(const std::exception& e)
 	{
 		throw std::runtime_error("ERROR: " + std::string(e.what()) + ". Existing .exr file path is expected.\n");
 	}
-	if (app->paramsNum() < 2)
+	const std::vector<std::string> positionalParams = app->positionalParams();
+	if (positionalParams.empty())
 	{
 		throw std::runtime_error("ERROR: Program parameter [1] is not provided. Existing .exr file path is expected.\n" + userTip_specifyExrFilepath + "\n");
 	}
-	fs::path filepath = app->param(1);
+	fs::path filepath = positionalParams[0];
 	if (not fs::exists(filepath))
 	{
 		throw std::runtime_error("ERROR: Program parameter [1] is invalid file path. Existing .exr file path is expected.\n" + userTip_specifyExrFilepath + "\n");
 	}
+	const uint32_t lazyCacheScanlinesNum = app->hasOption(g_c_optionLazy) ? uintOptionValue(*app, g_c_optionLazy, g_c_lazyCacheScanlinesNumDefault, 1) : 0;
+	const uint32_t decodingWorkersNum = uintOptionValue(*app, g_c_optionThreads, 0, 0);
+	const std::string dumpMode = app->optionValue(g_c_optionDump, g_c_dumpBlock);
+	if (dumpMode != g_c_dumpBlock and dumpMode != g_c_dumpPrintf)
+	{
+		throw std::runtime_error("ERROR: --" + g_c_optionDump + "=" + dumpMode + " is invalid. Expected: --" + g_c_optionDump + "=" + g_c_dumpBlock + " or --" + g_c_optionDump + "=" + g_c_dumpPrintf + ".\n");
+	}
+	const bool hasByteRange = app->hasOption(g_c_optionBytes);
+	const utils::Range<uint64_t> byteRange = hasByteRange ? rangeOptionValue(*app, g_c_optionBytes) : utils::Range<uint64_t>(0, UINT64_MAX);
+	const bool hasPixelRegion = app->hasOption(g_c_optionRows) or app->hasOption(g_c_optionColumns);
+	const utils::Range<uint32_t> regionRows = app->hasOption(g_c_optionRows) ? toUint32Range(rangeOptionValue(*app, g_c_optionRows)) : utils::Range<uint32_t>(0, UINT32_MAX);
+	const utils::Range<uint32_t> regionColumns = app->hasOption(g_c_optionColumns) ? toUint32Range(rangeOptionValue(*app, g_c_optionColumns)) : utils::Range<uint32_t>(0, UINT32_MAX);
+	const bool isOffsetTableCrossCheck = app->hasOption(g_c_optionCheckOffsets);
+	const bool isStream = app->hasOption(g_c_optionStream);
+	const uint32_t streamMemoryLimitMB = isStream ? uintOptionValue(*app, g_c_optionStream, g_c_streamMemoryLimitMBDefault, 1) : 0;
+	if (isStream)
+	{
+		// file is not loaded as a whole: no char and hex views, no pixel printout, no offset tables cross-check
+		for (const std::string& option : { g_c_optionLazy, g_c_optionDump, g_c_optionBytes, g_c_optionRows, g_c_optionColumns, g_c_optionCheckOffsets })
+		{
+			if (app->hasOption(option))
+			{
+				throw std::runtime_error("ERROR: --" + option + " does not apply to --" + g_c_optionStream + " analysis (it prints statistics only, bytes and pixels are not printed).\n");
+			}
+		}
+	}
 	#else
 	fs::path filepath = g_debugFilepath;
+	const uint32_t lazyCacheScanlinesNum = 0;
+	const uint32_t decodingWorkersNum = 0;
+	const std::string dumpMode = g_c_dumpBlock;
+	const bool hasByteRange = false;
+	const utils::Range<uint64_t> byteRange = utils::Range<uint64_t>(0, UINT64_MAX);
+	const bool hasPixelRegion = false;
+	const utils::Range<uint32_t> regionRows = utils::Range<uint32_t>(0, UINT32_MAX);
+	const utils::Range<uint32_t> regionColumns = utils::Range<uint32_t>(0, UINT32_MAX);
+	const bool isOffsetTableCrossCheck = false;
+	const bool isStream = false;
+	const uint32_t streamMemoryLimitMB = 0;
 	#endif
 
 	printf("file: %s\n\n", filepath.generic_string().c_str());
-	std::vector<ui8> filebytes = utils::file::getFilebytes_v5_CppOnly(filepath.string().c_str());
-	printf("EXR data (char view) -------------------------------------- \n");
-	utils::print::asChar(filebytes);
-	printf("\nEOF ------------------------------------------------------- \n\n");
-	printf("EXR data (hex view) --------------------------------------- \n");
-	utils::print::asBytes(filebytes);
-	printf("\nEOF ------------------------------------------------------- \n\n");
+	if (isStream)
+	{
+		printf("OpenEXR file streaming analysis result.\n");
+		const uint64_t invalidChunksNum = exrFileData::exrAnalysisStream(filepath, uint64_t(streamMemoryLimitMB) * 1024 * 1024, decodingWorkersNum);
+		if (invalidChunksNum != 0)
+		{
+			throw std::runtime_error("ERROR: " + std::to_string(invalidChunksNum) + " chunks of the file are invalid (see INVALID lines above).\n");
+		}
+		return;
+	}
+	utils::file::FileBytes file(filepath);		// memory-mapped if possible, buffered read otherwise (pipes, etc.)
+	const ui8view filebytes = file.view();
+	// char and hex views show [dumpFirstByte; dumpLastByte] bytes only (whole file by default)
+	if (hasByteRange and filebytes.size() <= byteRange.first())
+	{
+		throw std::runtime_error("ERROR: --" + g_c_optionBytes + " range starts at byte " + std::to_string(byteRange.first()) + ", which is beyond the end of file (" + std::to_string(filebytes.size()) + " bytes).\n");
+	}
+	const std::size_t dumpFirstByte = std::size_t(byteRange.first());
+	const std::size_t dumpLastByte = std::size_t(std::min<uint64_t>(byteRange.last(), filebytes.size() - 1));
+	const ui8view dumpBytes = filebytes.empty() ? filebytes : filebytes.subspan(dumpFirstByte, dumpLastByte - dumpFirstByte + 1);
+	const std::string dumpRangeNote = hasByteRange ? "bytes [0x" + utils::hex64(dumpFirstByte, 8) + "; 0x" + utils::hex64(dumpLastByte, 8) + "] only \n" : "";
+	if (dumpMode == g_c_dumpPrintf)
+	{
+		printf("EXR data (char view) -------------------------------------- \n%s", dumpRangeNote.c_str());
+		utils::print::asChar(dumpBytes, true, dumpFirstByte);
+		printf("\nEOF ------------------------------------------------------- \n\n");
+		printf("EXR data (hex view) --------------------------------------- \n%s", dumpRangeNote.c_str());
+		utils::print::asBytes(dumpBytes, dumpFirstByte);
+		printf("\nEOF ------------------------------------------------------- \n\n");
+	}
+	else
+	{
+		utils::print::DumpWriter dumpWriter;
+		printf("EXR data (char view) -------------------------------------- \n%s", dumpRangeNote.c_str());
+		dumpWriter.writeCharTable(dumpBytes, dumpFirstByte);
+		dumpWriter.flush();
+		printf("\nEOF ------------------------------------------------------- \n\n");
+		printf("EXR data (hex view) --------------------------------------- \n%s", dumpRangeNote.c_str());
+		dumpWriter.writeHexTable(dumpBytes, dumpFirstByte);
+		dumpWriter.flush();
+		printf("\nEOF ------------------------------------------------------- \n\n");
+	}
 	printf("OpenEXR file analysis result.\n");
 	std::size_t filesizeB = filebytes.size();
-	printf("File size = %u Bytes = %.6f KB = %.6f MB \n\n", uint32_t(filesizeB), float(filesizeB)/1024, float(filesizeB)/1024/1024);
-	exrFileData file = exrFileData(filebytes);
-	file.exrAnalysisDetailed();
+	printf("File size = %llu Bytes = %.6f KB = %.6f MB \n\n", (unsigned long long)filesizeB, double(filesizeB)/1024, double(filesizeB)/1024/1024);
+	exrFileData exrFile = exrFileData(filebytes);
+	exrFile.setLazyPixelDecoding(lazyCacheScanlinesNum);
+	exrFile.setDecodingWorkersNum(decodingWorkersNum);
+	exrFile.setOffsetTableCrossCheck(isOffsetTableCrossCheck);
+	if (hasPixelRegion)
+	{
+		exrFile.setPixelRegion(regionRows, regionColumns);
+	}
+	exrFile.exrAnalysisDetailed();
+}
+
+/// <returns> compression of "--compression=NAME" option (ZIP if option is not given), which must be one files can be written with </returns>
+exr2::consta::s_compression::value compressionOptionValue(const exe::ExeParams& app)
+{
+	const std::string name = app.optionValue(g_c_optionCompression, g_c_compressionDefault);
+	try
+	{
+		const exr2::consta::s_compression::value compression = exrCompression::compressionFromName(name);
+		if (exrCompression::isEncodingSupported(compression))
+		{
+			return compression;
+		}
+	}
+	catch(const std::exception&)
+	{
+	}
+	throw std::runtime_error("ERROR: --" + g_c_optionCompression + "=" + name + " is invalid. Expected one of: " + exrCompression::encodingSupportedNames() + ".\n");
+}
+
+/// <summary>
+///		Output file of each of (filepaths) for --write=(writePath): (writePath) itself for single file, file of the same name in directory (writePath)
+///		(created if it does not exist) in batch mode. Throws if output files are not distinct or output file is one of (filepaths).
+/// </summary>
+std::vector<fs::path> outputFilepathsOf(const std::vector<fs::path>& filepaths, const fs::path& writePath, const bool isBatch)
+{
+	if (writePath.empty())
+	{
+		throw std::runtime_error("ERROR: --" + g_c_optionWrite + " expects output " + (isBatch ? "directory" : "file") + " path, e.g. --" + g_c_optionWrite + "=" + (isBatch ? "recompressed" : "out.exr") + ".\n");
+	}
+	std::error_code error;
+	if (isBatch)
+	{
+		fs::create_directories(writePath, error);
+		if (error or not fs::is_directory(writePath))
+		{
+			throw std::runtime_error("ERROR: --" + g_c_optionWrite + "=" + writePath.generic_string() + " is not a directory and can not be created.\n");
+		}
+	}
+	std::vector<fs::path> outputFilepaths;
+	for (const fs::path& filepath : filepaths)
+	{
+		outputFilepaths.push_back(isBatch ? writePath / filepath.filename() : writePath);
+	}
+	std::vector<fs::path> inputs, outputs;
+	for (std::size_t i = 0; i < filepaths.size(); i++)
+	{
+		inputs.push_back(fs::weakly_canonical(filepaths[i], error));
+		outputs.push_back(fs::weakly_canonical(outputFilepaths[i], error));
+	}
+	std::vector<fs::path> sortedOutputs = outputs;
+	std::sort(sortedOutputs.begin(), sortedOutputs.end());
+	const auto duplicate = std::adjacent_find(sortedOutputs.begin(), sortedOutputs.end());
+	if (duplicate != sortedOutputs.end())
+	{
+		throw std::runtime_error("ERROR: --" + g_c_optionWrite + " would write " + duplicate->generic_string() + " more than once (input files of the same name).\n");
+	}
+	for (const fs::path& output : outputs)
+	{
+		if (std::find(inputs.begin(), inputs.end(), output) != inputs.end())
+		{
+			throw std::runtime_error("ERROR: --" + g_c_optionWrite + " would overwrite input file " + output.generic_string() + ".\n");
+		}
+	}
+	return outputFilepaths;
+}
+
+/// <returns> true if program is run with --batch, --json or --write option (no interactive wait then) </returns>
+bool isNonInteractiveMode(const int argc, char* argv[])
+{
+	try
+	{
+		const exe::ExeParams app(argc, (const char**)argv);
+		return app.hasOption(g_c_optionBatch) or app.hasOption(g_c_optionJson) or app.hasOption(g_c_optionWrite);
+	}
+	catch(const std::exception&)
+	{
+		return false;
+	}
+}
+
+/// <summary>
+///		Batch mode: analyse every file of the files, directories (their .exr files) and patterns (*, ?) given.
+///		Files are analysed concurrently (one exrFileData per file, --threads=N files at a time),
+///		result lines are printed in the order of files:
+///			OK      | path | 4 x 4, channels A,B,G,R, ZIP_COMPRESSION, INCREASING_Y
+///			WARNING | path | ... (end of file is not reached)
+///			FAIL    | path | error message
+///		With --json, one JSON object per file is written instead (NDJSON, in the order files are finished),
+///		--json without --batch writes one JSON object for the single file given.
+///		With --write, each file analysed without error is also written as single-part scanline .exr of --compression
+///		(into --write file, or into --write directory with --batch) and the result line (JSON object) tells where.
+/// </summary>
+/// <returns> process exit code: 0 if all files are OK, 1 otherwise </returns>
+int ApplicationBatch(const int argc, char* argv[])
+{
+	const exe::ExeParams app(argc, (const char**)argv);
+	const bool isBatch = app.hasOption(g_c_optionBatch);
+	const bool isJson = app.hasOption(g_c_optionJson);
+	const std::vector<std::string> positionalParams = app.positionalParams();
+	if (positionalParams.empty())
+	{
+		throw std::runtime_error("ERROR: --" + g_c_optionBatch + " expects .exr files, directories or patterns (e.g. render/shot010_*.exr) to analyse.\n");
+	}
+	const uint32_t workersNum = uintOptionValue(app, g_c_optionThreads, 0, 0);
+	const bool isQuiet = app.hasOption(g_c_optionQuiet);
+	const bool isOffsetTableCrossCheck = app.hasOption(g_c_optionCheckOffsets);
+	std::vector<fs::path> filepaths;
+	try
+	{
+		filepaths = utils::file::expandInputPaths(positionalParams, g_c_batchExtension);
+	}
+	catch(const std::exception& e)
+	{
+		throw std::runtime_error("ERROR: " + std::string(e.what()) + ".\n");
+	}
+	if (not isBatch and filepaths.size() != 1)
+	{
+		const std::string option = isJson ? g_c_optionJson : g_c_optionWrite;
+		throw std::runtime_error("ERROR: --" + option + " analyses one file, " + std::to_string(filepaths.size()) + " files are given. Use --" + g_c_optionBatch + " --" + option + " for many files.\n");
+	}
+	// --write: output file of each input file (batch: same file name in output directory)
+	const bool isWrite = app.hasOption(g_c_optionWrite);
+	const exr2::consta::s_compression::value writeCompression = isWrite ? compressionOptionValue(app) : exr2::consta::s_compression::value::NO;
+	std::vector<fs::path> outputFilepaths;
+	if (app.hasOption(g_c_optionCompression) and not isWrite)
+	{
+		throw std::runtime_error("ERROR: --" + g_c_optionCompression + " sets compression of written files, it is used with --" + g_c_optionWrite + "=PATH.\n");
+	}
+	if (app.hasOption(g_c_optionStream))
+	{
+		// streaming analysis prints its progress and statistics as text, file by file, which would be lost in result lines
+		throw std::runtime_error("ERROR: --" + g_c_optionStream + " analyses one file without --" + g_c_optionBatch + ", --" + g_c_optionJson + " and --" + g_c_optionWrite + ". Run it per file: EXRcheck_App.exe --" + g_c_optionStream + " filename.exr.\n");
+	}
+	if (isWrite)
+	{
+		outputFilepaths = outputFilepathsOf(filepaths, fs::path(app.optionValue(g_c_optionWrite)), isBatch);
+	}
+	// single file: threads decode its pixel data, batch: threads analyse files, each file is decoded on one thread
+	const uint32_t threadsNum = not isBatch ? 1 : utils::ThreadPool::threadsNum(workersNum);
+	const uint32_t decodingWorkersNum = isBatch ? 1 : workersNum;
+
+	enum class Status { OK, WARNING, FAIL };
+	struct FileResult
+	{
+		bool isDone = false;
+		Status status = Status::FAIL;
+		std::string line;
+	};
+	std::vector<FileResult> results(filepaths.size());
+	std::mutex resultsMutex;
+	std::size_t nextPrintedIndex = 0;		// guarded by (resultsMutex)
+	utils::JsonWriter json;					// guarded by (resultsMutex)
+	const std::string statusNames[] = { "OK", "WARNING", "FAIL" };
+	const std::string statusColumns[] = { "OK     ", "WARNING", "FAIL   " };
+	const auto analyseFile = [&](const std::size_t index)
+	{
+		const fs::path& filepath = filepaths[index];
+		FileResult result;
+		std::unique_ptr<utils::file::FileBytes> file = nullptr;
+		std::unique_ptr<exrFileData> exrFile = nullptr;
+		uint64_t writtenSizeBytes = 0;
+		try
+		{
+			file = std::make_unique<utils::file::FileBytes>(filepath);
+			exrFile = std::make_unique<exrFileData>(file->view());
+			exrFile->setDecodingWorkersNum(decodingWorkersNum);
+			exrFile->setOffsetTableCrossCheck(isOffsetTableCrossCheck);
+			if (isWrite)
+			{
+				// pixel data is validated without being kept, rows are decoded again window by window while written
+				exrFile->setLazyPixelDecoding(g_c_lazyCacheScanlinesNumDefault);
+			}
+			result.line = exrFile->exrAnalysisBrief();
+			result.status = Status::OK;
+			if (not exrFile->isEndOfFileReached())
+			{
+				result.status = Status::WARNING;
+				result.line += " (end of file is not reached)";
+			}
+			if (isWrite)
+			{
+				writtenSizeBytes = exrFile->writeScanlineExr(outputFilepaths[index], writeCompression);
+				result.line += " | written: " + outputFilepaths[index].generic_string() + ", " + exr2::consta::compressionName(writeCompression) + ", " + std::to_string(writtenSizeBytes) + " bytes";
+			}
+		}
+		catch(const std::exception& e)
+		{
+			result.status = Status::FAIL;
+			result.line = e.what();
+			std::replace(result.line.begin(), result.line.end(), '\n', ' ');
+		}
+		result.isDone = true;
+		std::lock_guard<std::mutex> lock(resultsMutex);
+		if (isJson)
+		{
+			json.beginObject();
+			json.member("file", filepath.generic_string());
+			json.member("status", statusNames[int(result.status)]);
+			if (result.status == Status::FAIL)
+			{
+				json.member("error", result.line);
+			}
+			else
+			{
+				exrFile->writeJsonMembers(json);
+				if (isWrite)
+				{
+					json.key("written");
+					json.beginObject();
+					json.member("file", outputFilepaths[index].generic_string());
+					json.member("compression", exr2::consta::compressionName(writeCompression));
+					json.member("sizeBytes", writtenSizeBytes);
+					json.endObject();
+				}
+			}
+			json.endObject();
+			json.endRecord();
+			results[index] = std::move(result);
+			return;
+		}
+		// print finished results in the order of files, as soon as all previous files are finished
+		result.line = statusColumns[int(result.status)] + " | " + filepath.generic_string() + " | " + result.line;
+		results[index] = std::move(result);
+		for (; nextPrintedIndex < results.size() and results[nextPrintedIndex].isDone; nextPrintedIndex++)
+		{
+			if (not isQuiet or results[nextPrintedIndex].status != Status::OK)
+			{
+				printf("%s\n", results[nextPrintedIndex].line.c_str());
+			}
+		}
+		fflush(stdout);
+	};
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (threadsNum == 1)
+	{
+		for (std::size_t i = 0; i < filepaths.size(); i++)
+		{
+			analyseFile(i);
+		}
+	}
+	else
+	{
+		utils::ThreadPool threadPool(threadsNum - 1);		// calling thread analyses files too
+		threadPool.parallelFor(0, filepaths.size(), 1, [&](const std::size_t first, const std::size_t last)
+		{
+			for (std::size_t i = first; i < last; i++)
+			{
+				analyseFile(i);
+			}
+		});
+	}
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::size_t statusCounts[3] = { 0, 0, 0 };
+	for (const FileResult& result : results)
+	{
+		statusCounts[int(result.status)]++;
+	}
+	if (not isJson)
+	{
+		printf("-------------------- \n");
+		printf("%u files analysed in %.3f s: %u OK, %u WARNING, %u FAIL \n", uint32_t(results.size()), seconds, uint32_t(statusCounts[0]), uint32_t(statusCounts[1]), uint32_t(statusCounts[2]));
+	}
+	return (statusCounts[0] == results.size()) ? 0 : 1;
 }
 
 int main(int argc, char* argv[])		// argc = , argv[0] = program .exe path, argv[1...] = input .exe parameters
 {
+	const bool isNonInteractive = isNonInteractiveMode(argc, argv);
 	try
 	{
+		if (isNonInteractive)
+		{
+			return ApplicationBatch(argc, argv);
+		}
 		Application(argc, argv);
 	}
-	catch(const std::exception e)
+	catch(const std::exception& e)
 	{
 		printf("FATAL ERROR: %s \n", e.what());
-		utils::waitForUser();
+		if (not isNonInteractive)
+		{
+			utils::waitForUser();
+		}
 		return -1;
 	}
 
@@ -0,0 +1,182 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "types.h"
+
+namespace utils
+{
+	namespace print
+	{
+		// "XX " text of each byte value (uppercase hex + space), used by DumpWriter
+		struct HexByteTable
+		{
+			std::array<std::array<char, 3>, 256> entries = {};
+			constexpr HexByteTable()
+			{
+				const char digits[] = "0123456789ABCDEF";
+				for (std::size_t i = 0; i < entries.size(); i++)
+				{
+					entries[i] = { digits[i >> 4], digits[i & 0x0F], ' ' };
+				}
+			}
+		};
+
+		/// <summary>
+		///		Block-based writer of hex / char dumps of bytes.
+		///		Output is the same as of utils::print::asBytes() and utils::print::asChar() (table view), but rows are formatted
+		///		with lookup tables into a large reusable buffer, which is written with a single fwrite() call when full.
+		///		Writes go to the same FILE as printf() (stdout by default), so output order with printf() calls is kept.
+		/// </summary>
+		/// <how-to-use>
+		///		utils::print::DumpWriter writer;
+		///		writer.writeHexTable(filebytes);
+		///		writer.flush();		// or let destructor flush
+		/// </how-to-use>
+		class DumpWriter
+		{
+			public:
+			static constexpr std::size_t s_c_rowBytesNum = 16;
+			static constexpr std::size_t s_c_defaultBufferSizeBytes = 1 << 20;		// 1 MB
+
+			explicit DumpWriter(FILE* output = stdout, const std::size_t bufferSizeBytes = s_c_defaultBufferSizeBytes)
+				: m_output(output), m_buffer(std::max(bufferSizeBytes, s_c_maxRowSizeBytes))
+			{
+				if (m_output == nullptr)
+				{
+					throw std::invalid_argument("DumpWriter: (output) must not be nullptr");
+				}
+			}
+			DumpWriter(const DumpWriter& other) = delete;
+			DumpWriter& operator=(const DumpWriter& other) = delete;
+			~DumpWriter() { flush(); }
+
+			/// <summary>
+			///		Write (bytes) as table of hex values, 16 per row, each row starts with offset of its first byte.
+			/// </summary>
+			/// <param name="firstByteOffset"> - offset of bytes[0] within file, printed offsets are (firstByteOffset + index in bytes) </param>
+			void writeHexTable(const ui8view bytes, const std::size_t firstByteOffset = 0)
+			{
+				write("___________ +0 +1 +2 +3 +4 +5 +6 +7 +8 +9 +a +b +c +d +e +f \n");
+				const std::size_t fullRowsNum = bytes.size() / s_c_rowBytesNum;
+				for (std::size_t row = 0; row < fullRowsNum; row++)
+				{
+					char* out = reserve(s_c_hexRowSizeBytes);
+					out = writeRowOffset(out, firstByteOffset + row * s_c_rowBytesNum);
+					const ui8* rowBytes = bytes.data() + row * s_c_rowBytesNum;
+					for (std::size_t i = 0; i < s_c_rowBytesNum; i++)
+					{
+						std::memcpy(out, s_c_hexTable.entries[rowBytes[i]].data(), 3);		// "XX "
+						out += 3;
+					}
+					*out++ = '\n';
+					m_used = out - m_buffer.data();
+				}
+				const std::size_t restBytesNum = bytes.size() % s_c_rowBytesNum;
+				if (restBytesNum != 0)		// last row is not terminated with '\n', as in asBytes()
+				{
+					char* out = reserve(s_c_hexRowSizeBytes);
+					out = writeRowOffset(out, firstByteOffset + fullRowsNum * s_c_rowBytesNum);
+					for (std::size_t i = 0; i < restBytesNum; i++)
+					{
+						std::memcpy(out, s_c_hexTable.entries[bytes[fullRowsNum * s_c_rowBytesNum + i]].data(), 3);
+						out += 3;
+					}
+					m_used = out - m_buffer.data();
+				}
+			}
+			/// <summary>
+			///		Write (bytes) as table of chars (bytes are written as is), 16 per row, each row starts with offset of its first byte.
+			/// </summary>
+			/// <param name="firstByteOffset"> - offset of bytes[0] within file, printed offsets are (firstByteOffset + index in bytes) </param>
+			void writeCharTable(const ui8view bytes, const std::size_t firstByteOffset = 0)
+			{
+				write("___________ 0123456789abcdef \n");
+				for (std::size_t first = 0; first < bytes.size(); first += s_c_rowBytesNum)
+				{
+					const std::size_t rowBytesNum = std::min(s_c_rowBytesNum, bytes.size() - first);
+					char* out = reserve(s_c_charRowSizeBytes);
+					out = writeRowOffset(out, firstByteOffset + first);
+					std::memcpy(out, bytes.data() + first, rowBytesNum);
+					out += rowBytesNum;
+					if (rowBytesNum == s_c_rowBytesNum)
+					{
+						*out++ = '\n';
+					}
+					m_used = out - m_buffer.data();
+				}
+			}
+			/// <summary> Write buffered output to the FILE. </summary>
+			void flush()
+			{
+				if (m_used != 0)
+				{
+					std::fwrite(m_buffer.data(), 1, m_used, m_output);
+					m_used = 0;
+				}
+			}
+
+			private:
+			static constexpr std::size_t s_c_offsetSizeBytes = 20;											// "0x%8.8llx: " (up to 16 digits)
+			static constexpr std::size_t s_c_hexRowSizeBytes = s_c_offsetSizeBytes + 3 * s_c_rowBytesNum + 1;	// + "XX " per byte + '\n'
+			static constexpr std::size_t s_c_charRowSizeBytes = s_c_offsetSizeBytes + s_c_rowBytesNum + 1;		// + char per byte + '\n'
+			static constexpr std::size_t s_c_maxRowSizeBytes = s_c_hexRowSizeBytes;
+
+			static constexpr HexByteTable s_c_hexTable = HexByteTable();
+
+			FILE* m_output = nullptr;
+			std::vector<char> m_buffer;
+			std::size_t m_used = 0;
+
+			/// <returns> pointer to free space of at least (bytesNum) bytes in the buffer, flushing it if needed </returns>
+			char* reserve(const std::size_t bytesNum)
+			{
+				if (m_buffer.size() - m_used < bytesNum)
+				{
+					flush();
+				}
+				return m_buffer.data() + m_used;
+			}
+			void write(const char* text)
+			{
+				const std::size_t length = std::strlen(text);
+				if (m_buffer.size() - m_used < length)
+				{
+					flush();
+				}
+				if (m_buffer.size() < length)
+				{
+					std::fwrite(text, 1, length, m_output);
+					return;
+				}
+				std::memcpy(m_buffer.data() + m_used, text, length);
+				m_used += length;
+			}
+			/// <summary> Write "0x%8.8llx: " of (offset) (lowercase, at least 8 digits, more for offsets past 4 GB). </summary>
+			static char* writeRowOffset(char* out, const std::size_t offset)
+			{
+				const char digits[] = "0123456789abcdef";
+				const uint64_t value = uint64_t(offset);
+				int32_t shift = 28;
+				while (shift < 60 and (value >> (shift + 4)) != 0)
+				{
+					shift += 4;
+				}
+				*out++ = '0';
+				*out++ = 'x';
+				for (; shift >= 0; shift -= 4)
+				{
+					*out++ = digits[(value >> shift) & 0x0F];
+				}
+				*out++ = ':';
+				*out++ = ' ';
+				return out;
+			}
+		};
+	}
+}
@@ -53,6 +53,38 @@ namespace exe
 			return m_argvStrings[index];
 		}
 		std::string pathAndName() const { return m_argvStrings[0]; }
+		/// <summary>
+		///		Options are parameters of "--name" or "--name=value" form, other parameters [1...] are positional (file paths, etc.).
+		/// </summary>
+		/// <returns> true if "--(optionName)" or "--(optionName)=..." parameter is provided </returns>
+		bool hasOption(const std::string& optionName) const
+		{
+			std::string value;
+			return findOption(optionName, value);
+		}
+		/// <returns> value of "--(optionName)=value" parameter, (defaultValue) if option is not provided or has no value </returns>
+		std::string optionValue(const std::string& optionName, const std::string& defaultValue = "") const
+		{
+			std::string value;
+			if (not findOption(optionName, value) or value.empty())
+			{
+				return defaultValue;
+			}
+			return value;
+		}
+		/// <returns> parameters [1...], which are not options, in the order they are provided </returns>
+		std::vector<std::string> positionalParams() const
+		{
+			std::vector<std::string> result;
+			for (argc_t i = 1; i < m_argc; i++)
+			{
+				if (not isOption(m_argvStrings[i]))
+				{
+					result.push_back(m_argvStrings[i]);
+				}
+			}
+			return result;
+		}
 		std::string toString() const
 		{
 			std::string result = "argc = " + std::to_string(m_argc) + "\n";
@@ -67,6 +99,30 @@ namespace exe
 		private:
 		argc_t m_argc = 0;
 		std::vector<std::string> m_argvStrings;
+		static inline const std::string s_c_optionPrefix = "--";
+
+		static bool isOption(const std::string& parameter) { return parameter.size() > s_c_optionPrefix.size() and parameter.starts_with(s_c_optionPrefix); }
+		/// <returns> true and (value) of the last matching option (empty if option has no "=value" part), false if option is not provided </returns>
+		bool findOption(const std::string& optionName, std::string& value) const
+		{
+			bool isFound = false;
+			const std::string option = s_c_optionPrefix + optionName;
+			for (argc_t i = 1; i < m_argc; i++)
+			{
+				const std::string& parameter = m_argvStrings[i];
+				if (parameter == option)
+				{
+					isFound = true;
+					value.clear();
+				}
+				else if (parameter.starts_with(option + "="))
+				{
+					isFound = true;
+					value = parameter.substr(option.size() + 1);
+				}
+			}
+			return isFound;
+		}
 	};
 }
 
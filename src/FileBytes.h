@@ -0,0 +1,342 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "pcinfo.h"
+#include "types.h"
+
+#if OS_WINDOWS
+	#ifndef NOMINMAX
+		#define NOMINMAX				// keep std::min / std::max usable after <windows.h>
+	#endif
+	#ifndef WIN32_LEAN_AND_MEAN
+		#define WIN32_LEAN_AND_MEAN
+	#endif
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace utils
+{
+	namespace file
+	{
+		/// <summary>
+		///		Read-only source of file bytes.
+		///		Regular files are memory-mapped, so the bytes are not copied and pages are loaded by the OS on first access.
+		///		Files that can not be mapped (pipes, character devices, empty files, mapping failure) are read into
+		///		an internal buffer using large block reads.
+		///		In both cases, the bytes are accessed through view(), which stays valid while the FileBytes object is alive.
+		/// </summary>
+		class FileBytes
+		{
+			public:
+			/// <summary>
+			///		Open the file and make its bytes available through view().
+			/// </summary>
+			/// <param name="filepath"> - name, relative path or absolute path of the target file </param>
+			/// <param name="allowMapping"> - if false, the file is always read into the buffer (no memory mapping) </param>
+			explicit FileBytes(const std::filesystem::path& filepath, const bool allowMapping = true)
+			{
+				if (allowMapping and tryMap(filepath))
+				{
+					return;
+				}
+				readBuffered(filepath);
+			}
+			FileBytes(const FileBytes& other) = delete;
+			FileBytes& operator=(const FileBytes& other) = delete;
+			~FileBytes() { unmap(); }
+
+			/// <summary> Get read-only view of all file bytes. </summary>
+			/// <returns> ui8view (span of const bytes), valid while this object is alive </returns>
+			ui8view view() const { return isMapped() ? ui8view(m_mapped, m_mappedSize) : ui8view(m_buffer.data(), m_buffer.size()); }
+			std::size_t size() const { return view().size(); }
+			/// <returns> true if file bytes are memory-mapped, false if they are read into the buffer </returns>
+			bool isMapped() const { return m_mapped != nullptr; }
+
+			private:
+			static const std::size_t s_c_readBlockSizeBytes = 1 << 20;	// 1 MB per read() call for inputs of unknown size (pipes)
+			const ui8* m_mapped = nullptr;
+			std::size_t m_mappedSize = 0;
+			std::vector<ui8> m_buffer;
+			#if OS_WINDOWS
+			HANDLE m_file = INVALID_HANDLE_VALUE;
+			HANDLE m_mapping = nullptr;
+			#endif
+
+			bool tryMap(const std::filesystem::path& filepath)
+			{
+				std::error_code error;
+				if (not std::filesystem::is_regular_file(filepath, error))
+				{
+					return false;	// pipe, device, etc. => can not be mapped
+				}
+				#if OS_WINDOWS
+				m_file = CreateFileW(filepath.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+				if (m_file == INVALID_HANDLE_VALUE)
+				{
+					return false;
+				}
+				LARGE_INTEGER filesize = {};
+				if (not GetFileSizeEx(m_file, &filesize) or filesize.QuadPart == 0 or uint64_t(filesize.QuadPart) > uint64_t(SIZE_MAX))
+				{
+					unmap();
+					return false;
+				}
+				m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (m_mapping == nullptr)
+				{
+					unmap();
+					return false;
+				}
+				m_mapped = (const ui8*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+				if (m_mapped == nullptr)
+				{
+					unmap();
+					return false;
+				}
+				m_mappedSize = std::size_t(filesize.QuadPart);
+				return true;
+				#else
+				const int fd = open(filepath.c_str(), O_RDONLY);
+				if (fd < 0)
+				{
+					return false;
+				}
+				struct stat fileStat = {};
+				if (fstat(fd, &fileStat) != 0 or fileStat.st_size <= 0 or uint64_t(fileStat.st_size) > uint64_t(SIZE_MAX))
+				{
+					close(fd);
+					return false;
+				}
+				void* mapped = mmap(nullptr, std::size_t(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+				close(fd);	// mapping stays valid after closing the descriptor
+				if (mapped == MAP_FAILED)
+				{
+					return false;
+				}
+				madvise(mapped, std::size_t(fileStat.st_size), MADV_SEQUENTIAL);
+				m_mapped = (const ui8*)mapped;
+				m_mappedSize = std::size_t(fileStat.st_size);
+				return true;
+				#endif
+			}
+
+			void unmap()
+			{
+				#if OS_WINDOWS
+				if (m_mapped != nullptr) UnmapViewOfFile(m_mapped);
+				if (m_mapping != nullptr) CloseHandle(m_mapping);
+				if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+				m_mapping = nullptr;
+				m_file = INVALID_HANDLE_VALUE;
+				#else
+				if (m_mapped != nullptr) munmap((void*)m_mapped, m_mappedSize);
+				#endif
+				m_mapped = nullptr;
+				m_mappedSize = 0;
+			}
+
+			void readBuffered(const std::filesystem::path& filepath)
+			{
+				FILE* file = std::fopen(filepath.string().c_str(), "rb");
+				if (file == nullptr)
+				{
+					throw std::runtime_error("Error opening file " + filepath.string() + ". Check the file exists and is readable.");
+				}
+				// regular files are read by one fread() into buffer of file size, pipes (size unknown) are read block-by-block until EOF
+				std::error_code error;
+				const bool isRegular = std::filesystem::is_regular_file(filepath, error);
+				const std::uintmax_t fileSize = isRegular ? std::filesystem::file_size(filepath, error) : 0;
+				std::size_t bytesRead = 0;
+				if (isRegular && !error)
+				{
+					m_buffer.resize(std::size_t(fileSize));
+					bytesRead = std::fread(m_buffer.data(), 1, m_buffer.size(), file);
+				}
+				else
+				{
+					do
+					{
+						m_buffer.resize(bytesRead + s_c_readBlockSizeBytes);
+						bytesRead += std::fread(m_buffer.data() + bytesRead, 1, s_c_readBlockSizeBytes, file);
+					}
+					while (bytesRead == m_buffer.size());
+				}
+				const bool hasFailed = std::ferror(file) != 0;
+				std::fclose(file);
+				m_buffer.resize(bytesRead);
+				if (hasFailed)
+				{
+					throw std::runtime_error("File operation failed: READ (" + filepath.string() + ")");
+				}
+			}
+		};
+
+		/// <summary>
+		///		Reader of byte ranges of a file, for files which are not kept in memory as a whole (streaming analysis):
+		///		only bytes asked for are read, into buffers of the caller. Reads are serialized, so one reader may be shared by threads.
+		/// </summary>
+		class FileReader
+		{
+			public:
+			/// <param name="filepath"> - name, relative path or absolute path of regular file (its size must be known) </param>
+			explicit FileReader(const std::filesystem::path& filepath)
+			{
+				std::error_code error;
+				m_size = uint64_t(std::filesystem::file_size(filepath, error));
+				if (error)
+				{
+					throw std::runtime_error("Error getting size of file " + filepath.string() + ". Check the file exists and is a regular file.");
+				}
+				m_file = std::fopen(filepath.string().c_str(), "rb");
+				if (m_file == nullptr)
+				{
+					throw std::runtime_error("Error opening file " + filepath.string() + ". Check the file exists and is readable.");
+				}
+			}
+			FileReader(const FileReader& other) = delete;
+			FileReader& operator=(const FileReader& other) = delete;
+			~FileReader() { std::fclose(m_file); }
+
+			uint64_t size() const { return m_size; }
+			/// <returns> number of bytes read so far </returns>
+			uint64_t bytesRead() const
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				return m_bytesRead;
+			}
+			/// <summary>
+			///		Read bytes [firstByteIndex; firstByteIndex + bytesNum) of file into (destination).
+			///		Throws if the bytes are out of file or can not be read.
+			/// </summary>
+			void read(const uint64_t firstByteIndex, const std::size_t bytesNum, ui8* destination)
+			{
+				if (m_size < firstByteIndex or m_size - firstByteIndex < bytesNum)
+				{
+					throw std::runtime_error("bytes [" + std::to_string(firstByteIndex) + "; " + std::to_string(firstByteIndex + bytesNum) + ") are out of file bytes range (" + std::to_string(m_size) + " bytes). File is truncated or is not a valid .exr file.");
+				}
+				std::lock_guard<std::mutex> lock(m_mutex);
+				#if OS_WINDOWS
+				const bool isSought = _fseeki64(m_file, int64_t(firstByteIndex), SEEK_SET) == 0;
+				#else
+				const bool isSought = fseeko(m_file, off_t(firstByteIndex), SEEK_SET) == 0;
+				#endif
+				if (not isSought or std::fread(destination, 1, bytesNum, m_file) != bytesNum)
+				{
+					throw std::runtime_error("File operation failed: READ of " + std::to_string(bytesNum) + " bytes at byte " + std::to_string(firstByteIndex) + ".");
+				}
+				m_bytesRead += bytesNum;
+			}
+
+			private:
+			std::FILE* m_file = nullptr;
+			uint64_t m_size = 0;
+			uint64_t m_bytesRead = 0;		// guarded by (m_mutex)
+			mutable std::mutex m_mutex;
+		};
+
+		/// <summary>
+		///		Writer of new file: bytes are appended one block after another, blocks already written may be overwritten
+		///		in place (e.g. table of offsets, which is known only after the blocks it points at are written).
+		/// </summary>
+		class FileWriter
+		{
+			public:
+			/// <param name="filepath"> - name, relative path or absolute path of file to create (existing file is overwritten) </param>
+			explicit FileWriter(const std::filesystem::path& filepath)
+				: m_filepath(filepath)
+			{
+				m_file = std::fopen(filepath.string().c_str(), "wb");
+				if (m_file == nullptr)
+				{
+					throw std::runtime_error("Error creating file " + filepath.string() + ". Check the directory exists and is writable.");
+				}
+			}
+			FileWriter(const FileWriter& other) = delete;
+			FileWriter& operator=(const FileWriter& other) = delete;
+			~FileWriter()
+			{
+				if (m_file != nullptr)
+				{
+					std::fclose(m_file);
+				}
+			}
+
+			/// <returns> number of bytes of file, i.e. index of next appended byte </returns>
+			uint64_t size() const { return m_size; }
+			/// <summary>
+			///		Append (bytes) to the end of file. Throws if they can not be written.
+			/// </summary>
+			void append(const ui8view bytes)
+			{
+				write(m_size, bytes);
+			}
+			/// <summary>
+			///		Overwrite bytes [firstByteIndex; firstByteIndex + bytes.size()) of file with (bytes), they must not extend past its end.
+			/// </summary>
+			void overwrite(const uint64_t firstByteIndex, const ui8view bytes)
+			{
+				if (m_size < firstByteIndex or m_size - firstByteIndex < bytes.size())
+				{
+					throw std::logic_error("bytes [" + std::to_string(firstByteIndex) + "; " + std::to_string(firstByteIndex + bytes.size()) + ") to overwrite are out of file bytes range (" + std::to_string(m_size) + " bytes).");
+				}
+				write(firstByteIndex, bytes);
+			}
+			/// <summary>
+			///		Flush and close file. Throws if buffered bytes can not be written. Destructor closes file too, without the check.
+			/// </summary>
+			void close()
+			{
+				const bool isClosed = std::fclose(m_file) == 0;
+				m_file = nullptr;
+				if (not isClosed)
+				{
+					throw std::runtime_error("File operation failed: CLOSE of " + m_filepath.string() + ".");
+				}
+			}
+
+			private:
+			std::filesystem::path m_filepath;
+			std::FILE* m_file = nullptr;
+			uint64_t m_size = 0;
+			uint64_t m_position = 0;		// of (m_file), seek is skipped when writing there
+
+			void write(const uint64_t firstByteIndex, const ui8view bytes)
+			{
+				if (m_file == nullptr)
+				{
+					throw std::logic_error("File " + m_filepath.string() + " is closed.");
+				}
+				if (firstByteIndex != m_position)
+				{
+					#if OS_WINDOWS
+					const bool isSought = _fseeki64(m_file, int64_t(firstByteIndex), SEEK_SET) == 0;
+					#else
+					const bool isSought = fseeko(m_file, off_t(firstByteIndex), SEEK_SET) == 0;
+					#endif
+					if (not isSought)
+					{
+						throw std::runtime_error("File operation failed: SEEK to byte " + std::to_string(firstByteIndex) + " of " + m_filepath.string() + ".");
+					}
+				}
+				if (std::fwrite(bytes.data(), 1, bytes.size(), m_file) != bytes.size())
+				{
+					throw std::runtime_error("File operation failed: WRITE of " + std::to_string(bytes.size()) + " bytes at byte " + std::to_string(firstByteIndex) + " of " + m_filepath.string() + ".");
+				}
+				m_position = firstByteIndex + bytes.size();
+				m_size = std::max(m_size, m_position);
+			}
+		};
+	}
+}
@@ -0,0 +1,282 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+	/// <summary>
+	///		Streaming writer of compact JSON (no whitespace between tokens).
+	///		Values are written into a reusable buffer as they come and the buffer is written with fwrite() when full,
+	///		so large arrays (offset tables, etc.) are never built as a whole string in memory.
+	///		Commas between object members and array elements are put automatically.
+	/// </summary>
+	/// <how-to-use>
+	///		utils::JsonWriter json;
+	///		json.beginObject();
+	///		json.member("width", 1920);
+	///		json.key("offsets");
+	///		json.beginArray();
+	///		for (uint64_t offset : offsets) { json.value(offset); }
+	///		json.endArray();
+	///		json.endObject();
+	///		json.endRecord();		// '\n' + flush: one NDJSON line
+	/// </how-to-use>
+	class JsonWriter
+	{
+		public:
+		static constexpr std::size_t s_c_defaultBufferSizeBytes = 1 << 16;		// 64 KB
+
+		explicit JsonWriter(FILE* output = stdout, const std::size_t bufferSizeBytes = s_c_defaultBufferSizeBytes)
+			: m_output(output), m_buffer(std::max(bufferSizeBytes, s_c_maxTokenSizeBytes))
+		{
+			if (m_output == nullptr)
+			{
+				throw std::invalid_argument("JsonWriter: (output) must not be nullptr");
+			}
+		}
+		JsonWriter(const JsonWriter& other) = delete;
+		JsonWriter& operator=(const JsonWriter& other) = delete;
+		~JsonWriter() { flush(); }
+
+		void beginObject() { beginValue(); put('{'); m_hasElements.push_back(false); }
+		void endObject() { endContainer('}'); }
+		void beginArray() { beginValue(); put('['); m_hasElements.push_back(false); }
+		void endArray() { endContainer(']'); }
+		/// <summary> Write member name of current object, next written value is the member value. </summary>
+		void key(const std::string& name)
+		{
+			if (m_hasElements.empty() or m_isAfterKey)
+			{
+				throw std::logic_error("JsonWriter::key(): key is allowed only inside of object, before a value");
+			}
+			beginValue();
+			putString(name);
+			put(':');
+			m_isAfterKey = true;
+		}
+
+		void value(const std::string& str) { beginValue(); putString(str); }
+		void value(const char* str) { beginValue(); putString(str); }
+		void value(const bool boolean) { beginValue(); putRaw(boolean ? "true" : "false"); }
+		void value(const int32_t number) { value(int64_t(number)); }
+		void value(const uint32_t number) { value(uint64_t(number)); }
+		void value(const int64_t number) { beginValue(); putFormatted("%lld", (long long)number); }
+		void value(const uint64_t number) { beginValue(); putFormatted("%llu", (unsigned long long)number); }
+		/// <summary> Write floating point number (9 significant digits, exact for float). NaN and infinity are written as null. </summary>
+		void value(const double number)
+		{
+			beginValue();
+			if (not std::isfinite(number))
+			{
+				putRaw("null");
+				return;
+			}
+			putFormatted("%.9g", number);
+		}
+		void valueNull() { beginValue(); putRaw("null"); }
+		/// <summary> Write "name":value member of current object. </summary>
+		template <typename ValueT>
+		void member(const std::string& name, const ValueT& memberValue)
+		{
+			key(name);
+			value(memberValue);
+		}
+
+		/// <summary> End top-level value with '\n' (one record of NDJSON) and flush it. </summary>
+		void endRecord()
+		{
+			if (not m_hasElements.empty())
+			{
+				throw std::logic_error("JsonWriter::endRecord(): not all objects / arrays are ended");
+			}
+			put('\n');
+			m_isFirstTopLevelValue = true;
+			flush();
+		}
+		/// <summary> Write buffered output to the FILE. </summary>
+		void flush()
+		{
+			if (m_used != 0)
+			{
+				std::fwrite(m_buffer.data(), 1, m_used, m_output);
+				m_used = 0;
+			}
+			std::fflush(m_output);
+		}
+
+		private:
+		static constexpr std::size_t s_c_maxTokenSizeBytes = 64;		// longest number / literal written at once
+
+		FILE* m_output = nullptr;
+		std::vector<char> m_buffer;
+		std::size_t m_used = 0;
+		std::vector<bool> m_hasElements;		// per open object / array: true if it already has a member / element
+		bool m_isAfterKey = false;
+		bool m_isFirstTopLevelValue = true;
+
+		/// <summary> Put comma before value, if it is not the first element of its container and does not follow a key. </summary>
+		void beginValue()
+		{
+			if (m_isAfterKey)
+			{
+				m_isAfterKey = false;
+				return;
+			}
+			if (m_hasElements.empty())
+			{
+				if (not m_isFirstTopLevelValue)
+				{
+					throw std::logic_error("JsonWriter: only one top-level value is allowed per record, call endRecord() first");
+				}
+				m_isFirstTopLevelValue = false;
+				return;
+			}
+			if (m_hasElements.back())
+			{
+				put(',');
+			}
+			m_hasElements.back() = true;
+		}
+		void endContainer(const char closingChar)
+		{
+			if (m_hasElements.empty() or m_isAfterKey)
+			{
+				throw std::logic_error("JsonWriter: no object / array to end, or object member has no value");
+			}
+			m_hasElements.pop_back();
+			put(closingChar);
+		}
+		void put(const char c)
+		{
+			if (m_used == m_buffer.size())
+			{
+				flush();
+			}
+			m_buffer[m_used++] = c;
+		}
+		void putRaw(const char* text)
+		{
+			for (; *text != '\0'; text++)
+			{
+				put(*text);
+			}
+		}
+		template <typename... Args>
+		void putFormatted(const char* format, Args... args)
+		{
+			if (m_buffer.size() - m_used < s_c_maxTokenSizeBytes)
+			{
+				flush();
+			}
+			const int length = std::snprintf(m_buffer.data() + m_used, s_c_maxTokenSizeBytes, format, args...);
+			m_used += std::size_t(std::clamp(length, 0, int(s_c_maxTokenSizeBytes) - 1));
+		}
+		/// <returns> size in bytes of well-formed UTF-8 sequence starting at (str)[index] (1 to 4), 0 if bytes there are not valid UTF-8 </returns>
+		static std::size_t utf8SequenceSizeBytes(const std::string& str, const std::size_t index)
+		{
+			const unsigned char lead = (unsigned char)str[index];
+			if (lead < 0x80)
+			{
+				return 1;
+			}
+			// second byte range depends on lead byte: no overlong forms, no surrogates (U+D800..U+DFFF), nothing above U+10FFFF
+			std::size_t sizeBytes = 0;
+			unsigned char secondMin = 0x80;
+			unsigned char secondMax = 0xBF;
+			if (lead >= 0xC2 and lead <= 0xDF)
+			{
+				sizeBytes = 2;
+			}
+			else if (lead == 0xE0)
+			{
+				sizeBytes = 3;
+				secondMin = 0xA0;
+			}
+			else if (lead == 0xED)
+			{
+				sizeBytes = 3;
+				secondMax = 0x9F;
+			}
+			else if (lead >= 0xE1 and lead <= 0xEF)
+			{
+				sizeBytes = 3;
+			}
+			else if (lead == 0xF0)
+			{
+				sizeBytes = 4;
+				secondMin = 0x90;
+			}
+			else if (lead == 0xF4)
+			{
+				sizeBytes = 4;
+				secondMax = 0x8F;
+			}
+			else if (lead >= 0xF1 and lead <= 0xF3)
+			{
+				sizeBytes = 4;
+			}
+			else
+			{
+				return 0;
+			}
+			if (str.size() - index < sizeBytes)
+			{
+				return 0;
+			}
+			for (std::size_t i = 1; i < sizeBytes; i++)
+			{
+				const unsigned char next = (unsigned char)str[index + i];
+				if (next < ((i == 1) ? secondMin : 0x80) or next > ((i == 1) ? secondMax : 0xBF))
+				{
+					return 0;
+				}
+			}
+			return sizeBytes;
+		}
+		/// <summary>
+		///		Put quoted (str) with ", \ and control chars escaped. Valid UTF-8 sequences are put as they are, any other byte
+		///		(attribute names and strings of .exr files are not guaranteed to be UTF-8) is escaped as \u00XX, i.e. read as Latin-1,
+		///		so the output is always valid JSON.
+		/// </summary>
+		void putString(const std::string& str)
+		{
+			const char digits[] = "0123456789abcdef";
+			put('"');
+			for (std::size_t index = 0; index < str.size();)
+			{
+				const char c = str[index];
+				const unsigned char uc = (unsigned char)c;
+				const std::size_t sequenceSizeBytes = utf8SequenceSizeBytes(str, index);
+				if (c == '"' or c == '\\')
+				{
+					put('\\');
+					put(c);
+				}
+				else if (uc < 0x20 or sequenceSizeBytes == 0)
+				{
+					putRaw("\\u00");
+					put(digits[uc >> 4]);
+					put(digits[uc & 0x0F]);
+				}
+				else
+				{
+					for (std::size_t i = 0; i < sequenceSizeBytes; i++)
+					{
+						put(str[index + i]);
+					}
+					index += sequenceSizeBytes;
+					continue;
+				}
+				index++;
+			}
+			put('"');
+		}
+	};
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+	/// <summary>
+	///		Fixed number of worker threads executing submitted tasks in FIFO order.
+	///		Main use is parallelFor(), which splits index range into chunks and processes them on workers and the calling thread.
+	/// </summary>
+	/// <how-to-use>
+	///		utils::ThreadPool pool(8);
+	///		pool.parallelFor(0, rowsNum, 16, [&](std::size_t first, std::size_t last)
+	///		{
+	///			for (std::size_t row = first; row < last; row++) { decodeRow(row); }
+	///		});
+	/// </how-to-use>
+	class ThreadPool
+	{
+		public:
+		/// <param name="workersNum"> - number of worker threads, 0 = one per hardware thread </param>
+		explicit ThreadPool(const uint32_t workersNum = 0)
+		{
+			const uint32_t threadsNum = (workersNum == 0) ? hardwareWorkersNum() : workersNum;
+			m_workers.reserve(threadsNum);
+			for (uint32_t i = 0; i < threadsNum; i++)
+			{
+				m_workers.emplace_back([this]() { workerLoop(); });
+			}
+		}
+		ThreadPool(const ThreadPool& other) = delete;
+		ThreadPool& operator=(const ThreadPool& other) = delete;
+		~ThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_isStopping = true;
+			}
+			m_taskAdded.notify_all();
+			for (std::thread& worker : m_workers)
+			{
+				worker.join();
+			}
+		}
+
+		/// <returns> number of hardware threads (at least 1) </returns>
+		static uint32_t hardwareWorkersNum() { return std::max(1u, std::thread::hardware_concurrency()); }
+		/// <returns> number of threads of (requestedThreadsNum) (e.g. --threads=N, calling thread included), 0 = one per hardware thread </returns>
+		static uint32_t threadsNum(const uint32_t requestedThreadsNum) { return (requestedThreadsNum == 0) ? hardwareWorkersNum() : requestedThreadsNum; }
+		uint32_t workersNum() const { return uint32_t(m_workers.size()); }
+
+		/// <summary>
+		///		Queue (task) for execution on one of the workers.
+		/// </summary>
+		void submit(std::function<void()> task)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_tasks.push_back(std::move(task));
+			}
+			m_taskAdded.notify_one();
+		}
+
+		/// <summary>
+		///		Split [begin; end) into chunks of (grainSize) indexes and call rangeFunc(first, last) for each chunk [first; last) concurrently.
+		///		Calling thread processes chunks too and returns when all chunks are processed.
+		///		If any call throws, remaining chunks are skipped and the first exception is rethrown to the caller.
+		///		Safe to call from inside a task of the same pool (calling thread never only waits for queued helpers).
+		/// </summary>
+		template <typename RangeFunc>
+		void parallelFor(const std::size_t begin, const std::size_t end, const std::size_t grainSize, RangeFunc&& rangeFunc)
+		{
+			if (end <= begin)
+			{
+				return;
+			}
+			const std::size_t grain = std::max<std::size_t>(1, grainSize);
+			std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+			state->begin = begin;
+			state->end = end;
+			state->grainSize = grain;
+			state->chunksNum = (end - begin + grain - 1) / grain;
+			state->rangeFunc = [&rangeFunc](const std::size_t first, const std::size_t last) { rangeFunc(first, last); };
+			// helpers that start after all chunks are taken only touch (state), which they co-own
+			const std::size_t helpersNum = std::min<std::size_t>(workersNum(), state->chunksNum - 1);
+			for (std::size_t i = 0; i < helpersNum; i++)
+			{
+				submit([state]() { runChunks(*state); });
+			}
+			runChunks(*state);
+			std::unique_lock<std::mutex> lock(state->mutex);
+			state->allChunksDone.wait(lock, [&state]() { return state->chunksDoneNum == state->chunksNum; });
+			if (state->error)
+			{
+				std::rethrow_exception(state->error);
+			}
+		}
+
+		private:
+		struct ParallelForState
+		{
+			std::size_t begin = 0, end = 0, grainSize = 1, chunksNum = 0;
+			std::function<void(std::size_t, std::size_t)> rangeFunc;
+			std::atomic<std::size_t> nextChunk = 0;
+			std::atomic<bool> hasFailed = false;
+			std::mutex mutex;
+			std::condition_variable allChunksDone;
+			std::size_t chunksDoneNum = 0;		// guarded by (mutex)
+			std::exception_ptr error = nullptr;	// guarded by (mutex)
+		};
+
+		std::vector<std::thread> m_workers;
+		std::deque<std::function<void()>> m_tasks;
+		std::mutex m_mutex;
+		std::condition_variable m_taskAdded;
+		bool m_isStopping = false;
+
+		void workerLoop()
+		{
+			while (true)
+			{
+				std::function<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_taskAdded.wait(lock, [this]() { return m_isStopping or not m_tasks.empty(); });
+					if (m_tasks.empty())
+					{
+						return;		// stopping and no work left
+					}
+					task = std::move(m_tasks.front());
+					m_tasks.pop_front();
+				}
+				task();
+			}
+		}
+
+		static void runChunks(ParallelForState& state)
+		{
+			while (true)
+			{
+				const std::size_t chunk = state.nextChunk.fetch_add(1);
+				if (state.chunksNum <= chunk)
+				{
+					return;
+				}
+				const std::size_t first = state.begin + chunk * state.grainSize;
+				const std::size_t last = std::min(state.end, first + state.grainSize);
+				std::exception_ptr error = nullptr;
+				if (not state.hasFailed)
+				{
+					try
+					{
+						state.rangeFunc(first, last);
+					}
+					catch(...)
+					{
+						error = std::current_exception();
+						state.hasFailed = true;
+					}
+				}
+				std::lock_guard<std::mutex> lock(state.mutex);
+				if (error and not state.error)
+				{
+					state.error = error;
+				}
+				state.chunksDoneNum++;
+				if (state.chunksDoneNum == state.chunksNum)
+				{
+					state.allChunksDone.notify_all();
+				}
+			}
+		}
+	};
+}
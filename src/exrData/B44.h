@@ -0,0 +1,242 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "exrData/ChunkDecoder.h"
+#include "exrData/exrConsta.h"
+#include "types.h"
+
+// SSE2 (part of every x86-64 CPU): all 16 samples of 4x4 block are unpacked at once
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define EXRB44_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+namespace exrCompression
+{
+	/// ReadMe: B44 / B44A compression of OpenEXR
+	/*
+		source: https://openexr.com/en/latest/TechnicalIntroduction.html#data-compression , OpenEXR library (ImfB44Compressor)
+		date: 2026.10.17
+
+		Chunk (32 scanlines or 1 tile) is compressed channel by channel (ordered as in chlist), lossy for HALF channels only:
+		- UINT and FLOAT channel: all its samples (lines of the chunk, 4 bytes each) are stored as they are;
+		- HALF channel: samples are split into blocks of 4x4 pixels (row by row, blocks of right and bottom edges are padded
+			by repeating last column / line), each block is stored as:
+			14 bytes:	uint16 t[0] (big-endian), 6-bit shift, 15 x 6-bit differences r[i]:
+							t[4] = t[0] + (r[0] << shift) - bias, t[8] = t[4] + ..., t[12] = t[8] + ...		(first column, r[0] ~ r[2])
+							t[1] = t[0] + (r[3] << shift) - bias, t[5] = t[4] + ..., t[9], t[13]			(second column, r[3] ~ r[6])
+							t[2] = t[1] + ..., ... t[3] = t[2] + ...										(r[7] ~ r[10], r[11] ~ r[14])
+						where bias = 0x20 << shift, all sums are modulo 2^16; or
+			3 bytes:	uint16 t[0] (big-endian), byte 0xFC (shift field >= 13) - all 16 samples of block are t[0] (B44A only).
+			t[i] is HALF sample mapped to ordered unsigned value: t = (h & 0x8000) ? ~h : (h | 0x8000), sample = (t & 0x8000) ? (t & 0x7FFF) : ~t.
+		HALF channels with pLinear = 1 are stored as exp-like encoded values, which are not decoded here (header is rejected).
+		If compressed data is not smaller than uncompressed, chunk stores uncompressed data instead.
+	*/
+
+	/// <summary>
+	///		Decompressor of B44 and B44A chunk data. Keeps its buffers between calls, so reuse one B44Decoder per thread.
+	/// </summary>
+	class B44Decoder : public ChunkDecoder
+	{
+		public:
+		/// <summary>
+		///		Decompress (compressed) chunk data of (layout) into (out): unpack 4x4 blocks of HALF channels, then interleave lines of channels.
+		/// </summary>
+		/// <param name="rawSize"> - size of uncompressed chunk data, (out) must have room for it </param>
+		void decode(const ui8view compressed, const ChunkLayout& layout, ui8* out, const std::size_t rawSize) override
+		{
+			tryValidateLayout(layout, rawSize, "B44");
+			const std::size_t width = layout.width, height = layout.height;
+			const std::size_t channelsNum = layout.channelDataTypes.size();
+			// 1. channels: HALF - unpacked into m_halfSamples, UINT and FLOAT - used from (compressed) as they are
+			m_channelData.resize(channelsNum);
+			std::size_t halfChannelsNum = 0;
+			for (const uint32_t channelDataType : layout.channelDataTypes)
+			{
+				halfChannelsNum += (channelDataType == exr2::consta::channel::datatype::HALF) ? 1 : 0;
+			}
+			m_halfSamples.resize(halfChannelsNum * width * height);
+			std::size_t position = 0;
+			uint16_t* halfChannel = m_halfSamples.data();
+			for (std::size_t channel = 0; channel < channelsNum; channel++)
+			{
+				if (layout.channelDataTypes[channel] != exr2::consta::channel::datatype::HALF)
+				{
+					const std::size_t channelSize = 4 * width * height;
+					if (compressed.size() - position < channelSize)
+					{
+						throw std::runtime_error("B44 chunk data is truncated inside samples of channel " + std::to_string(channel) + ".");
+					}
+					m_channelData[channel] = compressed.data() + position;
+					position += channelSize;
+					continue;
+				}
+				m_channelData[channel] = reinterpret_cast<const ui8*>(halfChannel);
+				for (std::size_t blockY = 0; blockY < height; blockY += 4)
+				{
+					for (std::size_t blockX = 0; blockX < width; blockX += 4)
+					{
+						position += unpackBlock(compressed, position, channel);
+						// block samples => channel samples, cropped at right and bottom edges
+						const std::size_t blockWidth = std::min<std::size_t>(4, width - blockX);
+						const std::size_t blockHeight = std::min<std::size_t>(4, height - blockY);
+						for (std::size_t y = 0; y < blockHeight; y++)
+						{
+							std::memcpy(halfChannel + (blockY + y) * width + blockX, m_block + 4*y, blockWidth * sizeof(uint16_t));
+						}
+					}
+				}
+				halfChannel += width * height;
+			}
+			if (position != compressed.size())
+			{
+				throw std::runtime_error("B44 chunk data has " + std::to_string(compressed.size() - position) + " bytes after last block.");
+			}
+			// 2. lines of channels => lines of chunk data (samples are little-endian, as file data)
+			for (std::size_t line = 0; line < height; line++)
+			{
+				for (std::size_t channel = 0; channel < channelsNum; channel++)
+				{
+					if (layout.channelDataTypes[channel] != exr2::consta::channel::datatype::HALF)
+					{
+						std::memcpy(out, m_channelData[channel] + 4 * width * line, 4 * width);
+						out += 4 * width;
+						continue;
+					}
+					const uint16_t* samples = reinterpret_cast<const uint16_t*>(m_channelData[channel]) + width * line;
+					for (std::size_t i = 0; i < width; i++)
+					{
+						out[2*i] = ui8(samples[i]);
+						out[2*i + 1] = ui8(samples[i] >> 8);
+					}
+					out += 2 * width;
+				}
+			}
+		}
+
+		private:
+		std::vector<const ui8*> m_channelData;		// first sample of each channel: in compressed data (UINT, FLOAT) or in m_halfSamples (HALF)
+		std::vector<uint16_t> m_halfSamples;
+		uint16_t m_block[16] = {};
+
+		/// <summary>
+		///		Unpack block of (compressed) data at (position) into m_block (16 HALF samples, row by row).
+		/// </summary>
+		/// <returns> size of the block in bytes: 3 or 14 </returns>
+		std::size_t unpackBlock(const ui8view compressed, const std::size_t position, const std::size_t channel)
+		{
+			const std::size_t bytesLeft = compressed.size() - position;
+			if (bytesLeft < 3)
+			{
+				throw std::runtime_error("B44 chunk data is truncated inside block of channel " + std::to_string(channel) + ".");
+			}
+			const ui8* b = compressed.data() + position;
+			if (b[2] >= (13 << 2))
+			{
+				const uint16_t sample = orderedToHalf(uint16_t((uint32_t(b[0]) << 8) | b[1]));
+				std::fill(m_block, m_block + 16, sample);
+				return 3;
+			}
+			if (bytesLeft < 14)
+			{
+				throw std::runtime_error("B44 chunk data is truncated inside block of channel " + std::to_string(channel) + ".");
+			}
+			#if EXRB44_SSE2
+			unpack14SSE2(b);
+			#else
+			unpack14(b);
+			#endif
+			return 14;
+		}
+
+		/// <returns> HALF sample of (ordered) value of B44 block </returns>
+		static uint16_t orderedToHalf(const uint16_t ordered)
+		{
+			return (ordered & 0x8000) ? uint16_t(ordered & 0x7FFF) : uint16_t(~ordered);
+		}
+
+		/// <summary>
+		///		Unpack 14-byte block (b) into m_block, one sample after another.
+		/// </summary>
+		void unpack14(const ui8* b)
+		{
+			uint16_t* t = m_block;
+			const uint32_t shift = b[2] >> 2;
+			const uint32_t bias = 0x20u << shift;
+			// r[i] - 6-bit fields following shift, 4 per 3 bytes
+			const auto r = [b](const uint32_t i) -> uint32_t
+			{
+				const uint32_t field = i + 1;		// field 0 is shift
+				const uint32_t bits = (uint32_t(b[2 + 3*(field/4)]) << 16) | (uint32_t(b[3 + 3*(field/4)]) << 8) | uint32_t(b[4 + 3*(field/4)]);
+				return (bits >> (18 - 6*(field%4))) & 0x3F;
+			};
+			t[0] = uint16_t((uint32_t(b[0]) << 8) | b[1]);
+			for (uint32_t row = 1; row < 4; row++)
+			{
+				t[4*row] = uint16_t(t[4*(row-1)] + (r(row - 1) << shift) - bias);
+			}
+			for (uint32_t column = 1; column < 4; column++)
+			{
+				for (uint32_t row = 0; row < 4; row++)
+				{
+					t[4*row + column] = uint16_t(t[4*row + column - 1] + (r(4*column - 1 + row) << shift) - bias);
+				}
+			}
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				t[i] = orderedToHalf(t[i]);
+			}
+		}
+
+		#if EXRB44_SSE2
+		/// <summary>
+		///		Unpack 14-byte block (b) into m_block, same as unpack14(), all samples at once.
+		///		Differences are laid out by rows of block: 16-bit lane (row, column) gets difference between t[row][column] and its left
+		///		(column > 0) or upper (column = 0) neighbour, so each row is 64-bit lane and samples are prefix sums of its lanes.
+		/// </summary>
+		void unpack14SSE2(const ui8* b)
+		{
+			// 32-bit lane g = bytes 2+3g ~ 4+3g: fields (4g ~ 4g+3), field k of every lane is difference of row k
+			const __m128i groups = _mm_set_epi32(
+				int32_t((uint32_t(b[11]) << 16) | (uint32_t(b[12]) << 8) | b[13]),
+				int32_t((uint32_t(b[8]) << 16) | (uint32_t(b[9]) << 8) | b[10]),
+				int32_t((uint32_t(b[5]) << 16) | (uint32_t(b[6]) << 8) | b[7]),
+				int32_t((uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 8) | b[4]));
+			const __m128i fieldMask = _mm_set1_epi32(0x3F);
+			const __m128i row0 = _mm_and_si128(_mm_srli_epi32(groups, 18), fieldMask);
+			const __m128i row1 = _mm_and_si128(_mm_srli_epi32(groups, 12), fieldMask);
+			const __m128i row2 = _mm_and_si128(_mm_srli_epi32(groups, 6), fieldMask);
+			const __m128i row3 = _mm_and_si128(groups, fieldMask);
+			// (field << shift) - bias, 16-bit lanes: rows 0 and 1, rows 2 and 3
+			const __m128i shift = _mm_cvtsi32_si128(b[2] >> 2);
+			const __m128i bias = _mm_sll_epi16(_mm_set1_epi16(0x20), shift);
+			__m128i rows01 = _mm_sub_epi16(_mm_sll_epi16(_mm_packs_epi32(row0, row1), shift), bias);
+			__m128i rows23 = _mm_sub_epi16(_mm_sll_epi16(_mm_packs_epi32(row2, row3), shift), bias);
+			// lane (0, 0) holds shift, not difference; t[2][0] - t[1][0] goes to lane (3, 0) too, as row 3 is summed from t[1][0]
+			rows01 = _mm_and_si128(rows01, _mm_set_epi16(-1, -1, -1, -1, -1, -1, -1, 0));
+			rows23 = _mm_add_epi16(rows23, _mm_slli_si128(_mm_and_si128(rows23, _mm_set_epi16(0, 0, 0, 0, 0, 0, 0, -1)), 8));
+			// prefix sums within rows
+			rows01 = _mm_add_epi16(rows01, _mm_slli_epi64(rows01, 16));
+			rows01 = _mm_add_epi16(rows01, _mm_slli_epi64(rows01, 32));
+			rows23 = _mm_add_epi16(rows23, _mm_slli_epi64(rows23, 16));
+			rows23 = _mm_add_epi16(rows23, _mm_slli_epi64(rows23, 32));
+			rows01 = _mm_add_epi16(rows01, _mm_set1_epi16(int16_t((uint32_t(b[0]) << 8) | b[1])));
+			rows23 = _mm_add_epi16(rows23, _mm_set1_epi16(int16_t(_mm_extract_epi16(rows01, 4))));		// + t[1][0]
+			// ordered values => HALF samples: (t & 0x8000) ? (t & 0x7FFF) : ~t
+			const __m128i sign01 = _mm_srai_epi16(rows01, 15), sign23 = _mm_srai_epi16(rows23, 15);
+			const __m128i ones = _mm_set1_epi16(-1), lowBits = _mm_set1_epi16(0x7FFF);
+			const __m128i notSign01 = _mm_xor_si128(sign01, ones), notSign23 = _mm_xor_si128(sign23, ones);
+			rows01 = _mm_and_si128(_mm_xor_si128(rows01, notSign01), _mm_or_si128(notSign01, lowBits));
+			rows23 = _mm_and_si128(_mm_xor_si128(rows23, notSign23), _mm_or_si128(notSign23, lowBits));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(m_block), rows01);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(m_block + 8), rows23);
+		}
+		#endif
+	};
+}
@@ -0,0 +1,294 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "ThreadPool.h"
+#include "utils.h"
+
+// SSE2 (part of every x86-64 CPU): statistics of 4 samples per instruction
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define EXRSTATS_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+namespace exrPixeldata
+{
+	/// <summary>
+	///		Running statistics of samples of one channel: number of samples, of NaN, +Inf and -Inf samples, of negative and of denormal samples,
+	///		min, max, mean and standard deviation of finite samples.
+	///		Samples are added run by run (scanline of a chunk, line of a tile, whole channel array, etc.), partial statistics are merged with merge().
+	///		Merged in the same order, results do not depend on how samples were split between threads.
+	///		Mean and standard deviation are kept as mean and sum of squared deviations from it (M2): samples are added in blocks,
+	///		M2 of a block is summed around the block mean (second pass over the block, while it is in cache) and blocks are merged
+	///		with Chan et al. formula, so standard deviation of samples of large mean and small spread keeps its precision.
+	///		UINT samples are converted to float (exact up to 2^24).
+	/// </summary>
+	class ChannelStats
+	{
+		public:
+		ChannelStats() {}
+
+		/// <summary>
+		///		Statistics of (valuesNum) samples of (values): samples are split into blocks of fixed size, blocks are reduced
+		///		concurrently on (threadPool) workers (if it is provided) and merged in order, so result does not depend on number of threads.
+		/// </summary>
+		static ChannelStats of(const float* values, const std::size_t valuesNum, utils::ThreadPool* threadPool = nullptr)
+		{
+			const std::size_t blocksNum = (valuesNum + s_c_blockSamplesNum - 1) / s_c_blockSamplesNum;
+			std::vector<ChannelStats> blocks(blocksNum);
+			const auto blocksRange = [&](const std::size_t firstBlock, const std::size_t lastBlock)
+			{
+				for (std::size_t block = firstBlock; block < lastBlock; block++)
+				{
+					const std::size_t firstValue = block * s_c_blockSamplesNum;
+					blocks[block].add(values + firstValue, std::min(s_c_blockSamplesNum, valuesNum - firstValue));
+				}
+			};
+			if (threadPool == nullptr or blocksNum < 2)
+			{
+				blocksRange(std::size_t(0), blocksNum);
+			}
+			else
+			{
+				threadPool->parallelFor(0, blocksNum, 1, blocksRange);
+			}
+			ChannelStats stats;
+			for (const ChannelStats& block : blocks)
+			{
+				stats.merge(block);
+			}
+			return stats;
+		}
+
+		/// <summary>
+		///		Add (valuesNum) samples of (values) to the statistics.
+		/// </summary>
+		void add(const float* values, const std::size_t valuesNum)
+		{
+			for (std::size_t blockFirst = 0; blockFirst < valuesNum; blockFirst += s_c_blockSamplesNum)
+			{
+				ChannelStats block;
+				block.addBlock(values + blockFirst, std::min(s_c_blockSamplesNum, valuesNum - blockFirst));
+				merge(block);
+			}
+		}
+		/// <summary>
+		///		Add samples counted by (other) statistics.
+		/// </summary>
+		void merge(const ChannelStats& other)
+		{
+			const double finiteNumA = double(finiteNum());
+			const double finiteNumB = double(other.finiteNum());
+			m_samplesNum += other.m_samplesNum;
+			m_nanNum += other.m_nanNum;
+			m_posInfNum += other.m_posInfNum;
+			m_negInfNum += other.m_negInfNum;
+			m_negativeNum += other.m_negativeNum;
+			m_denormalNum += other.m_denormalNum;
+			m_min = std::min(m_min, other.m_min);
+			m_max = std::max(m_max, other.m_max);
+			if (finiteNumB != 0.0)
+			{
+				const double finiteNumAB = finiteNumA + finiteNumB;
+				const double delta = other.m_mean - m_mean;
+				m_mean += delta * (finiteNumB / finiteNumAB);
+				m_m2 += other.m_m2 + delta * delta * (finiteNumA * finiteNumB / finiteNumAB);
+			}
+		}
+
+		uint64_t samplesNum() const { return m_samplesNum; }
+		uint64_t nanNum() const { return m_nanNum; }
+		uint64_t posInfNum() const { return m_posInfNum; }
+		uint64_t negInfNum() const { return m_negInfNum; }
+		uint64_t infNum() const { return m_posInfNum + m_negInfNum; }
+		/// <returns> number of finite samples below zero (-0 excluded) </returns>
+		uint64_t negativeNum() const { return m_negativeNum; }
+		/// <returns> number of denormal (subnormal) samples: non-zero, smaller in magnitude than the smallest normal float </returns>
+		uint64_t denormalNum() const { return m_denormalNum; }
+		/// <returns> number of samples, which are neither NaN nor infinite </returns>
+		uint64_t finiteNum() const { return m_samplesNum - m_nanNum - infNum(); }
+		/// <returns> min of finite samples, 0 if there are none </returns>
+		float min() const { return finiteNum() == 0 ? 0.0f : m_min; }
+		/// <returns> max of finite samples, 0 if there are none </returns>
+		float max() const { return finiteNum() == 0 ? 0.0f : m_max; }
+		/// <returns> mean of finite samples, 0 if there are none </returns>
+		double mean() const { return finiteNum() == 0 ? 0.0 : m_mean; }
+		/// <returns> (population) standard deviation of finite samples, 0 if there are none </returns>
+		double stddev() const
+		{
+			if (finiteNum() == 0)
+			{
+				return 0.0;
+			}
+			return std::sqrt(m_m2 / double(finiteNum()));
+		}
+
+		/// <returns> e.g. "65536 samples, min 0.000000, max 1.000000, mean 0.500000, stddev 0.288680, 0 NaN, 0 +Inf, 0 -Inf, 0 negative, 0 denormal" </returns>
+		std::string toString(const int32_t fltPrecis = 6) const
+		{
+			return std::to_string(m_samplesNum) + " samples, min " + utils::str(min(), fltPrecis) + ", max " + utils::str(max(), fltPrecis)
+				+ ", mean " + utils::str(float(mean()), fltPrecis) + ", stddev " + utils::str(float(stddev()), fltPrecis) + ", " + std::to_string(m_nanNum) + " NaN, "
+				+ std::to_string(m_posInfNum) + " +Inf, " + std::to_string(m_negInfNum) + " -Inf, " + std::to_string(m_negativeNum) + " negative, " + std::to_string(m_denormalNum) + " denormal";
+		}
+
+		private:
+		static constexpr std::size_t s_c_blockSamplesNum = 64 * 1024;		// samples per block of add() and of(): per-block partials are merged in block order
+		uint64_t m_samplesNum = 0, m_nanNum = 0, m_posInfNum = 0, m_negInfNum = 0, m_negativeNum = 0, m_denormalNum = 0;
+		float m_min = std::numeric_limits<float>::max();
+		float m_max = std::numeric_limits<float>::lowest();
+		double m_mean = 0.0;		// mean of finite samples
+		double m_m2 = 0.0;			// sum of squared deviations of finite samples from (m_mean)
+
+		/// <summary>
+		///		Statistics of one block of (valuesNum) <= (s_c_blockSamplesNum) samples, added to empty statistics:
+		///		counts, min, max and mean in the first pass, M2 around the block mean in the second.
+		/// </summary>
+		void addBlock(const float* values, const std::size_t valuesNum)
+		{
+			#if EXRSTATS_SSE2
+			const double sum = addSSE2(values, valuesNum);
+			#else
+			const double sum = addScalar(values, valuesNum);
+			#endif
+			if (finiteNum() == 0)
+			{
+				return;
+			}
+			m_mean = sum / double(finiteNum());
+			#if EXRSTATS_SSE2
+			m_m2 = squaredDeviationsSSE2(values, valuesNum, m_mean);
+			#else
+			m_m2 = squaredDeviationsScalar(values, valuesNum, m_mean);
+			#endif
+		}
+
+		/// <returns> sum of finite samples of (values), counts, min and max are added to the statistics </returns>
+		double addScalar(const float* values, const std::size_t valuesNum)
+		{
+			double sum = 0.0;
+			for (std::size_t i = 0; i < valuesNum; i++)
+			{
+				const float value = values[i];
+				switch (std::fpclassify(value))
+				{
+					case FP_NAN:		m_nanNum++; continue;
+					case FP_INFINITE:	(value < 0.0f) ? m_negInfNum++ : m_posInfNum++; continue;
+					case FP_SUBNORMAL:	m_denormalNum++; break;
+					default:			break;
+				}
+				m_negativeNum += (value < 0.0f) ? 1 : 0;
+				m_min = std::min(m_min, value);
+				m_max = std::max(m_max, value);
+				sum += value;
+			}
+			m_samplesNum += valuesNum;
+			return sum;
+		}
+		/// <returns> sum of squared deviations of finite samples of (values) from (meanValue) </returns>
+		static double squaredDeviationsScalar(const float* values, const std::size_t valuesNum, const double meanValue)
+		{
+			double m2 = 0.0;
+			for (std::size_t i = 0; i < valuesNum; i++)
+			{
+				if (std::isfinite(values[i]))
+				{
+					const double deviation = double(values[i]) - meanValue;
+					m2 += deviation * deviation;
+				}
+			}
+			return m2;
+		}
+
+		#if EXRSTATS_SSE2
+		/// <summary>
+		///		Same as addScalar(): samples are classified by their bits (NaN, Inf, denormal), non-finite samples are masked out of
+		///		min, max and sum. Sum is accumulated in double lanes, counts in 32-bit lanes (valuesNum <= s_c_blockSamplesNum).
+		/// </summary>
+		double addSSE2(const float* values, const std::size_t valuesNum)
+		{
+			const __m128i absMask = _mm_set1_epi32(0x7FFFFFFF);
+			const __m128i infBits = _mm_set1_epi32(0x7F800000);
+			const __m128i minNormalBits = _mm_set1_epi32(0x00800000);
+			const __m128i zero = _mm_setzero_si128();
+			const __m128 maxFloat = _mm_set1_ps(std::numeric_limits<float>::max());
+			const __m128 lowestFloat = _mm_set1_ps(std::numeric_limits<float>::lowest());
+			__m128 minLanes = maxFloat, maxLanes = lowestFloat;
+			__m128d sumLanes = _mm_setzero_pd();
+			__m128i nanLanes = zero, posInfLanes = zero, negInfLanes = zero, negativeLanes = zero, denormalLanes = zero;
+			const std::size_t vectorsEnd = valuesNum - valuesNum % 4;
+			for (std::size_t i = 0; i < vectorsEnd; i += 4)
+			{
+				const __m128 v = _mm_loadu_ps(values + i);
+				const __m128i bits = _mm_castps_si128(v);
+				const __m128i absBits = _mm_and_si128(bits, absMask);
+				const __m128i isSignSet = _mm_srai_epi32(bits, 31);
+				const __m128i isNonZero = _mm_cmpgt_epi32(absBits, zero);
+				const __m128i isInf = _mm_cmpeq_epi32(absBits, infBits);
+				const __m128i isFinite = _mm_cmplt_epi32(absBits, infBits);
+				// masks are -1 per lane, so subtracting them counts
+				nanLanes = _mm_sub_epi32(nanLanes, _mm_cmpgt_epi32(absBits, infBits));
+				posInfLanes = _mm_sub_epi32(posInfLanes, _mm_andnot_si128(isSignSet, isInf));
+				negInfLanes = _mm_sub_epi32(negInfLanes, _mm_and_si128(isSignSet, isInf));
+				negativeLanes = _mm_sub_epi32(negativeLanes, _mm_and_si128(_mm_and_si128(isSignSet, isNonZero), isFinite));
+				denormalLanes = _mm_sub_epi32(denormalLanes, _mm_and_si128(isNonZero, _mm_cmplt_epi32(absBits, minNormalBits)));
+				const __m128 finiteMask = _mm_castsi128_ps(isFinite);
+				const __m128 finite = _mm_and_ps(v, finiteMask);		// non-finite samples => 0
+				minLanes = _mm_min_ps(minLanes, _mm_or_ps(finite, _mm_andnot_ps(finiteMask, maxFloat)));
+				maxLanes = _mm_max_ps(maxLanes, _mm_or_ps(finite, _mm_andnot_ps(finiteMask, lowestFloat)));
+				sumLanes = _mm_add_pd(sumLanes, _mm_add_pd(_mm_cvtps_pd(finite), _mm_cvtps_pd(_mm_movehl_ps(finite, finite))));
+			}
+			m_nanNum += sumLanes32(nanLanes);
+			m_posInfNum += sumLanes32(posInfLanes);
+			m_negInfNum += sumLanes32(negInfLanes);
+			m_negativeNum += sumLanes32(negativeLanes);
+			m_denormalNum += sumLanes32(denormalLanes);
+			float minValues[4], maxValues[4];
+			double sums[2];
+			_mm_storeu_ps(minValues, minLanes);
+			_mm_storeu_ps(maxValues, maxLanes);
+			_mm_storeu_pd(sums, sumLanes);
+			for (uint32_t lane = 0; lane < 4; lane++)
+			{
+				m_min = std::min(m_min, minValues[lane]);
+				m_max = std::max(m_max, maxValues[lane]);
+			}
+			m_samplesNum += vectorsEnd;
+			return sums[0] + sums[1] + addScalar(values + vectorsEnd, valuesNum - vectorsEnd);
+		}
+		/// <summary> Same as squaredDeviationsScalar(): squared deviations of non-finite samples are masked to 0. </summary>
+		static double squaredDeviationsSSE2(const float* values, const std::size_t valuesNum, const double meanValue)
+		{
+			const __m128i absMask = _mm_set1_epi32(0x7FFFFFFF);
+			const __m128i infBits = _mm_set1_epi32(0x7F800000);
+			const __m128d meanLanes = _mm_set1_pd(meanValue);
+			__m128d m2Lanes = _mm_setzero_pd();
+			const std::size_t vectorsEnd = valuesNum - valuesNum % 4;
+			for (std::size_t i = 0; i < vectorsEnd; i += 4)
+			{
+				const __m128 v = _mm_loadu_ps(values + i);
+				const __m128i isFinite = _mm_cmplt_epi32(_mm_and_si128(_mm_castps_si128(v), absMask), infBits);
+				const __m128d lowDeviation = _mm_sub_pd(_mm_cvtps_pd(v), meanLanes);
+				const __m128d highDeviation = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(v, v)), meanLanes);
+				// 32-bit lane masks widened to 64-bit lanes of the low and high pair of samples
+				const __m128d lowSquares = _mm_and_pd(_mm_mul_pd(lowDeviation, lowDeviation), _mm_castsi128_pd(_mm_unpacklo_epi32(isFinite, isFinite)));
+				const __m128d highSquares = _mm_and_pd(_mm_mul_pd(highDeviation, highDeviation), _mm_castsi128_pd(_mm_unpackhi_epi32(isFinite, isFinite)));
+				m2Lanes = _mm_add_pd(m2Lanes, _mm_add_pd(lowSquares, highSquares));
+			}
+			double m2[2];
+			_mm_storeu_pd(m2, m2Lanes);
+			return m2[0] + m2[1] + squaredDeviationsScalar(values + vectorsEnd, valuesNum - vectorsEnd, meanValue);
+		}
+		static uint64_t sumLanes32(const __m128i lanes)
+		{
+			uint32_t counts[4];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(counts), lanes);
+			return uint64_t(counts[0]) + counts[1] + counts[2] + counts[3];
+		}
+		#endif
+	};
+}
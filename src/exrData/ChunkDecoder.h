@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "exrData/exrConsta.h"
+#include "types.h"
+
+namespace exrCompression
+{
+	/// <summary>
+	///		Pixels of uncompressed chunk data: (height) lines of (width) pixels, each line is channel after channel (ordered as in chlist),
+	///		each channel is (width) samples of its own type. Used by codecs, which compress channels separately, by type or by name (PIZ, PXR24, B44, DWA).
+	///		Deep chunk data has no such layout (all members are empty).
+	/// </summary>
+	struct ChunkLayout
+	{
+		std::span<const std::string> channelNames;
+		std::span<const uint32_t> channelDataTypes;		// exr2::consta::channel::datatype of each channel
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+	/// <summary>
+	///		Throws runtime_error if (layout) is empty (deep chunk data) or its lines do not make exactly (rawSize) bytes.
+	/// </summary>
+	/// <param name="compressionName"> - short name of compression for error message, e.g. "PIZ" </param>
+	inline void tryValidateLayout(const ChunkLayout& layout, const std::size_t rawSize, const std::string& compressionName)
+	{
+		if (layout.channelDataTypes.empty())
+		{
+			throw std::runtime_error(compressionName + " compression is valid for scanline and tiled images only.");
+		}
+		uint64_t lineSize = 0;
+		for (const uint32_t channelDataType : layout.channelDataTypes)
+		{
+			lineSize += uint64_t(exr2::consta::channel::channelDataTypeSizeInBytes(channelDataType)) * layout.width;
+		}
+		if (lineSize * layout.height != rawSize)
+		{
+			throw std::runtime_error(compressionName + " chunk of " + std::to_string(layout.width) + " x " + std::to_string(layout.height) + " pixels has " + std::to_string(rawSize) + " bytes of uncompressed data, " + std::to_string(lineSize * layout.height) + " bytes expected.");
+		}
+	}
+
+	/// <summary>
+	///		Decompressor of chunk data of one compression method (scanline block, tile, deep pixel offset table or deep sample data).
+	///		Decoder may keep its buffers between calls, so reuse one decoder per thread (see ChunkDecoders).
+	///		Output is uncompressed chunk data, as stored by NO_COMPRESSION chunk, so parsing of decoded data does not depend on the codec.
+	/// </summary>
+	class ChunkDecoder
+	{
+		public:
+		virtual ~ChunkDecoder() {}
+		/// <summary>
+		///		Decompress (compressed) chunk data of (layout) into (out). Throws if data is invalid or does not decompress to exactly (rawSize) bytes.
+		/// </summary>
+		/// <param name="rawSize"> - size of uncompressed chunk data, (out) must have room for it </param>
+		virtual void decode(const ui8view compressed, const ChunkLayout& layout, ui8* out, const std::size_t rawSize) = 0;
+	};
+
+	/// <summary>
+	///		Last two decompression steps shared by ZIP, ZIPS and RLE (compression applies them first):
+	///		reverse predictor of (predicted) bytes (each byte is stored as byte - previous byte + 128) in place,
+	///		then reverse byte split (bytes with even index are stored in first half, bytes with odd index - in second half) into (out).
+	/// </summary>
+	inline void reversePredictorAndByteSplit(ui8* predicted, ui8* out, const std::size_t rawSize)
+	{
+		for (std::size_t i = 1; i < rawSize; i++)
+		{
+			predicted[i] = ui8(predicted[i-1] + predicted[i] - 128);
+		}
+		const ui8* evenBytes = predicted;
+		const ui8* oddBytes = predicted + (rawSize + 1) / 2;
+		const std::size_t pairsNum = rawSize / 2;
+		for (std::size_t i = 0; i < pairsNum; i++)
+		{
+			out[2*i] = evenBytes[i];
+			out[2*i + 1] = oddBytes[i];
+		}
+		if (rawSize % 2 != 0)
+		{
+			out[rawSize - 1] = evenBytes[pairsNum];
+		}
+	}
+}
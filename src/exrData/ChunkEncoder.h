@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "exrData/ChunkDecoder.h"
+#include "types.h"
+
+namespace exrCompression
+{
+	/// <summary>
+	///		Compressor of chunk data of one compression method (scanline block): reverse of ChunkDecoder.
+	///		Encoder may keep its buffers between calls, so reuse one encoder per thread (see makeChunkEncoder()).
+	///		Input is uncompressed chunk data, as stored by NO_COMPRESSION chunk.
+	/// </summary>
+	class ChunkEncoder
+	{
+		public:
+		virtual ~ChunkEncoder() {}
+		/// <summary>
+		///		Compress (raw) chunk data of (layout) into (out) (resized to compressed size).
+		///		Caller stores (raw) instead, if (out) is not smaller than (raw).
+		/// </summary>
+		virtual void encode(const ui8view raw, const ChunkLayout& layout, std::vector<ui8>& out) = 0;
+	};
+
+	/// <summary>
+	///		First two compression steps shared by ZIP, ZIPS and RLE (reversed by reversePredictorAndByteSplit()):
+	///		byte split of (raw) (bytes with even index go to first half, bytes with odd index - to second half) into (out),
+	///		then predictor in place (each byte is replaced with byte - previous byte + 128).
+	/// </summary>
+	inline void byteSplitAndPredictor(const ui8* raw, ui8* out, const std::size_t rawSize)
+	{
+		ui8* evenBytes = out;
+		ui8* oddBytes = out + (rawSize + 1) / 2;
+		const std::size_t pairsNum = rawSize / 2;
+		for (std::size_t i = 0; i < pairsNum; i++)
+		{
+			evenBytes[i] = raw[2*i];
+			oddBytes[i] = raw[2*i + 1];
+		}
+		if (rawSize % 2 != 0)
+		{
+			evenBytes[pairsNum] = raw[rawSize - 1];
+		}
+		for (std::size_t i = rawSize; 1 < i; i--)		// from the last byte, so each byte is predicted from its original previous byte
+		{
+			out[i-1] = ui8(out[i-1] - out[i-2] + 128);
+		}
+	}
+}
@@ -0,0 +1,282 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "exrData/ChannelStats.h"
+#include "exrData/DeepPixeldata.h"
+#include "exrData/exrConsta.h"
+#include "exrData/exrTypes.h"
+#include "exrData/Pixeldata.h"
+#include "exrData/TiledPixeldata.h"
+#include "exrData/Compression.h"
+#include "types.h"
+#include "utils.h"
+
+namespace exrPixeldata
+{
+	enum class ChunkKind
+	{
+		SCANLINE,
+		TILE,
+		DEEP_SCANLINE
+	};
+
+	/// <summary>
+	///		Statistics of image (or of part of multi-part file), gathered chunk by chunk.
+	/// </summary>
+	struct ImageStats
+	{
+		std::vector<ChannelStats> channels;		// ordered as in chlist
+		uint64_t pixelsNum = 0;					// pixels of chunks added (of full resolution level only, for tiled image)
+		uint64_t deepSamplesNum = 0, deepMaxSamplesPerPixel = 0, deepEmptyPixelsNum = 0;	// deep image only
+
+		explicit ImageStats(const uint32_t channelsNum = 0) : channels(channelsNum) {}
+		void merge(const ImageStats& other)
+		{
+			for (std::size_t ch = 0; ch < channels.size(); ch++)
+			{
+				channels[ch].merge(other.channels[ch]);
+			}
+			pixelsNum += other.pixelsNum;
+			deepSamplesNum += other.deepSamplesNum;
+			deepMaxSamplesPerPixel = std::max(deepMaxSamplesPerPixel, other.deepMaxSamplesPerPixel);
+			deepEmptyPixelsNum += other.deepEmptyPixelsNum;
+		}
+	};
+
+	/// <summary>
+	///		Decodes chunks of one image (part), each given as its own bytes (e.g. read from file into a buffer), into statistics
+	///		without keeping decoded pixels: samples are decoded run by run (one line of one channel) into a small buffer.
+	///		Chunks are validated as by PixelData, TiledPixelData and DeepPixelData: header, data sizes, chunk of expected offset table entry.
+	///		Byte indexes in errors of chunk headers are counted from the first byte of the chunk.
+	///		Safe to call decode() concurrently, as long as each thread passes its own Scratch.
+	/// </summary>
+	class ChunkStatsDecoder
+	{
+		public:
+		/// <summary>
+		///		Buffers of one thread, reused by all chunks it decodes.
+		/// </summary>
+		struct Scratch
+		{
+			exrCompression::ChunkDecoders decoders;
+			std::vector<ui8> rawBuffer;				// uncompressed chunk data (pixel offset table, then sample data of deep chunk)
+			std::vector<float> values;				// decoded samples of one line of one channel
+			std::vector<uint64_t> sampleCounts;		// deep chunk: number of samples of each pixel
+		};
+
+		/// <param name="kind"> - kind of chunks of the image </param>
+		/// <param name="firstRowY"> - (y) of first image row (dataWindow.yMin) </param>
+		/// <param name="compressionValue"> - compression of chunks: NO or one with decoder in exrCompression::makeChunkDecoder() </param>
+		/// <param name="grid"> - levels and tiles of tiled image (not used by scanline images) </param>
+		ChunkStatsDecoder(const ChunkKind kind, const uint32_t imageRowsNum, const uint32_t imageColumnsNum, const int32_t firstRowY, const std::vector<std::string>& channelNames, const std::vector<uint32_t>& channelDataTypes, const exr2::consta::s_compression::value compressionValue, const TileGrid& grid = TileGrid())
+			: m_kind(kind), m_rowsNum(imageRowsNum), m_columnsNum(imageColumnsNum), m_firstRowY(firstRowY), m_channelDataTypes(channelDataTypes),
+			m_compression(compressionValue), m_scanlinesPerChunk(exr2::consta::scanlinesPerChunk(compressionValue)), m_grid(grid)
+		{
+			if (channelDataTypes.empty())
+			{
+				throw std::invalid_argument("(channelDataTypes) must describe non-zero number of channels");
+			}
+			for (const uint32_t channelDataType : m_channelDataTypes)
+			{
+				m_sampleSizes.push_back(exr2::consta::channel::channelDataTypeSizeInBytes(channelDataType));
+				m_kernels.push_back(ScanlineDecoder<float>::kernelFor(channelDataType));
+				m_bytesPerSample += m_sampleSizes.back();
+			}
+			if (m_kind == ChunkKind::SCANLINE)
+			{
+				m_decoder = std::make_shared<const ScanlineDecoder<float>>(ScanlineLayout(channelNames, channelDataTypes, imageColumnsNum));
+			}
+			if (m_kind == ChunkKind::TILE)
+			{
+				for (const TileGrid::Level& lvl : m_grid.levels())
+				{
+					for (const uint32_t width : { m_grid.tileWidth(lvl, 0), m_grid.tileWidth(lvl, lvl.tilesX - 1) })
+					{
+						if (m_lineDecoders.find(width) == m_lineDecoders.end())
+						{
+							m_lineDecoders[width] = std::make_shared<const ScanlineDecoder<float>>(ScanlineLayout(channelNames, channelDataTypes, width));
+						}
+					}
+				}
+			}
+		}
+
+		/// <returns> size of header of chunk of (kind) in bytes: fields before chunk data (part number of multi-part file excluded) </returns>
+		static uint32_t headerSizeInBytes(const ChunkKind kind)
+		{
+			switch (kind)
+			{
+				case ChunkKind::SCANLINE:		return 2 * sizeof(int32_t);						// y, data size
+				case ChunkKind::TILE:			return 5 * sizeof(int32_t);						// tileX, tileY, levelX, levelY, data size
+				case ChunkKind::DEEP_SCANLINE:	return sizeof(int32_t) + 3 * sizeof(uint64_t);	// y, packed offset table size, packed and unpacked sample data sizes
+			}
+			return 0;
+		}
+		/// <param name="header"> - first headerSizeInBytes(kind) bytes of chunk </param>
+		/// <returns> size of chunk of (kind) in bytes (part number of multi-part file excluded), as given by its header </returns>
+		static uint64_t sizeInBytes(const ChunkKind kind, const ui8* header)
+		{
+			switch (kind)
+			{
+				case ChunkKind::SCANLINE:		return headerSizeInBytes(kind) + uint64_t(exrTypes::readUint32(header + sizeof(int32_t)));
+				case ChunkKind::TILE:			return headerSizeInBytes(kind) + uint64_t(exrTypes::readUint32(header + 4 * sizeof(int32_t)));
+				case ChunkKind::DEEP_SCANLINE:
+				{
+					const uint64_t packedOffsetTableSize = exrTypes::readUint64(header + sizeof(int32_t));
+					const uint64_t packedSampleDataSize = exrTypes::readUint64(header + sizeof(int32_t) + sizeof(uint64_t));
+					if (UINT64_MAX - headerSizeInBytes(kind) - packedOffsetTableSize < packedSampleDataSize or UINT64_MAX - headerSizeInBytes(kind) < packedOffsetTableSize)
+					{
+						return UINT64_MAX;
+					}
+					return headerSizeInBytes(kind) + packedOffsetTableSize + packedSampleDataSize;
+				}
+			}
+			return 0;
+		}
+
+		/// <summary>
+		///		Validate and decode chunk of (tableEntryIndex) offset table entry and add its samples to (stats).
+		///		Samples of tiles of lower resolution levels are validated, but not added.
+		///		Throws if chunk is not valid or if it needs more than (memoryLimitBytes) of memory (chunk bytes + uncompressed data).
+		/// </summary>
+		/// <param name="chunkBytes"> - bytes of the chunk, starting with its header (part number of multi-part file excluded) </param>
+		/// <param name="chunkOffset"> - index of first byte of the chunk within file (offset table value), used in error messages </param>
+		void decode(const ui8view chunkBytes, const uint32_t tableEntryIndex, const uint64_t chunkOffset, Scratch& scratch, ImageStats& stats, const uint64_t memoryLimitBytes) const
+		{
+			switch (m_kind)
+			{
+				case ChunkKind::SCANLINE:		decodeScanlineChunk(chunkBytes, tableEntryIndex, chunkOffset, scratch, stats, memoryLimitBytes); break;
+				case ChunkKind::TILE:			decodeTileChunk(chunkBytes, tableEntryIndex, chunkOffset, scratch, stats, memoryLimitBytes); break;
+				case ChunkKind::DEEP_SCANLINE:	decodeDeepScanlineChunk(chunkBytes, tableEntryIndex, chunkOffset, scratch, stats, memoryLimitBytes); break;
+			}
+		}
+		ChunkKind kind() const { return m_kind; }
+		uint32_t channelsNum() const { return uint32_t(m_channelDataTypes.size()); }
+
+		private:
+		ChunkKind m_kind = ChunkKind::SCANLINE;
+		uint32_t m_rowsNum = 0, m_columnsNum = 0;
+		int32_t m_firstRowY = 0;
+		std::vector<uint32_t> m_channelDataTypes;
+		std::vector<uint32_t> m_sampleSizes;
+		std::vector<typename ScanlineDecoder<float>::ChannelRunKernel> m_kernels;
+		uint32_t m_bytesPerSample = 0;
+		exr2::consta::s_compression::value m_compression = exr2::consta::s_compression::value::NO;
+		uint32_t m_scanlinesPerChunk = 1;
+		std::shared_ptr<const ScanlineDecoder<float>> m_decoder = nullptr;		// scanline image
+		TileGrid m_grid;														// tiled image
+		TileLineDecoders<float> m_lineDecoders;									// tiled image
+
+		void decodeScanlineChunk(const ui8view chunkBytes, const uint32_t tableEntryIndex, const uint64_t chunkOffset, Scratch& scratch, ImageStats& stats, const uint64_t memoryLimitBytes) const
+		{
+			const ScanlineChunk<float> chunk(chunkBytes, 0, m_decoder, m_scanlinesPerChunk, m_rowsNum, m_firstRowY);
+			tryValidateFirstRow(chunk.firstRow(), chunk._y(), tableEntryIndex, chunkOffset);
+			tryValidateMemory(chunkBytes.size() + uint64_t(chunk.rawSizeInBytes()) + uint64_t(m_columnsNum) * sizeof(float), chunkOffset, memoryLimitBytes);
+			const ui8* raw = chunk.decodeData(chunkBytes, m_compression, scratch.decoders, scratch.rawBuffer);
+			scratch.values.resize(m_columnsNum);
+			for (uint32_t line = 0; line < chunk.scanlinesNum(); line++)
+			{
+				const ui8* scanline = raw + std::size_t(line) * m_decoder->layout().sizeInBytes();
+				for (uint32_t ch = 0; ch < channelsNum(); ch++)
+				{
+					m_decoder->decodeChannelRun(ch, scanline, scratch.values.data());
+					stats.channels[ch].add(scratch.values.data(), m_columnsNum);
+				}
+			}
+			stats.pixelsNum += uint64_t(chunk.scanlinesNum()) * m_columnsNum;
+		}
+		void decodeTileChunk(const ui8view chunkBytes, const uint32_t tableEntryIndex, const uint64_t chunkOffset, Scratch& scratch, ImageStats& stats, const uint64_t memoryLimitBytes) const
+		{
+			const TileChunk<float> chunk(chunkBytes, 0, m_grid, m_lineDecoders);
+			const TileGrid::TileCoords expected = m_grid.tileCoords(tableEntryIndex);
+			const TileGrid::TileCoords& actual = chunk.coords();
+			if (actual.tileX != expected.tileX or actual.tileY != expected.tileY or actual.levelX != expected.levelX or actual.levelY != expected.levelY)
+			{
+				throw std::runtime_error
+				(
+					"offset table entry " + std::to_string(tableEntryIndex) + " must point to tile (" + std::to_string(expected.tileX) + ", " + std::to_string(expected.tileY) + ") of level (" + std::to_string(expected.levelX) + ", " + std::to_string(expected.levelY) + "), "
+					"but tile at 0x" + utils::hex64(chunkOffset) + " is (" + std::to_string(actual.tileX) + ", " + std::to_string(actual.tileY) + ") of level (" + std::to_string(actual.levelX) + ", " + std::to_string(actual.levelY) + ")."
+				);
+			}
+			tryValidateMemory(chunkBytes.size() + uint64_t(chunk.rawSizeInBytes()) + uint64_t(chunk.width()) * sizeof(float), chunkOffset, memoryLimitBytes);
+			const ui8* raw = chunk.decodeData(chunkBytes, m_compression, scratch.decoders, scratch.rawBuffer);
+			if (actual.levelX != 0 or actual.levelY != 0)
+			{
+				return;
+			}
+			const std::shared_ptr<const ScanlineDecoder<float>>& lineDecoder = m_lineDecoders.at(chunk.width());
+			scratch.values.resize(chunk.width());
+			for (uint32_t line = 0; line < chunk.height(); line++)
+			{
+				const ui8* tileLine = raw + std::size_t(line) * lineDecoder->layout().sizeInBytes();
+				for (uint32_t ch = 0; ch < channelsNum(); ch++)
+				{
+					lineDecoder->decodeChannelRun(ch, tileLine, scratch.values.data());
+					stats.channels[ch].add(scratch.values.data(), chunk.width());
+				}
+			}
+			stats.pixelsNum += uint64_t(chunk.height()) * chunk.width();
+		}
+		void decodeDeepScanlineChunk(const ui8view chunkBytes, const uint32_t tableEntryIndex, const uint64_t chunkOffset, Scratch& scratch, ImageStats& stats, const uint64_t memoryLimitBytes) const
+		{
+			const DeepScanlineChunk chunk(chunkBytes, 0, m_scanlinesPerChunk, m_rowsNum, m_columnsNum, m_firstRowY);
+			tryValidateFirstRow(chunk.firstRow(), chunk._y(), tableEntryIndex, chunkOffset);
+			const uint64_t pixelsNum = uint64_t(chunk.scanlinesNum()) * m_columnsNum;
+			tryValidateMemory(chunkBytes.size() + uint64_t(chunk.rawOffsetTableSizeInBytes()) + chunk._unpackedSampleDataSizeInBytes() + pixelsNum * sizeof(uint64_t), chunkOffset, memoryLimitBytes);
+			scratch.sampleCounts.resize(std::size_t(pixelsNum));
+			const uint64_t chunkSamplesNum = chunk.decodeSampleCounts(chunkBytes, m_compression, scratch.decoders, scratch.rawBuffer, scratch.sampleCounts.data());
+			if (chunk._unpackedSampleDataSizeInBytes() != chunkSamplesNum * m_bytesPerSample)
+			{
+				throw std::runtime_error("unpacked sample data size of deep chunk at 0x" + utils::hex64(chunkOffset) + " is " + std::to_string(chunk._unpackedSampleDataSizeInBytes()) + " bytes, pixel offset table gives " + std::to_string(chunkSamplesNum) + " samples of " + std::to_string(m_bytesPerSample) + " bytes.");
+			}
+			for (const uint64_t count : scratch.sampleCounts)
+			{
+				stats.deepMaxSamplesPerPixel = std::max(stats.deepMaxSamplesPerPixel, count);
+				stats.deepEmptyPixelsNum += (count == 0) ? 1 : 0;
+			}
+			stats.deepSamplesNum += chunkSamplesNum;
+			stats.pixelsNum += pixelsNum;
+			if (chunkSamplesNum == 0)
+			{
+				return;
+			}
+			const ui8* raw = chunk.decodeSampleData(chunkBytes, m_compression, scratch.decoders, scratch.rawBuffer);
+			for (uint32_t line = 0; line < chunk.scanlinesNum(); line++)
+			{
+				uint64_t lineSamplesNum = 0;
+				for (uint32_t col = 0; col < m_columnsNum; col++)
+				{
+					lineSamplesNum += scratch.sampleCounts[std::size_t(line) * m_columnsNum + col];
+				}
+				scratch.values.resize(std::max<std::size_t>(scratch.values.size(), std::size_t(lineSamplesNum)));
+				for (uint32_t ch = 0; ch < channelsNum(); ch++)
+				{
+					m_kernels[ch](raw, scratch.values.data(), uint32_t(lineSamplesNum));
+					stats.channels[ch].add(scratch.values.data(), std::size_t(lineSamplesNum));
+					raw += std::size_t(lineSamplesNum) * m_sampleSizes[ch];
+				}
+			}
+		}
+
+		void tryValidateFirstRow(const uint32_t chunkFirstRow, const int32_t chunkY, const uint32_t tableEntryIndex, const uint64_t chunkOffset) const
+		{
+			if (chunkFirstRow != uint64_t(tableEntryIndex) * m_scanlinesPerChunk)
+			{
+				throw std::runtime_error("(y) row value of chunk at offset 0x" + utils::hex64(chunkOffset) + " is " + std::to_string(chunkY) + ", offset table entry is expected to point to chunk of row " + std::to_string(int64_t(m_firstRowY) + int64_t(tableEntryIndex) * m_scanlinesPerChunk) + ". Offset table or chunk is corrupted.");
+			}
+		}
+		static void tryValidateMemory(const uint64_t requiredBytes, const uint64_t chunkOffset, const uint64_t memoryLimitBytes)
+		{
+			if (memoryLimitBytes < requiredBytes)
+			{
+				throw std::runtime_error("chunk at 0x" + utils::hex64(chunkOffset) + " needs " + std::to_string(requiredBytes) + " bytes of memory to be decoded, more than memory limit of one thread (" + std::to_string(memoryLimitBytes) + " bytes).");
+			}
+		}
+	};
+}
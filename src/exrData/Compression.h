@@ -0,0 +1,142 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "exrData/B44.h"
+#include "exrData/ChunkDecoder.h"
+#include "exrData/ChunkEncoder.h"
+#include "exrData/Dwa.h"
+#include "exrData/exrConsta.h"
+#include "exrData/Piz.h"
+#include "exrData/Pxr24.h"
+#include "exrData/Rle.h"
+#include "exrData/Zip.h"
+
+namespace exrCompression
+{
+	/// <summary>
+	///		Registry of chunk decoders, keyed by compression: new decoder of (compressionValue) chunks, nullptr if compression is not supported.
+	///		NO_COMPRESSION has no decoder, its chunk data is used as it is. To support a compression, add its decoder here.
+	/// </summary>
+	inline std::unique_ptr<ChunkDecoder> makeChunkDecoder(const exr2::consta::s_compression::value compressionValue)
+	{
+		switch (compressionValue)
+		{
+			case exr2::consta::s_compression::value::RLE:	return std::make_unique<RleDecoder>();
+			case exr2::consta::s_compression::value::ZIPS:
+			case exr2::consta::s_compression::value::ZIP:	return std::make_unique<ZipDecoder>();
+			case exr2::consta::s_compression::value::PIZ:	return std::make_unique<PizDecoder>();
+			case exr2::consta::s_compression::value::PXR24:	return std::make_unique<Pxr24Decoder>();
+			case exr2::consta::s_compression::value::B44:
+			case exr2::consta::s_compression::value::B44A:	return std::make_unique<B44Decoder>();
+			case exr2::consta::s_compression::value::DWAA:
+			case exr2::consta::s_compression::value::DWAB:	return std::make_unique<DwaDecoder>();
+			default:										return nullptr;
+		}
+	}
+	/// <returns> true if chunks of (compressionValue) can be decoded: NO_COMPRESSION or compression with decoder in makeChunkDecoder() </returns>
+	inline bool isSupported(const exr2::consta::s_compression::value compressionValue)
+	{
+		return compressionValue == exr2::consta::s_compression::value::NO or makeChunkDecoder(compressionValue) != nullptr;
+	}
+	/// <returns> short names of supported compressions, e.g. "NO, RLE, ZIPS, ZIP, PIZ, PXR24, B44, B44A, DWAA, DWAB" </returns>
+	inline std::string supportedNames()
+	{
+		std::string names;
+		for (uint8_t value = exr2::consta::s_compression::value::NO; value <= exr2::consta::s_compression::value::DWAB; value++)
+		{
+			if (isSupported(exr2::consta::s_compression::value(value)))
+			{
+				const std::string name = exr2::consta::compressionName(value);
+				names += (names.empty() ? "" : ", ") + name.substr(0, name.find("_COMPRESSION"));
+			}
+		}
+		return names;
+	}
+
+	/// <summary>
+	///		Registry of chunk encoders, keyed by compression: new encoder of (compressionValue) chunks, nullptr if compression cannot be written.
+	///		NO_COMPRESSION has no encoder, its chunk data is stored as it is. To write a compression, add its encoder here.
+	/// </summary>
+	inline std::unique_ptr<ChunkEncoder> makeChunkEncoder(const exr2::consta::s_compression::value compressionValue)
+	{
+		switch (compressionValue)
+		{
+			case exr2::consta::s_compression::value::RLE:	return std::make_unique<RleEncoder>();
+			case exr2::consta::s_compression::value::ZIPS:
+			case exr2::consta::s_compression::value::ZIP:	return std::make_unique<ZipEncoder>();
+			case exr2::consta::s_compression::value::DWAA:
+			case exr2::consta::s_compression::value::DWAB:	return std::make_unique<DwaEncoder>();
+			default:										return nullptr;
+		}
+	}
+	/// <returns> true if chunks of (compressionValue) can be encoded: NO_COMPRESSION or compression with encoder in makeChunkEncoder() </returns>
+	inline bool isEncodingSupported(const exr2::consta::s_compression::value compressionValue)
+	{
+		return compressionValue == exr2::consta::s_compression::value::NO or makeChunkEncoder(compressionValue) != nullptr;
+	}
+	/// <returns> short names of compressions which can be encoded, e.g. "NO, RLE, ZIPS, ZIP, DWAA, DWAB" </returns>
+	inline std::string encodingSupportedNames()
+	{
+		std::string names;
+		for (uint8_t value = exr2::consta::s_compression::value::NO; value <= exr2::consta::s_compression::value::DWAB; value++)
+		{
+			if (isEncodingSupported(exr2::consta::s_compression::value(value)))
+			{
+				const std::string name = exr2::consta::compressionName(value);
+				names += (names.empty() ? "" : ", ") + name.substr(0, name.find("_COMPRESSION"));
+			}
+		}
+		return names;
+	}
+	/// <returns> compression of short (e.g. "ZIP") or full (e.g. "ZIP_COMPRESSION") name (case-insensitive). Throws invalid_argument if name is unknown. </returns>
+	inline exr2::consta::s_compression::value compressionFromName(const std::string& name)
+	{
+		std::string upperName = name;
+		std::transform(upperName.begin(), upperName.end(), upperName.begin(), [](const unsigned char c) { return char(std::toupper(c)); });
+		for (uint8_t value = exr2::consta::s_compression::value::NO; value <= exr2::consta::s_compression::value::DWAB; value++)
+		{
+			const std::string fullName = exr2::consta::compressionName(value);
+			if (upperName == fullName or upperName == fullName.substr(0, fullName.find("_COMPRESSION")))
+			{
+				return exr2::consta::s_compression::value(value);
+			}
+		}
+		throw std::invalid_argument("compression '" + name + "' is unknown (NO, RLE, ZIPS, ZIP, PIZ, PXR24, B44, B44A, DWAA or DWAB expected).");
+	}
+
+	/// <summary>
+	///		Decoders of one thread, one per compression, created on first use and reused by all chunks the thread decodes.
+	/// </summary>
+	class ChunkDecoders
+	{
+		public:
+		/// <returns> decoder of (compressionValue) chunks. Throws logic_error if compression is not supported. </returns>
+		ChunkDecoder& decoder(const exr2::consta::s_compression::value compressionValue)
+		{
+			if (s_c_compressionsNum <= std::size_t(compressionValue))
+			{
+				throw std::logic_error("compression " + std::to_string(uint32_t(compressionValue)) + " is not valid.");
+			}
+			std::unique_ptr<ChunkDecoder>& decoder = m_decoders[compressionValue];
+			if (decoder == nullptr)
+			{
+				decoder = makeChunkDecoder(compressionValue);
+				if (decoder == nullptr)
+				{
+					throw std::logic_error(exr2::consta::compressionName(compressionValue) + " decompression is not supported.");
+				}
+			}
+			return *decoder;
+		}
+
+		private:
+		static const std::size_t s_c_compressionsNum = std::size_t(exr2::consta::s_compression::value::DWAB) + 1;
+		std::array<std::unique_ptr<ChunkDecoder>, s_c_compressionsNum> m_decoders;
+	};
+}
@@ -0,0 +1,434 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "exrData/exrConsta.h"
+#include "exrData/exrTypes.h"
+#include "exrData/ImageBuffer.h"
+#include "exrData/Pixeldata.h"
+#include "exrData/Compression.h"
+#include "ThreadPool.h"
+#include "types.h"
+#include "utils.h"
+
+namespace exrPixeldata
+{
+	/*
+		source: https://openexr.com/en/latest/OpenEXRFileLayout.html#deep-data
+
+		Deep image pixel has any number of samples (0 or more), each sample has a value of each channel.
+		Deep scanline chunk stores (scanlinesPerChunk) scanlines, same as chunk of flat scanline image:
+		y								int32
+		packed pixel offset table size	uint64
+		packed sample data size			uint64
+		unpacked sample data size		uint64
+		pixel offset table				(packed size bytes) - int32 per pixel of each scanline: number of samples of the pixel
+										and of all previous pixels of the scanline (cumulative, starts from 0 for each scanline)
+		sample data						(packed size bytes) - scanline after scanline, channel after channel (ordered as in chlist),
+										samples of each pixel of the scanline, pixel after pixel
+		Pixel offset table and sample data are compressed separately, each is stored uncompressed if compression does not make it smaller.
+	*/
+
+	// stores exrFile.pixelData deep scanline chunk header (y, sizes of its parts) and location of its pixel offset table and sample data within filebytes.
+	class DeepScanlineChunk
+	{
+		public:
+		DeepScanlineChunk() {}
+		/// <param name="filebytes"> - view of bytes of full input .exr file </param>
+		/// <param name="chunkFirstByteIndex"> - index of first byte of chunk (first byte of its y) within filebytes (offset table value) </param>
+		/// <param name="scanlinesPerChunk"> - max number of scanlines in chunk, depends on compression </param>
+		/// <param name="imageRowsNum"> - number of image rows, limits number of scanlines in last chunk </param>
+		/// <param name="imageColumnsNum"> - number of pixels in each scanline </param>
+		/// <param name="firstRowY"> - (y) of first image row (dataWindow.yMin), chunk (y) values are counted from it </param>
+		DeepScanlineChunk(const ui8view filebytes, const uint64_t chunkFirstByteIndex, const uint32_t scanlinesPerChunk, const uint32_t imageRowsNum, const uint32_t imageColumnsNum, const int32_t firstRowY = 0)
+			: m_firstByteIndex(chunkFirstByteIndex), m_columnsNum(imageColumnsNum)
+		{
+			if (filebytes.size() < m_firstByteIndex + s_c_headerSizeInBytes)
+			{
+				throw std::runtime_error("deep chunk at 0x" + utils::hex64(m_firstByteIndex) + " is out of file bytes range. File is truncated or is not a valid .exr file.");
+			}
+			const ui8* header = filebytes.data() + m_firstByteIndex;
+			m_y = int32_t(exrTypes::readUint32(header));
+			m_packedOffsetTableSize = exrTypes::readUint64(header + 4);
+			m_packedSampleDataSize = exrTypes::readUint64(header + 12);
+			m_unpackedSampleDataSize = exrTypes::readUint64(header + 20);
+			const int64_t firstRow = int64_t(m_y) - firstRowY;
+			if (firstRow < 0 or int64_t(imageRowsNum) <= firstRow or firstRow % scanlinesPerChunk != 0)
+			{
+				throw std::runtime_error("(y) value of deep chunk at 0x" + utils::hex64(m_firstByteIndex) + " is " + std::to_string(m_y) + ", first row of chunk (" + std::to_string(firstRowY) + " + multiple of " + std::to_string(scanlinesPerChunk) + " in range [" + std::to_string(firstRowY) + "; " + std::to_string(int64_t(firstRowY) + imageRowsNum) + ")) is expected.");
+			}
+			m_firstRow = uint32_t(firstRow);
+			m_scanlinesNum = std::min(scanlinesPerChunk, imageRowsNum - m_firstRow);
+			if (UINT32_MAX / sizeof(int32_t) / m_scanlinesNum < m_columnsNum or UINT32_MAX < m_unpackedSampleDataSize)
+			{
+				throw std::runtime_error("uncompressed pixel offset table or sample data of deep chunk at 0x" + utils::hex64(m_firstByteIndex) + " is larger than 4 GB.");
+			}
+			const uint64_t dataFirstByteIndex = m_firstByteIndex + s_c_headerSizeInBytes;
+			if (filebytes.size() - dataFirstByteIndex < m_packedOffsetTableSize or filebytes.size() - dataFirstByteIndex - m_packedOffsetTableSize < m_packedSampleDataSize)
+			{
+				throw std::runtime_error("pixel offset table (" + std::to_string(m_packedOffsetTableSize) + " bytes) and sample data (" + std::to_string(m_packedSampleDataSize) + " bytes) of deep chunk at 0x" + utils::hex64(m_firstByteIndex) + " are out of file bytes range. File is truncated or is not a valid .exr file.");
+			}
+			if (rawOffsetTableSizeInBytes() < m_packedOffsetTableSize or m_unpackedSampleDataSize < m_packedSampleDataSize or m_packedOffsetTableSize == 0 or (m_packedSampleDataSize == 0) != (m_unpackedSampleDataSize == 0))
+			{
+				throw std::runtime_error("deep chunk at 0x" + utils::hex64(m_firstByteIndex) + " has invalid sizes: pixel offset table " + std::to_string(m_packedOffsetTableSize) + " of " + std::to_string(rawOffsetTableSizeInBytes()) + " bytes, sample data " + std::to_string(m_packedSampleDataSize) + " of " + std::to_string(m_unpackedSampleDataSize) + " bytes.");
+			}
+		}
+
+		/// <summary>
+		///		Decode pixel offset table into number of samples of each pixel of the chunk, scanline after scanline.
+		/// </summary>
+		/// <param name="sampleCounts"> - (scanlinesNum() x columns) values: number of samples of each pixel </param>
+		/// <returns> number of samples of all pixels of the chunk </returns>
+		uint64_t decodeSampleCounts(const ui8view filebytes, const exr2::consta::s_compression::value compressionValue, exrCompression::ChunkDecoders& decoders, std::vector<ui8>& rawBuffer, uint64_t* sampleCounts) const
+		{
+			const ui8* raw = decompressChunkData(filebytes.subspan(offsetTableFirstByteIndex(), std::size_t(m_packedOffsetTableSize)), rawOffsetTableSizeInBytes(), exrCompression::ChunkLayout(), compressionValue, decoders, rawBuffer);
+			uint64_t samplesNum = 0;
+			for (uint32_t line = 0; line < m_scanlinesNum; line++)
+			{
+				int32_t previous = 0;
+				for (uint32_t col = 0; col < m_columnsNum; col++)
+				{
+					const int32_t cumulative = int32_t(exrTypes::readUint32(raw + (std::size_t(line) * m_columnsNum + col) * sizeof(int32_t)));
+					if (cumulative < previous)
+					{
+						throw std::runtime_error("pixel offset table of deep chunk at 0x" + utils::hex64(m_firstByteIndex) + " is not increasing at pixel [" + std::to_string(m_firstRow + line) + ", " + std::to_string(col) + "] (" + std::to_string(previous) + " -> " + std::to_string(cumulative) + ").");
+					}
+					sampleCounts[std::size_t(line) * m_columnsNum + col] = uint64_t(cumulative - previous);
+					previous = cumulative;
+				}
+				samplesNum += uint64_t(previous);
+			}
+			return samplesNum;
+		}
+		/// <summary>
+		///		Get uncompressed sample data: decompress it into (rawBuffer) or, if chunk stores it uncompressed, point to filebytes.
+		/// </summary>
+		/// <returns> pointer to first byte of uncompressed sample data (unpackedSampleDataSizeInBytes() bytes) </returns>
+		const ui8* decodeSampleData(const ui8view filebytes, const exr2::consta::s_compression::value compressionValue, exrCompression::ChunkDecoders& decoders, std::vector<ui8>& rawBuffer) const
+		{
+			return decompressChunkData(filebytes.subspan(sampleDataFirstByteIndex(), std::size_t(m_packedSampleDataSize)), uint32_t(m_unpackedSampleDataSize), exrCompression::ChunkLayout(), compressionValue, decoders, rawBuffer);
+		}
+
+		int32_t _y() const { return m_y; }
+		/// <returns> image row of first scanline of chunk: (y) - dataWindow.yMin </returns>
+		uint32_t firstRow() const { return m_firstRow; }
+		uint64_t _packedOffsetTableSizeInBytes() const { return m_packedOffsetTableSize; }
+		uint64_t _packedSampleDataSizeInBytes() const { return m_packedSampleDataSize; }
+		uint64_t _unpackedSampleDataSizeInBytes() const { return m_unpackedSampleDataSize; }
+		uint32_t rawOffsetTableSizeInBytes() const { return m_scanlinesNum * m_columnsNum * uint32_t(sizeof(int32_t)); }
+		bool isOffsetTableCompressed() const { return m_packedOffsetTableSize < rawOffsetTableSizeInBytes(); }
+		bool isSampleDataCompressed() const { return m_packedSampleDataSize < m_unpackedSampleDataSize; }
+		uint32_t scanlinesNum() const { return m_scanlinesNum; }
+		uint64_t firstByteIndex() const { return m_firstByteIndex; }
+		uint64_t lastByteIndex() const { return sampleDataFirstByteIndex() + m_packedSampleDataSize - 1; }
+		/// <returns> index of first byte of (fieldIndex) header field: 0 = y, 1 = packed offset table size, 2 = packed sample data size, 3 = unpacked sample data size </returns>
+		uint64_t headerFieldFirstByteIndex(const uint32_t fieldIndex) const { return m_firstByteIndex + (fieldIndex == 0 ? 0 : sizeof(int32_t) + (fieldIndex - 1) * sizeof(uint64_t)); }
+		uint64_t offsetTableFirstByteIndex() const { return m_firstByteIndex + s_c_headerSizeInBytes; }
+		uint64_t sampleDataFirstByteIndex() const { return offsetTableFirstByteIndex() + m_packedOffsetTableSize; }
+
+		private:
+		static const uint32_t s_c_headerSizeInBytes = sizeof(int32_t) + 3 * sizeof(uint64_t);		// y, packed offset table size, packed and unpacked sample data sizes
+		uint64_t m_firstByteIndex = 0;
+		int32_t m_y = 0;
+		uint32_t m_firstRow = 0;
+		uint64_t m_packedOffsetTableSize = 0, m_packedSampleDataSize = 0, m_unpackedSampleDataSize = 0;
+		uint32_t m_scanlinesNum = 0, m_columnsNum = 0;
+	};
+
+	/// <summary>
+	///		Decoded deep scanline image, stored flat (no per-pixel containers):
+	///			sample offsets - prefix sums of sample counts of pixels, row by row: samples of pixel i are [offset(i); offset(i+1)),
+	///			sample arrays  - one contiguous, aligned array of all samples per channel (ordered as in chlist), pixel after pixel.
+	///		So, memory use is 8 bytes per pixel + (channels x sample size) per sample, and samples of a scanline of a channel are contiguous.
+	///		Chunks are decoded in two passes: pixel offset tables (to size the arrays), then sample data (straight into the arrays).
+	/// </summary>
+	template <Unsigned32OrFloat channelCType32>
+	class DeepPixelData
+	{
+		public:
+		/// <param name="chunkOffsets"> - offset table values: index of first byte of each chunk within filebytes, ordered by image row (y) </param>
+		/// <param name="compressionValue"> - compression of chunks: NO or one with decoder in exrCompression::makeChunkDecoder() </param>
+		/// <param name="threadPool"> - workers to decode chunks on, nullptr = decode on calling thread </param>
+		/// <param name="firstRowY"> - (y) of first image row (dataWindow.yMin): chunk of (y) starts at image row (y - firstRowY) </param>
+		DeepPixelData(const ui8view filebytes, const std::vector<uint64_t>& chunkOffsets, const uint32_t imageRowsNum, const uint32_t imageColumnsNum, const std::vector<std::string>& channelNames, const std::vector<uint32_t>& channelDataTypes, const exr2::consta::s_compression::value compressionValue, utils::ThreadPool* threadPool, const int32_t firstRowY = 0)
+			: m_rowsNum(imageRowsNum), m_columnsNum(imageColumnsNum), m_channelNames(channelNames), m_channelDataTypes(channelDataTypes),
+			m_compression(compressionValue), m_scanlinesPerChunk(exr2::consta::scanlinesPerChunk(compressionValue))
+		{
+			if (channelNames.size() != channelDataTypes.size() or channelNames.empty())
+			{
+				throw std::invalid_argument("(channelNames) and (channelDataTypes) must describe the same, non-zero number of channels");
+			}
+			const uint32_t chunksNum = (m_rowsNum + m_scanlinesPerChunk - 1) / m_scanlinesPerChunk;
+			if (chunkOffsets.size() != chunksNum or chunksNum == 0)
+			{
+				throw std::runtime_error("number of offset table entries (" + std::to_string(chunkOffsets.size()) + ") is different from number of image chunks (" + std::to_string(chunksNum) + ").");
+			}
+			for (const uint32_t channelDataType : m_channelDataTypes)
+			{
+				m_sampleSizes.push_back(exr2::consta::channel::channelDataTypeSizeInBytes(channelDataType));
+				m_kernels.push_back(ScanlineDecoder<channelCType32>::kernelFor(channelDataType));
+				m_bytesPerSample += m_sampleSizes.back();
+			}
+
+			// pass 1: pixel offset tables => sample count of each pixel, stored at (pixel index + 1) and summed up below
+			m_sampleOffsets.assign(std::size_t(m_rowsNum) * m_columnsNum + 1, 0);
+			m_chunks.resize(chunksNum);
+			forEachChunkRange(threadPool, [&](const std::size_t firstChunk, const std::size_t lastChunk)
+			{
+				exrCompression::ChunkDecoders decoders;
+				std::vector<ui8> rawBuffer;
+				for (std::size_t chunkIndex = firstChunk; chunkIndex < lastChunk; chunkIndex++)
+				{
+					if (filebytes.size() <= chunkOffsets[chunkIndex])
+					{
+						throw std::runtime_error("offset table value 0x" + utils::hex64(chunkOffsets[chunkIndex]) + " is out of file bytes range. File is truncated or is not a valid .exr file.");
+					}
+					DeepScanlineChunk& chunk = m_chunks[chunkIndex];
+					chunk = DeepScanlineChunk(filebytes, chunkOffsets[chunkIndex], m_scanlinesPerChunk, m_rowsNum, m_columnsNum, firstRowY);
+					if (chunk.firstRow() != chunkIndex * m_scanlinesPerChunk)
+					{
+						throw std::runtime_error("(y) row value of deep chunk at offset 0x" + utils::hex64(chunkOffsets[chunkIndex]) + " is " + std::to_string(chunk._y()) + ", offset table entry is expected to point to chunk of row " + std::to_string(int64_t(firstRowY) + chunkIndex * m_scanlinesPerChunk) + ". Offset table or chunk is corrupted.");
+					}
+					const uint64_t chunkSamplesNum = chunk.decodeSampleCounts(filebytes, m_compression, decoders, rawBuffer, m_sampleOffsets.data() + 1 + std::size_t(chunk.firstRow()) * m_columnsNum);
+					if (chunk._unpackedSampleDataSizeInBytes() != chunkSamplesNum * m_bytesPerSample)
+					{
+						throw std::runtime_error("unpacked sample data size of deep chunk at 0x" + utils::hex64(chunk.firstByteIndex()) + " is " + std::to_string(chunk._unpackedSampleDataSizeInBytes()) + " bytes, pixel offset table gives " + std::to_string(chunkSamplesNum) + " samples of " + std::to_string(m_bytesPerSample) + " bytes.");
+					}
+				}
+			});
+			for (std::size_t pixel = 1; pixel < m_sampleOffsets.size(); pixel++)
+			{
+				const uint64_t count = m_sampleOffsets[pixel];
+				m_maxSamplesPerPixel = std::max(m_maxSamplesPerPixel, count);
+				m_emptyPixelsNum += (count == 0) ? 1 : 0;
+				m_sampleOffsets[pixel] += m_sampleOffsets[pixel - 1];
+			}
+
+			// pass 2: sample data, each scanline of each channel is one contiguous run of the channel array
+			m_samples.reserve(channelsNum());
+			for (uint32_t ch = 0; ch < channelsNum(); ch++)
+			{
+				m_samples.emplace_back(std::size_t(samplesNum()));
+			}
+			forEachChunkRange(threadPool, [&](const std::size_t firstChunk, const std::size_t lastChunk)
+			{
+				exrCompression::ChunkDecoders decoders;
+				std::vector<ui8> rawBuffer;
+				for (std::size_t chunkIndex = firstChunk; chunkIndex < lastChunk; chunkIndex++)
+				{
+					const DeepScanlineChunk& chunk = m_chunks[chunkIndex];
+					const ui8* raw = chunk.decodeSampleData(filebytes, m_compression, decoders, rawBuffer);
+					for (uint32_t line = 0; line < chunk.scanlinesNum(); line++)
+					{
+						const uint32_t row = chunk.firstRow() + line;
+						const uint64_t lineFirstSample = rowFirstSampleIndex(row);
+						const uint32_t lineSamplesNum = uint32_t(rowFirstSampleIndex(row + 1) - lineFirstSample);
+						for (uint32_t ch = 0; ch < channelsNum(); ch++)
+						{
+							m_kernels[ch](raw, m_samples[ch].data() + lineFirstSample, lineSamplesNum);
+							raw += std::size_t(lineSamplesNum) * m_sampleSizes[ch];
+						}
+					}
+				}
+			});
+			// chunks, as ordered in file
+			std::sort(m_chunks.begin(), m_chunks.end(), [](const DeepScanlineChunk& left, const DeepScanlineChunk& right) { return left.firstByteIndex() < right.firstByteIndex(); });
+			m_firstByteIndex = m_chunks[0].firstByteIndex();
+			m_lastByteIndex = m_chunks[m_chunks.size()-1].lastByteIndex();
+		}
+		uint64_t firstByteIndex() const { return m_firstByteIndex; }	// firstByteIndex of first chunk (in file)
+		uint64_t lastByteIndex() const { return m_lastByteIndex; }		// lastByteIndex of last chunk (in file)
+		uint32_t rowsNum() const { return m_rowsNum; }
+		uint32_t columnsNum() const { return m_columnsNum; }
+		uint32_t channelsNum() const { return uint32_t(m_channelNames.size()); }
+		const std::vector<std::string>& channelNames() const { return m_channelNames; }
+
+		/// <returns> number of samples of all pixels </returns>
+		uint64_t samplesNum() const { return m_sampleOffsets.back(); }
+		uint64_t maxSamplesPerPixel() const { return m_maxSamplesPerPixel; }
+		double meanSamplesPerPixel() const { return double(samplesNum()) / double(m_sampleOffsets.size() - 1); }
+		/// <returns> number of pixels with no samples </returns>
+		uint64_t emptyPixelsNum() const { return m_emptyPixelsNum; }
+		/// <returns> number of samples of pixel [pixelRowIndex, pixelColumnIndex] </returns>
+		uint32_t sampleCount(const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const
+		{
+			const std::size_t pixel = pixelIndex(pixelRowIndex, pixelColumnIndex);
+			return uint32_t(m_sampleOffsets[pixel + 1] - m_sampleOffsets[pixel]);
+		}
+		/// <returns> index of first sample of pixel [pixelRowIndex, pixelColumnIndex] within channelSamples() arrays </returns>
+		uint64_t firstSampleIndex(const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const { return m_sampleOffsets[pixelIndex(pixelRowIndex, pixelColumnIndex)]; }
+		/// <returns> all samples of (channelIndex) channel (ordered as in chlist), samplesNum() values </returns>
+		const channelCType32* channelSamples(const uint32_t channelIndex) const { return m_samples.at(channelIndex).data(); }
+		/// <returns> value of (channelIndex) channel of (sampleIndex) sample (of sampleCount()) of pixel [pixelRowIndex, pixelColumnIndex] </returns>
+		channelCType32 sampleValue(const uint32_t channelIndex, const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex, const uint32_t sampleIndex) const
+		{
+			if (sampleCount(pixelRowIndex, pixelColumnIndex) <= sampleIndex)
+			{
+				throw std::invalid_argument("sample " + std::to_string(sampleIndex) + " of pixel [" + std::to_string(pixelRowIndex) + ", " + std::to_string(pixelColumnIndex) + "] is out of its " + std::to_string(sampleCount(pixelRowIndex, pixelColumnIndex)) + " samples");
+			}
+			return channelSamples(channelIndex)[firstSampleIndex(pixelRowIndex, pixelColumnIndex) + sampleIndex];
+		}
+
+		/// <returns> e.g. "1024 samples, max 8 per pixel, mean 2.50 per pixel, 12 empty pixels" </returns>
+		std::string statsString() const
+		{
+			return std::to_string(samplesNum()) + " samples, max " + std::to_string(m_maxSamplesPerPixel) + " per pixel, mean " + utils::str(float(meanSamplesPerPixel()), 2)
+				+ " per pixel, " + std::to_string(m_emptyPixelsNum) + " empty pixels";
+		}
+		/// <summary>
+		///		Samples of each pixel of (rows) x (columns) rectangle: number of samples, then values of each channel, sample after sample.
+		/// </summary>
+		std::string toStringAsDeepPixels(const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns, const uint8_t fltPrecis = 6) const
+		{
+			tryValidateRegion(rows, columns);
+			std::string str = "";
+			for (uint32_t row = rows.first(); row <= rows.last(); row++)
+			{
+				str += "row [" + std::to_string(row) + "]: \n";
+				for (uint32_t col = columns.first(); col <= columns.last(); col++)
+				{
+					const uint32_t count = sampleCount(row, col);
+					str += "\t pixel[" + std::to_string(row) + ", " + std::to_string(col) + "] samples = " + std::to_string(count) + "\n";
+					for (uint32_t ch = 0; ch < channelsNum() and count != 0; ch++)
+					{
+						str += "\t\t " + m_channelNames[ch] + " = ";
+						for (uint32_t s = 0; s < count; s++)
+						{
+							const channelCType32 value = sampleValue(ch, row, col, s);
+							str += (s == 0 ? "" : ", ") + (std::is_same_v<channelCType32, float> ? utils::str(value, fltPrecis) : std::to_string(value));
+						}
+						str += "\n";
+					}
+				}
+			}
+			return str;
+		}
+		/// <summary>
+		///		Chunks of (rows), as ordered in file: header, pixel offset table entries and samples of (columns).
+		///		Byte ranges of entries and samples are given within uncompressed pixel offset table and sample data of the chunk.
+		/// </summary>
+		std::string toStringAsExrDeepChunks(const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns, const uint8_t tabsNum = 0) const
+		{
+			tryValidateRegion(rows, columns);
+			std::string str;
+			for (const DeepScanlineChunk& chunk : m_chunks)
+			{
+				const uint32_t chunkFirstRow = chunk.firstRow();
+				if (chunkFirstRow + chunk.scanlinesNum() - 1 < rows.first() or rows.last() < chunkFirstRow)
+				{
+					continue;
+				}
+				str += utils::tabs(tabsNum) + byteRangeString(chunk.headerFieldFirstByteIndex(0), sizeof(int32_t)) + " chunk.y = " + std::to_string(chunk._y()) + " \n";
+				str += utils::tabs(tabsNum) + byteRangeString(chunk.headerFieldFirstByteIndex(1), sizeof(uint64_t)) + " packedPixelOffsetTableSizeInBytes = " + std::to_string(chunk._packedOffsetTableSizeInBytes())
+					+ (chunk.isOffsetTableCompressed() ? " (" + exr2::consta::compressionName(m_compression) : " (stored uncompressed") + ", " + std::to_string(chunk.rawOffsetTableSizeInBytes()) + " bytes uncompressed) \n";
+				str += utils::tabs(tabsNum) + byteRangeString(chunk.headerFieldFirstByteIndex(2), sizeof(uint64_t)) + " packedSampleDataSizeInBytes = " + std::to_string(chunk._packedSampleDataSizeInBytes())
+					+ (chunk.isSampleDataCompressed() ? " (" + exr2::consta::compressionName(m_compression) + ")" : " (stored uncompressed)") + " \n";
+				str += utils::tabs(tabsNum) + byteRangeString(chunk.headerFieldFirstByteIndex(3), sizeof(uint64_t)) + " unpackedSampleDataSizeInBytes = " + std::to_string(chunk._unpackedSampleDataSizeInBytes())
+					+ " (" + std::to_string(rowFirstSampleIndex(chunkFirstRow + chunk.scanlinesNum()) - rowFirstSampleIndex(chunkFirstRow)) + " samples, " + std::to_string(chunk.scanlinesNum()) + " scanline(s)) \n";
+				str += utils::tabs(tabsNum) + byteRangeString(chunk.offsetTableFirstByteIndex(), chunk._packedOffsetTableSizeInBytes()) + " pixel offset table \n";
+				if (chunk._packedSampleDataSizeInBytes() != 0)
+				{
+					str += utils::tabs(tabsNum) + byteRangeString(chunk.sampleDataFirstByteIndex(), chunk._packedSampleDataSizeInBytes()) + " sample data \n";
+				}
+				str += utils::tabs(tabsNum) + "entries (byte ranges within uncompressed pixel offset table and sample data): \n";
+				uint64_t lineRawFirstByteIndex = 0;		// first byte of samples of the scanline within uncompressed sample data
+				for (uint32_t line = 0; line < chunk.scanlinesNum(); line++)
+				{
+					const uint32_t row = chunkFirstRow + line;
+					const uint64_t lineFirstSample = rowFirstSampleIndex(row);
+					const uint64_t lineSamplesNum = rowFirstSampleIndex(row + 1) - lineFirstSample;
+					if (rows.contains(row))
+					{
+						for (uint32_t col = columns.first(); col <= columns.last(); col++)
+						{
+							const uint32_t entryFirstByteIndex = (line * m_columnsNum + col) * uint32_t(sizeof(int32_t));
+							str += utils::tabs(tabsNum+1) + "[+0x" + utils::hex(entryFirstByteIndex, 4) + "; +0x" + utils::hex(entryFirstByteIndex + uint32_t(sizeof(int32_t)) - 1, 4) + "] "
+								+ std::to_string(firstSampleIndex(row, col) + sampleCount(row, col) - lineFirstSample) + "\t = px[" + std::to_string(row) + ", " + std::to_string(col) + "] cumulative samples (" + std::to_string(sampleCount(row, col)) + " of pixel)\n";
+						}
+						uint64_t channelRawFirstByteIndex = lineRawFirstByteIndex;
+						for (uint32_t ch = 0; ch < channelsNum(); ch++)
+						{
+							for (uint32_t col = columns.first(); col <= columns.last(); col++)
+							{
+								for (uint32_t s = 0; s < sampleCount(row, col); s++)
+								{
+									const uint64_t sampleRawFirstByteIndex = channelRawFirstByteIndex + (firstSampleIndex(row, col) + s - lineFirstSample) * m_sampleSizes[ch];
+									str += utils::tabs(tabsNum+1) + "[+0x" + utils::hex(uint32_t(sampleRawFirstByteIndex), 4) + "; +0x" + utils::hex(uint32_t(sampleRawFirstByteIndex + m_sampleSizes[ch] - 1), 4) + "] " + utils::str(sampleValue(ch, row, col, s), 9)
+										+ "\t = px[" + std::to_string(row) + ", " + std::to_string(col) + "] sample " + std::to_string(s) + " channel " + m_channelNames[ch] + "\n";
+								}
+							}
+							channelRawFirstByteIndex += lineSamplesNum * m_sampleSizes[ch];
+						}
+					}
+					lineRawFirstByteIndex += lineSamplesNum * m_bytesPerSample;
+				}
+			}
+			return str;
+		}
+
+		private:
+		uint32_t m_rowsNum = 0, m_columnsNum = 0;
+		std::vector<std::string> m_channelNames;						// ordered as in chlist
+		std::vector<uint32_t> m_channelDataTypes;
+		std::vector<uint32_t> m_sampleSizes;							// size of one sample of each channel in file, bytes
+		std::vector<typename ScanlineDecoder<channelCType32>::ChannelRunKernel> m_kernels;		// decoding kernel of each channel
+		uint32_t m_bytesPerSample = 0;									// size of one sample of all channels in file
+		exr2::consta::s_compression::value m_compression = exr2::consta::s_compression::value::NO;
+		uint32_t m_scanlinesPerChunk = 1;
+		std::vector<DeepScanlineChunk> m_chunks;						// chunk headers, as ordered in file
+		std::vector<uint64_t> m_sampleOffsets;							// (rows x columns + 1) prefix sums of sample counts, row by row
+		std::vector<AlignedArray<channelCType32>> m_samples;			// samples of all pixels, one array per channel
+		uint64_t m_maxSamplesPerPixel = 0, m_emptyPixelsNum = 0;
+		uint64_t m_firstByteIndex = 0, m_lastByteIndex = 0;
+		static const uint32_t s_c_tasksPerWorker = 4;
+
+		std::size_t pixelIndex(const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const
+		{
+			if (m_rowsNum <= pixelRowIndex)
+			{
+				throw s_c_invalidPixelRowIndex;
+			}
+			if (m_columnsNum <= pixelColumnIndex)
+			{
+				throw s_c_invalidPixelColumnIndex;
+			}
+			return std::size_t(pixelRowIndex) * m_columnsNum + pixelColumnIndex;
+		}
+		/// <returns> index of first sample of first pixel of (row), (row) = rowsNum() gives samplesNum() </returns>
+		uint64_t rowFirstSampleIndex(const uint32_t row) const { return m_sampleOffsets[std::size_t(row) * m_columnsNum]; }
+		static std::string byteRangeString(const uint64_t firstByteIndex, const uint64_t sizeInBytes)
+		{
+			return "[0x" + utils::hex64(firstByteIndex, 4) + "; 0x" + utils::hex64(firstByteIndex + sizeInBytes - 1, 4) + "]";
+		}
+		void tryValidateRegion(const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns) const
+		{
+			if (rows.last() < rows.first() or m_rowsNum <= rows.last() or columns.last() < columns.first() or m_columnsNum <= columns.last())
+			{
+				throw std::invalid_argument
+				(
+					"region rows [" + std::to_string(rows.first()) + "; " + std::to_string(rows.last()) + "], columns [" + std::to_string(columns.first()) + "; " + std::to_string(columns.last()) + "] "
+					"is not valid for image of " + std::to_string(m_rowsNum) + " rows and " + std::to_string(m_columnsNum) + " columns"
+				);
+			}
+		}
+		/// <summary>
+		///		Call rangeFunc(first, last) for ranges of chunks, several ranges per worker of (threadPool) to even out the load,
+		///		or once for all chunks on calling thread, if (threadPool) is nullptr.
+		/// </summary>
+		template <typename RangeFunc>
+		void forEachChunkRange(utils::ThreadPool* threadPool, RangeFunc&& rangeFunc) const
+		{
+			if (threadPool == nullptr)
+			{
+				rangeFunc(std::size_t(0), m_chunks.size());
+				return;
+			}
+			const std::size_t chunksPerTask = std::max<std::size_t>(1, m_chunks.size() / (std::size_t(threadPool->workersNum() + 1) * s_c_tasksPerWorker));
+			threadPool->parallelFor(0, m_chunks.size(), chunksPerTask, rangeFunc);
+		}
+	};
+}
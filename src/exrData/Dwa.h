@@ -0,0 +1,1180 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "exrData/ChunkDecoder.h"
+#include "exrData/ChunkEncoder.h"
+#include "exrData/exrConsta.h"
+#include "exrData/Half.h"
+#include "exrData/Piz.h"
+#include "exrData/Rle.h"
+#include "exrData/Zip.h"
+#include "types.h"
+
+// SSE2 (part of every x86-64 CPU): inverse DCT and color conversion of 4 samples per instruction
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define EXRDWA_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+namespace exrCompression
+{
+	/// ReadMe: DWAA / DWAB compression of OpenEXR
+	/*
+		source: https://openexr.com/en/latest/TechnicalIntroduction.html#data-compression , OpenEXR library (ImfDwaCompressor, ImfDwaCompressorSimd, dwaLookups)
+		date: 2026.10.17
+
+		Chunk (DWAA - 32 scanlines, DWAB - 256 scanlines, or 1 tile) is compressed channel by channel, by scheme chosen from channel name suffix
+		(text after last '.') and data type by classifier rules:
+		- LOSSY_DCT (HALF / FLOAT, e.g. R, G, B, Y): samples are converted to nonlinear HALF (x^(1/2.2) up to 1, logarithmic above),
+			R, G, B channels of the same layer (prefix) to Y'CbCr, then each 8x8 block is transformed by DCT and quantized;
+			DC coefficient of each block is stored in DC data, 63 AC coefficients (zigzag order) - in AC data, where
+			0xFF00 ends block, 0xFFnn skips nn zero coefficients, other values are HALF coefficients;
+		- RLE (e.g. A): bytes of samples are split into planes (byte 0 of all samples, then byte 1, ...), then run-length encoded;
+		- UNKNOWN (other channels): samples are stored as they are.
+
+		Chunk data:
+			int64 x 11								- version, unknown uncompressed / compressed size, AC compressed size, DC compressed size,
+														RLE compressed / uncompressed / raw size, AC count, DC count, AC compression (0 - Huffman, 1 - zlib)
+			uint16 rulesSize, rules (version 2)		- classifier rules: suffix (null-terminated), byte (cscIndex + 1) << 4 | scheme << 2 | caseInsensitive,
+														byte data type; versions 0 and 1 use built-in rules
+			unknown data							- zlib, UNKNOWN channels one after another
+			AC data									- Huffman (as PIZ) or zlib, 16-bit values
+			DC data									- zlib with predictor and byte split (as ZIP), 16-bit values, plane of each channel of each DCT group
+			RLE data								- zlib, then run-length (as RLE chunk, without predictor)
+		DCT groups are decoded in order: RGB sets (ordered by layer prefix), then single LOSSY_DCT channels (ordered as in chlist).
+		Channels with pLinear = 1 skip linearization, they are not decoded here (header is rejected).
+		If compressed data is not smaller than uncompressed, chunk stores uncompressed data instead.
+		DwaEncoder writes version 2 data with default classifier rules of OpenEXR and always compresses AC data with zlib.
+	*/
+
+	/// <summary>
+	///		Coefficients of DWA inverse DCT: 0.5 * cos(k * pi / 16), with pi = 3.14159 as in OpenEXR.
+	/// </summary>
+	struct DctCoefficients
+	{
+		float a = .5f * std::cos(3.14159f / 4.0f);
+		float b = .5f * std::cos(3.14159f / 16.0f);
+		float c = .5f * std::cos(3.14159f / 8.0f);
+		float d = .5f * std::cos(3.f * 3.14159f / 16.0f);
+		float e = .5f * std::cos(5.f * 3.14159f / 16.0f);
+		float f = .5f * std::cos(3.f * 3.14159f / 8.0f);
+		float g = .5f * std::cos(7.f * 3.14159f / 16.0f);
+	};
+
+	/// <summary>
+	///		1D inverse DCT of 8 values (x[0], x[stride], ... x[7*stride]) in place.
+	/// </summary>
+	inline void dctInverse8(float* x, const std::size_t stride, const DctCoefficients& k)
+	{
+		const float x0 = x[0], x1 = x[stride], x2 = x[2*stride], x3 = x[3*stride], x4 = x[4*stride], x5 = x[5*stride], x6 = x[6*stride], x7 = x[7*stride];
+		const float alpha0 = k.c * x2, alpha1 = k.f * x2, alpha2 = k.c * x6, alpha3 = k.f * x6;
+		const float beta0 = k.b * x1 + k.d * x3 + k.e * x5 + k.g * x7;
+		const float beta1 = k.d * x1 - k.g * x3 - k.b * x5 - k.e * x7;
+		const float beta2 = k.e * x1 - k.b * x3 + k.g * x5 + k.d * x7;
+		const float beta3 = k.g * x1 - k.e * x3 + k.d * x5 - k.b * x7;
+		const float theta0 = k.a * (x0 + x4), theta3 = k.a * (x0 - x4);
+		const float theta1 = alpha0 + alpha3, theta2 = alpha1 - alpha2;
+		const float gamma0 = theta0 + theta1, gamma1 = theta3 + theta2, gamma2 = theta3 - theta2, gamma3 = theta0 - theta1;
+		x[0] = gamma0 + beta0;
+		x[stride] = gamma1 + beta1;
+		x[2*stride] = gamma2 + beta2;
+		x[3*stride] = gamma3 + beta3;
+		x[4*stride] = gamma3 - beta3;
+		x[5*stride] = gamma2 - beta2;
+		x[6*stride] = gamma1 - beta1;
+		x[7*stride] = gamma0 - beta0;
+	}
+
+	/// <summary>
+	///		Inverse DCT of 8x8 block (row by row) in place: rows, then columns.
+	/// </summary>
+	inline void dctInverse8x8Scalar(float* block, const DctCoefficients& k)
+	{
+		for (std::size_t row = 0; row < 8; row++)
+		{
+			dctInverse8(block + 8*row, 1, k);
+		}
+		for (std::size_t column = 0; column < 8; column++)
+		{
+			dctInverse8(block + column, 8, k);
+		}
+	}
+
+	#if EXRDWA_SSE2
+	/// <summary>
+	///		1D inverse DCT of columns of 4 x 8 values (x[row] = 4 columns of row), same operations as dctInverse8().
+	/// </summary>
+	inline void dctInverse8SSE2(__m128* x, const DctCoefficients& k)
+	{
+		const __m128 a = _mm_set1_ps(k.a), b = _mm_set1_ps(k.b), c = _mm_set1_ps(k.c), d = _mm_set1_ps(k.d), e = _mm_set1_ps(k.e), f = _mm_set1_ps(k.f), g = _mm_set1_ps(k.g);
+		const __m128 alpha0 = _mm_mul_ps(c, x[2]), alpha1 = _mm_mul_ps(f, x[2]), alpha2 = _mm_mul_ps(c, x[6]), alpha3 = _mm_mul_ps(f, x[6]);
+		const __m128 beta0 = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(b, x[1]), _mm_mul_ps(d, x[3])), _mm_mul_ps(e, x[5])), _mm_mul_ps(g, x[7]));
+		const __m128 beta1 = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(d, x[1]), _mm_mul_ps(g, x[3])), _mm_mul_ps(b, x[5])), _mm_mul_ps(e, x[7]));
+		const __m128 beta2 = _mm_add_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(e, x[1]), _mm_mul_ps(b, x[3])), _mm_mul_ps(g, x[5])), _mm_mul_ps(d, x[7]));
+		const __m128 beta3 = _mm_sub_ps(_mm_add_ps(_mm_sub_ps(_mm_mul_ps(g, x[1]), _mm_mul_ps(e, x[3])), _mm_mul_ps(d, x[5])), _mm_mul_ps(b, x[7]));
+		const __m128 theta0 = _mm_mul_ps(a, _mm_add_ps(x[0], x[4])), theta3 = _mm_mul_ps(a, _mm_sub_ps(x[0], x[4]));
+		const __m128 theta1 = _mm_add_ps(alpha0, alpha3), theta2 = _mm_sub_ps(alpha1, alpha2);
+		const __m128 gamma0 = _mm_add_ps(theta0, theta1), gamma1 = _mm_add_ps(theta3, theta2), gamma2 = _mm_sub_ps(theta3, theta2), gamma3 = _mm_sub_ps(theta0, theta1);
+		x[0] = _mm_add_ps(gamma0, beta0);
+		x[1] = _mm_add_ps(gamma1, beta1);
+		x[2] = _mm_add_ps(gamma2, beta2);
+		x[3] = _mm_add_ps(gamma3, beta3);
+		x[4] = _mm_sub_ps(gamma3, beta3);
+		x[5] = _mm_sub_ps(gamma2, beta2);
+		x[6] = _mm_sub_ps(gamma1, beta1);
+		x[7] = _mm_sub_ps(gamma0, beta0);
+	}
+
+	/// <summary>
+	///		Transpose 8x8 block held as left ([0][row]) and right ([1][row]) 4-column halves of its rows.
+	/// </summary>
+	inline void transpose8x8SSE2(__m128 (&halves)[2][8])
+	{
+		_MM_TRANSPOSE4_PS(halves[0][0], halves[0][1], halves[0][2], halves[0][3]);
+		_MM_TRANSPOSE4_PS(halves[1][0], halves[1][1], halves[1][2], halves[1][3]);
+		_MM_TRANSPOSE4_PS(halves[0][4], halves[0][5], halves[0][6], halves[0][7]);
+		_MM_TRANSPOSE4_PS(halves[1][4], halves[1][5], halves[1][6], halves[1][7]);
+		for (std::size_t row = 0; row < 4; row++)
+		{
+			std::swap(halves[1][row], halves[0][row + 4]);
+		}
+	}
+
+	/// <summary>
+	///		Inverse DCT of 8x8 block (row by row) in place, 4 rows (columns) at once: block is transposed, so that rows are
+	///		transformed as columns, transposed back, then columns are transformed. Result is the same as of dctInverse8x8Scalar().
+	/// </summary>
+	inline void dctInverse8x8SSE2(float* block, const DctCoefficients& k)
+	{
+		__m128 halves[2][8];
+		for (std::size_t row = 0; row < 8; row++)
+		{
+			halves[0][row] = _mm_loadu_ps(block + 8*row);
+			halves[1][row] = _mm_loadu_ps(block + 8*row + 4);
+		}
+		transpose8x8SSE2(halves);
+		dctInverse8SSE2(halves[0], k);
+		dctInverse8SSE2(halves[1], k);
+		transpose8x8SSE2(halves);
+		dctInverse8SSE2(halves[0], k);
+		dctInverse8SSE2(halves[1], k);
+		for (std::size_t row = 0; row < 8; row++)
+		{
+			_mm_storeu_ps(block + 8*row, halves[0][row]);
+			_mm_storeu_ps(block + 8*row + 4, halves[1][row]);
+		}
+	}
+	#endif
+
+	/// <summary> Inverse DCT of 8x8 block (row by row) in place: SSE2 if available, scalar otherwise. </summary>
+	inline void dctInverse8x8(float* block, const DctCoefficients& k)
+	{
+		#if EXRDWA_SSE2
+		dctInverse8x8SSE2(block, k);
+		#else
+		dctInverse8x8Scalar(block, k);
+		#endif
+	}
+
+	/// <summary>
+	///		Y'CbCr (Rec. 709) => R'G'B' of one sample in place: (y) becomes R, (cb) - G, (cr) - B.
+	/// </summary>
+	inline void csc709Inverse(float& y, float& cb, float& cr)
+	{
+		const float y1 = y, cb1 = cb, cr1 = cr;
+		y = y1 + 1.5747f * cr1;
+		cb = y1 - 0.1873f * cb1 - 0.4682f * cr1;
+		cr = y1 + 1.8556f * cb1;
+	}
+
+	/// <summary>
+	///		Y'CbCr (Rec. 709) => R'G'B' of (count) samples in place, as csc709Inverse() of each sample.
+	/// </summary>
+	inline void csc709Inverse(float* y, float* cb, float* cr, const std::size_t count)
+	{
+		std::size_t i = 0;
+		#if EXRDWA_SSE2
+		const __m128 rCr = _mm_set1_ps(1.5747f), gCb = _mm_set1_ps(0.1873f), gCr = _mm_set1_ps(0.4682f), bCb = _mm_set1_ps(1.8556f);
+		for (; i < count - count % 4; i += 4)
+		{
+			const __m128 y4 = _mm_loadu_ps(y + i), cb4 = _mm_loadu_ps(cb + i), cr4 = _mm_loadu_ps(cr + i);
+			_mm_storeu_ps(y + i, _mm_add_ps(y4, _mm_mul_ps(rCr, cr4)));
+			_mm_storeu_ps(cb + i, _mm_sub_ps(_mm_sub_ps(y4, _mm_mul_ps(gCb, cb4)), _mm_mul_ps(gCr, cr4)));
+			_mm_storeu_ps(cr + i, _mm_add_ps(y4, _mm_mul_ps(bCb, cb4)));
+		}
+		#endif
+		for (; i < count; i++)
+		{
+			csc709Inverse(y[i], cb[i], cr[i]);
+		}
+	}
+
+	/// <summary>
+	///		Lookup table of DWA lossy channels: nonlinear HALF => linear HALF (x^2.2 up to 1, e^(2.2 * (x - 1)) above, infinity and NaN => 0).
+	///		Built once, on first use.
+	/// </summary>
+	inline const std::vector<uint16_t>& dwaToLinearTable()
+	{
+		static const std::vector<uint16_t> s_c_table = []()
+		{
+			std::vector<uint16_t> table(65536);
+			const float logBase = float(std::pow(2.7182818, 2.2));
+			for (uint32_t i = 1; i < 65536; i++)
+			{
+				if ((i & 0x7C00) == 0x7C00)
+				{
+					continue;
+				}
+				const float value = exrHalf::halfToFloat(uint16_t(i));
+				const float sign = (value < 0) ? -1.0f : 1.0f;
+				const float magnitude = std::fabs(value);
+				const float linear = (magnitude <= 1.0f) ? sign * std::pow(magnitude, 2.2f) : sign * std::pow(logBase, magnitude - 1.0f);
+				table[i] = exrHalf::floatToHalf(linear);
+			}
+			return table;
+		}();
+		return s_c_table;
+	}
+
+	/// <summary>
+	///		Lookup table of DWA lossy channels: linear HALF => nonlinear HALF (x^(1/2.2) up to 1, ln(x) / 2.2 + 1 above, infinity and NaN => 0),
+	///		inverse of dwaToLinearTable(). Built once, on first use.
+	/// </summary>
+	inline const std::vector<uint16_t>& dwaToNonlinearTable()
+	{
+		static const std::vector<uint16_t> s_c_table = []()
+		{
+			std::vector<uint16_t> table(65536);
+			for (uint32_t i = 1; i < 65536; i++)
+			{
+				if ((i & 0x7C00) == 0x7C00)
+				{
+					continue;
+				}
+				const float value = exrHalf::halfToFloat(uint16_t(i));
+				const float sign = (value < 0) ? -1.0f : 1.0f;
+				const float magnitude = std::fabs(value);
+				const float nonlinear = (magnitude <= 1.0f) ? sign * std::pow(magnitude, 1.0f / 2.2f) : sign * (std::log(magnitude) / 2.2f + 1.0f);
+				table[i] = exrHalf::floatToHalf(nonlinear);
+			}
+			return table;
+		}();
+		return s_c_table;
+	}
+
+	/// <summary>
+	///		1D forward DCT of 8 values (x[0], x[stride], ... x[7*stride]) in place: transpose of dctInverse8(), as the transform is orthonormal.
+	/// </summary>
+	inline void dctForward8(float* x, const std::size_t stride, const DctCoefficients& k)
+	{
+		const float x0 = x[0], x1 = x[stride], x2 = x[2*stride], x3 = x[3*stride], x4 = x[4*stride], x5 = x[5*stride], x6 = x[6*stride], x7 = x[7*stride];
+		const float sum07 = x0 + x7, sum16 = x1 + x6, sum25 = x2 + x5, sum34 = x3 + x4;
+		const float difference07 = x0 - x7, difference16 = x1 - x6, difference25 = x2 - x5, difference34 = x3 - x4;
+		x[0] = k.a * (sum07 + sum16 + sum25 + sum34);
+		x[stride] = k.b * difference07 + k.d * difference16 + k.e * difference25 + k.g * difference34;
+		x[2*stride] = k.c * (sum07 - sum34) + k.f * (sum16 - sum25);
+		x[3*stride] = k.d * difference07 - k.g * difference16 - k.b * difference25 - k.e * difference34;
+		x[4*stride] = k.a * (sum07 - sum16 - sum25 + sum34);
+		x[5*stride] = k.e * difference07 - k.b * difference16 + k.g * difference25 + k.d * difference34;
+		x[6*stride] = k.f * (sum07 - sum34) - k.c * (sum16 - sum25);
+		x[7*stride] = k.g * difference07 - k.e * difference16 + k.d * difference25 - k.b * difference34;
+	}
+
+	/// <summary>
+	///		Forward DCT of 8x8 block (row by row) in place: rows, then columns.
+	/// </summary>
+	inline void dctForward8x8(float* block, const DctCoefficients& k)
+	{
+		for (std::size_t row = 0; row < 8; row++)
+		{
+			dctForward8(block + 8*row, 1, k);
+		}
+		for (std::size_t column = 0; column < 8; column++)
+		{
+			dctForward8(block + column, 8, k);
+		}
+	}
+
+	/// <summary>
+	///		R'G'B' => Y'CbCr (Rec. 709) of (count) samples in place: (r) becomes Y, (g) - Cb, (b) - Cr. Inverse of csc709Inverse().
+	/// </summary>
+	inline void csc709Forward(float* r, float* g, float* b, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const float r1 = r[i], g1 = g[i], b1 = b[i];
+			r[i] = 0.2126f * r1 + 0.7152f * g1 + 0.0722f * b1;
+			g[i] = -0.1146f * r1 - 0.3854f * g1 + 0.5f * b1;
+			b[i] = 0.5f * r1 - 0.4542f * g1 - 0.0458f * b1;
+		}
+	}
+
+	/// <summary>
+	///		Quantize DCT coefficient (value) to HALF: of all HALF values within (tolerance) of (value), the one with most trailing zero bits
+	///		(so AC and DC data compress better), nearest HALF if none.
+	/// </summary>
+	inline uint16_t dwaQuantize(const float value, const float tolerance)
+	{
+		const uint16_t nearest = exrHalf::floatToHalf(value);
+		if ((nearest & 0x7C00) == 0x7C00 or not (0 < tolerance))
+		{
+			return nearest;
+		}
+		const uint16_t sign = nearest & 0x8000;
+		const uint16_t magnitude = nearest & 0x7FFF;
+		const float absValue = std::fabs(value);
+		for (uint32_t bits = 15; 0 < bits; bits--)
+		{
+			const uint32_t step = 1u << bits;
+			const uint32_t lower = magnitude & ~(step - 1);
+			const uint32_t upper = lower + step;
+			const float lowerError = std::fabs(exrHalf::halfToFloat(uint16_t(lower)) - absValue);
+			const float upperError = (upper < 0x7C00) ? std::fabs(exrHalf::halfToFloat(uint16_t(upper)) - absValue) : tolerance + 1.0f;
+			if (lowerError <= tolerance or upperError <= tolerance)
+			{
+				const uint32_t best = (lowerError <= upperError) ? lower : upper;
+				return (best == 0) ? uint16_t(0) : uint16_t(sign | best);
+			}
+		}
+		return (magnitude == 0) ? uint16_t(0) : nearest;
+	}
+
+	/// <summary>
+	///		Constants of DWA chunk data, shared by DwaDecoder and DwaEncoder.
+	/// </summary>
+	struct DwaFormat
+	{
+		static const std::size_t s_c_sizesNum = 11;
+		static const uint64_t s_c_version = 2;					// written by DwaEncoder
+		static const uint64_t s_c_acHuffman = 0;
+		static const uint64_t s_c_acDeflate = 1;
+		static constexpr uint8_t s_c_zigzag[64] =		// index of coefficient of row-by-row block in zigzag order
+		{
+			 0,  1,  5,  6, 14, 15, 27, 28,
+			 2,  4,  7, 13, 16, 26, 29, 42,
+			 3,  8, 12, 17, 25, 30, 41, 43,
+			 9, 11, 18, 24, 31, 40, 44, 53,
+			10, 19, 23, 32, 39, 45, 52, 54,
+			20, 22, 33, 38, 46, 51, 55, 60,
+			21, 34, 37, 47, 50, 56, 59, 61,
+			35, 36, 48, 49, 57, 58, 62, 63
+		};
+	};
+
+	enum class DwaScheme : uint8_t
+	{
+		UNKNOWN = 0,
+		LOSSY_DCT = 1,
+		RLE = 2
+	};
+
+	/// <summary>
+	///		Classifier rule: channel of (channelDataType), whose name suffix is (suffix), is compressed by (scheme);
+	///		(cscIndex) 0 ~ 2 marks it as R, G or B of its layer (-1 = none).
+	/// </summary>
+	struct DwaChannelRule
+	{
+		std::string suffix;
+		DwaScheme scheme = DwaScheme::UNKNOWN;
+		int32_t cscIndex = -1;
+		bool isCaseInsensitive = false;
+		uint32_t channelDataType = 0;
+
+		bool matches(const std::string& channelSuffix, const uint32_t channelType) const
+		{
+			if (channelType != channelDataType)
+			{
+				return false;
+			}
+			if (not isCaseInsensitive)
+			{
+				return channelSuffix == suffix;
+			}
+			return channelSuffix.size() == suffix.size() and std::equal(channelSuffix.begin(), channelSuffix.end(), suffix.begin(), [](const char left, const char right)
+			{
+				return std::tolower(static_cast<unsigned char>(left)) == std::tolower(static_cast<unsigned char>(right));
+			});
+		}
+	};
+
+	/// <summary>
+	///		Classifier of channels of DWA chunk: holds classifier rules, chooses scheme of each channel and finds RGB sets.
+	/// </summary>
+	class DwaClassifier
+	{
+		public:
+		/// <summary>
+		///		Read classifier rules of version 2 chunk data (rules).
+		/// </summary>
+		/// <returns> size of rules in bytes </returns>
+		std::size_t readRules(const ui8view rules)
+		{
+			if (rules.size() < 2)
+			{
+				throw std::runtime_error("DWA chunk data is truncated before classifier rules.");
+			}
+			const std::size_t rulesSize = std::size_t(rules[0]) | (std::size_t(rules[1]) << 8);
+			if (rulesSize < 2 or rules.size() < rulesSize)
+			{
+				throw std::runtime_error("DWA chunk classifier rules size (" + std::to_string(rulesSize) + " bytes) is invalid.");
+			}
+			m_rules.clear();
+			std::size_t position = 2;
+			while (position < rulesSize)
+			{
+				const ui8* suffixEnd = std::find(rules.data() + position, rules.data() + rulesSize, ui8(0));
+				const std::size_t suffixSize = std::size_t(suffixEnd - (rules.data() + position));
+				if (rulesSize - position < suffixSize + 3)
+				{
+					throw std::runtime_error("DWA chunk classifier rule at byte " + std::to_string(position) + " is truncated.");
+				}
+				DwaChannelRule rule;
+				rule.suffix.assign(reinterpret_cast<const char*>(rules.data() + position), suffixSize);
+				position += suffixSize + 1;
+				const uint8_t flags = rules[position];
+				rule.cscIndex = int32_t(flags >> 4) - 1;
+				rule.scheme = DwaScheme((flags >> 2) & 3);
+				rule.isCaseInsensitive = (flags & 1) != 0;
+				rule.channelDataType = rules[position + 1];
+				position += 2;
+				if (2 < rule.cscIndex or DwaScheme::RLE < rule.scheme or exr2::consta::channel::datatype::max < rule.channelDataType)
+				{
+					throw std::runtime_error("DWA chunk classifier rule of suffix '" + rule.suffix + "' is invalid (flags 0x" + utils::hex(flags, 2) + ", data type " + std::to_string(rule.channelDataType) + ").");
+				}
+				m_rules.push_back(rule);
+			}
+			return rulesSize;
+		}
+
+		/// <summary>
+		///		Append classifier rules to (out), as version 2 chunk data stores them (reverse of readRules()).
+		/// </summary>
+		void writeRules(std::vector<ui8>& out) const
+		{
+			const std::size_t rulesStart = out.size();
+			out.resize(rulesStart + 2);
+			for (const DwaChannelRule& rule : m_rules)
+			{
+				out.insert(out.end(), rule.suffix.begin(), rule.suffix.end());
+				out.push_back(0);
+				out.push_back(ui8(((rule.cscIndex + 1) << 4) | (uint32_t(rule.scheme) << 2) | (rule.isCaseInsensitive ? 1 : 0)));
+				out.push_back(ui8(rule.channelDataType));
+			}
+			const std::size_t rulesSize = out.size() - rulesStart;
+			if (0xFFFF < rulesSize)
+			{
+				throw std::runtime_error("DWA classifier rules (" + std::to_string(rulesSize) + " bytes) do not fit into chunk data.");
+			}
+			out[rulesStart] = ui8(rulesSize);
+			out[rulesStart + 1] = ui8(rulesSize >> 8);
+		}
+
+		/// <summary> Use classifier rules of chunk data of versions 0 and 1. </summary>
+		void useLegacyRules()
+		{
+			const uint32_t half = exr2::consta::channel::datatype::HALF;
+			m_rules =
+			{
+				{ "r", DwaScheme::LOSSY_DCT, 0, true, half }, { "red", DwaScheme::LOSSY_DCT, 0, true, half },
+				{ "g", DwaScheme::LOSSY_DCT, 1, true, half }, { "grn", DwaScheme::LOSSY_DCT, 1, true, half }, { "green", DwaScheme::LOSSY_DCT, 1, true, half },
+				{ "b", DwaScheme::LOSSY_DCT, 2, true, half }, { "blu", DwaScheme::LOSSY_DCT, 2, true, half }, { "blue", DwaScheme::LOSSY_DCT, 2, true, half },
+				{ "y", DwaScheme::LOSSY_DCT, -1, true, half }, { "by", DwaScheme::LOSSY_DCT, -1, true, half }, { "ry", DwaScheme::LOSSY_DCT, -1, true, half }
+			};
+			for (uint32_t type = exr2::consta::channel::datatype::UINT; type <= exr2::consta::channel::datatype::FLOAT; type++)
+			{
+				m_rules.push_back({ "a", DwaScheme::RLE, -1, true, type });
+			}
+		}
+
+		/// <summary>
+		///		Use default classifier rules of OpenEXR writers (case-sensitive): R, G, B, Y, BY, RY of HALF and FLOAT are LOSSY_DCT, A is RLE.
+		/// </summary>
+		void useDefaultRules()
+		{
+			m_rules.clear();
+			const std::pair<const char*, int32_t> lossyChannels[] = { { "R", 0 }, { "G", 1 }, { "B", 2 }, { "Y", -1 }, { "BY", -1 }, { "RY", -1 } };
+			for (const auto& [suffix, cscIndex] : lossyChannels)
+			{
+				m_rules.push_back({ suffix, DwaScheme::LOSSY_DCT, cscIndex, false, exr2::consta::channel::datatype::HALF });
+				m_rules.push_back({ suffix, DwaScheme::LOSSY_DCT, cscIndex, false, exr2::consta::channel::datatype::FLOAT });
+			}
+			for (uint32_t type = exr2::consta::channel::datatype::UINT; type <= exr2::consta::channel::datatype::FLOAT; type++)
+			{
+				m_rules.push_back({ "A", DwaScheme::RLE, -1, false, type });
+			}
+		}
+
+		/// <summary>
+		///		Choose scheme of each channel of (layout) by rules (last matching rule wins) and find layers (name prefixes) having R, G and B channels.
+		/// </summary>
+		void classify(const ChunkLayout& layout)
+		{
+			const std::size_t channelsNum = layout.channelDataTypes.size();
+			if (layout.channelNames.size() != channelsNum)
+			{
+				throw std::runtime_error("DWA compression needs names of all " + std::to_string(channelsNum) + " channels.");
+			}
+			m_schemes.assign(channelsNum, DwaScheme::UNKNOWN);
+			std::map<std::string, std::array<int32_t, 3>> layers;
+			for (std::size_t channel = 0; channel < channelsNum; channel++)
+			{
+				const std::string& name = layout.channelNames[channel];
+				const std::size_t lastDot = name.find_last_of('.');
+				const std::string prefix = (lastDot == std::string::npos) ? "" : name.substr(0, lastDot);
+				const std::string suffix = (lastDot == std::string::npos) ? name : name.substr(lastDot + 1);
+				std::array<int32_t, 3>& layer = layers.try_emplace(prefix, std::array<int32_t, 3>{ -1, -1, -1 }).first->second;
+				for (const DwaChannelRule& rule : m_rules)
+				{
+					if (rule.matches(suffix, layout.channelDataTypes[channel]))
+					{
+						m_schemes[channel] = rule.scheme;
+						if (0 <= rule.cscIndex)
+						{
+							layer[rule.cscIndex] = int32_t(channel);
+						}
+					}
+				}
+			}
+			m_cscSets.clear();
+			for (const auto& [prefix, layer] : layers)
+			{
+				if (0 <= layer[0] and 0 <= layer[1] and 0 <= layer[2])
+				{
+					m_cscSets.push_back(layer);
+				}
+			}
+		}
+
+		/// <returns> scheme of each channel, chosen by classify() </returns>
+		const std::vector<DwaScheme>& schemes() const
+		{
+			return m_schemes;
+		}
+
+		/// <returns> R, G, B channels of each layer which has all 3 (ordered by layer prefix), found by classify() </returns>
+		const std::vector<std::array<int32_t, 3>>& cscSets() const
+		{
+			return m_cscSets;
+		}
+
+		private:
+		std::vector<DwaChannelRule> m_rules;
+		std::vector<DwaScheme> m_schemes;
+		std::vector<std::array<int32_t, 3>> m_cscSets;
+	};
+
+	/// <summary>
+	///		Decompressor of DWAA and DWAB chunk data. Keeps its buffers and Huffman tables between calls, so reuse one DwaDecoder per thread.
+	/// </summary>
+	class DwaDecoder : public ChunkDecoder
+	{
+		public:
+		/// <summary>
+		///		Decompress (compressed) chunk data of (layout) into (out): classify channels, unpack sections, then decode
+		///		lossy DCT groups, RLE and UNKNOWN channels into lines of chunk data.
+		/// </summary>
+		/// <param name="rawSize"> - size of uncompressed chunk data, (out) must have room for it </param>
+		void decode(const ui8view compressed, const ChunkLayout& layout, ui8* out, const std::size_t rawSize) override
+		{
+			tryValidateLayout(layout, rawSize, "DWA");
+			if (compressed.size() < DwaFormat::s_c_sizesNum * 8)
+			{
+				throw std::runtime_error("DWA chunk data (" + std::to_string(compressed.size()) + " bytes) is shorter than its header.");
+			}
+			uint64_t sizes[DwaFormat::s_c_sizesNum] = {};
+			for (std::size_t i = 0; i < DwaFormat::s_c_sizesNum; i++)
+			{
+				for (std::size_t byte = 0; byte < 8; byte++)
+				{
+					sizes[i] |= uint64_t(compressed[8*i + byte]) << (8*byte);
+				}
+			}
+			const uint64_t version = sizes[0];
+			if (2 < version)
+			{
+				throw std::runtime_error("DWA chunk data version " + std::to_string(version) + " is not supported (0 ~ 2 expected).");
+			}
+			std::size_t position = DwaFormat::s_c_sizesNum * 8;
+			if (version == 2)
+			{
+				position += m_classifier.readRules(compressed.subspan(position));
+			}
+			else
+			{
+				m_classifier.useLegacyRules();
+			}
+			m_classifier.classify(layout);
+			const std::vector<DwaScheme>& schemes = m_classifier.schemes();
+			// expected sizes of sections, from channels
+			const std::size_t width = layout.width, height = layout.height;
+			const std::size_t blocksNum = ((width + 7) / 8) * ((height + 7) / 8);
+			uint64_t unknownSize = 0, rleSize = 0, dcCount = 0;
+			for (std::size_t channel = 0; channel < schemes.size(); channel++)
+			{
+				const uint64_t channelSize = uint64_t(exr2::consta::channel::channelDataTypeSizeInBytes(layout.channelDataTypes[channel])) * width * height;
+				if (schemes[channel] == DwaScheme::UNKNOWN)		unknownSize += channelSize;
+				else if (schemes[channel] == DwaScheme::RLE)		rleSize += channelSize;
+				else											dcCount += blocksNum;		// channels of RGB sets are LOSSY_DCT too
+			}
+			const uint64_t unknownUncompressedSize = sizes[1], unknownCompressedSize = sizes[2], acCompressedSize = sizes[3], dcCompressedSize = sizes[4];
+			const uint64_t rleCompressedSize = sizes[5], rleUncompressedSize = sizes[6], rleRawSize = sizes[7];
+			const uint64_t acCount = sizes[8], dcCountStored = sizes[9], acCompression = sizes[10];
+			if (unknownUncompressedSize != unknownSize or rleRawSize != rleSize or dcCountStored != dcCount or 64 * dcCount < acCount)
+			{
+				throw std::runtime_error("DWA chunk header does not match its channels (unknown " + std::to_string(unknownUncompressedSize) + " / " + std::to_string(unknownSize) + " bytes, RLE " + std::to_string(rleRawSize) + " / " + std::to_string(rleSize) + " bytes, DC " + std::to_string(dcCountStored) + " / " + std::to_string(dcCount) + " values, AC " + std::to_string(acCount) + " values).");
+			}
+			const ui8view unknownData = section(compressed, position, unknownCompressedSize, "unknown");
+			const ui8view acData = section(compressed, position, acCompressedSize, "AC");
+			const ui8view dcData = section(compressed, position, dcCompressedSize, "DC");
+			const ui8view rleData = section(compressed, position, rleCompressedSize, "RLE");
+			// sections
+			m_unknown.resize(unknownSize);
+			if (0 < unknownSize)
+			{
+				inflateExactly(unknownData, m_unknown.data(), unknownSize, "unknown");
+			}
+			m_acValues.resize(acCount);
+			if (acCompression == DwaFormat::s_c_acHuffman)
+			{
+				m_huffmanDecoder.decode(acData, m_acValues.data(), acCount);
+			}
+			else if (acCompression == DwaFormat::s_c_acDeflate)
+			{
+				if (0 < acCount)
+				{
+					inflateExactly(acData, reinterpret_cast<ui8*>(m_acValues.data()), acCount * 2, "AC");
+				}
+			}
+			else
+			{
+				throw std::runtime_error("DWA chunk AC compression " + std::to_string(acCompression) + " is not valid (0 - Huffman, 1 - zlib expected).");
+			}
+			m_dcValues.resize(dcCount);
+			if (0 < dcCount)
+			{
+				m_dcPacked.resize(dcCount * 2);
+				inflateExactly(dcData, m_dcPacked.data(), dcCount * 2, "DC");
+				reversePredictorAndByteSplit(m_dcPacked.data(), reinterpret_cast<ui8*>(m_dcValues.data()), dcCount * 2);
+			}
+			m_rlePlanes.resize(rleSize);
+			if (0 < rleSize)
+			{
+				if (rleSize + rleSize / 64 + 16 < rleUncompressedSize)
+				{
+					throw std::runtime_error("DWA chunk RLE data of " + std::to_string(rleSize) + " bytes cannot be " + std::to_string(rleUncompressedSize) + " bytes long.");
+				}
+				m_rlePacked.resize(rleUncompressedSize);
+				inflateExactly(rleData, m_rlePacked.data(), rleUncompressedSize, "RLE");
+				runLengthDecode(ui8view(m_rlePacked.data(), rleUncompressedSize), m_rlePlanes.data(), rleSize, "RLE data of DWA chunk");
+			}
+			// channels => lines of chunk data
+			m_channelOffsets.resize(schemes.size());
+			std::size_t lineSize = 0;
+			for (std::size_t channel = 0; channel < schemes.size(); channel++)
+			{
+				m_channelOffsets[channel] = lineSize;
+				lineSize += exr2::consta::channel::channelDataTypeSizeInBytes(layout.channelDataTypes[channel]) * width;
+			}
+			m_acPosition = 0;
+			m_dcPosition = 0;
+			m_isDecoded.assign(schemes.size(), false);
+			for (const std::array<int32_t, 3>& cscSet : m_classifier.cscSets())
+			{
+				decodeLossyGroup(cscSet.data(), 3, layout, out, lineSize);
+			}
+			std::size_t unknownPosition = 0, rlePosition = 0;
+			for (std::size_t channel = 0; channel < schemes.size(); channel++)
+			{
+				if (m_isDecoded[channel])
+				{
+					continue;
+				}
+				const std::size_t sampleSize = exr2::consta::channel::channelDataTypeSizeInBytes(layout.channelDataTypes[channel]);
+				if (schemes[channel] == DwaScheme::LOSSY_DCT)
+				{
+					const int32_t group[1] = { int32_t(channel) };
+					decodeLossyGroup(group, 1, layout, out, lineSize);
+				}
+				else if (schemes[channel] == DwaScheme::RLE)
+				{
+					// planes of bytes: byte 0 of all samples, byte 1 of all samples, ...
+					const ui8* planes = m_rlePlanes.data() + rlePosition;
+					const std::size_t planeSize = width * height;
+					for (std::size_t line = 0; line < height; line++)
+					{
+						ui8* dst = out + line * lineSize + m_channelOffsets[channel];
+						for (std::size_t i = 0; i < width; i++)
+						{
+							for (std::size_t byte = 0; byte < sampleSize; byte++)
+							{
+								dst[sampleSize*i + byte] = planes[byte * planeSize + line * width + i];
+							}
+						}
+					}
+					rlePosition += sampleSize * planeSize;
+				}
+				else
+				{
+					for (std::size_t line = 0; line < height; line++)
+					{
+						std::memcpy(out + line * lineSize + m_channelOffsets[channel], m_unknown.data() + unknownPosition, sampleSize * width);
+						unknownPosition += sampleSize * width;
+					}
+				}
+			}
+			if (m_acPosition != acCount or m_dcPosition != dcCount)
+			{
+				throw std::runtime_error("DWA chunk AC / DC data does not match its lossy channels (AC " + std::to_string(m_acPosition) + " / " + std::to_string(acCount) + " values, DC " + std::to_string(m_dcPosition) + " / " + std::to_string(dcCount) + " values used).");
+			}
+		}
+
+		private:
+		DwaClassifier m_classifier;
+		std::vector<bool> m_isDecoded;
+		std::vector<std::size_t> m_channelOffsets;				// of each channel within line of chunk data
+		HuffmanDecoder m_huffmanDecoder;
+		std::vector<ui8> m_unknown;
+		std::vector<uint16_t> m_acValues;
+		std::vector<ui8> m_dcPacked;
+		std::vector<uint16_t> m_dcValues;
+		std::vector<ui8> m_rlePacked;
+		std::vector<ui8> m_rlePlanes;
+		std::size_t m_acPosition = 0;
+		std::size_t m_dcPosition = 0;
+		std::vector<uint16_t> m_blockRow;						// HALF samples of one row of blocks of each channel of DCT group, block by block
+		DctCoefficients m_dct;
+
+		/// <returns> view of (size) bytes of (compressed) at (position), (position) is moved past them </returns>
+		static ui8view section(const ui8view compressed, std::size_t& position, const uint64_t size, const std::string& name)
+		{
+			if (compressed.size() - position < size)
+			{
+				throw std::runtime_error("DWA chunk " + name + " data (" + std::to_string(size) + " bytes) is out of chunk data.");
+			}
+			const ui8view result = compressed.subspan(position, std::size_t(size));
+			position += std::size_t(size);
+			return result;
+		}
+
+		void inflateExactly(const ui8view zlibData, ui8* out, const std::size_t size, const std::string& name)
+		{
+			const std::size_t inflatedSize = zlibDecompress(zlibData, out, size);
+			if (inflatedSize != size)
+			{
+				throw std::runtime_error("DWA chunk " + name + " data decompresses to " + std::to_string(inflatedSize) + " bytes, " + std::to_string(size) + " bytes expected.");
+			}
+		}
+
+		/// <summary>
+		///		Copy AC coefficients of next block from m_acValues into (zigzag) (zeroed by caller), expanding runs of zeros.
+		/// </summary>
+		/// <returns> zigzag index of last non-zero coefficient (0 if block has DC only) </returns>
+		uint32_t unpackAcCoefficients(uint16_t* zigzag)
+		{
+			uint32_t lastNonZero = 0;
+			uint32_t index = 1;
+			while (index < 64)
+			{
+				if (m_acValues.size() <= m_acPosition)
+				{
+					throw std::runtime_error("DWA chunk AC data (" + std::to_string(m_acValues.size()) + " values) ends inside a block.");
+				}
+				const uint16_t value = m_acValues[m_acPosition++];
+				if (value == 0xFF00)					// end of block
+				{
+					index = 64;
+				}
+				else if ((value >> 8) == 0xFF)			// run of zeros
+				{
+					index += value & 0xFF;
+				}
+				else
+				{
+					zigzag[index] = value;
+					lastNonZero = index;
+					index++;
+				}
+			}
+			return lastNonZero;
+		}
+
+		/// <summary>
+		///		Decode LOSSY_DCT channels (group) of (componentsNum) channels (1, or R, G, B of a layer) into lines of chunk data (out),
+		///		taking their DC values from m_dcValues (plane of each channel) and AC values from m_acValues.
+		/// </summary>
+		void decodeLossyGroup(const int32_t* group, const uint32_t componentsNum, const ChunkLayout& layout, ui8* out, const std::size_t lineSize)
+		{
+			const std::vector<uint16_t>& toLinear = dwaToLinearTable();
+			const std::size_t width = layout.width, height = layout.height;
+			const std::size_t blocksX = (width + 7) / 8, blocksY = (height + 7) / 8;
+			for (uint32_t component = 0; component < componentsNum; component++)
+			{
+				const uint32_t channelDataType = layout.channelDataTypes[group[component]];
+				if (channelDataType != exr2::consta::channel::datatype::HALF and channelDataType != exr2::consta::channel::datatype::FLOAT)
+				{
+					throw std::runtime_error("DWA chunk lossy channel '" + layout.channelNames[group[component]] + "' is " + exr2::consta::channel::channelDataTypeName(channelDataType) + ", HALF or FLOAT expected.");
+				}
+			}
+			m_blockRow.resize(componentsNum * blocksX * 64);
+			alignas(16) float blocks[3][64];
+			uint16_t zigzag[64];
+			const float dcOnlyScale = 3.535536e-01f;
+			for (std::size_t blockY = 0; blockY < blocksY; blockY++)
+			{
+				for (std::size_t blockX = 0; blockX < blocksX; blockX++)
+				{
+					bool isConstant = true;
+					bool isDcOnly[3] = {};
+					for (uint32_t component = 0; component < componentsNum; component++)
+					{
+						std::fill(zigzag, zigzag + 64, uint16_t(0));
+						zigzag[0] = m_dcValues[m_dcPosition + component * blocksX * blocksY + blockY * blocksX + blockX];
+						const uint32_t lastNonZero = unpackAcCoefficients(zigzag);
+						float* block = blocks[component];
+						if (lastNonZero == 0)
+						{
+							isDcOnly[component] = true;
+							block[0] = exrHalf::halfToFloat(zigzag[0]) * dcOnlyScale * dcOnlyScale;
+							continue;
+						}
+						isConstant = false;
+						for (std::size_t i = 0; i < 64; i++)
+						{
+							block[i] = exrHalf::halfToFloat(zigzag[DwaFormat::s_c_zigzag[i]]);
+						}
+						dctInverse8x8(block, m_dct);
+					}
+					uint16_t* rowBlocks = m_blockRow.data() + blockX * 64;
+					if (isConstant)
+					{
+						// DC only blocks of all channels: one value per channel
+						if (componentsNum == 3)
+						{
+							csc709Inverse(blocks[0][0], blocks[1][0], blocks[2][0]);
+						}
+						for (uint32_t component = 0; component < componentsNum; component++)
+						{
+							std::fill(rowBlocks + component * blocksX * 64, rowBlocks + component * blocksX * 64 + 64, exrHalf::floatToHalf(blocks[component][0]));
+						}
+						continue;
+					}
+					for (uint32_t component = 0; component < componentsNum; component++)
+					{
+						if (isDcOnly[component])
+						{
+							std::fill(blocks[component] + 1, blocks[component] + 64, blocks[component][0]);
+						}
+					}
+					if (componentsNum == 3)
+					{
+						csc709Inverse(blocks[0], blocks[1], blocks[2], 64);
+					}
+					for (uint32_t component = 0; component < componentsNum; component++)
+					{
+						exrHalf::floatToHalf(blocks[component], rowBlocks + component * blocksX * 64, 64);
+					}
+				}
+				// row of blocks => lines, linearized
+				const std::size_t linesNum = std::min<std::size_t>(8, height - 8 * blockY);
+				for (uint32_t component = 0; component < componentsNum; component++)
+				{
+					const uint16_t* rowBlocks = m_blockRow.data() + component * blocksX * 64;
+					const bool isFloat = (layout.channelDataTypes[group[component]] == exr2::consta::channel::datatype::FLOAT);
+					for (std::size_t y = 0; y < linesNum; y++)
+					{
+						ui8* dst = out + (8 * blockY + y) * lineSize + m_channelOffsets[group[component]];
+						for (std::size_t x = 0; x < width; x++)
+						{
+							const uint16_t sample = toLinear[rowBlocks[(x / 8) * 64 + y * 8 + (x % 8)]];
+							if (isFloat)
+							{
+								const float value = exrHalf::halfToFloat(sample);
+								std::memcpy(dst + 4*x, &value, sizeof(value));
+							}
+							else
+							{
+								dst[2*x] = ui8(sample);
+								dst[2*x + 1] = ui8(sample >> 8);
+							}
+						}
+					}
+				}
+			}
+			m_dcPosition += componentsNum * blocksX * blocksY;
+			for (uint32_t component = 0; component < componentsNum; component++)
+			{
+				m_isDecoded[group[component]] = true;
+			}
+		}
+	};
+
+	/// <summary>
+	///		Compressor of DWAA and DWAB chunk data (version 2, default classifier rules of OpenEXR, zlib AC data: no Huffman encoder here).
+	///		Keeps its buffers between calls, so reuse one DwaEncoder per thread.
+	/// </summary>
+	class DwaEncoder : public ChunkEncoder
+	{
+		public:
+		/// <param name="compressionLevel"> - base quantization error x 100000 (higher - smaller output, larger error), 45 is default of OpenEXR </param>
+		explicit DwaEncoder(const float compressionLevel = 45.0f)
+			: m_quantizationError(compressionLevel / 100000.0f)
+		{
+			m_classifier.useDefaultRules();
+		}
+
+		/// <summary>
+		///		Compress (raw) chunk data of (layout) into (out): classify channels, encode lossy DCT groups, RLE and UNKNOWN channels
+		///		into sections, then write header, classifier rules and compressed sections.
+		/// </summary>
+		void encode(const ui8view raw, const ChunkLayout& layout, std::vector<ui8>& out) override
+		{
+			tryValidateLayout(layout, raw.size(), "DWA");
+			m_classifier.classify(layout);
+			const std::vector<DwaScheme>& schemes = m_classifier.schemes();
+			const std::size_t width = layout.width, height = layout.height;
+			m_channelOffsets.resize(schemes.size());
+			std::size_t lineSize = 0;
+			for (std::size_t channel = 0; channel < schemes.size(); channel++)
+			{
+				m_channelOffsets[channel] = lineSize;
+				lineSize += exr2::consta::channel::channelDataTypeSizeInBytes(layout.channelDataTypes[channel]) * width;
+			}
+			// channels => sections
+			m_unknown.clear();
+			m_acValues.clear();
+			m_dcValues.clear();
+			m_rlePlanes.clear();
+			m_isEncoded.assign(schemes.size(), false);
+			for (const std::array<int32_t, 3>& cscSet : m_classifier.cscSets())
+			{
+				encodeLossyGroup(cscSet.data(), 3, layout, raw.data(), lineSize);
+			}
+			for (std::size_t channel = 0; channel < schemes.size(); channel++)
+			{
+				if (m_isEncoded[channel])
+				{
+					continue;
+				}
+				const std::size_t sampleSize = exr2::consta::channel::channelDataTypeSizeInBytes(layout.channelDataTypes[channel]);
+				if (schemes[channel] == DwaScheme::LOSSY_DCT)
+				{
+					const int32_t group[1] = { int32_t(channel) };
+					encodeLossyGroup(group, 1, layout, raw.data(), lineSize);
+				}
+				else if (schemes[channel] == DwaScheme::RLE)
+				{
+					// planes of bytes: byte 0 of all samples, byte 1 of all samples, ...
+					for (std::size_t byte = 0; byte < sampleSize; byte++)
+					{
+						for (std::size_t line = 0; line < height; line++)
+						{
+							const ui8* src = raw.data() + line * lineSize + m_channelOffsets[channel];
+							for (std::size_t i = 0; i < width; i++)
+							{
+								m_rlePlanes.push_back(src[sampleSize*i + byte]);
+							}
+						}
+					}
+				}
+				else
+				{
+					for (std::size_t line = 0; line < height; line++)
+					{
+						const ui8* src = raw.data() + line * lineSize + m_channelOffsets[channel];
+						m_unknown.insert(m_unknown.end(), src, src + sampleSize * width);
+					}
+				}
+			}
+			// sections => chunk data
+			m_unknownPacked.clear();
+			if (not m_unknown.empty())
+			{
+				zlibCompress(ui8view(m_unknown.data(), m_unknown.size()), m_unknownPacked);
+			}
+			m_acPacked.clear();
+			if (not m_acValues.empty())
+			{
+				zlibCompress(ui8view(reinterpret_cast<const ui8*>(m_acValues.data()), m_acValues.size() * 2), m_acPacked);
+			}
+			m_dcPacked.clear();
+			if (not m_dcValues.empty())
+			{
+				m_predicted.resize(m_dcValues.size() * 2);
+				byteSplitAndPredictor(reinterpret_cast<const ui8*>(m_dcValues.data()), m_predicted.data(), m_predicted.size());
+				zlibCompress(ui8view(m_predicted.data(), m_predicted.size()), m_dcPacked);
+			}
+			m_rleRuns.clear();
+			m_rlePacked.clear();
+			if (not m_rlePlanes.empty())
+			{
+				runLengthEncode(ui8view(m_rlePlanes.data(), m_rlePlanes.size()), m_rleRuns);
+				zlibCompress(ui8view(m_rleRuns.data(), m_rleRuns.size()), m_rlePacked);
+			}
+			const uint64_t sizes[DwaFormat::s_c_sizesNum] =
+			{
+				DwaFormat::s_c_version, m_unknown.size(), m_unknownPacked.size(), m_acPacked.size(), m_dcPacked.size(),
+				m_rlePacked.size(), m_rleRuns.size(), m_rlePlanes.size(), m_acValues.size(), m_dcValues.size(), DwaFormat::s_c_acDeflate
+			};
+			out.clear();
+			for (const uint64_t size : sizes)
+			{
+				for (std::size_t byte = 0; byte < 8; byte++)
+				{
+					out.push_back(ui8(size >> (8*byte)));
+				}
+			}
+			m_classifier.writeRules(out);
+			out.insert(out.end(), m_unknownPacked.begin(), m_unknownPacked.end());
+			out.insert(out.end(), m_acPacked.begin(), m_acPacked.end());
+			out.insert(out.end(), m_dcPacked.begin(), m_dcPacked.end());
+			out.insert(out.end(), m_rlePacked.begin(), m_rlePacked.end());
+		}
+
+		private:
+		static constexpr uint8_t s_c_quantizationTableY[64] =		// JPEG luminance table, row by row, smallest value is 10
+		{
+			16, 11, 10, 16,  24,  40,  51,  61,
+			12, 12, 14, 19,  26,  58,  60,  55,
+			14, 13, 16, 24,  40,  57,  69,  56,
+			14, 17, 22, 29,  51,  87,  80,  62,
+			18, 22, 37, 56,  68, 109, 103,  77,
+			24, 35, 55, 64,  81, 104, 113,  92,
+			49, 64, 78, 87, 103, 121, 120, 101,
+			72, 92, 95, 98, 112, 100, 103,  99
+		};
+		static constexpr uint8_t s_c_quantizationTableCbCr[64] =	// JPEG chrominance table, row by row, smallest value is 17
+		{
+			17, 18, 24, 47, 99, 99, 99, 99,
+			18, 21, 26, 66, 99, 99, 99, 99,
+			24, 26, 56, 99, 99, 99, 99, 99,
+			47, 66, 99, 99, 99, 99, 99, 99,
+			99, 99, 99, 99, 99, 99, 99, 99,
+			99, 99, 99, 99, 99, 99, 99, 99,
+			99, 99, 99, 99, 99, 99, 99, 99,
+			99, 99, 99, 99, 99, 99, 99, 99
+		};
+
+		const float m_quantizationError;
+		DwaClassifier m_classifier;
+		std::vector<bool> m_isEncoded;
+		std::vector<std::size_t> m_channelOffsets;				// of each channel within line of chunk data
+		std::vector<ui8> m_unknown;
+		std::vector<ui8> m_unknownPacked;
+		std::vector<uint16_t> m_acValues;
+		std::vector<ui8> m_acPacked;
+		std::vector<uint16_t> m_dcValues;
+		std::vector<ui8> m_predicted;
+		std::vector<ui8> m_dcPacked;
+		std::vector<ui8> m_rlePlanes;
+		std::vector<ui8> m_rleRuns;
+		std::vector<ui8> m_rlePacked;
+		DctCoefficients m_dct;
+
+		/// <summary>
+		///		Append 63 AC coefficients of block (zigzag) to m_acValues, replacing runs of zeros with 0xFFnn and trailing zeros with 0xFF00.
+		/// </summary>
+		void packAcCoefficients(const uint16_t* zigzag)
+		{
+			uint32_t zerosNum = 0;
+			for (uint32_t index = 1; index < 64; index++)
+			{
+				if (zigzag[index] == 0)
+				{
+					zerosNum++;
+					continue;
+				}
+				if (zerosNum == 1)
+				{
+					m_acValues.push_back(0);
+				}
+				else if (1 < zerosNum)
+				{
+					m_acValues.push_back(uint16_t(0xFF00 | zerosNum));
+				}
+				zerosNum = 0;
+				m_acValues.push_back(zigzag[index]);
+			}
+			if (0 < zerosNum)
+			{
+				m_acValues.push_back(0xFF00);
+			}
+		}
+
+		/// <summary>
+		///		Encode LOSSY_DCT channels (group) of (componentsNum) channels (1, or R, G, B of a layer) of lines of chunk data (raw),
+		///		appending their DC values to m_dcValues (plane of each channel) and AC values to m_acValues. Partial blocks repeat last column and line.
+		/// </summary>
+		void encodeLossyGroup(const int32_t* group, const uint32_t componentsNum, const ChunkLayout& layout, const ui8* raw, const std::size_t lineSize)
+		{
+			const std::vector<uint16_t>& toNonlinear = dwaToNonlinearTable();
+			const std::size_t width = layout.width, height = layout.height;
+			const std::size_t blocksX = (width + 7) / 8, blocksY = (height + 7) / 8;
+			const std::size_t dcStart = m_dcValues.size();
+			m_dcValues.resize(dcStart + componentsNum * blocksX * blocksY);
+			alignas(16) float blocks[3][64];
+			uint16_t zigzag[64];
+			for (std::size_t blockY = 0; blockY < blocksY; blockY++)
+			{
+				for (std::size_t blockX = 0; blockX < blocksX; blockX++)
+				{
+					for (uint32_t component = 0; component < componentsNum; component++)
+					{
+						const bool isFloat = (layout.channelDataTypes[group[component]] == exr2::consta::channel::datatype::FLOAT);
+						for (std::size_t y = 0; y < 8; y++)
+						{
+							const std::size_t line = std::min(8 * blockY + y, height - 1);
+							const ui8* src = raw + line * lineSize + m_channelOffsets[group[component]];
+							for (std::size_t x = 0; x < 8; x++)
+							{
+								const std::size_t column = std::min(8 * blockX + x, width - 1);
+								uint16_t sample = 0;
+								if (isFloat)
+								{
+									float value = 0;
+									std::memcpy(&value, src + 4*column, sizeof(value));
+									sample = exrHalf::floatToHalf(value);
+								}
+								else
+								{
+									sample = uint16_t(src[2*column] | (src[2*column + 1] << 8));
+								}
+								blocks[component][8*y + x] = exrHalf::halfToFloat(toNonlinear[sample]);
+							}
+						}
+					}
+					if (componentsNum == 3)
+					{
+						csc709Forward(blocks[0], blocks[1], blocks[2], 64);
+					}
+					for (uint32_t component = 0; component < componentsNum; component++)
+					{
+						float* block = blocks[component];
+						dctForward8x8(block, m_dct);
+						const uint8_t* table = (componentsNum == 3 and 0 < component) ? s_c_quantizationTableCbCr : s_c_quantizationTableY;
+						const float tableMin = (componentsNum == 3 and 0 < component) ? 17.0f : 10.0f;
+						for (std::size_t i = 0; i < 64; i++)
+						{
+							zigzag[DwaFormat::s_c_zigzag[i]] = dwaQuantize(block[i], m_quantizationError * float(table[i]) / tableMin);
+						}
+						m_dcValues[dcStart + component * blocksX * blocksY + blockY * blocksX + blockX] = zigzag[0];
+						packAcCoefficients(zigzag);
+					}
+				}
+			}
+			for (uint32_t component = 0; component < componentsNum; component++)
+			{
+				m_isEncoded[group[component]] = true;
+			}
+		}
+	};
+}
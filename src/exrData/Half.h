@@ -0,0 +1,205 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// F16C (x86 half <-> float conversion instructions):
+//	GCC / Clang on x86 - kernel is compiled for F16C with target attribute and selected at run time, if CPU supports it;
+//	MSVC - kernel is used when compiled with /arch:AVX2 (F16C is a part of every AVX2 CPU).
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	#define EXRHALF_F16C_RUNTIME 1
+	#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(__AVX2__)
+	#define EXRHALF_F16C_ALWAYS 1
+	#include <immintrin.h>
+#endif
+
+namespace exrHalf
+{
+	/// <summary>
+	///		Lookup tables converting IEEE 754 binary16 (OpenEXR HALF) to binary32 bits without branches:
+	///		floatBits = mantissa[offset[h >> 10] + (h & 0x3FF)] + exponent[h >> 10]
+	///		(denormals, infinities and NaNs included). Built at compile time.
+	/// </summary>
+	struct HalfToFloatTable
+	{
+		std::array<uint32_t, 2048> mantissa = {};
+		std::array<uint32_t, 64> exponent = {};
+		std::array<uint16_t, 64> offset = {};
+		constexpr HalfToFloatTable()
+		{
+			// mantissa: [1; 1023] = denormals (normalized here), [1024; 2047] = normals
+			for (uint32_t i = 1; i < 1024; i++)
+			{
+				uint32_t m = i << 13;
+				uint32_t e = 0;
+				while ((m & 0x00800000) == 0)
+				{
+					e -= 0x00800000;
+					m <<= 1;
+				}
+				m &= ~uint32_t(0x00800000);
+				e += 0x38800000;
+				mantissa[i] = m | e;
+			}
+			for (uint32_t i = 1024; i < 2048; i++)
+			{
+				mantissa[i] = 0x38000000 + ((i - 1024) << 13);
+			}
+			// exponent: index = sign bit + 5 exponent bits
+			for (uint32_t i = 1; i < 31; i++)
+			{
+				exponent[i] = i << 23;
+				exponent[i + 32] = 0x80000000 + (i << 23);
+			}
+			exponent[31] = 0x47800000;		// infinity / NaN
+			exponent[32] = 0x80000000;		// -0 / negative denormals
+			exponent[63] = 0xC7800000;
+			for (uint32_t i = 0; i < 64; i++)
+			{
+				offset[i] = (i == 0 or i == 32) ? 0 : 1024;
+			}
+		}
+	};
+	static constexpr HalfToFloatTable s_c_halfToFloatTable = HalfToFloatTable();
+
+	/// <summary> Convert HALF (bits of IEEE 754 binary16) to float, table-based. </summary>
+	inline float halfToFloat(const uint16_t half)
+	{
+		const uint32_t exponentIndex = half >> 10;
+		const uint32_t bits = s_c_halfToFloatTable.mantissa[s_c_halfToFloatTable.offset[exponentIndex] + (half & 0x03FF)] + s_c_halfToFloatTable.exponent[exponentIndex];
+		float value = 0;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	/// <summary> Convert (count) HALF samples (little-endian, any alignment) to float, table-based. </summary>
+	inline void halfToFloatScalar(const uint8_t* src, float* dst, const std::size_t count)
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			uint16_t half = 0;
+			std::memcpy(&half, src + 2*i, sizeof(half));
+			dst[i] = halfToFloat(half);
+		}
+	}
+
+	#if EXRHALF_F16C_RUNTIME || EXRHALF_F16C_ALWAYS
+	#if EXRHALF_F16C_RUNTIME
+	__attribute__((target("avx,f16c")))
+	#endif
+	inline void halfToFloatF16C(const uint8_t* src, float* dst, const std::size_t count)
+	{
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m128i halfs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2*i));
+			_mm256_storeu_ps(dst + i, _mm256_cvtph_ps(halfs));
+		}
+		halfToFloatScalar(src + 2*i, dst + i, count - i);
+	}
+	#endif
+
+	/// <returns> true if halfToFloat(src, dst, count) uses F16C instructions on this CPU </returns>
+	inline bool isF16CUsed()
+	{
+		#if EXRHALF_F16C_RUNTIME
+		static const bool s_c_isF16CSupported = __builtin_cpu_supports("f16c") and __builtin_cpu_supports("avx");
+		return s_c_isF16CSupported;
+		#elif EXRHALF_F16C_ALWAYS
+		return true;
+		#else
+		return false;
+		#endif
+	}
+
+	/// <summary>
+	///		Convert run of (count) HALF samples (little-endian, as stored in .exr, any alignment) to float:
+	///		8 samples per instruction with F16C if CPU supports it, table-based otherwise.
+	/// </summary>
+	inline void halfToFloat(const uint8_t* src, float* dst, const std::size_t count)
+	{
+		#if EXRHALF_F16C_RUNTIME || EXRHALF_F16C_ALWAYS
+		if (isF16CUsed())
+		{
+			halfToFloatF16C(src, dst, count);
+			return;
+		}
+		#endif
+		halfToFloatScalar(src, dst, count);
+	}
+
+	/// <summary>
+	///		Convert float to HALF (bits of IEEE 754 binary16): rounded to nearest, ties to even (as OpenEXR half),
+	///		too large values to infinity, NaN to quiet NaN.
+	/// </summary>
+	inline uint16_t floatToHalf(const float value)
+	{
+		uint32_t bits = 0;
+		std::memcpy(&bits, &value, sizeof(bits));
+		const uint16_t sign = uint16_t((bits >> 16) & 0x8000);
+		const uint32_t absBits = bits & 0x7FFFFFFF;
+		if (0x7F800000 <= absBits)
+		{
+			return (absBits == 0x7F800000) ? uint16_t(sign | 0x7C00) : uint16_t(sign | 0x7E00 | ((absBits >> 13) & 0x03FF));
+		}
+		if (0x477FF000 <= absBits)		// >= 65520 rounds to infinity
+		{
+			return uint16_t(sign | 0x7C00);
+		}
+		if (absBits < 0x38800000)		// < 2^-14: HALF denormal or zero, in units of 2^-24
+		{
+			if (absBits < 0x33000000)	// <= 2^-25 rounds to zero
+			{
+				return sign;
+			}
+			const uint32_t mantissa = (absBits & 0x007FFFFF) | 0x00800000;
+			const uint32_t shift = 126 - (absBits >> 23);
+			const uint32_t rest = mantissa & ((1u << shift) - 1), half = 1u << (shift - 1);
+			uint32_t result = mantissa >> shift;
+			result += (half < rest or (rest == half and (result & 1) != 0)) ? 1 : 0;
+			return uint16_t(sign | result);
+		}
+		uint32_t result = (absBits - 0x38000000) >> 13;
+		const uint32_t rest = absBits & 0x1FFF;
+		result += (0x1000 < rest or (rest == 0x1000 and (result & 1) != 0)) ? 1 : 0;
+		return uint16_t(sign | result);
+	}
+
+	#if EXRHALF_F16C_RUNTIME || EXRHALF_F16C_ALWAYS
+	#if EXRHALF_F16C_RUNTIME
+	__attribute__((target("avx,f16c")))
+	#endif
+	inline void floatToHalfF16C(const float* src, uint16_t* dst, const std::size_t count)
+	{
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+		}
+		for (; i < count; i++)
+		{
+			dst[i] = floatToHalf(src[i]);
+		}
+	}
+	#endif
+
+	/// <summary>
+	///		Convert (count) floats to HALF bits: 8 values per instruction with F16C if CPU supports it, one by one otherwise.
+	/// </summary>
+	inline void floatToHalf(const float* src, uint16_t* dst, const std::size_t count)
+	{
+		#if EXRHALF_F16C_RUNTIME || EXRHALF_F16C_ALWAYS
+		if (isF16CUsed())
+		{
+			floatToHalfF16C(src, dst, count);
+			return;
+		}
+		#endif
+		for (std::size_t i = 0; i < count; i++)
+		{
+			dst[i] = floatToHalf(src[i]);
+		}
+	}
+}
@@ -0,0 +1,125 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "TemplateConcepts.h"
+
+namespace exrPixeldata
+{
+	/// <summary>
+	///		Fixed-size heap array, which first element is aligned to (s_c_alignmentBytes) bytes,
+	///		so SIMD loads/stores over the array never cross a cache line at its start.
+	///		Elements are not initialized on allocation (same as new T[n] for arithmetic T).
+	/// </summary>
+	template <templateConcept::numerical::StdNumeric T>
+	class AlignedArray
+	{
+		public:
+		static const std::size_t s_c_alignmentBytes = 64;	// cache line size / AVX-512 register size
+
+		AlignedArray() {}
+		explicit AlignedArray(const std::size_t size)
+			: m_size(size)
+		{
+			if (m_size != 0)
+			{
+				m_data = static_cast<T*>(::operator new(m_size * sizeof(T), std::align_val_t(s_c_alignmentBytes)));
+			}
+		}
+		AlignedArray(const AlignedArray<T>& other)
+			: AlignedArray(other.m_size)
+		{
+			if (m_size != 0)
+			{
+				std::memcpy(m_data, other.m_data, m_size * sizeof(T));
+			}
+		}
+		AlignedArray(AlignedArray<T>&& other) noexcept
+			: m_data(other.m_data), m_size(other.m_size)
+		{
+			other.m_data = nullptr;
+			other.m_size = 0;
+		}
+		AlignedArray<T>& operator=(AlignedArray<T> other) noexcept		// copy-and-swap: serves both copy and move assignment
+		{
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+			return *this;
+		}
+		~AlignedArray()
+		{
+			if (m_data != nullptr)
+			{
+				::operator delete(m_data, std::align_val_t(s_c_alignmentBytes));
+			}
+		}
+		T* data() { return m_data; }
+		const T* data() const { return m_data; }
+		std::size_t size() const { return m_size; }
+		T& operator[](const std::size_t index) { return m_data[index]; }
+		const T& operator[](const std::size_t index) const { return m_data[index]; }
+
+		private:
+		T* m_data = nullptr;
+		std::size_t m_size = 0;
+	};
+
+	/// <summary>
+	///		Planar (structure-of-arrays) storage of decoded image samples:
+	///		one contiguous, aligned array per channel, each array stores (rows x columns) samples row by row.
+	///		So, sample of pixel [row, col] of channel [ch] is at channelData(ch)[row * columnsNum() + col].
+	///		Channels are indexed in the same order as they are listed in chlist attribute (= order of channels in scanline).
+	/// </summary>
+	template <templateConcept::numerical::StdNumeric T>
+	class ImageBuffer
+	{
+		public:
+		ImageBuffer() {}
+		ImageBuffer(const uint32_t rowsNum, const uint32_t columnsNum, const uint32_t channelsNum)
+			: m_rowsNum(rowsNum), m_columnsNum(columnsNum)
+		{
+			m_channels.reserve(channelsNum);
+			for (uint32_t i = 0; i < channelsNum; i++)
+			{
+				m_channels.emplace_back(std::size_t(rowsNum) * columnsNum);
+			}
+		}
+		uint32_t rowsNum() const { return m_rowsNum; }
+		uint32_t columnsNum() const { return m_columnsNum; }
+		uint32_t channelsNum() const { return uint32_t(m_channels.size()); }
+		/// <returns> number of bytes taken by samples of all channels </returns>
+		std::size_t sizeInBytes() const { return std::size_t(m_rowsNum) * m_columnsNum * sizeof(T) * m_channels.size(); }
+
+		T* channelData(const uint32_t channelIndex) { return m_channels[channelIndex].data(); }
+		const T* channelData(const uint32_t channelIndex) const { return m_channels[channelIndex].data(); }
+		/// <returns> pointer to first sample of (row) in (channelIndex) channel array, samples of the row are contiguous </returns>
+		T* rowData(const uint32_t channelIndex, const uint32_t row) { return channelData(channelIndex) + std::size_t(row) * m_columnsNum; }
+		const T* rowData(const uint32_t channelIndex, const uint32_t row) const { return channelData(channelIndex) + std::size_t(row) * m_columnsNum; }
+		T value(const uint32_t channelIndex, const uint32_t row, const uint32_t column) const
+		{
+			tryValidateIndexes(channelIndex, row, column);
+			return rowData(channelIndex, row)[column];
+		}
+
+		private:
+		uint32_t m_rowsNum = 0, m_columnsNum = 0;
+		std::vector<AlignedArray<T>> m_channels;
+
+		void tryValidateIndexes(const uint32_t channelIndex, const uint32_t row, const uint32_t column) const
+		{
+			if (channelsNum() <= channelIndex or m_rowsNum <= row or m_columnsNum <= column)
+			{
+				throw std::invalid_argument
+				(
+					"ImageBuffer: (channelIndex, row, column) = (" + std::to_string(channelIndex) + ", " + std::to_string(row) + ", " + std::to_string(column) + ") "
+					"is out of valid range [0; " + std::to_string(channelsNum()) + "), [0; " + std::to_string(m_rowsNum) + "), [0; " + std::to_string(m_columnsNum) + ")"
+				);
+			}
+		}
+	};
+}
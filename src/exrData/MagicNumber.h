@@ -1,12 +1,13 @@
 #pragma once
 #include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <vector>
 #include "utils.h"
 
 namespace exr
 {
-	static int32_t magicNumber(const std::vector<ui8>& filebytes)
+	static int32_t magicNumber(const ui8view filebytes)
 	{
 		if (filebytes.size() < 4)
 		{
@@ -20,7 +21,7 @@ namespace exr
 			It allows file readers to distinguish OpenEXR files from other files, 
 			since the first four bytes of an OpenEXR file are always 0x76, 0x2f, 0x31 and 0x01.
 		*/
-		std::vector<uint8_t> exr_magicBytes = utils::slice((std::vector<uint8_t>)filebytes, 0, 3);
+		const ui8view exr_magicBytes = filebytes.first(4);
 		int32_t exr_magicNum = 0;
 		// pack 4 uint8_t into uint32_t - method 1: tested on little-endian, untested on big-endian systems
 		std::memcpy(&exr_magicNum, exr_magicBytes.data(), exr_magicBytes.size());	// safe & portable
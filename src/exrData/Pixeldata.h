@@ -1,6 +1,23 @@
 #pragma once
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "exrData/Half.h"
+#include "exrData/ImageBuffer.h"
+#include "exrData/Compression.h"
+#include "ThreadPool.h"
+#include "types.h"
 
 namespace exrPixeldata
 {
@@ -84,124 +101,247 @@ namespace exrPixeldata
 		
 		* Note: inside scanline, pixel channels are organized in the same order as they're listed in chlist attribute value.
 	*/
-	// stores exrFile.pixelData.RegularScanline[i].channel[i].pixel[i]
-	template <Unsigned32OrFloat channelCType32>
-	class Channel_i_ofPixel
+
+	/// <summary>
+	///		Layout of samples of one scanline as stored in file (uncompressed): channel after channel (ordered as in chlist),
+	///		each channel is (pixelsNum) samples of its own type (UINT, HALF or FLOAT), so sample size differs between channels.
+	///		Byte offsets of channels within scanline are computed once per file.
+	/// </summary>
+	class ScanlineLayout
 	{
 		public:
-		Channel_i_ofPixel(const std::vector<ui8>& filebytes, const uint32_t valueFirstByteIndex)
-			: m_channelAndByteRange(utils::IndexedValue<channelCType32>(0,0,0))
+		ScanlineLayout() {}
+		/// <param name="channelNames"> - name of each channel, ordered as in chlist </param>
+		/// <param name="channelDataTypes"> - exr2::consta::channel::datatype of each channel, ordered as in chlist </param>
+		/// <param name="pixelsNum"> - number of pixels in scanline (= number of image columns) </param>
+		ScanlineLayout(const std::vector<std::string>& channelNames, const std::vector<uint32_t>& channelDataTypes, const uint32_t pixelsNum)
+			: m_channelNames(channelNames), m_channelDataTypes(channelDataTypes), m_pixelsNum(pixelsNum)
 		{
-			//tryValidateChannelValueType<channelCType32>();
-			uint32_t valueLastByteIndex = valueFirstByteIndex + sizeof(channelCType32)-1;
-			channelCType32 value;
-			//if ((channelCType4Bytes == unsigned int) or (channelCType4Bytes == uint32_t))
-			if (std::is_same_v<channelCType32, unsigned int> or std::is_same_v<channelCType32, uint32_t>)
+			if (m_channelDataTypes.empty())
 			{
-				value = exrTypes::readUint32((filebytes.begin()+valueFirstByteIndex)._Ptr);
+				throw std::invalid_argument("ScanlineLayout: image must have at least 1 channel");
 			}
-			else if (std::is_same_v<channelCType32, float>)
+			if (m_channelNames.size() != m_channelDataTypes.size())
 			{
-				value = exrTypes::readFloat32((filebytes.begin()+valueFirstByteIndex)._Ptr);
+				throw std::invalid_argument("ScanlineLayout: number of channel names and of channel data types must be equal");
 			}
-			m_channelAndByteRange = utils::IndexedValue(valueFirstByteIndex, valueLastByteIndex, value);
+			uint64_t offset = 0;
+			for (const uint32_t channelDataType : m_channelDataTypes)
+			{
+				const uint32_t sampleSize = exr2::consta::channel::channelDataTypeSizeInBytes(channelDataType);
+				m_sampleSizes.push_back(sampleSize);
+				m_channelOffsets.push_back(uint32_t(offset));
+				offset += uint64_t(sampleSize) * m_pixelsNum;
+			}
+			if (UINT32_MAX < offset)
+			{
+				throw std::runtime_error("scanline of " + std::to_string(m_pixelsNum) + " pixels and " + std::to_string(channelsNum()) + " channels is larger than 4 GB.");
+			}
+			m_sizeInBytes = uint32_t(offset);
 		}
-		Channel_i_ofPixel(const Channel_i_ofPixel<channelCType32>& other)
-			: m_channelAndByteRange(other.m_channelAndByteRange)
+		uint32_t channelsNum() const { return uint32_t(m_channelDataTypes.size()); }
+		uint32_t pixelsNum() const { return m_pixelsNum; }
+		uint32_t channelDataType(const uint32_t channelIndex) const { return m_channelDataTypes[channelIndex]; }
+		uint32_t sampleSizeInBytes(const uint32_t channelIndex) const { return m_sampleSizes[channelIndex]; }
+		const std::vector<std::string>& channelNames() const { return m_channelNames; }
+		const std::vector<uint32_t>& channelDataTypes() const { return m_channelDataTypes; }
+		/// <returns> offset of first sample of (channelIndex) channel from first byte of scanline data </returns>
+		uint32_t channelOffsetInBytes(const uint32_t channelIndex) const { return m_channelOffsets[channelIndex]; }
+		/// <returns> size of samples of all channels of the scanline </returns>
+		uint32_t sizeInBytes() const { return m_sizeInBytes; }
+
+		private:
+		std::vector<std::string> m_channelNames;
+		std::vector<uint32_t> m_channelDataTypes;
+		std::vector<uint32_t> m_sampleSizes;
+		std::vector<uint32_t> m_channelOffsets;
+		uint32_t m_pixelsNum = 0;
+		uint32_t m_sizeInBytes = 0;
+	};
+
+	/// <returns> (value) converted to (OutT), clamped to [0; max] if (OutT) is unsigned </returns>
+	template <Unsigned32OrFloat OutT>
+	inline OutT floatToOutType(const float value)
+	{
+		if constexpr (std::is_floating_point_v<OutT>)
 		{
-			//tryValidateChannelValueType<channelCType32>();
+			return OutT(value);
 		}
-		Channel_i_ofPixel<channelCType32>& operator=(const Channel_i_ofPixel<channelCType32>& other)
+		else
 		{
-			if (this != &other)
+			if (not (0.0f < value))			// negative, 0 or NaN
 			{
-				m_channelAndByteRange = other.m_channelAndByteRange;
+				return 0;
 			}
-			return *this;
+			return float(std::numeric_limits<OutT>::max()) <= value ? std::numeric_limits<OutT>::max() : OutT(value);
 		}
-		channelCType32 value() const { return m_channelAndByteRange.value(); }
-		uint32_t firstByteIndex() const { return m_channelAndByteRange.firstByteIndex(); }
-		uint32_t lastByteIndex() const { return m_channelAndByteRange.lastByteIndex(); }
-		std::string toString(const uint8_t tabsNum = 0, const bool includeByteIndexes = false) const
+	}
+
+	/// <summary>
+	///		Convert run of (samplesNum) samples of (srcDataType) channel (as stored in file, little-endian, any alignment) into (dst).
+	///		Specialised at compile time for each (srcDataType, OutT) pair:
+	///			same type - memcpy, HALF -> float - vectorised exrHalf kernel, other pairs - converting loop
+	///			(float -> unsigned is clamped to [0; UINT32_MAX], NaN -> 0).
+	/// </summary>
+	template <uint32_t srcDataType, Unsigned32OrFloat OutT>
+	void decodeChannelRun(const ui8* src, OutT* dst, const uint32_t samplesNum)
+	{
+		if constexpr (srcDataType == exr2::consta::channel::datatype::HALF)
 		{
-			if (!includeByteIndexes)
-				return utils::tabs(tabsNum) + std::string(value());
-			else 
-				return utils::tabs(tabsNum) + "[0x" + utils::hex(firstByteIndex(),4) + "; 0x" + utils::hex(lastByteIndex(),4) + "] " + std::to_string(value());
+			if constexpr (std::is_same_v<OutT, float>)
+			{
+				exrHalf::halfToFloat(src, dst, samplesNum);
+			}
+			else
+			{
+				for (uint32_t i = 0; i < samplesNum; i++)
+				{
+					dst[i] = floatToOutType<OutT>(exrHalf::halfToFloat(uint16_t(src[2*i] | (src[2*i+1] << 8))));
+				}
+			}
 		}
-	
-		private:
-		utils::IndexedValue<channelCType32> m_channelAndByteRange;
-	
-	};
-	
-	// stores exrFile.pixelData.RegularScanline[i].channel[i]
-	template <Unsigned32OrFloat channelCType32>
-	class Channel_i_ofScanlinePixels
+		else
+		{
+			using SrcT = std::conditional_t<srcDataType == exr2::consta::channel::datatype::FLOAT, float, uint32_t>;
+			if constexpr (std::is_same_v<SrcT, OutT>)
+			{
+				std::memcpy(dst, src, std::size_t(samplesNum) * sizeof(OutT));
+			}
+			else
+			{
+				for (uint32_t i = 0; i < samplesNum; i++)
+				{
+					SrcT sample;
+					std::memcpy(&sample, src + i * sizeof(SrcT), sizeof(SrcT));
+					if constexpr (std::is_floating_point_v<SrcT>)
+					{
+						dst[i] = floatToOutType<OutT>(sample);
+					}
+					else
+					{
+						dst[i] = OutT(sample);
+					}
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	///		Per-file decoding plan: ScanlineLayout + kernel of each channel, chosen once from chlist data types,
+	///		so decoding of a scanline is one indirect call per channel run, with no switch per channel or sample.
+	///		(OutT) is the type all channels are converted to (e.g. float for UINT, HALF and FLOAT channels).
+	/// </summary>
+	/// <how-to-use>
+	///		const ScanlineDecoder<float> decoder(ScanlineLayout(chlist.channelsNames(), chlist.channelDataTypes(), imageColumnsNum));
+	///		decoder.decodeScanline(scanlineData, image, imageRow);
+	/// </how-to-use>
+	template <Unsigned32OrFloat OutT>
+	class ScanlineDecoder
 	{
 		public:
-		Channel_i_ofScanlinePixels() { /*tryValidateChannelValueType<channelCType32>();*/ }
-		Channel_i_ofScanlinePixels(const std::vector<ui8>& filebytes, const uint32_t pixeldataFirstByteIndex, const uint32_t scanlinePixelsNum)
+		using ChannelRunKernel = void (*)(const ui8* src, OutT* dst, const uint32_t samplesNum);
+
+		ScanlineDecoder() {}
+		explicit ScanlineDecoder(const ScanlineLayout& layout)
+			: m_layout(layout)
 		{
-			//tryValidateChannelValueType<channelCType32>();
-			uint32_t currentByteIndex = pixeldataFirstByteIndex;
-			for (uint32_t i = 0; i < scanlinePixelsNum; i++)
+			m_kernels.reserve(m_layout.channelsNum());
+			for (uint32_t ch = 0; ch < m_layout.channelsNum(); ch++)
 			{
-				Channel_i_ofPixel<channelCType32> channelOfPixel_copy = Channel_i_ofPixel<channelCType32>(filebytes, currentByteIndex);
-				m_channel_i_ofScanlinePixels.push_back(channelOfPixel_copy);
-				currentByteIndex += 4;	// because Channel_i_ofPixel requires channelCType4Bytes, not channelCType_?_Bytes
+				m_kernels.push_back(kernelFor(m_layout.channelDataType(ch)));
 			}
 		}
-		Channel_i_ofScanlinePixels(const Channel_i_ofScanlinePixels<channelCType32> &other)
-			: m_channel_i_ofScanlinePixels(other.m_channel_i_ofScanlinePixels)
+		const ScanlineLayout& layout() const { return m_layout; }
+
+		/// <summary> Convert samples of (channelIndex) channel of one scanline (scanlineData = first byte of scanline samples) into (dst). </summary>
+		void decodeChannelRun(const uint32_t channelIndex, const ui8* scanlineData, OutT* dst) const
 		{
-			//tryValidateChannelValueType<channelCType32>();
+			m_kernels[channelIndex](scanlineData + m_layout.channelOffsetInBytes(channelIndex), dst, m_layout.pixelsNum());
 		}
-		void tryValidatePixelColumnIndex(const uint32_t pixelIndex) const
+		/// <summary> Convert samples of all channels of one scanline into (imageRow) row of corresponding (image) channel arrays. </summary>
+		void decodeScanline(const ui8* scanlineData, ImageBuffer<OutT>& image, const uint32_t imageRow) const
 		{
-			if (pixelIndex < 0 or (scanlinePixelsNum()-1) < pixelIndex)
+			for (uint32_t ch = 0; ch < m_layout.channelsNum(); ch++)
 			{
-				throw s_c_invalidPixelColumnIndex;
+				decodeChannelRun(ch, scanlineData, image.rowData(ch, imageRow));
 			}
 		}
-		Channel_i_ofScanlinePixels<channelCType32>& operator=(const Channel_i_ofScanlinePixels<channelCType32>& other)
+
+		/// <returns> kernel converting run of samples of (channelDataType) channel into (OutT) samples </returns>
+		static ChannelRunKernel kernelFor(const uint32_t channelDataType)
 		{
-			if (this != &other)
+			switch (channelDataType)
 			{
-				m_channel_i_ofScanlinePixels.clear();
-				for (const Channel_i_ofPixel<channelCType32> channel_i_ofScanline : other.m_channel_i_ofScanlinePixels)
-				{
-					m_channel_i_ofScanlinePixels.push_back(channel_i_ofScanline);
-				}
+				case exr2::consta::channel::datatype::UINT:		return &exrPixeldata::decodeChannelRun<exr2::consta::channel::datatype::UINT, OutT>;
+				case exr2::consta::channel::datatype::HALF:		return &exrPixeldata::decodeChannelRun<exr2::consta::channel::datatype::HALF, OutT>;
+				case exr2::consta::channel::datatype::FLOAT:	return &exrPixeldata::decodeChannelRun<exr2::consta::channel::datatype::FLOAT, OutT>;
+				default: throw std::invalid_argument("ScanlineDecoder: channel data type " + std::to_string(channelDataType) + " is not valid (valid: UINT, HALF, FLOAT)");
 			}
-			return *this;
 		}
-		Channel_i_ofPixel<channelCType32> indexedChannelByPixelIndex(const uint32_t pixelIndex) const
+
+		private:
+		ScanlineLayout m_layout;
+		std::vector<ChannelRunKernel> m_kernels;		// index = channel index (ordered as in chlist)
+	};
+
+	/// <summary>
+	///		Get uncompressed data of chunk (scanline block or tile): decompress (data) into (rawBuffer) or,
+	///		if chunk stores data uncompressed (compression did not make it smaller than (rawSizeInBytes)), point to (data).
+	///		Decoder of (compressionValue) is taken from (decoders) of calling thread, throws logic_error if compression is not supported.
+	/// </summary>
+	/// <param name="layout"> - pixels of uncompressed chunk data (empty for deep chunk data) </param>
+	/// <returns> pointer to first byte of uncompressed chunk data (rawSizeInBytes bytes) </returns>
+	inline const ui8* decompressChunkData(const ui8view data, const uint32_t rawSizeInBytes, const exrCompression::ChunkLayout& layout, const exr2::consta::s_compression::value compressionValue, exrCompression::ChunkDecoders& decoders, std::vector<ui8>& rawBuffer)
+	{
+		if (rawSizeInBytes <= data.size())
 		{
-			tryValidatePixelColumnIndex(pixelIndex);
-			return m_channel_i_ofScanlinePixels[pixelIndex];
+			return data.data();
 		}
-		channelCType32 channelValueByPixelIndex(const uint32_t pixelIndex) const
+		rawBuffer.resize(rawSizeInBytes);
+		decoders.decoder(compressionValue).decode(data, layout, rawBuffer.data(), rawBuffer.size());
+		return rawBuffer.data();
+	}
+
+	// indexes of pixel channels in array returned by rgbaChannelIndexes()
+	static const uint32_t s_c_rgbaR = 0, s_c_rgbaG = 1, s_c_rgbaB = 2, s_c_rgbaA = 3;
+
+	/// <returns> [s_c_rgbaR, s_c_rgbaG, s_c_rgbaB, s_c_rgbaA] = index of "R", "G", "B", "A" channel within (channelNames), -1 if there is no such channel </returns>
+	inline std::array<int32_t, 4> rgbaChannelIndexes(const std::vector<std::string>& channelNames)
+	{
+		const std::array<std::string, 4> rgbaNames = { "R", "G", "B", "A" };
+		std::array<int32_t, 4> indexes = { -1, -1, -1, -1 };
+		for (uint32_t i = 0; i < rgbaNames.size(); i++)
 		{
-			tryValidatePixelColumnIndex(pixelIndex);
-			return m_channel_i_ofScanlinePixels[pixelIndex].value();
+			const auto found = std::find(channelNames.begin(), channelNames.end(), rgbaNames[i]);
+			if (found != channelNames.end())
+			{
+				indexes[i] = int32_t(found - channelNames.begin());
+			}
 		}
-		uint32_t firstByteIndex() const { return m_channel_i_ofScanlinePixels[0].firstByteIndex(); }	// first byte index of first scanline pixel channel_i entry
-		uint32_t lastByteIndex() const { return this->m_channel_i_ofScanlinePixels[scanlinePixelsNum()-1].lastByteIndex(); }	// last byte index of last scanline pixel channel_i entry
-		uint32_t scanlinePixelsNum() const { return this->m_channel_i_ofScanlinePixels.size(); }
-	
-		private:
-		std::vector<Channel_i_ofPixel<channelCType32>> m_channel_i_ofScanlinePixels;
-	
+		return indexes;
+	}
+	/// <returns> value of pixel channel (s_c_rgbaR, ...) missing in chlist: 0 for color, 1 for alpha </returns>
+	template <Unsigned32OrFloat channelCType32>
+	channelCType32 rgbaDefaultValue(const uint32_t rgbaIndex) { return rgbaIndex == s_c_rgbaA ? channelCType32(1) : channelCType32(0); }
+
+	/// <summary>
+	///		Pixel channel values returned by PixelData::pixelStructRGBA().
+	/// </summary>
+	template <Unsigned32OrFloat channelCType32>
+	struct PixelRGBA
+	{
+		channelCType32 r, g, b, a;
 	};
 	
-	// stores exrFile.pixelData.RegularScanLine[i]		(Channel_i_ofScanlinePixels per each pixel channel = scanline)
+	// stores exrFile.pixelData.RegularScanLine[i] header (y, data size) and location of its samples within filebytes.
+	// Samples themselves are decoded into ImageBuffer (one contiguous array per channel),
+	// byte indexes of each sample are computed on demand from the scanline data first byte index and ScanlineLayout (of ScanlineDecoder shared by all scanlines).
 	template <Unsigned32OrFloat channelCType32>
 	class RegularScanline
 	{
 		public:
-		static uint32_t pixelChannelsNum() { return 4; }		// number of channel_i_ofScanlinePixels = number of scanline's pixels' pixel channel groups
-		RegularScanline() { /*tryValidateChannelValueType<channelCType32>();*/ }
+		uint32_t pixelChannelsNum() const { return m_decoder->layout().channelsNum(); }		// number of channel groups in scanline (one group per pixel channel)
+		RegularScanline() {}
 		/// ReadMe: scanline structure
 		/*
 			source: https://openexr.com/en/latest/OpenEXRFileLayout.html#sample-file:~:text=End%20of%20scan%20line%20offset%20table
@@ -223,223 +363,475 @@ namespace exrPixeldata
 			
 		*/
 		/// <summary>
-		/// 
+		///		Read scanline header (y, data size) and compute byte location of scanline samples.
+		///		Samples are not read here, call decodeInto() to copy them into ImageBuffer.
 		/// </summary>
-		/// <param name="filebytes"></param>
-		/// <param name="scanlineFirstByteIndex"></param>
-		/// <param name="scanlinePixelsNum"></param>
-		/// <param name="pixelChannelsNum"></param>
-		RegularScanline(const std::vector<ui8>& filebytes, const uint32_t scanlineFirstByteIndex, const uint32_t scanlinePixelsNum, const uint32_t pixelChannelsNum)
+		/// <param name="filebytes"> - view of bytes of full input .exr file </param>
+		/// <param name="scanlineFirstByteIndex"> - index of first byte of scanline (first byte of its y) within filebytes </param>
+		/// <param name="decoder"> - layout of scanline samples (channels, their types, number of pixels) and their decoding kernels </param>
+		RegularScanline(const ui8view filebytes, const uint64_t scanlineFirstByteIndex, const std::shared_ptr<const ScanlineDecoder<channelCType32>>& decoder)
 			:
 			// calculate scanline generic data filebytes-indexes
 			m_firstByteIndex(scanlineFirstByteIndex),
-			m_yFirstByteIndex(scanlineFirstByteIndex), m_yLastByteIndex(scanlineFirstByteIndex + sizeof(m_y) - 1)
+			m_yFirstByteIndex(scanlineFirstByteIndex), m_yLastByteIndex(scanlineFirstByteIndex + sizeof(m_y) - 1),
+			m_decoder(decoder)
 		{
 			m_valueSizeFirstByteIndex = m_yLastByteIndex + 1;
 			m_valueSizeLastByteIndex = m_valueSizeFirstByteIndex + sizeof(m_valueSize) - 1;
-			// validate template type
-			//tryValidateChannelValueType<channelCType32>();
+			m_dataFirstByteIndex = m_valueSizeLastByteIndex + 1;
+			m_lastByteIndex = m_dataFirstByteIndex + m_decoder->layout().sizeInBytes() - 1;
+			if (filebytes.size() <= m_lastByteIndex or m_lastByteIndex < m_dataFirstByteIndex)
+			{
+				throw std::runtime_error("scanline at [0x" + utils::hex64(m_firstByteIndex) + " ~ 0x" + utils::hex64(m_lastByteIndex) + "] is out of file bytes range. File is truncated or is not a valid .exr file.");
+			}
 			// save scanline generic data
-			m_y = int32_t(exrTypes::readUint32((filebytes.begin()+m_yFirstByteIndex)._Ptr));					/// risk: converting this uint32->int32 when uint32 is greater than 0.5*2^32, may result in wrong number
-			uint32_t valueSize = exrTypes::readUint32((filebytes.begin()+m_valueSizeFirstByteIndex)._Ptr);
+			m_y = int32_t(exrTypes::readUint32(filebytes.data() + m_yFirstByteIndex));					/// risk: converting this uint32->int32 when uint32 is greater than 0.5*2^32, may result in wrong number
+			uint32_t valueSize = exrTypes::readUint32(filebytes.data() + m_valueSizeFirstByteIndex);
 			m_valueSize = int32_t(valueSize);	/// risk: converting this uint32->int32 when uint32 is greater than 0.5*2^32, may result in wrong number
-			
-			// read scanline pixels' channel groups
-			uint32_t scanlineChannelsA_firstByteIndex = m_valueSizeLastByteIndex + 1;
-			m_scanlineChannelsA = Channel_i_ofScanlinePixels<channelCType32>(filebytes, scanlineChannelsA_firstByteIndex, scanlinePixelsNum);
-			m_scanlineChannelsB = Channel_i_ofScanlinePixels<channelCType32>(filebytes, m_scanlineChannelsA.lastByteIndex()+1, scanlinePixelsNum);
-			m_scanlineChannelsG = Channel_i_ofScanlinePixels<channelCType32>(filebytes, m_scanlineChannelsB.lastByteIndex()+1, scanlinePixelsNum);
-			m_scanlineChannelsR = Channel_i_ofScanlinePixels<channelCType32>(filebytes, m_scanlineChannelsG.lastByteIndex()+1, scanlinePixelsNum);
-			m_lastByteIndex = m_scanlineChannelsR.lastByteIndex();
 		}
 
-		RegularScanline<channelCType32>& operator=(const RegularScanline<channelCType32>& other)
+		/// <summary>
+		///		Convert samples of each scanline channel into (imageRow) row of corresponding (image) channel array.
+		/// </summary>
+		void decodeInto(const ui8view filebytes, ImageBuffer<channelCType32>& image, const uint32_t imageRow) const
+		{
+			m_decoder->decodeScanline(filebytes.data() + m_dataFirstByteIndex, image, imageRow);
+		}
+
+		int32_t _y() const { return m_y; }
+		int32_t _valueSizeInBytes() const { return m_valueSize; }
+		uint64_t firstByteIndex() const { return m_firstByteIndex; }
+		uint64_t lastByteIndex() const { return m_lastByteIndex; }
+		uint64_t yFirstByteIndex() const { return m_yFirstByteIndex; }
+		uint64_t yLastByteIndex() const { return m_yLastByteIndex; }
+		uint64_t valueSizeFirstByteIndex() const { return m_valueSizeFirstByteIndex; }
+		uint64_t valueSizeLastByteIndex() const { return m_valueSizeLastByteIndex; }
+		/// <returns> index of first byte of first sample of (pixelChannelIndex) channel within filebytes </returns>
+		uint64_t channelFirstByteIndex(const uint32_t pixelChannelIndex) const
+		{
+			tryValidatePixelChannelIndex(pixelChannelIndex);
+			return m_dataFirstByteIndex + m_decoder->layout().channelOffsetInBytes(pixelChannelIndex);
+		}
+		uint64_t sampleFirstByteIndex(const uint32_t pixelChannelIndex, const uint32_t pixelColumnIndex) const { return channelFirstByteIndex(pixelChannelIndex) + uint64_t(pixelColumnIndex) * m_decoder->layout().sampleSizeInBytes(pixelChannelIndex); }
+		uint64_t sampleLastByteIndex(const uint32_t pixelChannelIndex, const uint32_t pixelColumnIndex) const { return sampleFirstByteIndex(pixelChannelIndex, pixelColumnIndex) + m_decoder->layout().sampleSizeInBytes(pixelChannelIndex) - 1; }
+		uint32_t sizeInBytes() const { return uint32_t(m_lastByteIndex - m_firstByteIndex + 1); }
+		uint32_t pixelsNum() const { return m_decoder->layout().pixelsNum(); }
+		
+		private:
+		uint64_t m_firstByteIndex = 0, m_lastByteIndex = 0;
+		int32_t m_y = 0;			uint64_t m_yFirstByteIndex = 0, m_yLastByteIndex = 0;
+		int32_t m_valueSize = 0;	uint64_t m_valueSizeFirstByteIndex = 0, m_valueSizeLastByteIndex = 0;
+		uint64_t m_dataFirstByteIndex = 0;
+		std::shared_ptr<const ScanlineDecoder<channelCType32>> m_decoder = nullptr;
+		
+		static inline const std::invalid_argument s_c_invalidChannelIndex = std::invalid_argument("(pixelChannelIndex) value is out of valid range [0; Scanline_v2::pixelChannelsNum() - 1]");
+		void tryValidatePixelChannelIndex(const uint32_t pixelChannelIndex) const
 		{
-			if (this != &other)
+			if (pixelChannelsNum() <= pixelChannelIndex)
 			{
-				m_firstByteIndex = other.m_firstByteIndex;
-				m_lastByteIndex = other.m_lastByteIndex;
-	
-				m_y = other.m_y;
-				m_yFirstByteIndex = other.m_yFirstByteIndex;
-				m_yLastByteIndex = other.m_yLastByteIndex;
+				throw s_c_invalidChannelIndex;
+			}
+		}
 	
-				m_valueSize = other.m_valueSize;
-				m_valueSizeFirstByteIndex = other.m_valueSizeFirstByteIndex;
-				m_valueSizeLastByteIndex = other.m_valueSizeLastByteIndex;
+	};
 	
-				m_scanlineChannelsA = other.m_scanlineChannelsA;
-				m_scanlineChannelsB = other.m_scanlineChannelsB;
-				m_scanlineChannelsG = other.m_scanlineChannelsG;
-				m_scanlineChannelsR = other.m_scanlineChannelsR;
+	// stores header (y, data size) of exrFile.pixelData chunk of compressed scanline image and location of its (compressed) data within filebytes.
+	// One chunk stores (scanlinesPerChunk) consecutive scanlines, compressed together (last chunk of image may store fewer),
+	// uncompressed chunk data is the scanlines one after another, each laid out as RegularScanline data (channel by channel).
+	template <Unsigned32OrFloat channelCType32>
+	class ScanlineChunk
+	{
+		public:
+		ScanlineChunk() {}
+		/// <summary>
+		///		Read chunk header (y, data size) and compute byte location of chunk data.
+		///		Data is not decompressed here, call decodeData() to get uncompressed scanlines.
+		/// </summary>
+		/// <param name="chunkFirstByteIndex"> - index of first byte of chunk (first byte of its y) within filebytes (offset table value) </param>
+		/// <param name="decoder"> - layout of samples of each scanline of the chunk (uncompressed) and their decoding kernels </param>
+		/// <param name="scanlinesPerChunk"> - max number of scanlines in chunk, depends on compression </param>
+		/// <param name="imageRowsNum"> - number of image rows, limits number of scanlines in last chunk </param>
+		/// <param name="firstRowY"> - (y) of first image row (dataWindow.yMin), chunk (y) values are counted from it </param>
+		ScanlineChunk(const ui8view filebytes, const uint64_t chunkFirstByteIndex, const std::shared_ptr<const ScanlineDecoder<channelCType32>>& decoder, const uint32_t scanlinesPerChunk, const uint32_t imageRowsNum, const int32_t firstRowY = 0)
+			: m_firstByteIndex(chunkFirstByteIndex), m_dataFirstByteIndex(chunkFirstByteIndex + sizeof(m_y) + sizeof(m_dataSize)),
+			m_decoder(decoder)
+		{
+			if (filebytes.size() < m_dataFirstByteIndex)
+			{
+				throw std::runtime_error("chunk at 0x" + utils::hex64(m_firstByteIndex) + " is out of file bytes range. File is truncated or is not a valid .exr file.");
+			}
+			m_y = int32_t(exrTypes::readUint32(filebytes.data() + m_firstByteIndex));
+			m_dataSize = exrTypes::readUint32(filebytes.data() + m_firstByteIndex + sizeof(m_y));
+			const int64_t firstRow = int64_t(m_y) - firstRowY;
+			if (firstRow < 0 or int64_t(imageRowsNum) <= firstRow or firstRow % scanlinesPerChunk != 0)
+			{
+				throw std::runtime_error("(y) value of chunk at 0x" + utils::hex64(m_firstByteIndex) + " is " + std::to_string(m_y) + ", first row of chunk (" + std::to_string(firstRowY) + " + multiple of " + std::to_string(scanlinesPerChunk) + " in range [" + std::to_string(firstRowY) + "; " + std::to_string(int64_t(firstRowY) + imageRowsNum) + ")) is expected.");
+			}
+			m_firstRow = uint32_t(firstRow);
+			m_scanlinesNum = std::min(scanlinesPerChunk, imageRowsNum - m_firstRow);
+			if (UINT32_MAX / m_scanlinesNum < m_decoder->layout().sizeInBytes())
+			{
+				throw std::runtime_error("uncompressed data of chunk at 0x" + utils::hex64(m_firstByteIndex) + " is larger than 4 GB.");
+			}
+			if (filebytes.size() - m_dataFirstByteIndex < m_dataSize or m_dataSize == 0)
+			{
+				throw std::runtime_error("data of chunk at 0x" + utils::hex64(m_firstByteIndex) + " (" + std::to_string(m_dataSize) + " bytes) is out of file bytes range. File is truncated or is not a valid .exr file.");
+			}
+			if (rawSizeInBytes() < m_dataSize)
+			{
+				throw std::runtime_error("data of chunk at 0x" + utils::hex64(m_firstByteIndex) + " (" + std::to_string(m_dataSize) + " bytes) is larger than its uncompressed size (" + std::to_string(rawSizeInBytes()) + " bytes).");
 			}
-			return *this;
 		}
+
+		/// <summary>
+		///		Get uncompressed chunk data: decompress it into (rawBuffer) or, if chunk stores data uncompressed, point to filebytes.
+		/// </summary>
+		/// <returns> pointer to first byte of uncompressed chunk data (rawSizeInBytes() bytes) </returns>
+		const ui8* decodeData(const ui8view filebytes, const exr2::consta::s_compression::value compressionValue, exrCompression::ChunkDecoders& decoders, std::vector<ui8>& rawBuffer) const
+		{
+			const exrCompression::ChunkLayout layout = { m_decoder->layout().channelNames(), m_decoder->layout().channelDataTypes(), pixelsNum(), m_scanlinesNum };
+			return decompressChunkData(filebytes.subspan(m_dataFirstByteIndex, m_dataSize), rawSizeInBytes(), layout, compressionValue, decoders, rawBuffer);
+		}
+		/// <summary>
+		///		Convert samples of each channel of (scanlineIndex) scanline of uncompressed chunk data (raw) into (imageRow) row of (image).
+		/// </summary>
+		void copyScanlineInto(const ui8* raw, const uint32_t scanlineIndex, ImageBuffer<channelCType32>& image, const uint32_t imageRow) const
+		{
+			m_decoder->decodeScanline(raw + std::size_t(scanlineIndex) * m_decoder->layout().sizeInBytes(), image, imageRow);
+		}
+
 		int32_t _y() const { return m_y; }
-		int32_t _valueSizeInBytes() const { return m_valueSize; }
-		channelCType32 a(const uint32_t pixelColumnIndex) const { m_scanlineChannelsA.tryValidatePixelColumnIndex(pixelColumnIndex); return m_scanlineChannelsA.channelValueByPixelIndex(pixelColumnIndex); }
-		channelCType32 b(const uint32_t pixelColumnIndex) const { m_scanlineChannelsB.tryValidatePixelColumnIndex(pixelColumnIndex); return m_scanlineChannelsB.channelValueByPixelIndex(pixelColumnIndex); }
-		channelCType32 g(const uint32_t pixelColumnIndex) const { m_scanlineChannelsG.tryValidatePixelColumnIndex(pixelColumnIndex); return m_scanlineChannelsG.channelValueByPixelIndex(pixelColumnIndex); }
-		channelCType32 r(const uint32_t pixelColumnIndex) const { m_scanlineChannelsR.tryValidatePixelColumnIndex(pixelColumnIndex); return m_scanlineChannelsR.channelValueByPixelIndex(pixelColumnIndex); }
-		channelCType32 ABGRchannelByIndex(const uint32_t scanlinePixelIndex, const uint32_t pixelChannelIndex)
+		/// <returns> image row of first scanline of chunk: (y) - dataWindow.yMin </returns>
+		uint32_t firstRow() const { return m_firstRow; }
+		uint32_t _dataSizeInBytes() const { return m_dataSize; }
+		/// <returns> true if chunk data is compressed (chunk stores data uncompressed, if compression does not make it smaller) </returns>
+		bool isCompressed() const { return m_dataSize < rawSizeInBytes(); }
+		uint32_t rawSizeInBytes() const { return m_scanlinesNum * m_decoder->layout().sizeInBytes(); }
+		uint32_t scanlinesNum() const { return m_scanlinesNum; }
+		uint32_t pixelsNum() const { return m_decoder->layout().pixelsNum(); }
+		uint32_t pixelChannelsNum() const { return m_decoder->layout().channelsNum(); }
+		uint64_t firstByteIndex() const { return m_firstByteIndex; }
+		uint64_t lastByteIndex() const { return m_dataFirstByteIndex + m_dataSize - 1; }
+		uint64_t yFirstByteIndex() const { return m_firstByteIndex; }
+		uint64_t yLastByteIndex() const { return m_firstByteIndex + sizeof(m_y) - 1; }
+		uint64_t dataSizeFirstByteIndex() const { return yLastByteIndex() + 1; }
+		uint64_t dataSizeLastByteIndex() const { return m_dataFirstByteIndex - 1; }
+		/// <returns> index of first byte of sample within uncompressed chunk data </returns>
+		uint32_t rawSampleFirstByteIndex(const uint32_t scanlineIndex, const uint32_t pixelChannelIndex, const uint32_t pixelColumnIndex) const { return scanlineIndex * m_decoder->layout().sizeInBytes() + m_decoder->layout().channelOffsetInBytes(pixelChannelIndex) + pixelColumnIndex * m_decoder->layout().sampleSizeInBytes(pixelChannelIndex); }
+		uint32_t sampleSizeInBytes(const uint32_t pixelChannelIndex) const { return m_decoder->layout().sampleSizeInBytes(pixelChannelIndex); }
+
+		private:
+		uint64_t m_firstByteIndex = 0, m_dataFirstByteIndex = 0;
+		int32_t m_y = 0;
+		uint32_t m_firstRow = 0;
+		uint32_t m_dataSize = 0;
+		uint32_t m_scanlinesNum = 0;
+		std::shared_ptr<const ScanlineDecoder<channelCType32>> m_decoder = nullptr;
+	};
+
+	/// <summary>
+	///		Bounded least-recently-used cache of decoded scanlines.
+	///		Each cached scanline occupies one row (slot) of internal ImageBuffer, so memory use is fixed by (capacity) on construction.
+	///		Not thread-safe: owner must serialize access.
+	/// </summary>
+	template <Unsigned32OrFloat channelCType32>
+	class ScanlineCache
+	{
+		public:
+		ScanlineCache() {}
+		ScanlineCache(const uint32_t capacity, const uint32_t scanlinePixelsNum, const uint32_t pixelChannelsNum)
+			: m_slots(capacity, scanlinePixelsNum, pixelChannelsNum)
 		{
-			tryValidatePixelChannelIndex(pixelChannelIndex);
-			switch(pixelChannelIndex)
+			if (capacity == 0)
 			{
-				case 0: return a(scanlinePixelIndex); break;
-				case 1: return b(scanlinePixelIndex); break;
-				case 2: return g(scanlinePixelIndex); break;
-				case 3: return r(scanlinePixelIndex); break;
-				default: throw s_c_invalidChannelIndex;
+				throw std::invalid_argument("ScanlineCache: (capacity) must be at least 1 scanline");
 			}
+			m_rowToSlot.reserve(capacity);
 		}
-		Channel_i_ofScanlinePixels<channelCType32> scanlineChannelsByChannelIndex(const uint32_t pixelChannelIndex) const
+		uint32_t capacity() const { return m_slots.rowsNum(); }
+		uint32_t size() const { return uint32_t(m_rowToSlot.size()); }
+		/// <summary>
+		///		Find cached scanline of image (row) and mark it as most recently used.
+		/// </summary>
+		/// <returns> true and (slot) of the scanline in slots() if cached, false otherwise </returns>
+		bool find(const uint32_t row, uint32_t& slot)
 		{
-			tryValidatePixelChannelIndex(pixelChannelIndex);
-			switch(pixelChannelIndex)
+			const auto it = m_rowToSlot.find(row);
+			if (it == m_rowToSlot.end())
 			{
-				case 0: return Channel_i_ofScanlinePixels<channelCType32>(m_scanlineChannelsA); break;
-				case 1: return Channel_i_ofScanlinePixels<channelCType32>(m_scanlineChannelsB); break;
-				case 2: return Channel_i_ofScanlinePixels<channelCType32>(m_scanlineChannelsG); break;
-				case 3: return Channel_i_ofScanlinePixels<channelCType32>(m_scanlineChannelsR); break;
-				default: throw s_c_invalidChannelIndex;
+				return false;
 			}
-			
+			m_usage.splice(m_usage.begin(), m_usage, it->second.second);
+			slot = it->second.first;
+			return true;
 		}
-		uint32_t firstByteIndex() const { return m_firstByteIndex; }
-		uint32_t lastByteIndex() const { return m_lastByteIndex; }
-		uint32_t yFirstByteIndex() const { return m_yFirstByteIndex; }
-		uint32_t yLastByteIndex() const { return m_yLastByteIndex; }
-		uint32_t valueSizeFirstByteIndex() const { return m_valueSizeFirstByteIndex; }
-		uint32_t valueSizeLastByteIndex() const { return m_valueSizeLastByteIndex; }
-		uint32_t sizeInBytes() const { return m_lastByteIndex - m_firstByteIndex + 1; }
-		uint32_t pixelsNum() const { return m_scanlineChannelsA.scanlinePixelsNum(); }	// all channels are of same scanline of pixels => their size is the same
-		
-		private:
-		uint32_t m_firstByteIndex = 0, m_lastByteIndex = 0;
-		int32_t m_y = 0;			uint32_t m_yFirstByteIndex = 0, m_yLastByteIndex = 0;
-		int32_t m_valueSize = 0;	uint32_t m_valueSizeFirstByteIndex = 0, m_valueSizeLastByteIndex = 0;
-		Channel_i_ofScanlinePixels<channelCType32> m_scanlineChannelsA;	// already provides its .firstByteIndex() and .lastByteIndex()
-		Channel_i_ofScanlinePixels<channelCType32> m_scanlineChannelsB;
-		Channel_i_ofScanlinePixels<channelCType32> m_scanlineChannelsG;
-		Channel_i_ofScanlinePixels<channelCType32> m_scanlineChannelsR;
-		
-		static inline const std::invalid_argument s_c_invalidChannelIndex = std::invalid_argument("(pixelChannelIndex) value is out of valid range [0; Scanline_v2::pixelChannelsNum() - 1]");
-		void tryValidatePixelChannelIndex(const uint32_t pixelChannelIndex) const
+		/// <summary>
+		///		Reserve slot for scanline of image (row), evicting least recently used scanline if cache is full.
+		///		Caller decodes the scanline into returned slot of slots().
+		/// </summary>
+		/// <returns> slot (row of slots()) to decode scanline into </returns>
+		uint32_t insert(const uint32_t row)
 		{
-			if (pixelChannelIndex < 0 or (pixelChannelsNum() - 1) < pixelChannelIndex)
+			uint32_t slot = size();
+			if (size() == capacity())
 			{
-				throw s_c_invalidChannelIndex;
+				const uint32_t evictedRow = m_usage.back();
+				slot = m_rowToSlot[evictedRow].first;
+				m_rowToSlot.erase(evictedRow);
+				m_usage.pop_back();
 			}
+			m_usage.push_front(row);
+			m_rowToSlot[row] = { slot, m_usage.begin() };
+			return slot;
 		}
-	
+		ImageBuffer<channelCType32>& slots() { return m_slots; }
+		const ImageBuffer<channelCType32>& slots() const { return m_slots; }
+
+		private:
+		ImageBuffer<channelCType32> m_slots;		// slot = row of the buffer
+		std::list<uint32_t> m_usage;				// cached image rows, most recently used first
+		std::unordered_map<uint32_t, std::pair<uint32_t, std::list<uint32_t>::iterator>> m_rowToSlot;	// image row -> (slot, position in m_usage)
 	};
-	
-	// stores exrFile.pixelData		(RegularScanline per each image row (image line) = pixelData)
+
+	// stores exrFile.pixelData		(RegularScanline header per each image row + decoded samples in planar ImageBuffer = pixelData)
+	// Chunks are located by offset table only (never by size of previous chunk), so any row is reached in one seek, whatever the lineOrder.
+	// Two modes:
+	//		eager - all chunks are decoded on construction (constructor with threadPool),
+	//		lazy  - only chunk offsets are stored on construction, chunk is decoded on first access to its pixels
+	//				and kept in bounded LRU cache (constructor with cacheScanlinesNum).
 	template <Unsigned32OrFloat channelCType32>
 	class PixelData
 	{
 		public:
-		PixelData(const std::vector<ui8>& filebytes, const uint32_t pixeldataFirstByteIndex, const uint32_t imageRowsNum, const uint32_t imageColumnsNum, const uint32_t pixelChannelsNum, const exr2::consta::s_lineOrder::ctype lineOrderValue)
-		{
-			//tryValidateChannelValueType<channelCType32>();
-			// from .exr, read each scanline, providing (currentScanlineFirstByteIndex) which starts from (pixeldataFirstByteIndex) value and steps (+ scanline.byteSize()),
-			uint32_t currentScanlineFirstByteIndex = pixeldataFirstByteIndex;
-			for (uint32_t scanlineIndex = 0; scanlineIndex < imageRowsNum; scanlineIndex++)
-			{
-				// read next scanline
-				RegularScanline<channelCType32> scanline_copy = RegularScanline<channelCType32>(filebytes, currentScanlineFirstByteIndex, imageColumnsNum, pixelChannelsNum);
-				m_scanlines.push_back(scanline_copy);
-				currentScanlineFirstByteIndex += m_scanlines[scanlineIndex].sizeInBytes();
-				// validate scanline.y(), scanline row index
-				//		if (lineOrder == INCREASING_Y)		=> u_y must be the same as (scanlineIndex) value,
-				//		else if (lineOrder == DECREASING_Y) => u_y must be the same as (imageRowsNumber-1 - scanlineIndex),
-				//		else if (lineOrder == RANDOM_Y)		=> u_y must be in range [0; imageRowsNumber-1].
-				//		else => lineOrder value is unknown.
-				int32_t scanlineY = m_scanlines[scanlineIndex]._y();
-				if (lineOrderValue == exr2::consta::s_lineOrder::value::INCREASING_Y)
+		/// <summary>
+		///		Eager mode, offset table based: decode all chunks, concurrently on (threadPool) workers if it is provided.
+		///		Position of each chunk is taken from offset table, so chunks do not depend on each other.
+		///		Chunks are then validated in file order against (lineOrderValue).
+		/// </summary>
+		/// <param name="chunkOffsets"> - offset table values: index of first byte of each chunk within filebytes, ordered by image row (y) </param>
+		/// <param name="compressionValue"> - compression of chunks: NO or one with decoder in exrCompression::makeChunkDecoder() </param>
+		/// <param name="threadPool"> - workers to decode chunks on, nullptr = decode on calling thread </param>
+		/// <param name="firstRowY"> - (y) of first image row (dataWindow.yMin): chunk of (y) starts at image row (y - firstRowY) </param>
+		PixelData(const ui8view filebytes, const std::vector<uint64_t>& chunkOffsets, const uint32_t imageRowsNum, const uint32_t imageColumnsNum, const std::vector<std::string>& channelNames, const std::vector<uint32_t>& channelDataTypes, const exr2::consta::s_lineOrder::ctype lineOrderValue, const exr2::consta::s_compression::value compressionValue, utils::ThreadPool* threadPool, const int32_t firstRowY = 0)
+			: m_image(imageRowsNum, imageColumnsNum, uint32_t(channelDataTypes.size())),
+			m_rowsNum(imageRowsNum), m_columnsNum(imageColumnsNum), m_firstRowY(firstRowY), m_decoder(std::make_shared<const ScanlineDecoder<channelCType32>>(ScanlineLayout(channelNames, channelDataTypes, imageColumnsNum))),
+			m_channelNames(channelNames), m_rgbaChannelIndexes(rgbaChannelIndexes(channelNames, channelDataTypes)),
+			m_compression(compressionValue), m_scanlinesPerChunk(exr2::consta::scanlinesPerChunk(compressionValue))
+		{
+			const uint32_t chunksNum = chunksNumFor(imageRowsNum);
+			tryValidateChunkOffsets(filebytes, chunkOffsets, chunksNum);
+			if (m_compression == exr2::consta::s_compression::value::NO)
+			{
+				m_scanlines.resize(imageRowsNum);
+				forEachRange(threadPool, imageRowsNum, [&](const std::size_t firstRow, const std::size_t lastRow)
 				{
-					if (scanlineY != scanlineIndex)
-						throw std::runtime_error("(y) row value of scanline from .exr is different from (rowIndex) or (scanlineIndex). Check .exr lineOrder value to know actual order in your .exr file.");
+					for (std::size_t row = firstRow; row < lastRow; row++)
+					{
+						m_scanlines[row] = RegularScanline<channelCType32>(filebytes, chunkOffsets[row], m_decoder);
+						tryValidateChunkY(m_scanlines[row]._y(), uint32_t(row), chunkOffsets[row]);
+						m_scanlines[row].decodeInto(filebytes, m_image, uint32_t(row));
+					}
+				});
+				// scanlines, as ordered in file
+				std::sort(m_scanlines.begin(), m_scanlines.end(), [](const RegularScanline<channelCType32>& left, const RegularScanline<channelCType32>& right) { return left.firstByteIndex() < right.firstByteIndex(); });
+				for (uint32_t scanlineIndex = 0; scanlineIndex < imageRowsNum; scanlineIndex++)
+				{
+					tryValidateScanlineY(rowOf(m_scanlines[scanlineIndex]._y()), scanlineIndex, imageRowsNum, lineOrderValue);
 				}
-				else if (lineOrderValue == exr2::consta::s_lineOrder::value::DECREASING_Y)
+				m_firstByteIndex = m_scanlines[0].firstByteIndex();
+				m_lastByteIndex = m_scanlines[m_scanlines.size()-1].lastByteIndex();
+				return;
+			}
+			m_chunks.resize(chunksNum);
+			forEachRange(threadPool, chunksNum, [&](const std::size_t firstChunk, const std::size_t lastChunk)
+			{
+				// decompression buffers are reused by all chunks of the task
+				exrCompression::ChunkDecoders decoders;
+				std::vector<ui8> rawBuffer;
+				for (std::size_t chunkIndex = firstChunk; chunkIndex < lastChunk; chunkIndex++)
 				{
-					if (scanlineY != imageRowsNum-1-scanlineIndex)
-						throw std::runtime_error("(y) row value of scanline from .exr is different from (imageRows-1-rowIndex) or (imageRows-1-scanlineIndex). Check .exr lineOrder value to know actual order in your .exr file.");
+					ScanlineChunk<channelCType32>& chunk = m_chunks[chunkIndex];
+					chunk = ScanlineChunk<channelCType32>(filebytes, chunkOffsets[chunkIndex], m_decoder, m_scanlinesPerChunk, imageRowsNum, m_firstRowY);
+					tryValidateChunkY(chunk._y(), uint32_t(chunkIndex) * m_scanlinesPerChunk, chunkOffsets[chunkIndex]);
+					const ui8* raw = chunk.decodeData(filebytes, m_compression, decoders, rawBuffer);
+					for (uint32_t i = 0; i < chunk.scanlinesNum(); i++)
+					{
+						chunk.copyScanlineInto(raw, i, m_image, chunk.firstRow() + i);
+					}
 				}
-				else if (lineOrderValue == exr2::consta::s_lineOrder::value::RANDOM_Y)
+			});
+			// chunks, as ordered in file
+			std::sort(m_chunks.begin(), m_chunks.end(), [](const ScanlineChunk<channelCType32>& left, const ScanlineChunk<channelCType32>& right) { return left.firstByteIndex() < right.firstByteIndex(); });
+			for (uint32_t chunkIndex = 0; chunkIndex < chunksNum; chunkIndex++)
+			{
+				tryValidateScanlineY(int32_t(m_chunks[chunkIndex].firstRow() / m_scanlinesPerChunk), chunkIndex, chunksNum, lineOrderValue);
+			}
+			m_firstByteIndex = m_chunks[0].firstByteIndex();
+			m_lastByteIndex = m_chunks[m_chunks.size()-1].lastByteIndex();
+		}
+		/// <summary>
+		///		Lazy mode: store chunk offsets only. Chunk is decoded on first access to any of its pixels, its scanlines
+		///		are kept in cache of (cacheScanlinesNum) most recently used scanlines, so memory use does not depend on image height.
+		/// </summary>
+		/// <param name="chunkOffsets"> - offset table values: index of first byte of each chunk within filebytes, ordered by image row (y) </param>
+		/// <param name="compressionValue"> - compression of chunks: NO or one with decoder in exrCompression::makeChunkDecoder() </param>
+		/// <param name="cacheScanlinesNum"> - max number of decoded scanlines kept in memory (raised to number of scanlines per chunk, if smaller) </param>
+		/// <param name="firstRowY"> - (y) of first image row (dataWindow.yMin): chunk of (y) starts at image row (y - firstRowY) </param>
+		PixelData(const ui8view filebytes, const std::vector<uint64_t>& chunkOffsets, const uint32_t imageRowsNum, const uint32_t imageColumnsNum, const std::vector<std::string>& channelNames, const std::vector<uint32_t>& channelDataTypes, const exr2::consta::s_lineOrder::ctype lineOrderValue, const exr2::consta::s_compression::value compressionValue, const uint32_t cacheScanlinesNum, const int32_t firstRowY = 0)
+			: m_rowsNum(imageRowsNum), m_columnsNum(imageColumnsNum), m_firstRowY(firstRowY), m_decoder(std::make_shared<const ScanlineDecoder<channelCType32>>(ScanlineLayout(channelNames, channelDataTypes, imageColumnsNum))),
+			m_channelNames(channelNames), m_rgbaChannelIndexes(rgbaChannelIndexes(channelNames, channelDataTypes)),
+			m_compression(compressionValue), m_scanlinesPerChunk(exr2::consta::scanlinesPerChunk(compressionValue)),
+			m_isLazy(true), m_filebytes(filebytes), m_chunkOffsets(chunkOffsets),
+			m_cache(std::max(cacheScanlinesNum, m_scanlinesPerChunk), imageColumnsNum, uint32_t(channelDataTypes.size()))
+		{
+			tryValidateChunkOffsets(filebytes, m_chunkOffsets, chunksNumFor(imageRowsNum));
+			if (lineOrderValue != exr2::consta::s_lineOrder::value::INCREASING_Y and lineOrderValue != exr2::consta::s_lineOrder::value::DECREASING_Y and lineOrderValue != exr2::consta::s_lineOrder::value::RANDOM_Y)
+			{
+				throw std::runtime_error("(lineOrder) attribute of your .exr file has invalid value. Check OpenEXR documentation on valid lineOrder values.");
+			}
+			// offset table is ordered by (y) no matter the lineOrder, so first and last chunks in file are found by offset value.
+			// Only headers (y, data size) of those two are read here.
+			const auto [minOffset, maxOffset] = std::minmax_element(m_chunkOffsets.begin(), m_chunkOffsets.end());
+			if (m_compression == exr2::consta::s_compression::value::NO)
+			{
+				m_firstByteIndex = RegularScanline<channelCType32>(m_filebytes, *minOffset, m_decoder).firstByteIndex();
+				m_lastByteIndex = RegularScanline<channelCType32>(m_filebytes, *maxOffset, m_decoder).lastByteIndex();
+			}
+			else
+			{
+				m_firstByteIndex = chunkHeader(*minOffset).firstByteIndex();
+				m_lastByteIndex = chunkHeader(*maxOffset).lastByteIndex();
+			}
+		}
+		uint64_t firstByteIndex() const { return m_firstByteIndex; }	// firstByteIndex of first scanline (in file)
+		uint64_t lastByteIndex() const { return m_lastByteIndex; }		// lastByteIndex of last scanline (in file)
+		uint32_t rowsNum() const { return m_rowsNum; }
+		uint32_t columnsNum() const { return m_columnsNum; }
+		bool isLazy() const { return m_isLazy; }
+		/// <returns> max number of decoded scanlines kept in memory (0 in eager mode) </returns>
+		uint32_t cacheScanlinesNum() const { return m_isLazy ? m_cache.capacity() : 0; }
+		/// <returns> decoded samples, one contiguous array per channel (channels ordered as in chlist). Empty in lazy mode. </returns>
+		const ImageBuffer<channelCType32>& image() const { return m_image; }
+
+		/// <summary>
+		///		Lazy mode: decode (and validate) all chunks, concurrently on (threadPool) workers if it is provided, as eager mode does,
+		///		but without keeping their samples, so memory use does not depend on image height. Chunks are then validated in file order against (lineOrderValue).
+		/// </summary>
+		void decodeAllChunks(utils::ThreadPool* threadPool, const exr2::consta::s_lineOrder::ctype lineOrderValue) const
+		{
+			const uint32_t chunksNum = chunksNumFor(m_rowsNum);
+			forEachRange(threadPool, chunksNum, [&](const std::size_t firstChunk, const std::size_t lastChunk)
+			{
+				// decompression buffers and samples are reused by all chunks of the task
+				exrCompression::ChunkDecoders decoders;
+				std::vector<ui8> rawBuffer;
+				ImageBuffer<channelCType32> samples(m_scanlinesPerChunk, m_columnsNum, channelsNum());
+				for (std::size_t chunkIndex = firstChunk; chunkIndex < lastChunk; chunkIndex++)
 				{
-					if ((scanlineY < 0) or ((imageRowsNum-1) < scanlineY))
-						throw std::runtime_error("(y) row value of scanline from .exr is out of valid range [0; imageRowsNum-1]. Check .exr lineOrder value to know actual order in your .exr file.");
+					const uint64_t offset = m_chunkOffsets[chunkIndex];
+					if (m_compression == exr2::consta::s_compression::value::NO)
+					{
+						const RegularScanline<channelCType32> scanline(m_filebytes, offset, m_decoder);
+						tryValidateChunkY(scanline._y(), uint32_t(chunkIndex), offset);
+						scanline.decodeInto(m_filebytes, samples, 0);
+						continue;
+					}
+					const ScanlineChunk<channelCType32> chunk = chunkHeader(offset);
+					tryValidateChunkY(chunk._y(), uint32_t(chunkIndex) * m_scanlinesPerChunk, offset);
+					const ui8* raw = chunk.decodeData(m_filebytes, m_compression, decoders, rawBuffer);
+					for (uint32_t i = 0; i < chunk.scanlinesNum(); i++)
+					{
+						chunk.copyScanlineInto(raw, i, samples, i);
+					}
 				}
-				else throw std::runtime_error("(lineOrder) attribute of your .exr file has invalid value. Check OpenEXR documentation on valid lineOrder values.");
-	
+			});
+			// chunks, as ordered in file: (y) of each chunk is validated above, so its offset table index is its index in image
+			std::vector<uint32_t> chunksInFileOrder(chunksNum);
+			for (uint32_t chunkIndex = 0; chunkIndex < chunksNum; chunkIndex++)
+			{
+				chunksInFileOrder[chunkIndex] = chunkIndex;
+			}
+			std::stable_sort(chunksInFileOrder.begin(), chunksInFileOrder.end(), [&](const uint32_t left, const uint32_t right) { return m_chunkOffsets[left] < m_chunkOffsets[right]; });
+			for (uint32_t fileIndex = 0; fileIndex < chunksNum; fileIndex++)
+			{
+				tryValidateScanlineY(int32_t(chunksInFileOrder[fileIndex]), fileIndex, chunksNum, lineOrderValue);
 			}
 		}
-		PixelData<channelCType32>& operator=(const PixelData<channelCType32>& other)
+
+		/// <summary>
+		///		Copy samples of all channels of image (row) into row (outRow) of (out) (of the same columns and channels).
+		///		Lazy mode decodes the scanline on cache miss, so rows copied in increasing order decode each chunk once.
+		/// </summary>
+		void copyRowInto(const uint32_t row, ImageBuffer<channelCType32>& out, const uint32_t outRow) const
 		{
-			if (this != &other)
+			tryValidatePixelRowIndex(row);
+			if (not m_isLazy)
 			{
-				m_scanlines.clear();
-				for (const RegularScanline<channelCType32> scanline : other.m_scanlines)
+				for (uint32_t ch = 0; ch < channelsNum(); ch++)
 				{
-					m_scanlines.push_back(scanline);
+					std::copy_n(m_image.rowData(ch, row), m_columnsNum, out.rowData(ch, outRow));
 				}
+				return;
+			}
+			std::lock_guard<std::mutex> lock(m_cacheMutex);
+			const uint32_t slot = cachedScanlineSlot(row);
+			for (uint32_t ch = 0; ch < channelsNum(); ch++)
+			{
+				std::copy_n(m_cache.slots().rowData(ch, slot), m_columnsNum, out.rowData(ch, outRow));
 			}
-			return *this;
 		}
-		uint32_t firstByteIndex() const { return m_scanlines[0].firstByteIndex(); }						// firstByteIndex of first scanline
-		uint32_t lastByteIndex() const { return m_scanlines[m_scanlines.size()-1].lastByteIndex(); }	// lastByteIndex of last scanline
+
+		uint32_t channelsNum() const { return m_decoder->layout().channelsNum(); }
+		/// <returns> names of all channels, ordered as in chlist (= order of channels in image()) </returns>
+		const std::vector<std::string>& channelNames() const { return m_channelNames; }
+		/// <returns> value of sample of (channelIndex) channel (ordered as in chlist) of pixel [pixelRowIndex, pixelColumnIndex] </returns>
+		channelCType32 channelValue(const uint32_t channelIndex, const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const { return sampleValue(channelIndex, pixelRowIndex, pixelColumnIndex); }
+
+		// pixel channels, found in chlist by name: "R", "G", "B", "A". Missing color channel reads as 0, missing alpha as 1.
+		channelCType32 r(const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const { return rgbaValue(s_c_rgbaR, pixelRowIndex, pixelColumnIndex); }
+		channelCType32 g(const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const { return rgbaValue(s_c_rgbaG, pixelRowIndex, pixelColumnIndex); }
+		channelCType32 b(const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const { return rgbaValue(s_c_rgbaB, pixelRowIndex, pixelColumnIndex); }
+		channelCType32 a(const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const { return rgbaValue(s_c_rgbaA, pixelRowIndex, pixelColumnIndex); }
+		/// <returns> true if chlist has at least one of "R", "G", "B", "A" channels </returns>
+		bool hasRGBAChannels() const { return std::any_of(m_rgbaChannelIndexes.begin(), m_rgbaChannelIndexes.end(), [](const int32_t index) { return 0 <= index; }); }
 
 		/// <summary>
-		/// 
+		///		Get all channels of pixel [pixelRowIndex, pixelColumnIndex].
 		/// </summary>
 		/// <how-to-use>
 		///		int main()
 		///		{
-		///			auto rgba = pixelStructRGBA(2, 5);	std::cout << "pixelRGBA[2,5]= " << rgba;
+		///			auto rgba = pixelStructRGBA(2, 5);	std::cout << "pixelRGBA[2,5].r= " << rgba.r;
 		///			// or 
 		///			auto [r,g,b,a] = pixelStructRGBA(2, 5);		printf("pixelRGBA[2,5]= (%u, %u, %u, %u)", r, g, b, a);
 		///		}
 		/// </how-to-use>
-		/// <param name="pixelRowIndex"></param>
-		/// <param name="pixelColumnIndex"></param>
-		/// <returns></returns>
-		auto pixelStructRGBA(const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const
+		/// <param name="pixelRowIndex"> - image row (from top) </param>
+		/// <param name="pixelColumnIndex"> - image column (from left) </param>
+		/// <returns> PixelRGBA struct of pixel channel values </returns>
+		PixelRGBA<channelCType32> pixelStructRGBA(const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const
 		{
 			tryValidatePixelRowIndex(pixelRowIndex);
 			tryValidatePixelColumnIndex(pixelColumnIndex);
-			channelCType32 a = m_scanlines[pixelRowIndex].a(pixelColumnIndex);
-			channelCType32 b = m_scanlines[pixelRowIndex].b(pixelColumnIndex);
-			channelCType32 g = m_scanlines[pixelRowIndex].g(pixelColumnIndex);
-			channelCType32 r = m_scanlines[pixelRowIndex].r(pixelColumnIndex);
-			return {r, g, b, a};
+			if (m_isLazy)
+			{
+				// one cache lookup for all channels of the pixel
+				std::lock_guard<std::mutex> lock(m_cacheMutex);
+				const uint32_t slot = cachedScanlineSlot(pixelRowIndex);
+				const ImageBuffer<channelCType32>& slots = m_cache.slots();
+				const auto slotValue = [&](const uint32_t rgbaIndex)
+				{
+					const int32_t channelIndex = m_rgbaChannelIndexes[rgbaIndex];
+					return channelIndex < 0 ? rgbaDefaultValue<channelCType32>(rgbaIndex) : slots.value(uint32_t(channelIndex), slot, pixelColumnIndex);
+				};
+				return { slotValue(s_c_rgbaR), slotValue(s_c_rgbaG), slotValue(s_c_rgbaB), slotValue(s_c_rgbaA) };
+			}
+			return { r(pixelRowIndex, pixelColumnIndex), g(pixelRowIndex, pixelColumnIndex), b(pixelRowIndex, pixelColumnIndex), a(pixelRowIndex, pixelColumnIndex) };
 		}
 		std::string pixelRGBAString(const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex, const bool hex = false, const uint8_t fltPrecis = 6) const
 		{
-			tryValidatePixelRowIndex(pixelRowIndex);
-			tryValidatePixelColumnIndex(pixelColumnIndex);
-			//std::string scanlinePixelsValues = "";
-			//for (uint32_t pixelRowIndex = 0; pixelRowIndex < u_scanlines.size(); pixelRowIndex++)
-			//{
-			//	const Scanline_v2<channelCType> scanline = u_scanlines[pixelRowIndex];
-			//	for (uint32_t pixelColumnIndex = 0; pixelColumnIndex < scanline.pixelsNum(); pixelColumnIndex++)
-			//	{
-			//		channelCType a = scanline.a(pixelColumnIndex);
-			//		channelCType b = scanline.b(pixelColumnIndex);
-			//		channelCType g = scanline.g(pixelColumnIndex);
-			//		channelCType r = scanline.r(pixelColumnIndex);
-			//		scanlinePixelsValues += 
-			//			std::to_string(pixelRowIndex) + ", " + std::to_string(pixelColumnIndex) + ": " + 
-			//			std::to_string(r) + ", " + std::to_string(g) + ", " + std::to_string(b) + ", " + std::to_string(a) + "\n";
-			//	}
-			//}
 			std::string rgbaStr = "<empty>";
-			const RegularScanline<channelCType32> scanline = m_scanlines[pixelRowIndex];
-			channelCType32 a = scanline.a(pixelColumnIndex);
-			channelCType32 b = scanline.b(pixelColumnIndex);
-			channelCType32 g = scanline.g(pixelColumnIndex);
-			channelCType32 r = scanline.r(pixelColumnIndex);
+			const auto [r, g, b, a] = pixelStructRGBA(pixelRowIndex, pixelColumnIndex);
 			// compatible with numeric C-types
 			if (!hex)
 			{
@@ -465,58 +857,361 @@ namespace exrPixeldata
 		}
 		std::string toStringAsRGBAPixels(const bool hex = false, const uint8_t fltPrecis = 6) const
 		{
+			return toStringAsRGBAPixels(allRows(), allColumns(), hex, fltPrecis);
+		}
+		/// <summary>
+		///		Same as toStringAsRGBAPixels(hex, fltPrecis), for pixels of (rows) x (columns) rectangle only.
+		///		Channels other than R, G, B, A (e.g. Z, N.x) are printed after RGBA of each pixel, as (name, name) = values.
+		///		In lazy mode, only scanlines of (rows) are decoded.
+		/// </summary>
+		std::string toStringAsRGBAPixels(const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns, const bool hex = false, const uint8_t fltPrecis = 6) const
+		{
+			tryValidateRegion(rows, columns);
+			std::vector<uint32_t> otherChannelIndexes;
+			std::string otherChannelsNames = "";
+			for (uint32_t ch = 0; ch < channelsNum(); ch++)
+			{
+				if (std::find(m_rgbaChannelIndexes.begin(), m_rgbaChannelIndexes.end(), int32_t(ch)) == m_rgbaChannelIndexes.end())
+				{
+					otherChannelsNames += (otherChannelIndexes.empty() ? "" : ", ") + m_channelNames[ch];
+					otherChannelIndexes.push_back(ch);
+				}
+			}
 			std::string str = "";
-			for (uint32_t row = 0; row < m_scanlines.size(); row++)
+			for (uint32_t row = rows.first(); row <= rows.last(); row++)
 			{
 				str += "row [" + std::to_string(row) + "]: \n";
-				RegularScanline<channelCType32> scanline = m_scanlines[row];
-				for (uint32_t col = 0; col < scanline.pixelsNum(); col++)
+				for (uint32_t col = columns.first(); col <= columns.last(); col++)
 				{
-					str += "\t pixel[" + std::to_string(row) + ", " + std::to_string(col) + "].RGBA = " + pixelRGBAString(row, col, hex, fltPrecis) + "\n";
+					if (hasRGBAChannels())
+					{
+						str += "\t pixel[" + std::to_string(row) + ", " + std::to_string(col) + "].RGBA = " + pixelRGBAString(row, col, hex, fltPrecis) + "\n";
+					}
+					if (not otherChannelIndexes.empty())
+					{
+						str += "\t pixel[" + std::to_string(row) + ", " + std::to_string(col) + "].(" + otherChannelsNames + ") = " + channelsValuesString(otherChannelIndexes, row, col, fltPrecis) + "\n";
+					}
 				}
 			}
 			return str;
 		}
 		std::string toStringAsExrPixeldata(std::vector<std::string>& channelNamesOrderedAsInChlist, const uint8_t tabsNum = 0) const
+		{
+			return toStringAsExrPixeldata(channelNamesOrderedAsInChlist, allRows(), allColumns(), tabsNum);
+		}
+		/// <summary>
+		///		Same as toStringAsExrPixeldata(channelNames, tabsNum), for scanlines of (rows) and samples of (columns) only.
+		///		In lazy mode, only scanlines of (rows) are decoded.
+		/// </summary>
+		std::string toStringAsExrPixeldata(std::vector<std::string>& channelNamesOrderedAsInChlist, const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns, const uint8_t tabsNum = 0) const
 		{
 			// note: order of channel names in Chlist is the same as the order of channels in PixelData
+			tryValidateRegion(rows, columns);
 			std::string pixeldataStr;
-			for (uint32_t i = 0; i < m_scanlines.size(); i++)	// scanline index = row
+			if (m_compression != exr2::consta::s_compression::value::NO)
+			{
+				return toStringAsExrChunks(channelNamesOrderedAsInChlist, rows, columns, tabsNum);
+			}
+			const std::vector<RegularScanline<channelCType32>> lazyScanlines = m_isLazy ? scanlineHeadersInFileOrder() : std::vector<RegularScanline<channelCType32>>();
+			for (const RegularScanline<channelCType32>& scanline : m_isLazy ? lazyScanlines : m_scanlines)		// scanlines, as ordered in file
 			{
-				RegularScanline<channelCType32> scanline = m_scanlines[i];
-				pixeldataStr += utils::tabs(tabsNum) + "[0x" + utils::hex(scanline.yFirstByteIndex(),4) + "; 0x" + utils::hex(scanline.yLastByteIndex(),4) + "] scanline.y = " + std::to_string(scanline._y()) + " \n";
-				pixeldataStr += utils::tabs(tabsNum) + "[0x" + utils::hex(scanline.valueSizeFirstByteIndex(),4) + "; 0x" + utils::hex(scanline.valueSizeLastByteIndex(),4) + "] dataSizeInBytes = " + std::to_string(scanline._valueSizeInBytes()) + "\n";
+				const int32_t row = rowOf(scanline._y());
+				if (row < 0 or not rows.contains(uint32_t(row)))
+				{
+					continue;
+				}
+				pixeldataStr += utils::tabs(tabsNum) + "[0x" + utils::hex64(scanline.yFirstByteIndex(),4) + "; 0x" + utils::hex64(scanline.yLastByteIndex(),4) + "] scanline.y = " + std::to_string(scanline._y()) + " \n";
+				pixeldataStr += utils::tabs(tabsNum) + "[0x" + utils::hex64(scanline.valueSizeFirstByteIndex(),4) + "; 0x" + utils::hex64(scanline.valueSizeLastByteIndex(),4) + "] dataSizeInBytes = " + std::to_string(scanline._valueSizeInBytes()) + "\n";
 				pixeldataStr += utils::tabs(tabsNum) + "entries: \n";
 				for (uint32_t j = 0; j < scanline.pixelChannelsNum(); j++)		// pixel channel
 				{
-					Channel_i_ofScanlinePixels<channelCType32> scanlinePixelsChannels = scanline.scanlineChannelsByChannelIndex(j);
-					for (uint32_t k = 0; k < scanline.pixelsNum(); k++)			// scanline pixel index = column
+					for (uint32_t k = columns.first(); k <= columns.last(); k++)	// scanline pixel index = column
 					{
-						Channel_i_ofPixel<channelCType32> channel = scanlinePixelsChannels.indexedChannelByPixelIndex(k);
 						// output: [0x001; 0x006] channelValue	\t = px[row, col] channel channelName
 						pixeldataStr += 
-							utils::tabs(tabsNum+1) + "[0x" + utils::hex(channel.firstByteIndex(),4) + "; 0x" + utils::hex(channel.lastByteIndex(),4) + "] " + utils::str(channel.value(), 9)
-							+ "\t = px[" + std::to_string(i) + ", " + std::to_string(k) + "] channel " + channelNamesOrderedAsInChlist[j] + "\n";
+							utils::tabs(tabsNum+1) + "[0x" + utils::hex64(scanline.sampleFirstByteIndex(j, k),4) + "; 0x" + utils::hex64(scanline.sampleLastByteIndex(j, k),4) + "] " + utils::str(sampleValue(j, row, k), 9)
+							+ "\t = px[" + std::to_string(row) + ", " + std::to_string(k) + "] channel " + channelNamesOrderedAsInChlist[j] + "\n";
+					}
+				}
+			}
+			return pixeldataStr;
+		}
+		/// <summary>
+		///		Same as toStringAsExrPixeldata(), for compressed image: sample byte ranges are given within uncompressed chunk data.
+		/// </summary>
+		std::string toStringAsExrChunks(std::vector<std::string>& channelNamesOrderedAsInChlist, const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns, const uint8_t tabsNum = 0) const
+		{
+			std::string pixeldataStr;
+			const std::vector<ScanlineChunk<channelCType32>> lazyChunks = m_isLazy ? chunkHeadersInFileOrder() : std::vector<ScanlineChunk<channelCType32>>();
+			for (const ScanlineChunk<channelCType32>& chunk : m_isLazy ? lazyChunks : m_chunks)		// chunks, as ordered in file
+			{
+				if (chunk.firstRow() + chunk.scanlinesNum() - 1 < rows.first() or rows.last() < chunk.firstRow())
+				{
+					continue;
+				}
+				pixeldataStr += utils::tabs(tabsNum) + "[0x" + utils::hex64(chunk.yFirstByteIndex(),4) + "; 0x" + utils::hex64(chunk.yLastByteIndex(),4) + "] chunk.y = " + std::to_string(chunk._y()) + " \n";
+				pixeldataStr += utils::tabs(tabsNum) + "[0x" + utils::hex64(chunk.dataSizeFirstByteIndex(),4) + "; 0x" + utils::hex64(chunk.dataSizeLastByteIndex(),4) + "] dataSizeInBytes = " + std::to_string(chunk._dataSizeInBytes())
+					+ (chunk.isCompressed() ? " (" + exr2::consta::compressionName(m_compression) : " (stored uncompressed")
+					+ ", " + std::to_string(chunk.scanlinesNum()) + " scanline(s), " + std::to_string(chunk.rawSizeInBytes()) + " bytes uncompressed) \n";
+				pixeldataStr += utils::tabs(tabsNum) + "[0x" + utils::hex64(chunk.dataSizeLastByteIndex()+1,4) + "; 0x" + utils::hex64(chunk.lastByteIndex(),4) + "] data \n";
+				pixeldataStr += utils::tabs(tabsNum) + "entries (byte ranges within uncompressed chunk data): \n";
+				for (uint32_t i = 0; i < chunk.scanlinesNum(); i++)					// scanline of chunk
+				{
+					const uint32_t row = chunk.firstRow() + i;
+					if (not rows.contains(row))
+					{
+						continue;
+					}
+					for (uint32_t j = 0; j < chunk.pixelChannelsNum(); j++)			// pixel channel
+					{
+						for (uint32_t k = columns.first(); k <= columns.last(); k++)	// scanline pixel index = column
+						{
+							const uint32_t sampleFirstByteIndex = chunk.rawSampleFirstByteIndex(i, j, k);
+							pixeldataStr += 
+								utils::tabs(tabsNum+1) + "[+0x" + utils::hex(sampleFirstByteIndex,4) + "; +0x" + utils::hex(sampleFirstByteIndex + chunk.sampleSizeInBytes(j) - 1,4) + "] " + utils::str(sampleValue(j, row, k), 9)
+								+ "\t = px[" + std::to_string(row) + ", " + std::to_string(k) + "] channel " + channelNamesOrderedAsInChlist[j] + "\n";
+						}
 					}
-					if (pixeldataStr[pixeldataStr.size()-1] == '\n') pixeldataStr.erase(pixeldataStr.end());	// remove last '\n'
 				}
 			}
 			return pixeldataStr;
 		}
 	
 		private:
-		std::vector<RegularScanline<channelCType32>> m_scanlines;
+		ImageBuffer<channelCType32> m_image;							// eager mode: samples of all scanlines
+		std::vector<RegularScanline<channelCType32>> m_scanlines;		// eager mode, uncompressed image: scanline headers, as ordered in file
+		std::vector<ScanlineChunk<channelCType32>> m_chunks;			// eager mode, compressed image: chunk headers, as ordered in file
+		uint32_t m_rowsNum = 0, m_columnsNum = 0;
+		int32_t m_firstRowY = 0;										// (y) of image row 0 = dataWindow.yMin
+		std::shared_ptr<const ScanlineDecoder<channelCType32>> m_decoder = nullptr;		// channels of each scanline, their data types, byte offsets and decoding kernels
+		std::vector<std::string> m_channelNames;						// ordered as in chlist
+		std::array<int32_t, 4> m_rgbaChannelIndexes = { -1, -1, -1, -1 };	// [s_c_rgbaR, s_c_rgbaG, s_c_rgbaB, s_c_rgbaA] = index of channel in chlist, -1 = no such channel
+		exr2::consta::s_compression::value m_compression = exr2::consta::s_compression::value::NO;
+		uint32_t m_scanlinesPerChunk = 1;
+		uint64_t m_firstByteIndex = 0, m_lastByteIndex = 0;
+		// lazy mode
+		bool m_isLazy = false;
+		ui8view m_filebytes;
+		std::vector<uint64_t> m_chunkOffsets;							// index = image row / m_scanlinesPerChunk
+		mutable ScanlineCache<channelCType32> m_cache;
+		mutable exrCompression::ChunkDecoders m_decoders;
+		mutable std::vector<ui8> m_rawBuffer;							// uncompressed data of last decoded chunk
+		mutable std::mutex m_cacheMutex;								// guards m_cache, m_decoders, m_rawBuffer
+		static const uint32_t s_c_tasksPerWorker = 4;
+		static const uint32_t s_c_chunkHeaderSizeInBytes = sizeof(int32_t) + sizeof(uint32_t);	// (y) and data size of scanline or chunk
+
+		utils::Range<uint32_t> allRows() const { return utils::Range<uint32_t>(0, m_rowsNum - 1); }
+		utils::Range<uint32_t> allColumns() const { return utils::Range<uint32_t>(0, m_columnsNum - 1); }
+		void tryValidateRegion(const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns) const
+		{
+			if (rows.last() < rows.first() or m_rowsNum <= rows.last() or columns.last() < columns.first() or m_columnsNum <= columns.last())
+			{
+				throw std::invalid_argument
+				(
+					"region rows [" + std::to_string(rows.first()) + "; " + std::to_string(rows.last()) + "], columns [" + std::to_string(columns.first()) + "; " + std::to_string(columns.last()) + "] "
+					"is not valid for image of " + std::to_string(m_rowsNum) + " rows and " + std::to_string(m_columnsNum) + " columns"
+				);
+			}
+		}
+		uint32_t chunksNumFor(const uint32_t imageRowsNum) const { return (imageRowsNum + m_scanlinesPerChunk - 1) / m_scanlinesPerChunk; }
+		ScanlineChunk<channelCType32> chunkHeader(const uint64_t chunkOffset) const
+		{
+			return ScanlineChunk<channelCType32>(m_filebytes, chunkOffset, m_decoder, m_scanlinesPerChunk, m_rowsNum, m_firstRowY);
+		}
+		/// <returns> image row of scanline of (y): (y) - dataWindow.yMin, -1 if it does not fit int32 (is out of any image) </returns>
+		int32_t rowOf(const int32_t y) const
+		{
+			const int64_t row = int64_t(y) - m_firstRowY;
+			return (row < 0 or INT32_MAX < row) ? -1 : int32_t(row);
+		}
+		/// <summary>
+		///		Call rangeFunc(first, last) for ranges of [0; itemsNum), several ranges per worker of (threadPool) to even out the load,
+		///		or once for whole range on calling thread, if (threadPool) is nullptr.
+		/// </summary>
+		template <typename RangeFunc>
+		static void forEachRange(utils::ThreadPool* threadPool, const std::size_t itemsNum, RangeFunc&& rangeFunc)
+		{
+			if (threadPool == nullptr)
+			{
+				rangeFunc(std::size_t(0), itemsNum);
+				return;
+			}
+			const std::size_t itemsPerTask = std::max<std::size_t>(1, itemsNum / (std::size_t(threadPool->workersNum() + 1) * s_c_tasksPerWorker));
+			threadPool->parallelFor(0, itemsNum, itemsPerTask, rangeFunc);
+		}
+
+		// validate scanline.y(), scanline row index
+		//		if (lineOrder == INCREASING_Y)		=> u_y must be the same as (scanlineIndex) value,
+		//		else if (lineOrder == DECREASING_Y) => u_y must be the same as (imageRowsNumber-1 - scanlineIndex),
+		//		else if (lineOrder == RANDOM_Y)		=> u_y must be in range [0; imageRowsNumber-1].
+		//		else => lineOrder value is unknown.
+		// (scanlineIndex) = index of scanline in file order. Rows are compared as int64_t: (scanlineY) may be negative (-1 = out of any image).
+		static void tryValidateScanlineY(const int32_t scanlineY, const uint32_t scanlineIndex, const uint32_t imageRowsNum, const exr2::consta::s_lineOrder::ctype lineOrderValue)
+		{
+			if (lineOrderValue == exr2::consta::s_lineOrder::value::INCREASING_Y)
+			{
+				if (int64_t(scanlineY) != int64_t(scanlineIndex))
+					throw std::runtime_error("(y) row value of scanline from .exr is different from (rowIndex) or (scanlineIndex). Check .exr lineOrder value to know actual order in your .exr file.");
+			}
+			else if (lineOrderValue == exr2::consta::s_lineOrder::value::DECREASING_Y)
+			{
+				if (int64_t(scanlineY) != int64_t(imageRowsNum) - 1 - scanlineIndex)
+					throw std::runtime_error("(y) row value of scanline from .exr is different from (imageRows-1-rowIndex) or (imageRows-1-scanlineIndex). Check .exr lineOrder value to know actual order in your .exr file.");
+			}
+			else if (lineOrderValue == exr2::consta::s_lineOrder::value::RANDOM_Y)
+			{
+				if ((scanlineY < 0) or (int64_t(imageRowsNum) <= scanlineY))
+					throw std::runtime_error("(y) row value of scanline from .exr is out of valid range [0; imageRowsNum-1]. Check .exr lineOrder value to know actual order in your .exr file.");
+			}
+			else throw std::runtime_error("(lineOrder) attribute of your .exr file has invalid value. Check OpenEXR documentation on valid lineOrder values.");
+		}
+		/// <summary>
+		///		Offset table must have one entry per chunk, and each entry must leave room for chunk header (y, data size) within filebytes.
+		///		Offsets are compared and then used as uint64_t, so entries past 4 GB are located, not wrapped.
+		/// </summary>
+		static void tryValidateChunkOffsets(const ui8view filebytes, const std::vector<uint64_t>& chunkOffsets, const uint32_t chunksNum)
+		{
+			if (chunkOffsets.size() != chunksNum or chunksNum == 0)
+			{
+				throw std::runtime_error("number of offset table entries (" + std::to_string(chunkOffsets.size()) + ") is different from number of image chunks (" + std::to_string(chunksNum) + ").");
+			}
+			for (const uint64_t offset : chunkOffsets)
+			{
+				if (filebytes.size() < s_c_chunkHeaderSizeInBytes or filebytes.size() - s_c_chunkHeaderSizeInBytes < offset)
+				{
+					throw std::runtime_error("offset table value 0x" + utils::hex64(offset) + " is out of file bytes range. File is truncated or is not a valid .exr file.");
+				}
+			}
+		}
+
+		/// <returns> [s_c_rgbaR, s_c_rgbaG, s_c_rgbaB, s_c_rgbaA] = index of "R", "G", "B", "A" channel within (channelNames), -1 if there is no such channel </returns>
+		static std::array<int32_t, 4> rgbaChannelIndexes(const std::vector<std::string>& channelNames, const std::vector<uint32_t>& channelDataTypes)
+		{
+			if (channelNames.size() != channelDataTypes.size() or channelNames.empty())
+			{
+				throw std::invalid_argument("(channelNames) and (channelDataTypes) must describe the same, non-zero number of channels");
+			}
+			return exrPixeldata::rgbaChannelIndexes(channelNames);
+		}
+		channelCType32 rgbaValue(const uint32_t rgbaIndex, const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const
+		{
+			const int32_t channelIndex = m_rgbaChannelIndexes[rgbaIndex];
+			if (channelIndex < 0)
+			{
+				tryValidatePixelRowIndex(pixelRowIndex);
+				tryValidatePixelColumnIndex(pixelColumnIndex);
+				return rgbaDefaultValue<channelCType32>(rgbaIndex);
+			}
+			return sampleValue(uint32_t(channelIndex), pixelRowIndex, pixelColumnIndex);
+		}
+		std::string channelsValuesString(const std::vector<uint32_t>& channelIndexes, const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex, const uint8_t fltPrecis) const
+		{
+			std::string str = "";
+			for (const uint32_t ch : channelIndexes)
+			{
+				const channelCType32 value = sampleValue(ch, pixelRowIndex, pixelColumnIndex);
+				str += (str.empty() ? "" : ", ") + (std::is_same_v<channelCType32, float> ? utils::str(value, fltPrecis) : std::to_string(value));
+			}
+			return str;
+		}
+		channelCType32 sampleValue(const uint32_t channelIndex, const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex) const
+		{
+			if (not m_isLazy)
+			{
+				return m_image.value(channelIndex, pixelRowIndex, pixelColumnIndex);
+			}
+			tryValidatePixelRowIndex(pixelRowIndex);
+			std::lock_guard<std::mutex> lock(m_cacheMutex);
+			return m_cache.slots().value(channelIndex, cachedScanlineSlot(pixelRowIndex), pixelColumnIndex);
+		}
+		/// <summary>
+		///		Lazy mode: find scanline of (pixelRowIndex) in cache, decoding it from filebytes on cache miss.
+		///		Caller must hold (m_cacheMutex).
+		/// </summary>
+		/// <returns> slot (row of m_cache.slots()) storing samples of (pixelRowIndex) image row </returns>
+		uint32_t cachedScanlineSlot(const uint32_t pixelRowIndex) const
+		{
+			uint32_t slot = 0;
+			if (m_cache.find(pixelRowIndex, slot))
+			{
+				return slot;
+			}
+			if (m_compression == exr2::consta::s_compression::value::NO)
+			{
+				const RegularScanline<channelCType32> scanline(m_filebytes, m_chunkOffsets[pixelRowIndex], m_decoder);
+				tryValidateChunkY(scanline._y(), pixelRowIndex, m_chunkOffsets[pixelRowIndex]);
+				slot = m_cache.insert(pixelRowIndex);
+				scanline.decodeInto(m_filebytes, m_cache.slots(), slot);
+				return slot;
+			}
+			// all scanlines of the chunk are cached: neighbouring rows are usually accessed next.
+			// Cache capacity is not less than scanlines per chunk, so scanlines of this chunk do not evict each other.
+			const uint32_t chunkIndex = pixelRowIndex / m_scanlinesPerChunk;
+			const ScanlineChunk<channelCType32> chunk = chunkHeader(m_chunkOffsets[chunkIndex]);
+			tryValidateChunkY(chunk._y(), chunkIndex * m_scanlinesPerChunk, m_chunkOffsets[chunkIndex]);
+			const ui8* raw = chunk.decodeData(m_filebytes, m_compression, m_decoders, m_rawBuffer);
+			for (uint32_t i = 0; i < chunk.scanlinesNum(); i++)
+			{
+				const uint32_t row = chunk.firstRow() + i;
+				uint32_t rowSlot = 0;
+				if (not m_cache.find(row, rowSlot))
+				{
+					rowSlot = m_cache.insert(row);
+				}
+				chunk.copyScanlineInto(raw, i, m_cache.slots(), rowSlot);
+			}
+			m_cache.find(pixelRowIndex, slot);
+			return slot;
+		}
+		/// <returns> lazy mode, uncompressed image: headers (not samples) of all scanlines, ordered as in file </returns>
+		std::vector<RegularScanline<channelCType32>> scanlineHeadersInFileOrder() const
+		{
+			std::vector<uint64_t> offsets = m_chunkOffsets;
+			std::sort(offsets.begin(), offsets.end());
+			std::vector<RegularScanline<channelCType32>> headers;
+			headers.reserve(offsets.size());
+			for (const uint64_t offset : offsets)
+			{
+				headers.push_back(RegularScanline<channelCType32>(m_filebytes, offset, m_decoder));
+			}
+			return headers;
+		}
+		/// <returns> lazy mode, compressed image: headers (not data) of all chunks, ordered as in file </returns>
+		std::vector<ScanlineChunk<channelCType32>> chunkHeadersInFileOrder() const
+		{
+			std::vector<uint64_t> offsets = m_chunkOffsets;
+			std::sort(offsets.begin(), offsets.end());
+			std::vector<ScanlineChunk<channelCType32>> headers;
+			headers.reserve(offsets.size());
+			for (const uint64_t offset : offsets)
+			{
+				headers.push_back(chunkHeader(offset));
+			}
+			return headers;
+		}
+		/// <summary>
+		///		Offset table is ordered by (y): chunk of (chunkIndex) entry must start at image row (chunkIndex * scanlinesPerChunk),
+		///		that is at (y) = dataWindow.yMin + (expectedRow).
+		/// </summary>
+		void tryValidateChunkY(const int32_t chunkY, const uint32_t expectedRow, const uint64_t chunkOffset) const
+		{
+			const int64_t expectedY = int64_t(m_firstRowY) + expectedRow;
+			if (chunkY != expectedY)
+			{
+				throw std::runtime_error("(y) row value of chunk at offset 0x" + utils::hex64(chunkOffset) + " is " + std::to_string(chunkY) + ", offset table entry is expected to point to chunk of row " + std::to_string(expectedY) + ". Offset table or chunk is corrupted.");
+			}
+		}
 
 		void tryValidatePixelRowIndex(const uint32_t pixelRowIndex) const
 		{
-			if (pixelRowIndex < 0 or (m_scanlines.size() - 1) < pixelRowIndex)
+			if (rowsNum() <= pixelRowIndex)
 			{
 				throw s_c_invalidPixelRowIndex;
 			}
 		}
 		void tryValidatePixelColumnIndex(const uint32_t pixelColumnIndex) const
 		{
-			if (pixelColumnIndex < 0 or (m_scanlines[0].pixelsNum() - 1) < pixelColumnIndex)
+			if (columnsNum() <= pixelColumnIndex)
 			{
 				throw s_c_invalidPixelColumnIndex;
 			}
@@ -0,0 +1,531 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "exrData/ChunkDecoder.h"
+#include "types.h"
+
+namespace exrCompression
+{
+	/// ReadMe: PIZ compression of OpenEXR
+	/*
+		source: https://openexr.com/en/latest/TechnicalIntroduction.html#data-compression , OpenEXR library (ImfPizCompressor, ImfHuf, ImfWav)
+		date: 2026.10.17
+
+		Chunk (32 scanlines or 1 tile) is compressed in 4 steps:
+		1. samples are regrouped by channel: all lines of channel 0, then all lines of channel 1, ...
+			each sample is 16-bit value(s): HALF - 1, UINT and FLOAT - 2 (low half first);
+		2. LUT: values which appear in chunk are marked in bitmap of 65536 bits, each value is replaced with its index among marked values
+			(0 is always marked), so values of chunk become [0; maxValue];
+		3. wavelet: each channel (each 16-bit half of 4-byte channel separately) is transformed with 2D Haar wavelet,
+			level by level (14-bit variant if maxValue < 2^14, modulo 2^16 variant otherwise);
+		4. result is Huffman coded (canonical code, runs of the same value are coded with extra run length symbol).
+
+		Chunk data:
+			uint16 minNonZero, uint16 maxNonZero	- range of non-zero bytes of bitmap (minNonZero > maxNonZero if bitmap is empty)
+			bitmap[minNonZero ~ maxNonZero]			- bytes of bitmap, value v is marked by bit (v & 7) of byte (v >> 3)
+			int32 length							- size of Huffman coded data
+			Huffman coded data:
+				uint32 im, iM, tableLength, nBits, 0	- code lengths are given for symbols [im; iM], iM is the run length symbol
+				code lengths							- 6 bits each, 59 ~ 62 = run of 2 ~ 5 zero lengths, 63 + 8 bits = run of 6 ~ 261 zero lengths
+				codes									- nBits bits, most significant bit first, run length symbol is followed by 8-bit count
+																of repetitions of previous value
+	*/
+
+	/// <summary>
+	///		Decoder of Huffman coded data of PIZ chunk (and of AC coefficients of DWA chunk). Keeps its tables between calls, so reuse one HuffmanDecoder per thread.
+	/// </summary>
+	class HuffmanDecoder
+	{
+		public:
+		/// <summary>
+		///		Decode Huffman coded (compressed) data into exactly (outNum) 16-bit values of (out). Throws runtime_error if data is invalid.
+		/// </summary>
+		void decode(const ui8view compressed, uint16_t* out, const std::size_t outNum)
+		{
+			if (compressed.empty())
+			{
+				if (outNum != 0)
+				{
+					throw std::runtime_error("Huffman coded data is empty, " + std::to_string(outNum) + " values expected.");
+				}
+				return;
+			}
+			if (compressed.size() < s_c_headerSizeInBytes)
+			{
+				throw std::runtime_error("Huffman coded data (" + std::to_string(compressed.size()) + " bytes) is shorter than its header.");
+			}
+			const uint32_t minSymbol = readUint32(compressed.data());
+			const uint32_t maxSymbol = readUint32(compressed.data() + 4);
+			const uint32_t bitsNum = readUint32(compressed.data() + 12);
+			if (s_c_symbolsNum <= minSymbol or s_c_symbolsNum <= maxSymbol or maxSymbol < minSymbol)
+			{
+				throw std::runtime_error("Huffman code table has invalid symbol range [" + std::to_string(minSymbol) + "; " + std::to_string(maxSymbol) + "].");
+			}
+			const ui8view table = compressed.subspan(s_c_headerSizeInBytes);
+			const std::size_t tableSize = unpackCodeLengths(table, minSymbol, maxSymbol);
+			const ui8view codes = table.subspan(tableSize);
+			if (codes.size() < (uint64_t(bitsNum) + 7) / 8)
+			{
+				throw std::runtime_error("Huffman coded data is truncated: " + std::to_string(bitsNum) + " bits expected, " + std::to_string(codes.size()) + " bytes left.");
+			}
+			buildCanonicalCodes();
+			buildDecodingTable();
+			decodeCodes(codes.data(), bitsNum, maxSymbol, out, outNum);
+		}
+
+		private:
+		static const uint32_t s_c_symbolsNum = 65537;			// 16-bit values + run length symbol
+		static const uint32_t s_c_maxCodeLength = 58;
+		static const uint32_t s_c_tableBits = 14;				// codes of up to 14 bits are decoded by one lookup
+		static const uint32_t s_c_tableSize = 1 << s_c_tableBits;
+		static const uint32_t s_c_shortZeroRun = 59, s_c_longZeroRun = 63, s_c_shortestLongZeroRun = 6;
+		static const std::size_t s_c_headerSizeInBytes = 20;
+
+		struct TableEntry
+		{
+			uint32_t symbol = 0;			// short code: decoded symbol, long codes: index of first of them in m_longCodeSymbols
+			uint16_t length = 0;			// short code: length in bits, 0 if entry is for long codes (or for no code)
+			uint16_t longCodesNum = 0;		// number of codes longer than s_c_tableBits, which start with bits of entry index
+		};
+		std::vector<uint64_t> m_codes = std::vector<uint64_t>(s_c_symbolsNum);		// code of symbol << 6 | length of code, valid for m_codedSymbols only
+		std::vector<uint32_t> m_codedSymbols;											// symbols, which have code (non-zero code length), ascending
+		std::vector<TableEntry> m_table = std::vector<TableEntry>(s_c_tableSize);
+		std::vector<uint32_t> m_longCodeSymbols;
+
+		static uint32_t readUint32(const ui8* bytes)
+		{
+			return uint32_t(bytes[0]) | (uint32_t(bytes[1]) << 8) | (uint32_t(bytes[2]) << 16) | (uint32_t(bytes[3]) << 24);
+		}
+		static uint64_t codeLength(const uint64_t code) { return code & 63; }
+		static uint64_t codeBits(const uint64_t code) { return code >> 6; }
+
+		/// <summary>
+		///		Read code lengths of symbols [minSymbol; maxSymbol] from (table) into m_codes, list symbols of non-zero length in m_codedSymbols.
+		/// </summary>
+		/// <returns> number of bytes of (table) used </returns>
+		std::size_t unpackCodeLengths(const ui8view table, const uint32_t minSymbol, const uint32_t maxSymbol)
+		{
+			uint64_t buffer = 0;
+			uint32_t bufferBits = 0;
+			std::size_t position = 0;
+			m_codedSymbols.clear();
+			const auto readBits = [&](const uint32_t bitsNum) -> uint32_t
+			{
+				while (bufferBits < bitsNum)
+				{
+					if (table.size() <= position)
+					{
+						throw std::runtime_error("Huffman code table is truncated.");
+					}
+					buffer = (buffer << 8) | table[position++];
+					bufferBits += 8;
+				}
+				bufferBits -= bitsNum;
+				return uint32_t(buffer >> bufferBits) & ((1u << bitsNum) - 1);
+			};
+			for (uint32_t symbol = minSymbol; symbol <= maxSymbol; symbol++)
+			{
+				const uint32_t length = readBits(6);
+				if (length < s_c_shortZeroRun)
+				{
+					if (length != 0)
+					{
+						m_codes[symbol] = length;
+						m_codedSymbols.push_back(symbol);
+					}
+					continue;
+				}
+				const uint32_t zerosNum = (length == s_c_longZeroRun) ? readBits(8) + s_c_shortestLongZeroRun : length - s_c_shortZeroRun + 2;
+				if (maxSymbol + 1 - symbol < zerosNum)
+				{
+					throw std::runtime_error("Huffman code table is longer than its symbol range.");
+				}
+				symbol += zerosNum - 1;
+			}
+			return position;
+		}
+		/// <summary>
+		///		Assign canonical codes to code lengths of m_codes: longer codes come first, codes of the same length are consecutive in symbol order.
+		/// </summary>
+		void buildCanonicalCodes()
+		{
+			uint64_t codesOfLength[s_c_maxCodeLength + 1] = {};
+			for (const uint32_t symbol : m_codedSymbols)
+			{
+				codesOfLength[m_codes[symbol]]++;
+			}
+			uint64_t code = 0;
+			for (uint32_t length = s_c_maxCodeLength; 0 < length; length--)
+			{
+				const uint64_t nextCode = (code + codesOfLength[length]) >> 1;
+				codesOfLength[length] = code;		// first code of the length
+				code = nextCode;
+			}
+			for (const uint32_t symbol : m_codedSymbols)
+			{
+				const uint64_t length = m_codes[symbol];
+				m_codes[symbol] = length | (codesOfLength[length]++ << 6);
+			}
+		}
+		/// <summary>
+		///		Fill m_table: entry of each (s_c_tableBits)-bit prefix of short code gives symbol and length,
+		///		entry of (s_c_tableBits) first bits of long codes lists their symbols in m_longCodeSymbols.
+		/// </summary>
+		void buildDecodingTable()
+		{
+			std::fill(m_table.begin(), m_table.end(), TableEntry());
+			std::size_t longCodesNum = 0;
+			for (const uint32_t symbol : m_codedSymbols)
+			{
+				const uint64_t length = codeLength(m_codes[symbol]), bits = codeBits(m_codes[symbol]);
+				if ((bits >> length) != 0)
+				{
+					throw std::runtime_error("Huffman code table is invalid (code of symbol " + std::to_string(symbol) + " is longer than its length).");
+				}
+				if (s_c_tableBits < length)
+				{
+					TableEntry& entry = m_table[std::size_t(bits >> (length - s_c_tableBits))];
+					if (entry.length != 0 or entry.longCodesNum == UINT16_MAX)
+					{
+						throw std::runtime_error("Huffman code table is invalid (code of symbol " + std::to_string(symbol) + " overlaps shorter code).");
+					}
+					entry.longCodesNum++;
+					longCodesNum++;
+					continue;
+				}
+				const std::size_t firstEntry = std::size_t(bits << (s_c_tableBits - length)), entriesNum = std::size_t(1) << (s_c_tableBits - length);
+				for (std::size_t i = firstEntry; i < firstEntry + entriesNum; i++)
+				{
+					if (m_table[i].length != 0 or m_table[i].longCodesNum != 0)
+					{
+						throw std::runtime_error("Huffman code table is invalid (code of symbol " + std::to_string(symbol) + " overlaps another code).");
+					}
+					m_table[i].symbol = symbol;
+					m_table[i].length = uint16_t(length);
+				}
+			}
+			if (longCodesNum == 0)
+			{
+				return;
+			}
+			// symbols of long codes, grouped by entry: entry.symbol is end of group first, then is decremented by each symbol put
+			m_longCodeSymbols.resize(longCodesNum);
+			uint32_t groupEnd = 0;
+			for (TableEntry& entry : m_table)
+			{
+				groupEnd += entry.longCodesNum;
+				entry.symbol = (entry.length == 0) ? groupEnd : entry.symbol;
+			}
+			for (auto symbol = m_codedSymbols.rbegin(); symbol != m_codedSymbols.rend(); symbol++)
+			{
+				const uint64_t length = codeLength(m_codes[*symbol]);
+				if (s_c_tableBits < length)
+				{
+					m_longCodeSymbols[--m_table[std::size_t(codeBits(m_codes[*symbol]) >> (length - s_c_tableBits))].symbol] = *symbol;
+				}
+			}
+		}
+		/// <summary>
+		///		Decode (bitsNum) bits of (codes) into (outNum) values of (out): (runSymbol) repeats previous value.
+		/// </summary>
+		void decodeCodes(const ui8* codes, const uint64_t bitsNum, const uint32_t runSymbol, uint16_t* out, const std::size_t outNum) const
+		{
+			const ui8* in = codes;
+			const ui8* const inEnd = codes + (bitsNum + 7) / 8;
+			uint64_t buffer = 0;
+			uint32_t bufferBits = 0;
+			uint64_t bitsLeft = bitsNum;			// bits of codes, which are not consumed yet (padding of last byte excluded)
+			std::size_t outPos = 0;
+			// fills buffer with whole bytes: 57 ~ 64 bits, unless codes end
+			const auto refill = [&]()
+			{
+				while (bufferBits <= 56 and in < inEnd)
+				{
+					buffer = (buffer << 8) | *in++;
+					bufferBits += 8;
+				}
+			};
+			const auto put = [&](const uint32_t symbol)
+			{
+				if (symbol != runSymbol)
+				{
+					if (outPos == outNum)
+					{
+						throw std::runtime_error("Huffman coded data decodes to more than " + std::to_string(outNum) + " values expected.");
+					}
+					out[outPos++] = uint16_t(symbol);
+					return;
+				}
+				if (bufferBits < 8)
+				{
+					refill();
+				}
+				if (bitsLeft < 8 or bufferBits < 8)
+				{
+					throw std::runtime_error("Huffman coded data ends inside run length.");
+				}
+				bufferBits -= 8;
+				bitsLeft -= 8;
+				const std::size_t repeatsNum = std::size_t(buffer >> bufferBits) & 0xFF;
+				if (outPos == 0 or outNum - outPos < repeatsNum)
+				{
+					throw std::runtime_error("Huffman coded data has invalid run of " + std::to_string(repeatsNum) + " values at value " + std::to_string(outPos) + ".");
+				}
+				std::fill(out + outPos, out + outPos + repeatsNum, out[outPos - 1]);
+				outPos += repeatsNum;
+			};
+			while (0 < bitsLeft)
+			{
+				if (bufferBits < s_c_tableBits)
+				{
+					refill();
+				}
+				const std::size_t prefix = std::size_t((s_c_tableBits <= bufferBits) ? (buffer >> (bufferBits - s_c_tableBits)) : (buffer << (s_c_tableBits - bufferBits))) & (s_c_tableSize - 1);
+				const TableEntry& entry = m_table[prefix];
+				if (entry.length != 0)
+				{
+					if (bitsLeft < entry.length)
+					{
+						throw std::runtime_error("Huffman coded data ends inside a code.");
+					}
+					bufferBits -= entry.length;
+					bitsLeft -= entry.length;
+					put(entry.symbol);
+					continue;
+				}
+				refill();
+				bool isFound = false;
+				for (uint32_t i = entry.symbol; i < entry.symbol + entry.longCodesNum; i++)
+				{
+					const uint32_t symbol = m_longCodeSymbols[i];
+					const uint32_t length = uint32_t(codeLength(m_codes[symbol]));
+					if (length <= bufferBits and length <= bitsLeft and ((buffer >> (bufferBits - length)) & ((uint64_t(1) << length) - 1)) == codeBits(m_codes[symbol]))
+					{
+						bufferBits -= length;
+						bitsLeft -= length;
+						put(symbol);
+						isFound = true;
+						break;
+					}
+				}
+				if (not isFound)
+				{
+					throw std::runtime_error("Huffman coded data of PIZ chunk has invalid code at value " + std::to_string(outPos) + ".");
+				}
+			}
+			if (outPos != outNum)
+			{
+				throw std::runtime_error("Huffman coded data of PIZ chunk decodes to " + std::to_string(outPos) + " values, " + std::to_string(outNum) + " values expected.");
+			}
+		}
+	};
+
+	/// <summary>
+	///		Inverse of one step of 14-bit Haar wavelet: (low, high) => (a, b).
+	/// </summary>
+	inline void waveletDecode14(const uint16_t low, const uint16_t high, uint16_t& a, uint16_t& b)
+	{
+		const int32_t h = int16_t(high);
+		const int32_t ai = int16_t(low) + (h & 1) + (h >> 1);
+		a = uint16_t(int16_t(ai));
+		b = uint16_t(int16_t(ai - h));
+	}
+	/// <summary>
+	///		Inverse of one step of modulo 2^16 Haar wavelet: (low, high) => (a, b).
+	/// </summary>
+	inline void waveletDecode16(const uint16_t low, const uint16_t high, uint16_t& a, uint16_t& b)
+	{
+		const int32_t bi = (int32_t(low) - (int32_t(high) >> 1)) & 0xFFFF;
+		a = uint16_t((int32_t(high) + bi - 0x8000) & 0xFFFF);
+		b = uint16_t(bi);
+	}
+
+	/// <summary>
+	///		Inverse 2D Haar wavelet of (nx) x (ny) values of (in), in place: value (x, y) is in[x * ox + y * oy].
+	///		Levels are reversed from the coarsest one: level p combines values at distance p into 2 x 2 blocks at distance 2p.
+	/// </summary>
+	template <bool is14Bit>
+	void waveletDecode(uint16_t* in, const int32_t nx, const int32_t ox, const int32_t ny, const int32_t oy)
+	{
+		const auto step = [](const uint16_t low, const uint16_t high, uint16_t& a, uint16_t& b)
+		{
+			if constexpr (is14Bit) waveletDecode14(low, high, a, b);
+			else waveletDecode16(low, high, a, b);
+		};
+		const int32_t n = std::min(nx, ny);
+		int32_t p = 1;
+		while (p <= n)
+		{
+			p <<= 1;
+		}
+		p >>= 1;
+		int32_t p2 = p;
+		p >>= 1;
+		for (; 1 <= p; p2 = p, p >>= 1)
+		{
+			const std::ptrdiff_t ox1 = std::ptrdiff_t(ox) * p, oy1 = std::ptrdiff_t(oy) * p;
+			int32_t y = 0;
+			for (; y <= ny - p2; y += p2)
+			{
+				uint16_t* const py = in + std::ptrdiff_t(oy) * y;
+				int32_t x = 0;
+				for (; x <= nx - p2; x += p2)
+				{
+					uint16_t* const p00 = py + std::ptrdiff_t(ox) * x;
+					uint16_t* const p01 = p00 + ox1;
+					uint16_t* const p10 = p00 + oy1;
+					uint16_t* const p11 = p10 + ox1;
+					uint16_t i00, i01, i10, i11;
+					step(*p00, *p10, i00, i10);
+					step(*p01, *p11, i01, i11);
+					step(i00, i01, *p00, *p01);
+					step(i10, i11, *p10, *p11);
+				}
+				// odd column
+				if (nx & p)
+				{
+					uint16_t* const p00 = py + std::ptrdiff_t(ox) * x;
+					uint16_t i00;
+					step(*p00, *(p00 + oy1), i00, *(p00 + oy1));
+					*p00 = i00;
+				}
+			}
+			// odd line
+			if (ny & p)
+			{
+				uint16_t* const py = in + std::ptrdiff_t(oy) * y;
+				for (int32_t x = 0; x <= nx - p2; x += p2)
+				{
+					uint16_t* const p00 = py + std::ptrdiff_t(ox) * x;
+					uint16_t i00;
+					step(*p00, *(p00 + ox1), i00, *(p00 + ox1));
+					*p00 = i00;
+				}
+			}
+		}
+	}
+
+	/// <summary>
+	///		Decompressor of PIZ chunk data. Keeps its buffers and Huffman tables between calls, so reuse one PizDecoder per thread.
+	/// </summary>
+	class PizDecoder : public ChunkDecoder
+	{
+		public:
+		/// <summary>
+		///		Decompress (compressed) chunk data of (layout) into (out), reversing Huffman coding, wavelet, LUT and channel regrouping steps.
+		/// </summary>
+		/// <param name="rawSize"> - size of uncompressed chunk data, (out) must have room for it </param>
+		void decode(const ui8view compressed, const ChunkLayout& layout, ui8* out, const std::size_t rawSize) override
+		{
+			tryValidateLayout(layout, rawSize, "PIZ");
+			// bitmap of values and LUT
+			if (compressed.size() < 4)
+			{
+				throw std::runtime_error("PIZ chunk data (" + std::to_string(compressed.size()) + " bytes) is shorter than its bitmap range.");
+			}
+			const uint32_t minNonZero = uint32_t(compressed[0]) | (uint32_t(compressed[1]) << 8);
+			const uint32_t maxNonZero = uint32_t(compressed[2]) | (uint32_t(compressed[3]) << 8);
+			if (s_c_bitmapSize <= maxNonZero)
+			{
+				throw std::runtime_error("PIZ chunk bitmap range [" + std::to_string(minNonZero) + "; " + std::to_string(maxNonZero) + "] is out of bitmap (" + std::to_string(s_c_bitmapSize) + " bytes).");
+			}
+			std::size_t position = 4;
+			std::fill(m_bitmap.begin(), m_bitmap.end(), ui8(0));
+			if (minNonZero <= maxNonZero)
+			{
+				const std::size_t bitmapBytesNum = maxNonZero - minNonZero + 1;
+				if (compressed.size() - position < bitmapBytesNum)
+				{
+					throw std::runtime_error("PIZ chunk data is truncated inside bitmap.");
+				}
+				std::memcpy(m_bitmap.data() + minNonZero, compressed.data() + position, bitmapBytesNum);
+				position += bitmapBytesNum;
+			}
+			const uint16_t maxValue = reverseLutFromBitmap();
+			// Huffman coded data
+			if (compressed.size() - position < 4)
+			{
+				throw std::runtime_error("PIZ chunk data is truncated before Huffman coded data.");
+			}
+			const uint32_t codedSize = uint32_t(compressed[position]) | (uint32_t(compressed[position+1]) << 8) | (uint32_t(compressed[position+2]) << 16) | (uint32_t(compressed[position+3]) << 24);
+			position += 4;
+			if (compressed.size() - position < codedSize)
+			{
+				throw std::runtime_error("Huffman coded data of PIZ chunk (" + std::to_string(codedSize) + " bytes) is out of chunk data.");
+			}
+			const std::size_t valuesNum = rawSize / 2;
+			m_values.resize(valuesNum);
+			m_huffmanDecoder.decode(compressed.subspan(position, codedSize), m_values.data(), valuesNum);
+			// wavelet of each 16-bit half of each channel: channels are stored one after another, (height) lines of (width) samples each
+			std::size_t channelFirstValue = 0;
+			for (const uint32_t channelDataType : layout.channelDataTypes)
+			{
+				const int32_t halvesNum = int32_t(exr2::consta::channel::channelDataTypeSizeInBytes(channelDataType) / 2);
+				for (int32_t half = 0; half < halvesNum; half++)
+				{
+					uint16_t* const first = m_values.data() + channelFirstValue + half;
+					if (maxValue < (1 << 14))
+					{
+						waveletDecode<true>(first, int32_t(layout.width), halvesNum, int32_t(layout.height), int32_t(layout.width) * halvesNum);
+					}
+					else
+					{
+						waveletDecode<false>(first, int32_t(layout.width), halvesNum, int32_t(layout.height), int32_t(layout.width) * halvesNum);
+					}
+				}
+				channelFirstValue += std::size_t(halvesNum) * layout.width * layout.height;
+			}
+			for (uint16_t& value : m_values)
+			{
+				value = m_lut[value];
+			}
+			// lines of channels => lines of chunk data (16-bit values are little-endian, as file data)
+			ui8* outLine = out;
+			for (uint32_t line = 0; line < layout.height; line++)
+			{
+				channelFirstValue = 0;
+				for (const uint32_t channelDataType : layout.channelDataTypes)
+				{
+					const std::size_t channelLineSize = std::size_t(exr2::consta::channel::channelDataTypeSizeInBytes(channelDataType)) * layout.width;
+					std::memcpy(outLine, m_values.data() + channelFirstValue + line * (channelLineSize / 2), channelLineSize);
+					outLine += channelLineSize;
+					channelFirstValue += (channelLineSize / 2) * layout.height;
+				}
+			}
+		}
+
+		private:
+		static const std::size_t s_c_bitmapSize = 65536 / 8;
+		std::vector<ui8> m_bitmap = std::vector<ui8>(s_c_bitmapSize);
+		std::vector<uint16_t> m_lut = std::vector<uint16_t>(65536);
+		std::vector<uint16_t> m_values;
+		HuffmanDecoder m_huffmanDecoder;
+
+		/// <summary>
+		///		Fill m_lut: index of value among values marked in m_bitmap (0 is always marked) => value, unused indexes => 0.
+		/// </summary>
+		/// <returns> largest index (number of marked values - 1) </returns>
+		uint16_t reverseLutFromBitmap()
+		{
+			uint32_t k = 0;
+			m_lut[k++] = 0;
+			for (uint32_t byteIndex = 0; byteIndex < s_c_bitmapSize; byteIndex++)
+			{
+				for (uint32_t bits = m_bitmap[byteIndex] & ((byteIndex == 0) ? 0xFE : 0xFF); bits != 0; bits &= bits - 1)
+				{
+					m_lut[k++] = uint16_t(byteIndex * 8 + std::countr_zero(bits));
+				}
+			}
+			const uint16_t maxIndex = uint16_t(k - 1);
+			std::fill(m_lut.begin() + k, m_lut.end(), uint16_t(0));
+			return maxIndex;
+		}
+	};
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "exrData/ChunkDecoder.h"
+#include "exrData/exrConsta.h"
+#include "exrData/Zip.h"
+#include "types.h"
+
+namespace exrCompression
+{
+	/// ReadMe: PXR24 compression of OpenEXR
+	/*
+		source: https://openexr.com/en/latest/TechnicalIntroduction.html#data-compression , OpenEXR library (ImfPxr24Compressor)
+		date: 2026.10.17
+
+		Chunk (16 scanlines or 1 tile) is compressed in 3 steps, lossy for FLOAT channels only:
+		1. FLOAT samples are rounded to 24-bit floats (8-bit exponent, 15-bit mantissa), UINT and HALF samples are kept as they are;
+		2. predictor: within each line of each channel, each sample (as unsigned integer) is replaced with (sample - previous sample),
+			first sample of line - with (sample - 0), then bytes of the line of differences are split into planes:
+			most significant bytes of all samples, then next bytes, ... (UINT - 4 planes, HALF - 2 planes, FLOAT - 3 planes);
+		3. result (lines of channels, as uncompressed chunk data) is compressed with zlib (deflate).
+		Decompressed FLOAT sample is 24-bit float with 8 zero low bits appended.
+		If compressed data is not smaller than uncompressed, chunk stores uncompressed data instead.
+	*/
+
+	/// <summary>
+	///		Decompressor of PXR24 chunk data. Keeps its buffers between calls, so reuse one Pxr24Decoder per thread.
+	/// </summary>
+	class Pxr24Decoder : public ChunkDecoder
+	{
+		public:
+		/// <summary>
+		///		Decompress (compressed) chunk data of (layout) into (out), reversing zlib, byte planes and predictor steps.
+		/// </summary>
+		/// <param name="rawSize"> - size of uncompressed chunk data, (out) must have room for it </param>
+		void decode(const ui8view compressed, const ChunkLayout& layout, ui8* out, const std::size_t rawSize) override
+		{
+			tryValidateLayout(layout, rawSize, "PXR24");
+			std::size_t packedLineSize = 0;
+			for (const uint32_t channelDataType : layout.channelDataTypes)
+			{
+				packedLineSize += std::size_t(packedSampleSizeInBytes(channelDataType)) * layout.width;
+			}
+			const std::size_t packedSize = packedLineSize * layout.height;
+			m_packed.resize(packedSize);
+			const std::size_t inflatedSize = zlibDecompress(compressed, m_packed.data(), packedSize);
+			if (inflatedSize != packedSize)
+			{
+				throw std::runtime_error("PXR24 chunk decompresses to " + std::to_string(inflatedSize) + " bytes, " + std::to_string(packedSize) + " bytes expected.");
+			}
+			const std::size_t width = layout.width;
+			const ui8* in = m_packed.data();
+			for (uint32_t line = 0; line < layout.height; line++)
+			{
+				for (const uint32_t channelDataType : layout.channelDataTypes)
+				{
+					uint32_t pixel = 0;
+					if (channelDataType == exr2::consta::channel::datatype::UINT)
+					{
+						const ui8* plane0 = in;
+						const ui8* plane1 = plane0 + width;
+						const ui8* plane2 = plane1 + width;
+						const ui8* plane3 = plane2 + width;
+						for (std::size_t i = 0; i < width; i++)
+						{
+							pixel += (uint32_t(plane0[i]) << 24) | (uint32_t(plane1[i]) << 16) | (uint32_t(plane2[i]) << 8) | uint32_t(plane3[i]);
+							writeLE32(out + 4*i, pixel);
+						}
+						in += 4 * width;
+						out += 4 * width;
+					}
+					else if (channelDataType == exr2::consta::channel::datatype::HALF)
+					{
+						const ui8* plane0 = in;
+						const ui8* plane1 = plane0 + width;
+						for (std::size_t i = 0; i < width; i++)
+						{
+							pixel += (uint32_t(plane0[i]) << 8) | uint32_t(plane1[i]);
+							out[2*i] = ui8(pixel);
+							out[2*i + 1] = ui8(pixel >> 8);
+						}
+						in += 2 * width;
+						out += 2 * width;
+					}
+					else
+					{
+						const ui8* plane0 = in;
+						const ui8* plane1 = plane0 + width;
+						const ui8* plane2 = plane1 + width;
+						for (std::size_t i = 0; i < width; i++)
+						{
+							pixel += (uint32_t(plane0[i]) << 24) | (uint32_t(plane1[i]) << 16) | (uint32_t(plane2[i]) << 8);
+							writeLE32(out + 4*i, pixel);
+						}
+						in += 3 * width;
+						out += 4 * width;
+					}
+				}
+			}
+		}
+
+		private:
+		std::vector<ui8> m_packed;
+
+		/// <returns> size of sample of (channelDataType) after PXR24 packing: UINT 4, HALF 2, FLOAT 3 </returns>
+		static uint32_t packedSampleSizeInBytes(const uint32_t channelDataType)
+		{
+			return (channelDataType == exr2::consta::channel::datatype::FLOAT) ? 3 : exr2::consta::channel::channelDataTypeSizeInBytes(channelDataType);
+		}
+		static void writeLE32(ui8* out, const uint32_t value)
+		{
+			out[0] = ui8(value);
+			out[1] = ui8(value >> 8);
+			out[2] = ui8(value >> 16);
+			out[3] = ui8(value >> 24);
+		}
+	};
+}
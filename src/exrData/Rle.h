@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "exrData/ChunkDecoder.h"
+#include "exrData/ChunkEncoder.h"
+#include "types.h"
+
+namespace exrCompression
+{
+	/// ReadMe: RLE compression of OpenEXR
+	/*
+		source: https://openexr.com/en/latest/TechnicalIntroduction.html#data-compression
+		date: 2026.10.17
+
+		Chunk (of 1 scanline) is compressed in 3 steps, the first two are the same as of ZIP:
+		1. bytes of uncompressed chunk are split: bytes with even index go to first half, bytes with odd index - to second half;
+		2. predictor: each byte is replaced with (byte - previous byte + 128);
+		3. result is run-length encoded: signed count byte, then
+			count < 0	=> -count bytes follow, copied as they are (literal run of 1 ~ 128 bytes),
+			count >= 0	=> one byte follows, repeated count + 1 times (run of 1 ~ 128 equal bytes).
+		If compressed data is not smaller than uncompressed, chunk stores uncompressed data instead.
+	*/
+
+	/// <summary>
+	///		Run-length decode (compressed) into exactly (rawSize) bytes of (out): step 3 of RLE compression, also used by RLE channels of DWA.
+	/// </summary>
+	/// <param name="dataName"> - name of decoded data for error messages, e.g. "RLE chunk" </param>
+	inline void runLengthDecode(const ui8view compressed, ui8* out, const std::size_t rawSize, const std::string& dataName)
+	{
+		std::size_t inPos = 0, outPos = 0;
+		while (inPos < compressed.size())
+		{
+			const int8_t count = int8_t(compressed[inPos++]);
+			const std::size_t runSize = (count < 0) ? std::size_t(-int32_t(count)) : std::size_t(count) + 1;
+			if (rawSize - outPos < runSize)
+			{
+				throw std::runtime_error(dataName + " decompresses to more than " + std::to_string(rawSize) + " bytes expected (run of " + std::to_string(runSize) + " bytes at compressed byte " + std::to_string(inPos - 1) + ").");
+			}
+			const std::size_t runInputSize = (count < 0) ? runSize : 1;
+			if (compressed.size() - inPos < runInputSize)
+			{
+				throw std::runtime_error(dataName + " data ends inside a run (at compressed byte " + std::to_string(inPos - 1) + ").");
+			}
+			if (count < 0)
+			{
+				std::memcpy(out + outPos, compressed.data() + inPos, runSize);
+			}
+			else
+			{
+				std::memset(out + outPos, compressed[inPos], runSize);
+			}
+			inPos += runInputSize;
+			outPos += runSize;
+		}
+		if (outPos != rawSize)
+		{
+			throw std::runtime_error(dataName + " decompresses to " + std::to_string(outPos) + " bytes, " + std::to_string(rawSize) + " bytes expected.");
+		}
+	}
+
+	/// <summary>
+	///		Run-length encode (raw) and append result to (out): step 3 of RLE compression (reversed by runLengthDecode()), also used by RLE channels of DWA.
+	///		Runs of 3 or more equal bytes are stored as repeated byte, other bytes - as literal runs.
+	/// </summary>
+	inline void runLengthEncode(const ui8view raw, std::vector<ui8>& out)
+	{
+		const std::size_t c_maxRunSize = 128, c_minRepeatSize = 3;
+		const auto repeatSizeAt = [&](const std::size_t position)
+		{
+			std::size_t size = 1;
+			while (position + size < raw.size() and raw[position + size] == raw[position] and size < c_maxRunSize)
+			{
+				size++;
+			}
+			return size;
+		};
+		std::size_t position = 0;
+		while (position < raw.size())
+		{
+			const std::size_t repeatSize = repeatSizeAt(position);
+			if (c_minRepeatSize <= repeatSize)
+			{
+				out.push_back(ui8(repeatSize - 1));
+				out.push_back(raw[position]);
+				position += repeatSize;
+				continue;
+			}
+			// literal run ends where a repeated run starts
+			std::size_t literalSize = repeatSize;
+			while (position + literalSize < raw.size() and literalSize < c_maxRunSize and repeatSizeAt(position + literalSize) < c_minRepeatSize)
+			{
+				literalSize++;
+			}
+			out.push_back(ui8(-int32_t(literalSize)));
+			out.insert(out.end(), raw.begin() + position, raw.begin() + position + literalSize);
+			position += literalSize;
+		}
+	}
+
+	/// <summary>
+	///		Decompressor of RLE chunk data. Keeps its buffer between calls, so reuse one RleDecoder per thread.
+	/// </summary>
+	class RleDecoder : public ChunkDecoder
+	{
+		public:
+		/// <summary>
+		///		Decompress (compressed) chunk data into (out), reversing run-length, predictor and byte split steps.
+		/// </summary>
+		/// <param name="rawSize"> - size of uncompressed chunk data, (out) must have room for it </param>
+		void decode(const ui8view compressed, const ChunkLayout& /*layout*/, ui8* out, const std::size_t rawSize) override
+		{
+			m_unpacked.resize(rawSize);
+			runLengthDecode(compressed, m_unpacked.data(), rawSize, "RLE chunk");
+			reversePredictorAndByteSplit(m_unpacked.data(), out, rawSize);
+		}
+
+		private:
+		std::vector<ui8> m_unpacked;
+	};
+
+	/// <summary>
+	///		Compressor of RLE chunk data. Keeps its buffer between calls, so reuse one RleEncoder per thread.
+	/// </summary>
+	class RleEncoder : public ChunkEncoder
+	{
+		public:
+		void encode(const ui8view raw, const ChunkLayout& /*layout*/, std::vector<ui8>& out) override
+		{
+			m_predicted.resize(raw.size());
+			byteSplitAndPredictor(raw.data(), m_predicted.data(), raw.size());
+			out.clear();
+			runLengthEncode(ui8view(m_predicted.data(), m_predicted.size()), out);
+		}
+
+		private:
+		std::vector<ui8> m_predicted;
+	};
+}
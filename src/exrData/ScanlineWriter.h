@@ -0,0 +1,286 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "exrData/ChunkEncoder.h"
+#include "exrData/Compression.h"
+#include "exrData/exrConsta.h"
+#include "exrData/Half.h"
+#include "exrData/ImageBuffer.h"
+#include "exrData/Pixeldata.h"
+#include "FileBytes.h"
+#include "ThreadPool.h"
+#include "types.h"
+
+namespace exrPixeldata
+{
+	/// <summary>
+	///		Writer of single-part scanline .exr file: magic number, version field, header, offset table, then chunks of chosen compression,
+	///		encoded from samples of image rows. Chunks are written in lineOrder, window by window: rows of a window of chunks are fetched,
+	///		its chunks are packed and encoded concurrently (one slot per thread), then appended to file in order, so memory used
+	///		is bounded by the window, not by the image. Offset table is written last, over its zeroed placeholder.
+	/// </summary>
+	class ScanlineWriter
+	{
+		public:
+		/// <summary>
+		///		Samples of image rows (rows): rows.size() rows x image width columns, one array per channel (ordered as in chlist).
+		///		Called on the thread calling write(), once per window of chunks, rows in increasing order within the window.
+		/// </summary>
+		using RowsSource = std::function<ImageBuffer<float>(const utils::Range<uint32_t>& rows)>;
+		/// <summary>
+		///		Exact samples of UINT channels of image rows (rows): rows.size() rows x image width columns, one array per UINT channel only
+		///		(ordered as in chlist). Called right after RowsSource, for the same rows, if image has UINT channels.
+		/// </summary>
+		using UintRowsSource = std::function<ImageBuffer<uint32_t>(const utils::Range<uint32_t>& rows)>;
+
+		/// <param name="channelNames"> - name of each channel, ordered as in chlist </param>
+		/// <param name="channelDataTypes"> - exr2::consta::channel::datatype of each channel, ordered as in chlist </param>
+		/// <param name="yMin"> - y of image row 0 (dataWindow.yMin), stored in each chunk </param>
+		/// <param name="lineOrder"> - INCREASING_Y or DECREASING_Y (file order of chunks) </param>
+		ScanlineWriter(const std::vector<std::string>& channelNames, const std::vector<uint32_t>& channelDataTypes, const uint32_t width, const uint32_t height, const int32_t yMin,
+			const exr2::consta::s_compression::value compression, const exr2::consta::s_lineOrder::ctype lineOrder)
+			: m_layout(channelNames, channelDataTypes, width), m_rowsNum(height), m_yMin(yMin), m_compression(compression), m_lineOrder(lineOrder)
+		{
+			if (width == 0 or height == 0)
+			{
+				throw std::invalid_argument("ScanlineWriter: image must have at least 1 row and 1 column.");
+			}
+			if (not exrCompression::isEncodingSupported(compression))
+			{
+				throw std::invalid_argument("ScanlineWriter: " + exr2::consta::compressionName(compression) + " compression can not be written (supported: " + exrCompression::encodingSupportedNames() + ").");
+			}
+			if (lineOrder != exr2::consta::s_lineOrder::value::INCREASING_Y and lineOrder != exr2::consta::s_lineOrder::value::DECREASING_Y)
+			{
+				throw std::invalid_argument("ScanlineWriter: lineOrder of scanline file must be INCREASING_Y or DECREASING_Y.");
+			}
+			m_hasLongNames = std::any_of(channelNames.begin(), channelNames.end(), [](const std::string& name) { return s_c_shortNameMaxLength < name.size(); });
+			m_uintChannelsNum = uint32_t(std::count(channelDataTypes.begin(), channelDataTypes.end(), uint32_t(exr2::consta::channel::datatype::UINT)));
+			m_scanlinesPerChunk = exr2::consta::scanlinesPerChunk(compression);
+			m_chunksNum = (m_rowsNum + m_scanlinesPerChunk - 1) / m_scanlinesPerChunk;
+			if (uint64_t(m_layout.sizeInBytes()) * m_scanlinesPerChunk > uint64_t(INT32_MAX))
+			{
+				throw std::invalid_argument("ScanlineWriter: chunk of " + std::to_string(m_scanlinesPerChunk) + " scanlines of " + std::to_string(m_layout.sizeInBytes()) + " bytes is larger than 2 GB.");
+			}
+		}
+
+		/// <summary>
+		///		Add header attribute of (name), (type) and (value) bytes (as stored in file). Attributes are written in order they are added.
+		///		"compression" and "lineOrder" are written by the writer itself, other required attributes ("channels", "dataWindow",
+		///		"displayWindow", "pixelAspectRatio", "screenWindowCenter", "screenWindowWidth") must be added by caller.
+		/// </summary>
+		void addAttribute(const std::string& name, const std::string& type, const ui8view value)
+		{
+			if (name.empty() or type.empty() or name.find('\0') != std::string::npos or type.find('\0') != std::string::npos)
+			{
+				throw std::invalid_argument("ScanlineWriter: attribute name and type must be non-empty strings without null bytes.");
+			}
+			if (name == exr::consta::StdAttribName::s_compression or name == exr::consta::StdAttribName::s_lineOrder)
+			{
+				throw std::invalid_argument("ScanlineWriter: attribute \'" + name + "\' is written by the writer.");
+			}
+			m_hasLongNames = m_hasLongNames or s_c_shortNameMaxLength < name.size() or s_c_shortNameMaxLength < type.size();
+			appendAttribute(m_attributes, name, type, value);
+		}
+
+		uint32_t chunksNum() const { return m_chunksNum; }
+		uint32_t uintChannelsNum() const { return m_uintChannelsNum; }
+
+		/// <summary>
+		///		Write the file, taking samples of its rows from (fetchRows), and samples of its UINT channels from (fetchUintRows).
+		///		HALF samples are rounded to nearest, FLOAT samples are copied, UINT samples are copied as is (never through float).
+		///		Chunk whose compressed data is not smaller than uncompressed is stored uncompressed.
+		/// </summary>
+		/// <param name="fetchUintRows"> - may be empty if image has no UINT channels </param>
+		/// <param name="threadPool"> - workers to encode chunks on (calling thread encodes too), nullptr = encode on calling thread </param>
+		/// <returns> size of written file in bytes </returns>
+		uint64_t write(const std::filesystem::path& filepath, const RowsSource& fetchRows, const UintRowsSource& fetchUintRows, utils::ThreadPool* threadPool) const
+		{
+			if (m_uintChannelsNum != 0 and not fetchUintRows)
+			{
+				throw std::invalid_argument("ScanlineWriter: image has UINT channels, but no source of their samples is given.");
+			}
+			utils::file::FileWriter file(filepath);
+			std::vector<ui8> bytes;
+			appendInt32(bytes, int32_t(exr2::consta::c_magicNumber));
+			appendInt32(bytes, int32_t(exr2::consta::c_versionNumber | (m_hasLongNames ? exr2::consta::ValidVersionField::c_longNamesBit : 0)));
+			bytes.insert(bytes.end(), m_attributes.begin(), m_attributes.end());
+			const ui8 compressionValue = ui8(m_compression), lineOrderValue = ui8(m_lineOrder);
+			appendAttribute(bytes, exr::consta::StdAttribName::s_compression, exr::consta::Type::s_compression, ui8view(&compressionValue, 1));
+			appendAttribute(bytes, exr::consta::StdAttribName::s_lineOrder, exr::consta::Type::s_lineOrder, ui8view(&lineOrderValue, 1));
+			bytes.push_back(0x00);		// end of header
+			file.append(bytes);
+			const uint64_t offsetTableFirstByteIndex = file.size();
+			bytes.assign(std::size_t(m_chunksNum) * sizeof(uint64_t), 0);
+			file.append(bytes);
+
+			// window of chunks: one chunk per slot, one slot per thread
+			std::vector<Slot> slots((threadPool == nullptr) ? 1 : threadPool->workersNum() + 1);
+			std::vector<uint64_t> offsets(m_chunksNum);
+			for (uint32_t windowFirst = 0; windowFirst < m_chunksNum; windowFirst += uint32_t(slots.size()))
+			{
+				const uint32_t windowSize = std::min(uint32_t(slots.size()), m_chunksNum - windowFirst);
+				const uint32_t firstChunk = isDecreasing() ? m_chunksNum - windowFirst - windowSize : windowFirst;
+				const uint32_t firstRow = firstChunk * m_scanlinesPerChunk;
+				const uint32_t lastRow = std::min(m_rowsNum, (firstChunk + windowSize) * m_scanlinesPerChunk) - 1;
+				const ImageBuffer<float> rows = fetchRows(utils::Range<uint32_t>(firstRow, lastRow));
+				const ImageBuffer<uint32_t> uintRows = (m_uintChannelsNum != 0) ? fetchUintRows(utils::Range<uint32_t>(firstRow, lastRow)) : ImageBuffer<uint32_t>();
+				if (rows.rowsNum() != lastRow - firstRow + 1 or rows.columnsNum() != m_layout.pixelsNum() or rows.channelsNum() != m_layout.channelsNum()
+					or (m_uintChannelsNum != 0 and (uintRows.rowsNum() != rows.rowsNum() or uintRows.columnsNum() != rows.columnsNum() or uintRows.channelsNum() != m_uintChannelsNum)))
+				{
+					throw std::logic_error("ScanlineWriter: samples of rows [" + std::to_string(firstRow) + "; " + std::to_string(lastRow) + "] do not match image layout.");
+				}
+				const auto slotsRange = [&](const std::size_t firstSlot, const std::size_t lastSlot)
+				{
+					for (std::size_t slotIndex = firstSlot; slotIndex < lastSlot; slotIndex++)
+					{
+						encodeChunk(rows, uintRows, (firstChunk + uint32_t(slotIndex)) * m_scanlinesPerChunk - firstRow, slots[slotIndex]);
+					}
+				};
+				if (threadPool == nullptr)
+				{
+					slotsRange(std::size_t(0), windowSize);
+				}
+				else
+				{
+					threadPool->parallelFor(0, windowSize, 1, slotsRange);
+				}
+				// chunks are appended in lineOrder
+				for (uint32_t i = 0; i < windowSize; i++)
+				{
+					const uint32_t slotIndex = isDecreasing() ? windowSize - 1 - i : i;
+					const uint32_t chunkIndex = firstChunk + slotIndex;
+					const Slot& slot = slots[slotIndex];
+					const std::vector<ui8>& data = slot.isEncoded ? slot.encoded : slot.raw;
+					offsets[chunkIndex] = file.size();
+					bytes.clear();
+					appendInt32(bytes, m_yMin + int32_t(chunkIndex * m_scanlinesPerChunk));
+					appendInt32(bytes, int32_t(data.size()));
+					file.append(bytes);
+					file.append(ui8view(data.data(), data.size()));
+				}
+			}
+
+			// offset table is ordered by y, no matter the lineOrder
+			bytes.clear();
+			for (const uint64_t offset : offsets)
+			{
+				for (std::size_t byte = 0; byte < sizeof(offset); byte++)
+				{
+					bytes.push_back(ui8(offset >> (8*byte)));
+				}
+			}
+			file.overwrite(offsetTableFirstByteIndex, bytes);
+			const uint64_t fileSize = file.size();
+			file.close();
+			return fileSize;
+		}
+
+		private:
+		static const std::size_t s_c_shortNameMaxLength = 31;		// longer attribute name, type or channel name needs version field bit 10
+
+		/// <summary> Buffers of one thread: uncompressed chunk data, its compressed data and encoder (reused by all chunks of the slot). </summary>
+		struct Slot
+		{
+			std::unique_ptr<exrCompression::ChunkEncoder> encoder;
+			std::vector<ui8> raw;
+			std::vector<ui8> encoded;
+			std::vector<uint16_t> halfRow;
+			bool isEncoded = false;
+		};
+
+		ScanlineLayout m_layout;
+		uint32_t m_rowsNum = 0;
+		int32_t m_yMin = 0;
+		exr2::consta::s_compression::value m_compression = exr2::consta::s_compression::value::NO;
+		exr2::consta::s_lineOrder::ctype m_lineOrder = exr2::consta::s_lineOrder::value::INCREASING_Y;
+		uint32_t m_scanlinesPerChunk = 1;
+		uint32_t m_chunksNum = 0;
+		uint32_t m_uintChannelsNum = 0;
+		bool m_hasLongNames = false;
+		std::vector<ui8> m_attributes;				// added by addAttribute(), as stored in file
+
+		bool isDecreasing() const { return m_lineOrder == exr2::consta::s_lineOrder::value::DECREASING_Y; }
+
+		static void appendInt32(std::vector<ui8>& out, const int32_t value)
+		{
+			for (std::size_t byte = 0; byte < sizeof(value); byte++)
+			{
+				out.push_back(ui8(uint32_t(value) >> (8*byte)));
+			}
+		}
+
+		static void appendAttribute(std::vector<ui8>& out, const std::string& name, const std::string& type, const ui8view value)
+		{
+			out.insert(out.end(), name.begin(), name.end());
+			out.push_back(0x00);
+			out.insert(out.end(), type.begin(), type.end());
+			out.push_back(0x00);
+			appendInt32(out, int32_t(value.size()));
+			out.insert(out.end(), value.begin(), value.end());
+		}
+
+		/// <summary>
+		///		Pack scanlines of chunk, starting at row (firstRow) of (rows) and (uintRows), into uncompressed chunk data of (slot), then encode it.
+		/// </summary>
+		void encodeChunk(const ImageBuffer<float>& rows, const ImageBuffer<uint32_t>& uintRows, const uint32_t firstRow, Slot& slot) const
+		{
+			const uint32_t scanlinesNum = std::min(m_scanlinesPerChunk, rows.rowsNum() - firstRow);
+			const uint32_t width = m_layout.pixelsNum();
+			slot.raw.resize(std::size_t(scanlinesNum) * m_layout.sizeInBytes());
+			for (uint32_t scanline = 0; scanline < scanlinesNum; scanline++)
+			{
+				ui8* dst = slot.raw.data() + std::size_t(scanline) * m_layout.sizeInBytes();
+				uint32_t uintCh = 0;
+				for (uint32_t ch = 0; ch < m_layout.channelsNum(); ch++)
+				{
+					const float* src = rows.rowData(ch, firstRow + scanline);
+					ui8* channelDst = dst + m_layout.channelOffsetInBytes(ch);
+					switch (m_layout.channelDataType(ch))
+					{
+						case exr2::consta::channel::datatype::HALF:
+						{
+							slot.halfRow.resize(width);
+							exrHalf::floatToHalf(src, slot.halfRow.data(), width);
+							for (uint32_t i = 0; i < width; i++)
+							{
+								channelDst[2*i] = ui8(slot.halfRow[i]);
+								channelDst[2*i + 1] = ui8(slot.halfRow[i] >> 8);
+							}
+							break;
+						}
+						case exr2::consta::channel::datatype::FLOAT:
+						{
+							std::memcpy(channelDst, src, sizeof(float) * width);
+							break;
+						}
+						default:
+						{
+							std::memcpy(channelDst, uintRows.rowData(uintCh, firstRow + scanline), sizeof(uint32_t) * width);
+							uintCh++;
+							break;
+						}
+					}
+				}
+			}
+			slot.isEncoded = false;
+			if (m_compression == exr2::consta::s_compression::value::NO)
+			{
+				return;
+			}
+			if (slot.encoder == nullptr)
+			{
+				slot.encoder = exrCompression::makeChunkEncoder(m_compression);
+			}
+			const exrCompression::ChunkLayout layout = { m_layout.channelNames(), m_layout.channelDataTypes(), width, scanlinesNum };
+			slot.encoder->encode(ui8view(slot.raw.data(), slot.raw.size()), layout, slot.encoded);
+			slot.isEncoded = slot.encoded.size() < slot.raw.size();
+		}
+	};
+}
@@ -0,0 +1,733 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "exrData/exrConsta.h"
+#include "exrData/exrTypes.h"
+#include "exrData/ImageBuffer.h"
+#include "exrData/Pixeldata.h"
+#include "exrData/Compression.h"
+#include "ThreadPool.h"
+#include "types.h"
+#include "utils.h"
+
+namespace exrPixeldata
+{
+	/*
+		source: https://openexr.com/en/latest/OpenEXRFileLayout.html#tiles
+
+		Tiled image is stored as tiles of (tiledesc.xSize x tiledesc.ySize) pixels (tiles of the right and bottom edges may be smaller).
+		Image may have several resolution levels (tiledesc level mode):
+			ONE_LEVEL		- 1 level (0, 0) of full resolution;
+			MIPMAP_LEVELS	- levels (l, l), each is half the width and height of previous one, down to 1 x 1;
+			RIPMAP_LEVELS	- levels (lx, ly) for each combination of width halved lx times and height halved ly times.
+		Level size = max(1, round(fullSize / 2^level)), rounded down or up (tiledesc rounding mode).
+		Offset table has one entry per tile of each level, ordered by level (ripmap: ly, then lx), then by tile y, then by tile x.
+
+		Tile chunk:
+		tileX, tileY, levelX, levelY	int32 x 4
+		dataSize						int32
+		data							(dataSize bytes) - tile lines, each line is laid out as scanline of tile width pixels
+	*/
+
+	/// <summary>
+	///		Geometry of tiled image: levels, their sizes, number of tiles of each level and index of first offset table entry of each level.
+	/// </summary>
+	class TileGrid
+	{
+		public:
+		struct Level
+		{
+			uint32_t x = 0, y = 0;					// level number along x and y
+			uint32_t width = 0, height = 0;			// level size in pixels
+			uint32_t tilesX = 0, tilesY = 0;		// number of tiles along x and y
+			uint32_t firstChunkIndex = 0;			// offset table entry of tile (0, 0) of the level
+			uint32_t chunksNum() const { return tilesX * tilesY; }
+		};
+		struct TileCoords
+		{
+			uint32_t tileX = 0, tileY = 0, levelX = 0, levelY = 0;
+		};
+
+		TileGrid() {}
+		/// <param name="imageWidth"> - width of full resolution level (dataWindow) </param>
+		/// <param name="imageHeight"> - height of full resolution level (dataWindow) </param>
+		/// <param name="tileDesc"> - value of "tiles" attribute </param>
+		TileGrid(const uint32_t imageWidth, const uint32_t imageHeight, const exrTypes::TileDesc& tileDesc)
+			: m_tileXSize(tileDesc.xSize()), m_tileYSize(tileDesc.ySize()), m_levelMode(tileDesc.levelMode()), m_roundingMode(tileDesc.roundingMode())
+		{
+			if (imageWidth == 0 or imageHeight == 0)
+			{
+				throw std::runtime_error("tiled image of " + std::to_string(imageWidth) + " x " + std::to_string(imageHeight) + " pixels has no tiles.");
+			}
+			switch (m_levelMode)
+			{
+				case exr2::consta::s_levelMode::value::ONE_LEVEL:
+					m_xLevelsNum = m_yLevelsNum = 1;
+					break;
+				case exr2::consta::s_levelMode::value::MIPMAP_LEVELS:
+					m_xLevelsNum = m_yLevelsNum = roundLog2(std::max(imageWidth, imageHeight), m_roundingMode) + 1;
+					break;
+				case exr2::consta::s_levelMode::value::RIPMAP_LEVELS:
+					m_xLevelsNum = roundLog2(imageWidth, m_roundingMode) + 1;
+					m_yLevelsNum = roundLog2(imageHeight, m_roundingMode) + 1;
+					break;
+				default:
+					throw std::runtime_error("tiledesc level mode " + std::to_string(m_levelMode) + " is not valid.");
+			}
+			// levels, ordered as in offset table
+			uint64_t chunksNum = 0;
+			const auto addLevel = [&](const uint32_t levelX, const uint32_t levelY)
+			{
+				Level level;
+				level.x = levelX;
+				level.y = levelY;
+				level.width = levelSize(imageWidth, levelX, m_roundingMode);
+				level.height = levelSize(imageHeight, levelY, m_roundingMode);
+				level.tilesX = (level.width + m_tileXSize - 1) / m_tileXSize;
+				level.tilesY = (level.height + m_tileYSize - 1) / m_tileYSize;
+				level.firstChunkIndex = uint32_t(chunksNum);
+				chunksNum += uint64_t(level.tilesX) * level.tilesY;
+				if (UINT32_MAX < chunksNum)
+				{
+					throw std::runtime_error("tiled image has more than 2^32-1 tiles.");
+				}
+				m_levels.push_back(level);
+			};
+			if (m_levelMode == exr2::consta::s_levelMode::value::RIPMAP_LEVELS)
+			{
+				for (uint32_t ly = 0; ly < m_yLevelsNum; ly++)
+				{
+					for (uint32_t lx = 0; lx < m_xLevelsNum; lx++)
+					{
+						addLevel(lx, ly);
+					}
+				}
+			}
+			else
+			{
+				for (uint32_t l = 0; l < m_xLevelsNum; l++)
+				{
+					addLevel(l, l);
+				}
+			}
+			m_chunksNum = uint32_t(chunksNum);
+		}
+		uint32_t tileXSize() const { return m_tileXSize; }
+		uint32_t tileYSize() const { return m_tileYSize; }
+		uint8_t levelMode() const { return m_levelMode; }
+		uint8_t roundingMode() const { return m_roundingMode; }
+		uint32_t xLevelsNum() const { return m_xLevelsNum; }
+		uint32_t yLevelsNum() const { return m_yLevelsNum; }
+		/// <returns> number of tiles of all levels (= number of offset table entries) </returns>
+		uint32_t chunksNum() const { return m_chunksNum; }
+		/// <returns> levels, ordered as in offset table </returns>
+		const std::vector<Level>& levels() const { return m_levels; }
+		bool hasLevel(const uint32_t levelX, const uint32_t levelY) const
+		{
+			if (m_levelMode == exr2::consta::s_levelMode::value::RIPMAP_LEVELS)
+			{
+				return levelX < m_xLevelsNum and levelY < m_yLevelsNum;
+			}
+			return levelX == levelY and levelX < m_xLevelsNum;
+		}
+		const Level& level(const uint32_t levelX, const uint32_t levelY) const
+		{
+			if (not hasLevel(levelX, levelY))
+			{
+				throw std::invalid_argument("level (" + std::to_string(levelX) + ", " + std::to_string(levelY) + ") does not exist in " + exr2::consta::levelModeName(m_levelMode) + " image of " + std::to_string(m_xLevelsNum) + " x " + std::to_string(m_yLevelsNum) + " levels");
+			}
+			const uint32_t levelIndex = (m_levelMode == exr2::consta::s_levelMode::value::RIPMAP_LEVELS) ? levelY * m_xLevelsNum + levelX : levelX;
+			return m_levels[levelIndex];
+		}
+		/// <returns> true if tile (tileX, tileY) of level (levelX, levelY) exists </returns>
+		bool hasTile(const TileCoords& tile) const
+		{
+			if (not hasLevel(tile.levelX, tile.levelY))
+			{
+				return false;
+			}
+			const Level& lvl = level(tile.levelX, tile.levelY);
+			return tile.tileX < lvl.tilesX and tile.tileY < lvl.tilesY;
+		}
+		/// <returns> index of offset table entry of (tile) </returns>
+		uint32_t chunkIndex(const TileCoords& tile) const
+		{
+			if (not hasTile(tile))
+			{
+				throw std::invalid_argument("tile (" + std::to_string(tile.tileX) + ", " + std::to_string(tile.tileY) + ") of level (" + std::to_string(tile.levelX) + ", " + std::to_string(tile.levelY) + ") does not exist");
+			}
+			const Level& lvl = level(tile.levelX, tile.levelY);
+			return lvl.firstChunkIndex + tile.tileY * lvl.tilesX + tile.tileX;
+		}
+		/// <returns> coordinates of tile of (chunkIndex) offset table entry </returns>
+		TileCoords tileCoords(const uint32_t chunkIndex) const
+		{
+			if (m_chunksNum <= chunkIndex)
+			{
+				throw std::invalid_argument("(chunkIndex) " + std::to_string(chunkIndex) + " is out of valid range [0; " + std::to_string(m_chunksNum) + ")");
+			}
+			// last level, which first chunk is not after (chunkIndex)
+			const auto next = std::upper_bound(m_levels.begin(), m_levels.end(), chunkIndex, [](const uint32_t index, const Level& lvl) { return index < lvl.firstChunkIndex; });
+			const Level& lvl = *(next - 1);
+			const uint32_t indexInLevel = chunkIndex - lvl.firstChunkIndex;
+			return { indexInLevel % lvl.tilesX, indexInLevel / lvl.tilesX, lvl.x, lvl.y };
+		}
+		/// <returns> width of tile (tileX) of (lvl): tile x size, or less for tiles of the right edge </returns>
+		uint32_t tileWidth(const Level& lvl, const uint32_t tileX) const { return std::min(m_tileXSize, lvl.width - tileX * m_tileXSize); }
+		/// <returns> height of tile (tileY) of (lvl): tile y size, or less for tiles of the bottom edge </returns>
+		uint32_t tileHeight(const Level& lvl, const uint32_t tileY) const { return std::min(m_tileYSize, lvl.height - tileY * m_tileYSize); }
+
+		/// <returns> floor(log2(x)) for ROUND_DOWN, ceil(log2(x)) for ROUND_UP </returns>
+		static uint32_t roundLog2(const uint32_t x, const uint8_t roundingMode)
+		{
+			uint32_t log2 = 0;
+			while ((uint64_t(1) << (log2 + 1)) <= x)
+			{
+				log2++;
+			}
+			const bool isPowerOf2 = (x & (x - 1)) == 0;
+			return (roundingMode == exr2::consta::s_roundingMode::value::ROUND_UP and not isPowerOf2) ? log2 + 1 : log2;
+		}
+		/// <returns> size of (level) level of image of (fullSize) pixels: max(1, fullSize / 2^level), rounded by (roundingMode) </returns>
+		static uint32_t levelSize(const uint32_t fullSize, const uint32_t level, const uint8_t roundingMode)
+		{
+			const uint64_t divisor = uint64_t(1) << level;
+			const uint64_t size = (roundingMode == exr2::consta::s_roundingMode::value::ROUND_UP) ? (fullSize + divisor - 1) / divisor : fullSize / divisor;
+			return uint32_t(std::max<uint64_t>(size, 1));
+		}
+
+		private:
+		uint32_t m_tileXSize = 1, m_tileYSize = 1;
+		uint8_t m_levelMode = exr2::consta::s_levelMode::value::ONE_LEVEL;
+		uint8_t m_roundingMode = exr2::consta::s_roundingMode::value::ROUND_DOWN;
+		uint32_t m_xLevelsNum = 1, m_yLevelsNum = 1;
+		uint32_t m_chunksNum = 0;
+		std::vector<Level> m_levels;
+	};
+
+	// decoders of tile lines by tile width: full tile width + widths of tiles of the right edge of each level
+	template <Unsigned32OrFloat channelCType32>
+	using TileLineDecoders = std::unordered_map<uint32_t, std::shared_ptr<const ScanlineDecoder<channelCType32>>>;
+
+	// stores exrFile.pixelData tile chunk header (tile coordinates, data size) and location of its data within filebytes.
+	template <Unsigned32OrFloat channelCType32>
+	class TileChunk
+	{
+		public:
+		TileChunk() {}
+		/// <param name="filebytes"> - view of bytes of full input .exr file </param>
+		/// <param name="chunkFirstByteIndex"> - index of first byte of chunk (first byte of its tileX) within filebytes (offset table value) </param>
+		/// <param name="grid"> - levels and tiles of the image, tile coordinates are validated against it </param>
+		/// <param name="lineDecoders"> - decoders of tile lines of each tile width of the image </param>
+		TileChunk(const ui8view filebytes, const uint64_t chunkFirstByteIndex, const TileGrid& grid, const TileLineDecoders<channelCType32>& lineDecoders)
+			: m_firstByteIndex(chunkFirstByteIndex), m_dataFirstByteIndex(chunkFirstByteIndex + s_c_headerSizeInBytes)
+		{
+			if (filebytes.size() < m_dataFirstByteIndex or m_dataFirstByteIndex < m_firstByteIndex)
+			{
+				throw std::runtime_error("tile at 0x" + utils::hex64(m_firstByteIndex) + " is out of file bytes range. File is truncated or is not a valid .exr file.");
+			}
+			const ui8* header = filebytes.data() + m_firstByteIndex;
+			const int32_t tileX = int32_t(exrTypes::readUint32(header)), tileY = int32_t(exrTypes::readUint32(header + 4));
+			const int32_t levelX = int32_t(exrTypes::readUint32(header + 8)), levelY = int32_t(exrTypes::readUint32(header + 12));
+			m_dataSize = exrTypes::readUint32(header + 16);
+			m_coords = { uint32_t(tileX), uint32_t(tileY), uint32_t(levelX), uint32_t(levelY) };
+			if (tileX < 0 or tileY < 0 or levelX < 0 or levelY < 0 or not grid.hasTile(m_coords))
+			{
+				throw std::runtime_error
+				(
+					"tile at 0x" + utils::hex64(m_firstByteIndex) + " has coordinates (" + std::to_string(tileX) + ", " + std::to_string(tileY) + ") of level (" + std::to_string(levelX) + ", " + std::to_string(levelY) + "), "
+					"which do not exist in " + exr2::consta::levelModeName(grid.levelMode()) + " image of " + std::to_string(grid.xLevelsNum()) + " x " + std::to_string(grid.yLevelsNum()) + " levels."
+				);
+			}
+			const TileGrid::Level& lvl = grid.level(m_coords.levelX, m_coords.levelY);
+			m_width = grid.tileWidth(lvl, m_coords.tileX);
+			m_height = grid.tileHeight(lvl, m_coords.tileY);
+			m_decoder = lineDecoders.at(m_width);
+			if (UINT32_MAX / m_height < m_decoder->layout().sizeInBytes())
+			{
+				throw std::runtime_error("uncompressed data of tile at 0x" + utils::hex64(m_firstByteIndex) + " is larger than 4 GB.");
+			}
+			if (filebytes.size() - m_dataFirstByteIndex < m_dataSize or m_dataSize == 0)
+			{
+				throw std::runtime_error("data of tile at 0x" + utils::hex64(m_firstByteIndex) + " (" + std::to_string(m_dataSize) + " bytes) is out of file bytes range. File is truncated or is not a valid .exr file.");
+			}
+			if (rawSizeInBytes() < m_dataSize)
+			{
+				throw std::runtime_error("data of tile at 0x" + utils::hex64(m_firstByteIndex) + " (" + std::to_string(m_dataSize) + " bytes) is larger than its uncompressed size (" + std::to_string(rawSizeInBytes()) + " bytes).");
+			}
+		}
+
+		/// <summary>
+		///		Get uncompressed tile data: decompress it into (rawBuffer) or, if tile stores data uncompressed, point to filebytes.
+		/// </summary>
+		/// <returns> pointer to first byte of uncompressed tile data (rawSizeInBytes() bytes) </returns>
+		const ui8* decodeData(const ui8view filebytes, const exr2::consta::s_compression::value compressionValue, exrCompression::ChunkDecoders& decoders, std::vector<ui8>& rawBuffer) const
+		{
+			const exrCompression::ChunkLayout layout = { m_decoder->layout().channelNames(), m_decoder->layout().channelDataTypes(), m_width, m_height };
+			return decompressChunkData(filebytes.subspan(m_dataFirstByteIndex, m_dataSize), rawSizeInBytes(), layout, compressionValue, decoders, rawBuffer);
+		}
+		/// <summary>
+		///		Convert samples of all lines of uncompressed tile data (raw) into rows [0; height()) and columns [0; width()) of (tile).
+		/// </summary>
+		void decodeInto(const ui8* raw, ImageBuffer<channelCType32>& tile) const
+		{
+			for (uint32_t line = 0; line < m_height; line++)
+			{
+				m_decoder->decodeScanline(raw + std::size_t(line) * m_decoder->layout().sizeInBytes(), tile, line);
+			}
+		}
+
+		const TileGrid::TileCoords& coords() const { return m_coords; }
+		uint32_t width() const { return m_width; }
+		uint32_t height() const { return m_height; }
+		uint32_t _dataSizeInBytes() const { return m_dataSize; }
+		/// <returns> true if tile data is compressed (tile stores data uncompressed, if compression does not make it smaller) </returns>
+		bool isCompressed() const { return m_dataSize < rawSizeInBytes(); }
+		uint32_t rawSizeInBytes() const { return m_height * m_decoder->layout().sizeInBytes(); }
+		uint32_t pixelChannelsNum() const { return m_decoder->layout().channelsNum(); }
+		uint64_t firstByteIndex() const { return m_firstByteIndex; }
+		uint64_t lastByteIndex() const { return m_dataFirstByteIndex + m_dataSize - 1; }
+		/// <returns> index of first byte of (fieldIndex) header field: 0 = tileX, 1 = tileY, 2 = levelX, 3 = levelY, 4 = dataSize </returns>
+		uint64_t headerFieldFirstByteIndex(const uint32_t fieldIndex) const { return m_firstByteIndex + fieldIndex * sizeof(int32_t); }
+		uint64_t dataFirstByteIndex() const { return m_dataFirstByteIndex; }
+		/// <returns> index of first byte of sample within uncompressed tile data </returns>
+		uint32_t rawSampleFirstByteIndex(const uint32_t line, const uint32_t pixelChannelIndex, const uint32_t pixelColumnIndex) const { return line * m_decoder->layout().sizeInBytes() + m_decoder->layout().channelOffsetInBytes(pixelChannelIndex) + pixelColumnIndex * m_decoder->layout().sampleSizeInBytes(pixelChannelIndex); }
+		uint32_t sampleSizeInBytes(const uint32_t pixelChannelIndex) const { return m_decoder->layout().sampleSizeInBytes(pixelChannelIndex); }
+
+		private:
+		static const uint32_t s_c_headerSizeInBytes = 5 * sizeof(int32_t);		// tileX, tileY, levelX, levelY, dataSize
+		uint64_t m_firstByteIndex = 0, m_dataFirstByteIndex = 0;
+		TileGrid::TileCoords m_coords;
+		uint32_t m_dataSize = 0;
+		uint32_t m_width = 0, m_height = 0;
+		std::shared_ptr<const ScanlineDecoder<channelCType32>> m_decoder = nullptr;
+	};
+
+	/// <summary>
+	///		Bounded least-recently-used cache of decoded tiles, keyed by offset table entry index of tile.
+	///		Each cached tile occupies one slot = ImageBuffer of full tile size, so memory use is fixed by (capacity) on construction.
+	///		Not thread-safe: owner must serialize access.
+	/// </summary>
+	template <Unsigned32OrFloat channelCType32>
+	class TileCache
+	{
+		public:
+		TileCache() {}
+		TileCache(const uint32_t capacity, const uint32_t tileYSize, const uint32_t tileXSize, const uint32_t pixelChannelsNum)
+		{
+			if (capacity == 0)
+			{
+				throw std::invalid_argument("TileCache: (capacity) must be at least 1 tile");
+			}
+			m_slots.reserve(capacity);
+			for (uint32_t i = 0; i < capacity; i++)
+			{
+				m_slots.emplace_back(tileYSize, tileXSize, pixelChannelsNum);
+			}
+			m_chunkToSlot.reserve(capacity);
+		}
+		uint32_t capacity() const { return uint32_t(m_slots.size()); }
+		uint32_t size() const { return uint32_t(m_chunkToSlot.size()); }
+		/// <summary>
+		///		Find cached tile of offset table entry (chunkIndex) and mark it as most recently used.
+		/// </summary>
+		/// <returns> true and (slot) of the tile in slot() if cached, false otherwise </returns>
+		bool find(const uint32_t chunkIndex, uint32_t& slot)
+		{
+			const auto it = m_chunkToSlot.find(chunkIndex);
+			if (it == m_chunkToSlot.end())
+			{
+				return false;
+			}
+			m_usage.splice(m_usage.begin(), m_usage, it->second.second);
+			slot = it->second.first;
+			return true;
+		}
+		/// <summary>
+		///		Reserve slot for tile of offset table entry (chunkIndex), evicting least recently used tile if cache is full.
+		///		Caller decodes the tile into returned slot.
+		/// </summary>
+		uint32_t insert(const uint32_t chunkIndex)
+		{
+			uint32_t slot = size();
+			if (size() == capacity())
+			{
+				const uint32_t evictedChunk = m_usage.back();
+				slot = m_chunkToSlot[evictedChunk].first;
+				m_chunkToSlot.erase(evictedChunk);
+				m_usage.pop_back();
+			}
+			m_usage.push_front(chunkIndex);
+			m_chunkToSlot[chunkIndex] = { slot, m_usage.begin() };
+			return slot;
+		}
+		/// <summary> Forget tile of offset table entry (chunkIndex), e.g. if its decoding failed. </summary>
+		void erase(const uint32_t chunkIndex)
+		{
+			const auto it = m_chunkToSlot.find(chunkIndex);
+			if (it != m_chunkToSlot.end())
+			{
+				m_usage.erase(it->second.second);
+				m_chunkToSlot.erase(it);
+			}
+		}
+		ImageBuffer<channelCType32>& slot(const uint32_t slotIndex) { return m_slots[slotIndex]; }
+		const ImageBuffer<channelCType32>& slot(const uint32_t slotIndex) const { return m_slots[slotIndex]; }
+
+		private:
+		std::vector<ImageBuffer<channelCType32>> m_slots;		// samples of cached tile (top-left part of slot for tiles of right / bottom edge)
+		std::list<uint32_t> m_usage;							// cached tiles (offset table entry index), most recently used first
+		std::unordered_map<uint32_t, std::pair<uint32_t, std::list<uint32_t>::iterator>> m_chunkToSlot;	// chunk index -> (slot, position in m_usage)
+	};
+
+	// stores exrFile.pixelData of tiled image (single-part): tile offsets only, tiles are decoded on access
+	// and kept in bounded LRU tile cache, so region queries decode only the tiles they overlap.
+	template <Unsigned32OrFloat channelCType32>
+	class TiledPixelData
+	{
+		public:
+		/// <param name="chunkOffsets"> - offset table values: index of first byte of each tile within filebytes, ordered as in TileGrid </param>
+		/// <param name="grid"> - levels and tiles of the image </param>
+		/// <param name="compressionValue"> - compression of tiles: NO or one with decoder in exrCompression::makeChunkDecoder() (each tile is compressed as a whole) </param>
+		/// <param name="cacheTilesNum"> - max number of decoded tiles kept in memory </param>
+		TiledPixelData(const ui8view filebytes, const std::vector<uint64_t>& chunkOffsets, const TileGrid& grid, const std::vector<std::string>& channelNames, const std::vector<uint32_t>& channelDataTypes, const exr2::consta::s_compression::value compressionValue, const uint32_t cacheTilesNum)
+			: m_filebytes(filebytes), m_chunkOffsets(chunkOffsets), m_grid(grid), m_channelNames(channelNames),
+			m_rgbaChannelIndexes(rgbaChannelIndexes(channelNames)), m_compression(compressionValue),
+			m_cache(cacheTilesNum, grid.tileYSize(), grid.tileXSize(), uint32_t(channelDataTypes.size()))
+		{
+			if (channelNames.size() != channelDataTypes.size() or channelNames.empty())
+			{
+				throw std::invalid_argument("(channelNames) and (channelDataTypes) must describe the same, non-zero number of channels");
+			}
+			if (m_chunkOffsets.size() != m_grid.chunksNum())
+			{
+				throw std::runtime_error("number of offset table entries (" + std::to_string(m_chunkOffsets.size()) + ") is different from number of tiles of all levels (" + std::to_string(m_grid.chunksNum()) + ").");
+			}
+			for (const uint64_t offset : m_chunkOffsets)
+			{
+				if (m_filebytes.size() <= offset)
+				{
+					throw std::runtime_error("offset table value 0x" + utils::hex64(offset) + " is out of file bytes range. File is truncated or is not a valid .exr file.");
+				}
+			}
+			for (const TileGrid::Level& lvl : m_grid.levels())
+			{
+				for (const uint32_t width : { m_grid.tileWidth(lvl, 0), m_grid.tileWidth(lvl, lvl.tilesX - 1) })
+				{
+					if (m_lineDecoders.find(width) == m_lineDecoders.end())
+					{
+						m_lineDecoders[width] = std::make_shared<const ScanlineDecoder<channelCType32>>(ScanlineLayout(channelNames, channelDataTypes, width));
+					}
+				}
+			}
+			// first and last tiles in file are found by offset value, only their headers are read here
+			const auto [minOffset, maxOffset] = std::minmax_element(m_chunkOffsets.begin(), m_chunkOffsets.end());
+			m_firstByteIndex = tileHeader(uint32_t(minOffset - m_chunkOffsets.begin())).firstByteIndex();
+			m_lastByteIndex = tileHeader(uint32_t(maxOffset - m_chunkOffsets.begin())).lastByteIndex();
+		}
+		uint64_t firstByteIndex() const { return m_firstByteIndex; }	// firstByteIndex of first tile (in file)
+		uint64_t lastByteIndex() const { return m_lastByteIndex; }		// lastByteIndex of last tile (in file)
+		const TileGrid& grid() const { return m_grid; }
+		uint32_t rowsNum() const { return m_grid.levels()[0].height; }		// rows of full resolution level
+		uint32_t columnsNum() const { return m_grid.levels()[0].width; }	// columns of full resolution level
+		uint32_t channelsNum() const { return uint32_t(m_channelNames.size()); }
+		const std::vector<std::string>& channelNames() const { return m_channelNames; }
+		/// <returns> max number of decoded tiles kept in memory </returns>
+		uint32_t cacheTilesNum() const { return m_cache.capacity(); }
+
+		/// <summary>
+		///		Random-access tile fetch: decode (or find in cache) the tile and return copy of its samples.
+		/// </summary>
+		/// <returns> samples of tile, (tile height) rows x (tile width) columns, one array per channel (ordered as in chlist) </returns>
+		ImageBuffer<channelCType32> tile(const TileGrid::TileCoords& coords) const
+		{
+			const TileGrid::Level& lvl = m_grid.level(coords.levelX, coords.levelY);
+			const uint32_t chunkIndex = m_grid.chunkIndex(coords);
+			ImageBuffer<channelCType32> samples(m_grid.tileHeight(lvl, coords.tileY), m_grid.tileWidth(lvl, coords.tileX), channelsNum());
+			std::lock_guard<std::mutex> lock(m_cacheMutex);
+			copyTileRegion(m_cache.slot(cachedTileSlot(chunkIndex)), 0, 0, samples, 0, 0, samples.rowsNum(), samples.columnsNum());
+			return samples;
+		}
+		/// <returns> value of sample of (channelIndex) channel (ordered as in chlist) of pixel [pixelRowIndex, pixelColumnIndex] of level (levelX, levelY) </returns>
+		channelCType32 channelValue(const uint32_t channelIndex, const uint32_t pixelRowIndex, const uint32_t pixelColumnIndex, const uint32_t levelX = 0, const uint32_t levelY = 0) const
+		{
+			const TileGrid::Level& lvl = m_grid.level(levelX, levelY);
+			if (lvl.height <= pixelRowIndex or lvl.width <= pixelColumnIndex)
+			{
+				throw std::invalid_argument("pixel [" + std::to_string(pixelRowIndex) + ", " + std::to_string(pixelColumnIndex) + "] is out of level of " + std::to_string(lvl.height) + " rows and " + std::to_string(lvl.width) + " columns");
+			}
+			const uint32_t chunkIndex = m_grid.chunkIndex({ pixelColumnIndex / m_grid.tileXSize(), pixelRowIndex / m_grid.tileYSize(), levelX, levelY });
+			std::lock_guard<std::mutex> lock(m_cacheMutex);
+			return m_cache.slot(cachedTileSlot(chunkIndex)).value(channelIndex, pixelRowIndex % m_grid.tileYSize(), pixelColumnIndex % m_grid.tileXSize());
+		}
+		/// <summary>
+		///		Samples of (rows) x (columns) region of level (levelX, levelY). Each tile overlapping the region is fetched once.
+		/// </summary>
+		/// <returns> samples of region, one array per channel (ordered as in chlist), row 0 = rows.first(), column 0 = columns.first() </returns>
+		ImageBuffer<channelCType32> region(const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns, const uint32_t levelX = 0, const uint32_t levelY = 0) const
+		{
+			const TileGrid::Level& lvl = m_grid.level(levelX, levelY);
+			tryValidateRegion(rows, columns, lvl);
+			ImageBuffer<channelCType32> samples(rows.last() - rows.first() + 1, columns.last() - columns.first() + 1, channelsNum());
+			std::lock_guard<std::mutex> lock(m_cacheMutex);
+			for (uint32_t tileY = rows.first() / m_grid.tileYSize(); tileY <= rows.last() / m_grid.tileYSize(); tileY++)
+			{
+				for (uint32_t tileX = columns.first() / m_grid.tileXSize(); tileX <= columns.last() / m_grid.tileXSize(); tileX++)
+				{
+					// overlap of tile and region, in level pixels
+					const uint32_t firstRow = std::max(rows.first(), tileY * m_grid.tileYSize()), lastRow = std::min(rows.last(), tileY * m_grid.tileYSize() + m_grid.tileHeight(lvl, tileY) - 1);
+					const uint32_t firstCol = std::max(columns.first(), tileX * m_grid.tileXSize()), lastCol = std::min(columns.last(), tileX * m_grid.tileXSize() + m_grid.tileWidth(lvl, tileX) - 1);
+					const ImageBuffer<channelCType32>& tileSamples = m_cache.slot(cachedTileSlot(m_grid.chunkIndex({ tileX, tileY, levelX, levelY })));
+					copyTileRegion(tileSamples, firstRow - tileY * m_grid.tileYSize(), firstCol - tileX * m_grid.tileXSize(), samples, firstRow - rows.first(), firstCol - columns.first(), lastRow - firstRow + 1, lastCol - firstCol + 1);
+				}
+			}
+			return samples;
+		}
+		/// <summary>
+		///		Decode every tile of every level (validates all tile headers and data), concurrently on (threadPool) workers if it is provided.
+		///		Decoded tiles are not cached.
+		/// </summary>
+		void decodeAllTiles(utils::ThreadPool* threadPool) const
+		{
+			const auto decodeRange = [&](const std::size_t firstChunk, const std::size_t lastChunk)
+			{
+				exrCompression::ChunkDecoders decoders;
+				std::vector<ui8> rawBuffer;
+				ImageBuffer<channelCType32> samples(m_grid.tileYSize(), m_grid.tileXSize(), channelsNum());
+				for (std::size_t chunkIndex = firstChunk; chunkIndex < lastChunk; chunkIndex++)
+				{
+					const TileChunk<channelCType32> chunk = tileHeader(uint32_t(chunkIndex));
+					chunk.decodeInto(chunk.decodeData(m_filebytes, m_compression, decoders, rawBuffer), samples);
+				}
+			};
+			if (threadPool == nullptr)
+			{
+				decodeRange(std::size_t(0), m_chunkOffsets.size());
+				return;
+			}
+			const std::size_t chunksPerTask = std::max<std::size_t>(1, m_chunkOffsets.size() / (std::size_t(threadPool->workersNum() + 1) * s_c_tasksPerWorker));
+			threadPool->parallelFor(0, m_chunkOffsets.size(), chunksPerTask, decodeRange);
+		}
+
+		/// <summary>
+		///		Values of pixels of (rows) x (columns) region of full resolution level, as PixelData::toStringAsRGBAPixels() does
+		///		(RGBA of each pixel, then other channels). Region is decoded one row of tiles at a time.
+		/// </summary>
+		std::string toStringAsRGBAPixels(const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns, const uint8_t fltPrecis = 6) const
+		{
+			tryValidateRegion(rows, columns, m_grid.levels()[0]);
+			const bool hasRGBAChannels = std::any_of(m_rgbaChannelIndexes.begin(), m_rgbaChannelIndexes.end(), [](const int32_t index) { return 0 <= index; });
+			std::vector<uint32_t> otherChannelIndexes;
+			std::string otherChannelsNames = "";
+			for (uint32_t ch = 0; ch < channelsNum(); ch++)
+			{
+				if (std::find(m_rgbaChannelIndexes.begin(), m_rgbaChannelIndexes.end(), int32_t(ch)) == m_rgbaChannelIndexes.end())
+				{
+					otherChannelsNames += (otherChannelIndexes.empty() ? "" : ", ") + m_channelNames[ch];
+					otherChannelIndexes.push_back(ch);
+				}
+			}
+			std::string str = "";
+			for (uint32_t bandFirstRow = rows.first(); bandFirstRow <= rows.last(); )
+			{
+				const uint32_t bandLastRow = std::min(rows.last(), (bandFirstRow / m_grid.tileYSize() + 1) * m_grid.tileYSize() - 1);
+				const ImageBuffer<channelCType32> band = region(utils::Range<uint32_t>(bandFirstRow, bandLastRow), columns);
+				for (uint32_t row = bandFirstRow; row <= bandLastRow; row++)
+				{
+					str += "row [" + std::to_string(row) + "]: \n";
+					for (uint32_t col = columns.first(); col <= columns.last(); col++)
+					{
+						const uint32_t bandRow = row - bandFirstRow, bandCol = col - columns.first();
+						const auto bandValue = [&](const uint32_t channelIndex) { return valueString(band.value(channelIndex, bandRow, bandCol), fltPrecis); };
+						if (hasRGBAChannels)
+						{
+							std::string rgbaStr = "";
+							for (uint32_t rgbaIndex = s_c_rgbaR; rgbaIndex <= s_c_rgbaA; rgbaIndex++)
+							{
+								const int32_t channelIndex = m_rgbaChannelIndexes[rgbaIndex];
+								rgbaStr += (rgbaIndex == s_c_rgbaR ? "" : ", ") + (channelIndex < 0 ? valueString(rgbaDefaultValue<channelCType32>(rgbaIndex), fltPrecis) : bandValue(uint32_t(channelIndex)));
+							}
+							str += "\t pixel[" + std::to_string(row) + ", " + std::to_string(col) + "].RGBA = " + rgbaStr + "\n";
+						}
+						if (not otherChannelIndexes.empty())
+						{
+							std::string valuesStr = "";
+							for (const uint32_t ch : otherChannelIndexes)
+							{
+								valuesStr += (valuesStr.empty() ? "" : ", ") + bandValue(ch);
+							}
+							str += "\t pixel[" + std::to_string(row) + ", " + std::to_string(col) + "].(" + otherChannelsNames + ") = " + valuesStr + "\n";
+						}
+					}
+				}
+				if (bandLastRow == rows.last())
+				{
+					break;
+				}
+				bandFirstRow = bandLastRow + 1;
+			}
+			return str;
+		}
+		std::string toStringAsRGBAPixels(const uint8_t fltPrecis = 6) const
+		{
+			return toStringAsRGBAPixels(utils::Range<uint32_t>(0, rowsNum() - 1), utils::Range<uint32_t>(0, columnsNum() - 1), fltPrecis);
+		}
+		/// <summary>
+		///		Tiles as stored in file: header of each tile (all levels), byte ranges and values of its samples
+		///		within (rows) x (columns) region (pixel coordinates of the level of the tile).
+		/// </summary>
+		std::string toStringAsExrTiles(const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns, const uint8_t tabsNum = 0) const
+		{
+			std::vector<uint32_t> chunkIndexes(m_chunkOffsets.size());
+			for (uint32_t i = 0; i < chunkIndexes.size(); i++)
+			{
+				chunkIndexes[i] = i;
+			}
+			std::stable_sort(chunkIndexes.begin(), chunkIndexes.end(), [this](const uint32_t left, const uint32_t right) { return m_chunkOffsets[left] < m_chunkOffsets[right]; });
+			std::string pixeldataStr;
+			for (const uint32_t chunkIndex : chunkIndexes)		// tiles, as ordered in file
+			{
+				const TileChunk<channelCType32> chunk = tileHeader(chunkIndex);
+				const TileGrid::TileCoords& coords = chunk.coords();
+				const std::string fieldNames[] = { "tile.x", "tile.y", "tile.levelX", "tile.levelY" };
+				const uint32_t fieldValues[] = { coords.tileX, coords.tileY, coords.levelX, coords.levelY };
+				for (uint32_t i = 0; i < 4; i++)
+				{
+					pixeldataStr += utils::tabs(tabsNum) + "[0x" + utils::hex64(chunk.headerFieldFirstByteIndex(i),4) + "; 0x" + utils::hex64(chunk.headerFieldFirstByteIndex(i+1)-1,4) + "] " + fieldNames[i] + " = " + std::to_string(fieldValues[i]) + " \n";
+				}
+				pixeldataStr += utils::tabs(tabsNum) + "[0x" + utils::hex64(chunk.headerFieldFirstByteIndex(4),4) + "; 0x" + utils::hex64(chunk.dataFirstByteIndex()-1,4) + "] dataSizeInBytes = " + std::to_string(chunk._dataSizeInBytes())
+					+ (chunk.isCompressed() ? " (" + exr2::consta::compressionName(m_compression) : " (stored uncompressed")
+					+ ", " + std::to_string(chunk.width()) + " x " + std::to_string(chunk.height()) + " pixels, " + std::to_string(chunk.rawSizeInBytes()) + " bytes uncompressed) \n";
+				pixeldataStr += utils::tabs(tabsNum) + "[0x" + utils::hex64(chunk.dataFirstByteIndex(),4) + "; 0x" + utils::hex64(chunk.lastByteIndex(),4) + "] data \n";
+				// overlap of tile and region, in level pixels
+				const uint32_t tileFirstRow = coords.tileY * m_grid.tileYSize(), tileFirstCol = coords.tileX * m_grid.tileXSize();
+				const uint32_t firstRow = std::max(rows.first(), tileFirstRow), lastRow = std::min(rows.last(), tileFirstRow + chunk.height() - 1);
+				const uint32_t firstCol = std::max(columns.first(), tileFirstCol), lastCol = std::min(columns.last(), tileFirstCol + chunk.width() - 1);
+				if (lastRow < firstRow or lastCol < firstCol)
+				{
+					continue;
+				}
+				pixeldataStr += utils::tabs(tabsNum) + "entries (byte ranges within uncompressed tile data): \n";
+				const ImageBuffer<channelCType32> samples = region(utils::Range<uint32_t>(firstRow, lastRow), utils::Range<uint32_t>(firstCol, lastCol), coords.levelX, coords.levelY);
+				for (uint32_t row = firstRow; row <= lastRow; row++)				// tile line
+				{
+					for (uint32_t j = 0; j < chunk.pixelChannelsNum(); j++)			// pixel channel
+					{
+						for (uint32_t k = firstCol; k <= lastCol; k++)				// level column
+						{
+							const uint32_t sampleFirstByteIndex = chunk.rawSampleFirstByteIndex(row - tileFirstRow, j, k - tileFirstCol);
+							pixeldataStr +=
+								utils::tabs(tabsNum+1) + "[+0x" + utils::hex(sampleFirstByteIndex,4) + "; +0x" + utils::hex(sampleFirstByteIndex + chunk.sampleSizeInBytes(j) - 1,4) + "] " + utils::str(samples.value(j, row - firstRow, k - firstCol), 9)
+								+ "\t = px[" + std::to_string(row) + ", " + std::to_string(k) + "] level (" + std::to_string(coords.levelX) + ", " + std::to_string(coords.levelY) + ") channel " + m_channelNames[j] + "\n";
+						}
+					}
+				}
+			}
+			return pixeldataStr;
+		}
+
+		private:
+		ui8view m_filebytes;
+		std::vector<uint64_t> m_chunkOffsets;							// ordered as in offset table (see TileGrid)
+		TileGrid m_grid;
+		std::vector<std::string> m_channelNames;						// ordered as in chlist
+		std::array<int32_t, 4> m_rgbaChannelIndexes = { -1, -1, -1, -1 };
+		exr2::consta::s_compression::value m_compression = exr2::consta::s_compression::value::NO;
+		TileLineDecoders<channelCType32> m_lineDecoders;
+		uint64_t m_firstByteIndex = 0, m_lastByteIndex = 0;
+		mutable TileCache<channelCType32> m_cache;
+		mutable exrCompression::ChunkDecoders m_decoders;
+		mutable std::vector<ui8> m_rawBuffer;							// uncompressed data of last decoded tile
+		mutable std::mutex m_cacheMutex;								// guards m_cache, m_decoders, m_rawBuffer
+		static const uint32_t s_c_tasksPerWorker = 4;
+
+		/// <summary>
+		///		Read header of tile of (chunkIndex) offset table entry and check the tile is the one the entry must point to.
+		/// </summary>
+		TileChunk<channelCType32> tileHeader(const uint32_t chunkIndex) const
+		{
+			const TileChunk<channelCType32> chunk(m_filebytes, m_chunkOffsets[chunkIndex], m_grid, m_lineDecoders);
+			const TileGrid::TileCoords expected = m_grid.tileCoords(chunkIndex);
+			const TileGrid::TileCoords& actual = chunk.coords();
+			if (actual.tileX != expected.tileX or actual.tileY != expected.tileY or actual.levelX != expected.levelX or actual.levelY != expected.levelY)
+			{
+				throw std::runtime_error
+				(
+					"offset table entry " + std::to_string(chunkIndex) + " must point to tile (" + std::to_string(expected.tileX) + ", " + std::to_string(expected.tileY) + ") of level (" + std::to_string(expected.levelX) + ", " + std::to_string(expected.levelY) + "), "
+					"but tile at 0x" + utils::hex64(m_chunkOffsets[chunkIndex]) + " is (" + std::to_string(actual.tileX) + ", " + std::to_string(actual.tileY) + ") of level (" + std::to_string(actual.levelX) + ", " + std::to_string(actual.levelY) + ")."
+				);
+			}
+			return chunk;
+		}
+		/// <summary>
+		///		Find tile of (chunkIndex) offset table entry in cache, decoding it from filebytes on cache miss.
+		///		Caller must hold (m_cacheMutex).
+		/// </summary>
+		/// <returns> slot of m_cache storing samples of the tile </returns>
+		uint32_t cachedTileSlot(const uint32_t chunkIndex) const
+		{
+			uint32_t slot = 0;
+			if (m_cache.find(chunkIndex, slot))
+			{
+				return slot;
+			}
+			const TileChunk<channelCType32> chunk = tileHeader(chunkIndex);
+			slot = m_cache.insert(chunkIndex);
+			try
+			{
+				chunk.decodeInto(chunk.decodeData(m_filebytes, m_compression, m_decoders, m_rawBuffer), m_cache.slot(slot));
+			}
+			catch (...)
+			{
+				m_cache.erase(chunkIndex);
+				throw;
+			}
+			return slot;
+		}
+		/// <summary> Copy (rowsNum) x (columnsNum) samples of all channels from (src) at [srcRow, srcColumn] to (dst) at [dstRow, dstColumn]. </summary>
+		static void copyTileRegion(const ImageBuffer<channelCType32>& src, const uint32_t srcRow, const uint32_t srcColumn, ImageBuffer<channelCType32>& dst, const uint32_t dstRow, const uint32_t dstColumn, const uint32_t rowsNum, const uint32_t columnsNum)
+		{
+			for (uint32_t ch = 0; ch < dst.channelsNum(); ch++)
+			{
+				for (uint32_t i = 0; i < rowsNum; i++)
+				{
+					std::memcpy(dst.rowData(ch, dstRow + i) + dstColumn, src.rowData(ch, srcRow + i) + srcColumn, std::size_t(columnsNum) * sizeof(channelCType32));
+				}
+			}
+		}
+		static void tryValidateRegion(const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns, const TileGrid::Level& lvl)
+		{
+			if (rows.last() < rows.first() or lvl.height <= rows.last() or columns.last() < columns.first() or lvl.width <= columns.last())
+			{
+				throw std::invalid_argument
+				(
+					"region rows [" + std::to_string(rows.first()) + "; " + std::to_string(rows.last()) + "], columns [" + std::to_string(columns.first()) + "; " + std::to_string(columns.last()) + "] "
+					"is not valid for level (" + std::to_string(lvl.x) + ", " + std::to_string(lvl.y) + ") of " + std::to_string(lvl.height) + " rows and " + std::to_string(lvl.width) + " columns"
+				);
+			}
+		}
+		static std::string valueString(const channelCType32 value, const uint8_t fltPrecis)
+		{
+			if constexpr (std::is_same_v<channelCType32, float>)
+			{
+				return utils::str(value, fltPrecis);
+			}
+			else
+			{
+				return std::to_string(value);
+			}
+		}
+	};
+}
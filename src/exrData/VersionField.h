@@ -1,4 +1,5 @@
 #pragma once
+#include <cstring>
 #include <stdexcept>
 #include <vector>
 
@@ -10,9 +11,13 @@
 class VersionField
 {
 	public:
-	VersionField(const std::vector<ui8>& filebytes)
+	VersionField(const ui8view filebytes)
 	{
-		std::vector<uint8_t> exr_versionFieldBytes = utils::slice((std::vector<uint8_t>)filebytes, s_c_vfFirstByteIndex, s_c_vfLastByteIndex);	// versionField: filebytes [04~07]
+		if (filebytes.size() <= s_c_vfLastByteIndex)
+		{
+			throw std::invalid_argument("(filebytes) contains less than 8 bytes. Unable to extract OpenEXR Version Field.");
+		}
+		const ui8view exr_versionFieldBytes = filebytes.subspan(s_c_vfFirstByteIndex, s_c_vfLastByteIndex - s_c_vfFirstByteIndex + 1);	// versionField: filebytes [04~07]
 		std::memcpy(&m_versionfield, exr_versionFieldBytes.data(), exr_versionFieldBytes.size());
 		m_exrVersionNum = m_versionfield & 0x000000FF;
 		m_bit09_singlePartTiled = bool((m_versionfield & 0x00000200) >> 8);	// docs say mask = 0x0200 => bit 9 is bit countable or bit index ? - test!
@@ -41,7 +46,7 @@ class VersionField
 
 	bool isValidExr2_0() const
 	{
-		uint32_t versionfieldAnyVersion = m_versionfield & 0xFFFFFF00;		// all its except OpenEXR version byte
+		uint32_t versionfieldAnyVersion = m_versionfield & 0xFFFFFF00 & ~exr2::consta::ValidVersionField::c_longNamesBit;		// all bits except OpenEXR version byte and bit 10 (long names are valid in any file)
 		return (versionfieldAnyVersion == exr2::consta::ValidVersionField::c_singleScan or
 			versionfieldAnyVersion == exr2::consta::ValidVersionField::c_singleTile or
 			versionfieldAnyVersion == exr2::consta::ValidVersionField::c_multiScanOrTile or
@@ -49,6 +54,12 @@ class VersionField
 			versionfieldAnyVersion == exr2::consta::ValidVersionField::c_multiDeepScanOrTile);
 	}
 
+	/// <returns> whole version field (4 bytes, little-endian) </returns>
+	uint32_t value() const
+	{
+		return m_versionfield;
+	}
+
 	uint8_t exrVersion() const
 	{
 		return m_exrVersionNum;
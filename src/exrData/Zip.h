@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "exrData/ChunkDecoder.h"
+#include "exrData/ChunkEncoder.h"
+#include "types.h"
+
+namespace exrCompression
+{
+	/// ReadMe: ZIP / ZIPS compression of OpenEXR
+	/*
+		source: https://openexr.com/en/latest/TechnicalIntroduction.html#data-compression
+		date: 2026.10.17
+
+		Chunk data is compressed in 3 steps (decompression reverses them in opposite order):
+		1. bytes of uncompressed chunk are split: bytes with even index go to first half, bytes with odd index - to second half;
+		2. predictor: each byte is replaced with (byte - previous byte + 128);
+		3. result is compressed with zlib (deflate) - ZIPS chunk stores 1 scanline, ZIP chunk stores 16 scanlines.
+		If compressed data is not smaller than uncompressed, chunk stores uncompressed data instead.
+	*/
+
+	/// <summary>
+	///		Decompress zlib stream (src) into (dst) and verify its adler32 checksum (zlib uncompress()).
+	/// </summary>
+	/// <param name="dstSize"> - capacity of (dst), decompressed data must fit into it </param>
+	/// <returns> number of decompressed bytes written to (dst) </returns>
+	inline std::size_t zlibDecompress(const ui8view src, ui8* dst, const std::size_t dstSize)
+	{
+		// chunk data is smaller than 2 GB (its size is int32), so sizes fit uLong of any platform
+		uLongf decompressedSize = uLongf(dstSize);
+		const int result = uncompress(dst, &decompressedSize, src.data(), uLong(src.size()));
+		if (result == Z_BUF_ERROR)
+		{
+			throw std::runtime_error("zlib stream is truncated or decompresses to more bytes than expected (" + std::to_string(dstSize) + ").");
+		}
+		if (result != Z_OK)
+		{
+			throw std::runtime_error("zlib stream is invalid (" + std::string(zError(result)) + ").");
+		}
+		return std::size_t(decompressedSize);
+	}
+
+	/// <summary>
+	///		Compress (src) into zlib stream of default compression level (zlib compress2()), appended to (dst).
+	/// </summary>
+	inline void zlibCompress(const ui8view src, std::vector<ui8>& dst)
+	{
+		const std::size_t dstFirst = dst.size();
+		uLongf compressedSize = compressBound(uLong(src.size()));
+		dst.resize(dstFirst + compressedSize);
+		const int result = compress2(dst.data() + dstFirst, &compressedSize, src.data(), uLong(src.size()), Z_DEFAULT_COMPRESSION);
+		if (result != Z_OK)
+		{
+			throw std::runtime_error("zlib compression of " + std::to_string(src.size()) + " bytes failed (" + std::string(zError(result)) + ").");
+		}
+		dst.resize(dstFirst + compressedSize);
+	}
+
+	/// <summary>
+	///		Decompressor of ZIP / ZIPS chunk data. Keeps its buffers between calls, so reuse one ZipDecoder per thread.
+	/// </summary>
+	class ZipDecoder : public ChunkDecoder
+	{
+		public:
+		/// <summary>
+		///		Decompress (compressed) chunk data into (out), reversing zlib, predictor and byte split steps.
+		/// </summary>
+		/// <param name="rawSize"> - size of uncompressed chunk data, (out) must have room for it </param>
+		void decode(const ui8view compressed, const ChunkLayout& /*layout*/, ui8* out, const std::size_t rawSize) override
+		{
+			m_inflated.resize(rawSize);
+			const std::size_t inflatedSize = zlibDecompress(compressed, m_inflated.data(), rawSize);
+			if (inflatedSize != rawSize)
+			{
+				throw std::runtime_error("ZIP chunk decompresses to " + std::to_string(inflatedSize) + " bytes, " + std::to_string(rawSize) + " bytes expected.");
+			}
+			reversePredictorAndByteSplit(m_inflated.data(), out, rawSize);
+		}
+
+		private:
+		std::vector<ui8> m_inflated;
+	};
+
+	/// <summary>
+	///		Compressor of ZIP / ZIPS chunk data. Keeps its buffers between calls, so reuse one ZipEncoder per thread.
+	/// </summary>
+	class ZipEncoder : public ChunkEncoder
+	{
+		public:
+		void encode(const ui8view raw, const ChunkLayout& /*layout*/, std::vector<ui8>& out) override
+		{
+			m_predicted.resize(raw.size());
+			byteSplitAndPredictor(raw.data(), m_predicted.data(), raw.size());
+			out.clear();
+			zlibCompress(ui8view(m_predicted.data(), m_predicted.size()), out);
+		}
+
+		private:
+		std::vector<ui8> m_predicted;
+	};
+}
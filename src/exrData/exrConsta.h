@@ -18,6 +18,10 @@ namespace exr
 			inline static const std::string s_pixelAspectRatio = "pixelAspectRatio";
 			inline static const std::string s_screenWindowCenter = "screenWindowCenter";
 			inline static const std::string s_screenWindowWidth = "screenWindowWidth";
+			inline static const std::string s_tiles = "tiles";					// required for tiled images only
+			inline static const std::string s_name = "name";					// required for multi-part files only
+			inline static const std::string s_type = "type";					// required for multi-part files only
+			inline static const std::string s_chunkCount = "chunkCount";		// required for multi-part files only
 		};
 
 		/* document tag [STD-ATTRIBUTE-01] */
@@ -29,6 +33,9 @@ namespace exr
 			inline static const std::string s_lineOrder = "lineOrder";
 			inline static const std::string s_float32 = "float";
 			inline static const std::string s_v2f = "v2f";
+			inline static const std::string s_tiledesc = "tiledesc";
+			inline static const std::string s_int32 = "int";
+			inline static const std::string s_string = "string";
 		};
 
 		/* document tag [EXR-ATTRIB-TYPES-01] */
@@ -39,6 +46,8 @@ namespace exr
 			inline static const uint32_t s_lineOrder	= 1;
 			inline static const uint32_t s_float32	= sizeof(float);
 			inline static const uint32_t s_v2f		= 2 * sizeof(float);
+			inline static const uint32_t s_tiledesc	= 2 * sizeof(uint32_t) + 1;
+			inline static const uint32_t s_int32		= sizeof(int32_t);
 		};
 
 	}
@@ -51,6 +60,7 @@ namespace exr2
 	{
 		const uint32_t c_magicNumber = 0x01312F76; const uint32_t c_magicNumber_firstByteIndex = 0, c_magicNumber_lastByteIndex = 3;
 		const uint8_t c_versionNumber = 0x02;
+		const uint32_t c_headerFirstByteIndex = 8;	// header attributes start right after magic number [00~03] and version field [04~07]
 
 		/* document tag [VERSIONFIELD-02] */
 		namespace ValidVersionField
@@ -60,11 +70,12 @@ namespace exr2
 			inline constexpr uint32_t c_multiScanOrTile		= 0x00001000;	// bits 9, 10, 11, 12: 0, ~, 0, 1
 			inline constexpr uint32_t c_singleDeepScanOrTile= 0x00000800;	// bits 9, 10, 11, 12: 0, ~, 1, 0
 			inline constexpr uint32_t c_multiDeepScanOrTile	= 0x00001800;	// bits 9, 10, 11, 12: 0, ~, 1, 1
+			inline constexpr uint32_t c_longNamesBit		= 0x00000400;	// bit 10: attribute names / types up to 255 bytes, valid with any of the above
 		}
 
 		namespace channel
 		{
-			const enum datatype
+			enum datatype
 			{
 				min		= 0x00,
 				UINT	= 0x00,
@@ -88,11 +99,18 @@ namespace exr2
 					(channelDataTypeByteValue == exr2::consta::channel::datatype::HALF) ? "HALF" : 
 					(channelDataTypeByteValue == exr2::consta::channel::datatype::FLOAT) ? "FLOAT" : "EXR2_INVALID_VALUE_OF_CHANNEL_DATA_TYPE_BYTE";
 			}
+
+			/// <returns> size of one sample of channel of (channelDataTypeByteValue) type in bytes: UINT 4, HALF 2, FLOAT 4 </returns>
+			uint32_t channelDataTypeSizeInBytes(const uint32_t channelDataTypeByteValue)
+			{
+				channelDataTypeName(channelDataTypeByteValue);		// validates the value
+				return (channelDataTypeByteValue == exr2::consta::channel::datatype::HALF) ? 2 : 4;
+			}
 		}
 
 		namespace s_compression
 		{
-			static const enum value
+			enum value
 			{
 				NO		= 0x00,
 				RLE		= 0x01,
@@ -130,12 +148,94 @@ namespace exr2
 			}
 			return name;
 		}
+		/// <summary>
+		///		Number of scanlines stored (and compressed together) in one chunk of scanline image, 
+		///		see https://openexr.com/en/latest/OpenEXRFileLayout.html#scan-lines
+		/// </summary>
+		static uint32_t scanlinesPerChunk(const uint8_t compressionValue)
+		{
+			switch(compressionValue)
+			{
+				case s_compression::value::NO:
+				case s_compression::value::RLE:
+				case s_compression::value::ZIPS:	return 1;
+				case s_compression::value::ZIP:
+				case s_compression::value::PXR24:	return 16;
+				case s_compression::value::PIZ:
+				case s_compression::value::B44:
+				case s_compression::value::B44A:
+				case s_compression::value::DWAA:	return 32;
+				case s_compression::value::DWAB:	return 256;
+				default:
+				{
+					throw std::invalid_argument("OpenEXR compression can not have the specified value. Check the documentation.");
+				}
+			}
+		}
+
+		/* document tag [EXR-ATTRIB-TYPES-01]: tiledesc.mode = levelMode + roundingMode * 16 */
+		namespace s_levelMode
+		{
+			enum value
+			{
+				ONE_LEVEL		= 0x00,
+				MIPMAP_LEVELS	= 0x01,
+				RIPMAP_LEVELS	= 0x02
+			};
+		}
+
+		static std::string levelModeName(const uint8_t levelModeValue)
+		{
+			switch(levelModeValue)
+			{
+				case s_levelMode::value::ONE_LEVEL:		return "ONE_LEVEL";
+				case s_levelMode::value::MIPMAP_LEVELS:	return "MIPMAP_LEVELS";
+				case s_levelMode::value::RIPMAP_LEVELS:	return "RIPMAP_LEVELS";
+				default:
+				{
+					throw std::invalid_argument("OpenEXR tiledesc level mode can not have the specified value. Check the documentation.");
+				}
+			}
+		}
+
+		namespace s_roundingMode
+		{
+			enum value
+			{
+				ROUND_DOWN	= 0x00,
+				ROUND_UP	= 0x01
+			};
+		}
+
+		static std::string roundingModeName(const uint8_t roundingModeValue)
+		{
+			switch(roundingModeValue)
+			{
+				case s_roundingMode::value::ROUND_DOWN:	return "ROUND_DOWN";
+				case s_roundingMode::value::ROUND_UP:	return "ROUND_UP";
+				default:
+				{
+					throw std::invalid_argument("OpenEXR tiledesc rounding mode can not have the specified value. Check the documentation.");
+				}
+			}
+		}
+
+		/* document tag [STD-ATTRIBUTE-01]: values of "type" attribute (multi-part files) */
+		namespace PartType
+		{
+			inline static const std::string s_scanlineImage = "scanlineimage";
+			inline static const std::string s_tiledImage = "tiledimage";
+			inline static const std::string s_deepScanline = "deepscanline";
+			inline static const std::string s_deepTile = "deeptile";
+		};
+		// multi-part file: each chunk starts with number of part it belongs to (int32)
+		const uint32_t c_partNumberSizeInBytes = sizeof(int32_t);
 
 		namespace s_lineOrder
 		{
 			typedef uint8_t ctype;
 
-			static const enum value
+			enum value
 			{
 				INCREASING_Y = 0x00,
 				DECREASING_Y = 0x01,
@@ -1,6 +1,8 @@
 #pragma once
 #include <algorithm>
+#include <cstring>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <stdexcept>
 
@@ -59,12 +61,17 @@ namespace exrTypes
 		return value;
 	}
 
-	static std::string readCString(const std::vector<ui8>::const_iterator strFirst, const std::vector<ui8>::const_iterator cend)
+	static std::string readCString(const ui8view bytes, const std::size_t strFirstByteIndex)
 	{
-		std::vector<ui8>::const_iterator strEnd = std::find(strFirst, cend, '\0');
-		if (strEnd == cend)
+		if (bytes.size() <= strFirstByteIndex)
 		{
-			throw std::runtime_error("\'\0\' (c-string null-terminator) not found");
+			throw std::runtime_error("c-string first byte index is out of bytes range");
+		}
+		const ui8view::iterator strFirst = bytes.begin() + strFirstByteIndex;
+		const ui8view::iterator strEnd = std::find(strFirst, bytes.end(), '\0');
+		if (strEnd == bytes.end())
+		{
+			throw std::runtime_error("\'\\0\' (c-string null-terminator) not found");
 		}
 		return std::string(strFirst, strEnd);
 	}
@@ -96,7 +103,7 @@ namespace exrTypes
 	class Channel
 	{
 		public:
-		Channel(const std::vector<ui8>& filebytes, const uint32_t channelFirstByteIndex, const bool versionFieldBit10)
+		Channel(const ui8view filebytes, const uint32_t channelFirstByteIndex, const bool versionFieldBit10)
 			: m_channel_firstByteIndex(channelFirstByteIndex)
 		{
 			// find "channels\0chlist\0" byte-substring in filebytes and analyse the following bytes
@@ -104,16 +111,16 @@ namespace exrTypes
 			m_channel_lastByteIndex = lastByteIndex();
 		}
 
-		void analyseChannel(const std::vector<ui8>& bytes, const uint32_t channelFirstByteIndex)
+		void analyseChannel(const ui8view bytes, const uint32_t channelFirstByteIndex)
 		{
 			// chlist channel name
 			m_name_firstByteIndex = channelFirstByteIndex;
-			m_name = exrTypes::readCString(bytes.cbegin() + m_name_firstByteIndex, bytes.cend());
+			m_name = exrTypes::readCString(bytes, m_name_firstByteIndex);
 			m_name_lastByteIndex = m_name_firstByteIndex + m_name.length();	// no -1 because counting +1 '\0'
 			// channel data type
 			m_channelType_firstByteIndex = m_name_lastByteIndex + 1;
 			m_channelType_lastByteIndex = m_channelType_firstByteIndex + sizeof(m_channelType)-1; // int32_t is 4 bytes => offset= 3
-			m_channelType = exrTypes::readUint32((bytes.cbegin() + m_channelType_firstByteIndex)._Ptr);
+			m_channelType = exrTypes::readUint32(bytes.data() + m_channelType_firstByteIndex);
 			// channel pLinear
 			m_pLinear_firstByteIndex = m_channelType_lastByteIndex + 1;
 			m_pLinear_lastByteIndex = m_pLinear_firstByteIndex;
@@ -128,11 +135,11 @@ namespace exrTypes
 			// channel xSampling int
 			m_samplingX_firstByteIndex = m_reserved_lastByteIndex + 1;
 			m_samplingX_lastByteIndex = m_samplingX_firstByteIndex + sizeof(m_samplingX)-1; // int32_t is 4 bytes => offset= 3
-			m_samplingX = exrTypes::readUint32((bytes.cbegin()+m_samplingX_firstByteIndex)._Ptr);
+			m_samplingX = exrTypes::readUint32(bytes.data() + m_samplingX_firstByteIndex);
 			// channel ySampling int
 			m_samplingY_firstByteIndex = m_samplingX_lastByteIndex + 1;
 			m_samplingY_lastByteIndex = m_samplingY_firstByteIndex + sizeof(m_samplingY)-1; // int32_t is 4 bytes => offset= 3
-			m_samplingY = exrTypes::readUint32((bytes.cbegin()+m_samplingY_firstByteIndex)._Ptr);
+			m_samplingY = exrTypes::readUint32(bytes.data() + m_samplingY_firstByteIndex);
 			m_channel_lastByteIndex = m_samplingY_lastByteIndex;
 			m_isAnalysed = true;
 		}
@@ -141,6 +148,15 @@ namespace exrTypes
 		
 		uint32_t type() const { return m_channelType; }
 
+		/// <returns> pLinear byte: 1 if channel samples are perceptually linear (B44 stores them exp-like encoded), 0 otherwise </returns>
+		uint8_t pLinear() const { return m_pLinear; }
+
+		/// <returns> xSampling: channel has samples only in columns x with x % xSampling == 0 (1 = sample in every column) </returns>
+		int32_t xSampling() const { return m_samplingX; }
+
+		/// <returns> ySampling: channel has samples only in lines y with y % ySampling == 0 (1 = sample in every line) </returns>
+		int32_t ySampling() const { return m_samplingY; }
+
 		uint32_t lastByteIndex() const
 		{
 			if (!m_isAnalysed) throw m_channelNotAnalysed;
@@ -313,10 +329,10 @@ namespace exrTypes
 		///		** Since there is no constant pre-known size of value of Chlist type, calling tryValidateSizeIs has no sense, 
 		///			since there is no suitable predefined requiredSize constant.
 		/// </summary>
-		/// <param name="filebytes"> - vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
+		/// <param name="filebytes"> - view of bytes (uin8_t / unsigned char) of full input .exr file </param>
 		/// <param name="chlistFirstByteIndex"> - index of first byte of chlist value within "filebytes" vector of input .exr file bytes </param>
-		Chlist(const std::vector<ui8> filebytes, const uint32_t chlistFirstByteIndex, const bool versionFieldBit10)
-			: exrTypeBase(chlistFirstByteIndex, sizeInBytes())
+		Chlist(const ui8view filebytes, const uint32_t chlistFirstByteIndex, const bool versionFieldBit10)
+			: exrTypeBase(chlistFirstByteIndex, 1)		// size of empty chlist (final 0x00 byte), real size is set below; sizeInBytes() must not be called before m_channels is constructed
 		{
 			// tryValidateSizeIs();		// chlist size does not have predefined const value
 			// extract channels from attribute byte sequence
@@ -386,6 +402,68 @@ namespace exrTypes
 			return exr2::consta::channel::channelDataTypeName(m_channels[channelIndex].type());
 		}
 
+		/// <returns> data type values (UINT, HALF or FLOAT) of all channels, ordered as in chlist </returns>
+		std::vector<uint32_t> channelDataTypes() const
+		{
+			std::vector<uint32_t> types;
+			for (uint32_t i = 0; i < m_channels.size(); i++)
+			{
+				types.push_back(m_channels[i].type());
+			}
+			return types;
+		}
+
+		int32_t channelXSampling(const uint32_t channelIndex) const
+		{
+			tryValidateChannelIndex(channelIndex);
+			return m_channels[channelIndex].xSampling();
+		}
+
+		int32_t channelYSampling(const uint32_t channelIndex) const
+		{
+			tryValidateChannelIndex(channelIndex);
+			return m_channels[channelIndex].ySampling();
+		}
+
+		/// <returns> true if any channel has xSampling or ySampling other than 1 (fewer samples than pixels) </returns>
+		bool isAnyChannelSubsampled() const
+		{
+			for (uint32_t i = 0; i < m_channels.size(); i++)
+			{
+				if (m_channels[i].xSampling() != 1 or m_channels[i].ySampling() != 1)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/// <returns> true if any HALF channel has pLinear = 1 </returns>
+		bool isAnyHalfChannelPerceptuallyLinear() const
+		{
+			for (uint32_t i = 0; i < m_channels.size(); i++)
+			{
+				if (m_channels[i].type() == exr2::consta::channel::datatype::HALF and m_channels[i].pLinear() != 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/// <returns> true if any channel has pLinear = 1 </returns>
+		bool isAnyChannelPerceptuallyLinear() const
+		{
+			for (uint32_t i = 0; i < m_channels.size(); i++)
+			{
+				if (m_channels[i].pLinear() != 0)
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
 		/// <summary> Implements interface: returns string containing values stored within class. </summary>
 		/// <returns> std::string text with values stored by class </returns>
 		std::string toString(const uint8_t tabsNum = 0) const override
@@ -427,9 +505,9 @@ namespace exrTypes
 		///			checks the type of stored OpenEXR data to be of same size as its OpenEXR equivalent,
 		///			reads the value (or components of value) from filebytes.
 		/// </summary>
-		/// <param name="filebytes"> - vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
+		/// <param name="filebytes"> - view of bytes (uin8_t / unsigned char) of full input .exr file </param>
 		/// <param name="compressionFirstByteIndex"> - index of first byte of compression value within "filebytes" vector of input .exr file bytes </param>
-		Compression(const std::vector<ui8> filebytes, const uint32_t compressionFirstByteIndex)
+		Compression(const ui8view filebytes, const uint32_t compressionFirstByteIndex)
 			: exrTypeBase(compressionFirstByteIndex, sizeInBytes())
 		{
 			// check if type of stored value and sizeInBytes() are implemented correctly
@@ -489,9 +567,9 @@ namespace exrTypes
 		///			initializes filebytes indexes of first and last bytes of each value component & 
 		///			reads that value (or those components of value) from filebytes.
 		/// </summary>
-		/// <param name="filebytes"> - vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
+		/// <param name="filebytes"> - view of bytes (uin8_t / unsigned char) of full input .exr file </param>
 		/// <param name="box2iFirstByteIndex"> - index of first byte of box2i value within "filebytes" vector of input .exr file bytes </param>
-		Box2i(const std::vector<ui8>& filebytes, const uint32_t box2iFirstByteIndex)
+		Box2i(const ui8view filebytes, const uint32_t box2iFirstByteIndex)
 			: exrTypeBase(box2iFirstByteIndex, sizeInBytes())
 		{
 			tryValidateSizeIs(exr::consta::TypeValueSizeBytes::s_box2i);
@@ -504,10 +582,10 @@ namespace exrTypes
 			m_xMax_lastByteIndex = m_xMax_firstByteIndex + sizeof(m_xMax) - 1;
 			m_yMax_firstByteIndex = m_xMax_lastByteIndex + 1;
 			m_yMax_lastByteIndex = m_yMax_firstByteIndex + sizeof(m_yMax) - 1;
-			m_xMin = exrTypes::readUint32((filebytes.begin() + m_xMin_firstByteIndex)._Ptr);
-			m_yMin = exrTypes::readUint32((filebytes.begin() + m_yMin_firstByteIndex)._Ptr);
-			m_xMax = exrTypes::readUint32((filebytes.begin() + m_xMax_firstByteIndex)._Ptr);
-			m_yMax = exrTypes::readUint32((filebytes.begin() + m_yMax_firstByteIndex)._Ptr);
+			m_xMin = exrTypes::readUint32(filebytes.data() + m_xMin_firstByteIndex);
+			m_yMin = exrTypes::readUint32(filebytes.data() + m_yMin_firstByteIndex);
+			m_xMax = exrTypes::readUint32(filebytes.data() + m_xMax_firstByteIndex);
+			m_yMax = exrTypes::readUint32(filebytes.data() + m_yMax_firstByteIndex);
 		}
 		/// <summary>
 		///		Get xMin component of value of box2i type.
@@ -579,9 +657,9 @@ namespace exrTypes
 		///			checks the type of stored OpenEXR data to be of same size as its OpenEXR equivalent,
 		///			reads that value (or those components of value) from filebytes.
 		/// </summary>
-		/// <param name="filebytes"> vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
+		/// <param name="filebytes"> view of bytes (uin8_t / unsigned char) of full input .exr file </param>
 		/// <param name="box2iFirstByteIndex"> index of first byte of box2i value within "filebytes" vector of input .exr file bytes </param>
-		LineOrder(const std::vector<ui8>& filebytes, const uint32_t lineOrderFirstByteIndex)
+		LineOrder(const ui8view filebytes, const uint32_t lineOrderFirstByteIndex)
 			:
 			exrTypeBase(lineOrderFirstByteIndex, sizeInBytes()),
 			m_lineOrder(filebytes[lineOrderFirstByteIndex])
@@ -638,13 +716,13 @@ namespace exrTypes
 		///			checks the type of stored OpenEXR data to be of same size as its OpenEXR equivalent,
 		///			reads that value (or those components of value) from filebytes.
 		/// </summary>
-		/// <param name="filebytes"> vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
+		/// <param name="filebytes"> view of bytes (uin8_t / unsigned char) of full input .exr file </param>
 		/// <param name="box2iFirstByteIndex"> index of first byte of box2i value within "filebytes" vector of input .exr file bytes </param>
-		Float32(const std::vector<ui8>& filebytes, const uint32_t floatFirstByteIndex)
+		Float32(const ui8view filebytes, const uint32_t floatFirstByteIndex)
 			: exrTypeBase(floatFirstByteIndex, sizeInBytes())
 		{
 			tryValidateSizeIs(exr::consta::TypeValueSizeBytes::s_float32);
-			m_float32 = readFloat32((void*)(filebytes.begin()+floatFirstByteIndex)._Ptr);
+			m_float32 = readFloat32(filebytes.data() + floatFirstByteIndex);
 		}
 		/// <summary>
 		///		Get Float32 value.
@@ -692,14 +770,14 @@ namespace exrTypes
 		///			initializes filebytes indexes of first and last bytes of each value component & 
 		///			reads that value (or those components of value) from filebytes.
 		/// </summary>
-		/// <param name="filebytes"> vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
+		/// <param name="filebytes"> view of bytes (uin8_t / unsigned char) of full input .exr file </param>
 		/// <param name="box2iFirstByteIndex"> index of first byte of box2i value within "filebytes" vector of input .exr file bytes </param>
-		V2f(const std::vector<ui8>& filebytes, const uint32_t v2fFirstByteIndex)
+		V2f(const ui8view filebytes, const uint32_t v2fFirstByteIndex)
 			: exrTypeBase(v2fFirstByteIndex, sizeInBytes())
 		{
 			tryValidateSizeIs(exr::consta::TypeValueSizeBytes::s_v2f);
-			m_v2f[0] = readFloat32((void*)(filebytes.begin()+v2fFirstByteIndex)._Ptr);
-			m_v2f[1] = readFloat32((void*)(filebytes.begin()+v2fFirstByteIndex+byteOffset(1))._Ptr);
+			m_v2f[0] = readFloat32(filebytes.data() + v2fFirstByteIndex);
+			m_v2f[1] = readFloat32(filebytes.data() + v2fFirstByteIndex + byteOffset(1));
 		}
 		/// <summary>
 		///		Get float component of value of v2f (vector of 2 floats) type.
@@ -744,12 +822,274 @@ namespace exrTypes
 		float m_v2f[m_v2fLen] = {0};
 	};
 
+	/// <summary>
+	///		TileDesc = description of tiles of tiled image: size of tile (xSize, ySize), level mode and level size rounding mode.
+	///		Implements OpenEXR type interface to operate with data of "tiledesc" OpenEXR type.
+	///		Value layout: xSize (uint32), ySize (uint32), mode (uint8) = levelMode + roundingMode * 16.
+	/// </summary>
+	class TileDesc : public exrTypeBase
+	{
+		public:
+		/// <summary>
+		///		Constructor creates instance of base class and
+		///			checks the type of stored OpenEXR data to be of same size as its OpenEXR equivalent,
+		///			reads that value (or those components of value) from filebytes and validates them.
+		/// </summary>
+		/// <param name="filebytes"> - view of bytes (uin8_t / unsigned char) of full input .exr file </param>
+		/// <param name="tiledescFirstByteIndex"> - index of first byte of tiledesc value within "filebytes" vector of input .exr file bytes </param>
+		TileDesc(const ui8view filebytes, const uint32_t tiledescFirstByteIndex)
+			: exrTypeBase(tiledescFirstByteIndex, sizeInBytes())
+		{
+			tryValidateSizeIs(exr::consta::TypeValueSizeBytes::s_tiledesc);
+			if (filebytes.size() - tiledescFirstByteIndex < sizeInBytes())
+			{
+				throw std::runtime_error("tiledesc value at 0x" + utils::hex(tiledescFirstByteIndex) + " is out of file bytes range.");
+			}
+			m_xSize = readUint32(filebytes.data() + tiledescFirstByteIndex);
+			m_ySize = readUint32(filebytes.data() + tiledescFirstByteIndex + sizeof(m_xSize));
+			m_mode = filebytes[tiledescFirstByteIndex + sizeof(m_xSize) + sizeof(m_ySize)];
+			if (m_xSize == 0 or m_ySize == 0 or INT32_MAX < m_xSize or INT32_MAX < m_ySize)
+			{
+				throw std::runtime_error("tiledesc tile size " + std::to_string(m_xSize) + " x " + std::to_string(m_ySize) + " is not valid (valid: [1; 2^31-1]).");
+			}
+			exr2::consta::levelModeName(levelMode());			// validates the value
+			exr2::consta::roundingModeName(roundingMode());		// validates the value
+		}
+		uint32_t xSize() const { return m_xSize; }
+		uint32_t ySize() const { return m_ySize; }
+		/// <returns> exr2::consta::s_levelMode value: ONE_LEVEL, MIPMAP_LEVELS or RIPMAP_LEVELS </returns>
+		uint8_t levelMode() const { return m_mode & 0x0F; }
+		/// <returns> exr2::consta::s_roundingMode value: ROUND_DOWN or ROUND_UP </returns>
+		uint8_t roundingMode() const { return m_mode >> 4; }
+
+		/// <summary> Implements interface: returns string of name of OpenEXR-defined data type stored within this class. </summary>
+		/// <returns> std::string name of OpenEXR-defined type of data stored within this class </returns>
+		std::string type() const override { return exr::consta::Type::s_tiledesc; }
+		/// <summary>
+		///		Implements interface: returns number of bytes that OpenEXR data stored within this class takes, 
+		///		which must be equal to the size (in bytes) of value of corresponding OpenEXR-defined data type 
+		///		this class is implemented to store.
+		/// </summary>
+		/// <returns> uint32_t number of bytes taken by OpenEXR data stored within this class </returns>
+		uint32_t sizeInBytes() const override { return sizeof(m_xSize) + sizeof(m_ySize) + sizeof(m_mode); }
+		/// <summary> Implements interface: returns string containing values stored within class. </summary>
+		/// <returns> std::string text with values stored by class </returns>
+		std::string toString(const uint8_t tabsNum = 0) const override
+		{
+			const std::string tabs = utils::tabs(tabsNum);
+			const uint32_t xSizeFirstByteIndex = firstByteIndex(), ySizeFirstByteIndex = xSizeFirstByteIndex + sizeof(m_xSize), modeByteIndex = ySizeFirstByteIndex + sizeof(m_ySize);
+			return 
+				tabs + "[0x" + utils::hex(xSizeFirstByteIndex, 4) + " ~ 0x" + utils::hex(ySizeFirstByteIndex - 1, 4) + "] xSize = " + std::to_string(m_xSize) + "\n" + 
+				tabs + "[0x" + utils::hex(ySizeFirstByteIndex, 4) + " ~ 0x" + utils::hex(modeByteIndex - 1, 4) + "] ySize = " + std::to_string(m_ySize) + "\n" + 
+				tabs + "[0x" + utils::hex(modeByteIndex, 4) + "] mode = 0x" + utils::hex(m_mode, 2) + " = " + exr2::consta::levelModeName(levelMode()) + ", " + exr2::consta::roundingModeName(roundingMode());
+		}
+
+		private:
+		uint32_t m_xSize = 0;
+		uint32_t m_ySize = 0;
+		uint8_t m_mode = 0;		// size in bytes must equal to exr::consta::TypeValueSizeBytes::s_tiledesc
+	};
+
+	/// <summary>
+	///		Implements OpenEXR type interface to operate with data of "int" (32-bit signed) OpenEXR type + 
+	///		method value() specifically for comfortable work with data of this type.
+	/// </summary>
+	class Int32 : public exrTypeBase
+	{
+		public:
+		/// <summary>
+		///		Constructor creates instance of base class and
+		///			checks the type of stored OpenEXR data to be of same size as its OpenEXR equivalent,
+		///			reads that value from filebytes.
+		/// </summary>
+		/// <param name="filebytes"> - view of bytes (uin8_t / unsigned char) of full input .exr file </param>
+		/// <param name="intFirstByteIndex"> - index of first byte of int value within "filebytes" vector of input .exr file bytes </param>
+		Int32(const ui8view filebytes, const uint32_t intFirstByteIndex)
+			: exrTypeBase(intFirstByteIndex, sizeInBytes())
+		{
+			tryValidateSizeIs(exr::consta::TypeValueSizeBytes::s_int32);
+			m_int32 = int32_t(readUint32(filebytes.data() + intFirstByteIndex));
+		}
+		int32_t value() const { return m_int32; }
+
+		/// <summary> Implements interface: returns string of name of OpenEXR-defined data type stored within this class. </summary>
+		/// <returns> std::string name of OpenEXR-defined type of data stored within this class </returns>
+		std::string type() const override { return exr::consta::Type::s_int32; }
+		/// <summary>
+		///		Implements interface: returns number of bytes that OpenEXR data stored within this class takes, 
+		///		which must be equal to the size (in bytes) of value of corresponding OpenEXR-defined data type 
+		///		this class is implemented to store.
+		/// </summary>
+		/// <returns> uint32_t number of bytes taken by OpenEXR data stored within this class </returns>
+		uint32_t sizeInBytes() const override { return sizeof(m_int32); }
+		/// <summary> Implements interface: returns string containing values stored within class. </summary>
+		/// <returns> std::string text with values stored by class </returns>
+		std::string toString(const uint8_t tabsNum = 0) const override
+		{
+			return utils::tabs(tabsNum) + std::to_string(m_int32);
+		}
+
+		private:
+		int32_t m_int32 = 0;
+	};
+
+	/// <summary>
+	///		Implements OpenEXR type interface to operate with data of "string" OpenEXR type + 
+	///		method value() specifically for comfortable work with data of this type.
+	///		String value is not null-terminated, its length is the attribute value size.
+	/// </summary>
+	class String : public exrTypeBase
+	{
+		public:
+		/// <param name="filebytes"> - view of bytes (uin8_t / unsigned char) of full input .exr file </param>
+		/// <param name="stringFirstByteIndex"> - index of first byte of string value within "filebytes" vector of input .exr file bytes </param>
+		/// <param name="stringSizeInBytes"> - attribute value size </param>
+		String(const ui8view filebytes, const uint32_t stringFirstByteIndex, const uint32_t stringSizeInBytes)
+			: exrTypeBase(stringFirstByteIndex, stringSizeInBytes),
+			m_string((const char*)filebytes.data() + stringFirstByteIndex, stringSizeInBytes)
+		{
+		}
+		const std::string& value() const { return m_string; }
+
+		/// <summary> Implements interface: returns string of name of OpenEXR-defined data type stored within this class. </summary>
+		/// <returns> std::string name of OpenEXR-defined type of data stored within this class </returns>
+		std::string type() const override { return exr::consta::Type::s_string; }
+		/// <summary> Implements interface: returns number of bytes that OpenEXR data stored within this class takes. </summary>
+		/// <returns> uint32_t number of bytes taken by OpenEXR data stored within this class </returns>
+		uint32_t sizeInBytes() const override { return uint32_t(m_string.size()); }
+		/// <summary> Implements interface: returns string containing values stored within class. </summary>
+		/// <returns> std::string text with values stored by class </returns>
+		std::string toString(const uint8_t tabsNum = 0) const override
+		{
+			return utils::tabs(tabsNum) + "\'" + m_string + "\'";
+		}
+
+		private:
+		std::string m_string;
+	};
+
 	/// Extend Interface implementations: USER MANUAL - step 1.
 	/// 1. User implements exrValueTypeInterface_v2 storing other data of OpenEXR/custom type, for ex. MyV4F (4-float vector)
 	///		and in constructor implements reading & initializing it from .exr filebytes,
 	///		+ optionally, implements methods for comfortable workfloaw specifically with this data,
 	///		+ implements virtual methods of base class (common for all OpenEXR value data types).
 	
+	/// <summary>
+	///		Location of one attribute within .exr filebytes, as found by HeaderIndex.
+	///		Attribute layout: name + '\0', type + '\0', value size (int32), value (value size bytes).
+	/// </summary>
+	struct AttribEntry
+	{
+		std::string name;
+		std::string type;
+		uint32_t valueSizeBytes = 0;
+		uint32_t name_firstByteIndex = 0;		// = first byte of attribute
+		uint32_t type_firstByteIndex = 0;
+		uint32_t valueSize_firstByteIndex = 0;
+		uint32_t value_firstByteIndex = 0;
+		uint32_t value_lastByteIndex() const { return value_firstByteIndex + valueSizeBytes - 1; }	// = last byte of attribute
+		/// <summary> Get string with attribute byte ranges, name, type and value size (value itself is not interpreted). </summary>
+		std::string toString(const uint8_t tabsNum = 0) const
+		{
+			const std::string tabs = utils::tabs(tabsNum);
+			return 
+				"[0x" + utils::hex(name_firstByteIndex, 4) + " ~ 0x" + utils::hex(value_lastByteIndex(), 4) + "] attribute:\n" 
+				+ tabs + "\t [0x" + utils::hex(name_firstByteIndex, 4) + " ~ 0x" + utils::hex(type_firstByteIndex - 1, 4) + "] name = \'" + name + "\' + \'\\0\' \n"
+				+ tabs + "\t [0x" + utils::hex(type_firstByteIndex, 4) + " ~ 0x" + utils::hex(valueSize_firstByteIndex - 1, 4) + "] type = \'" + type + "\' + \'\\0\' \n"
+				+ tabs + "\t [0x" + utils::hex(valueSize_firstByteIndex, 4) + " ~ 0x" + utils::hex(value_firstByteIndex - 1, 4) + "] value size = 0x" + utils::hex(valueSizeBytes) + " = " + std::to_string(valueSizeBytes) + " bytes \n" 
+				+ tabs + "\t [0x" + utils::hex(value_firstByteIndex, 4) + " ~ 0x" + utils::hex(value_lastByteIndex(), 4) + "] value: (not analysed)";
+		}
+	};
+
+	/// <summary>
+	///		Index of header attributes.
+	///		Walks the header attribute list once, from its first byte to the null byte ending the header,
+	///		and maps each attribute name to its type, value size and byte indexes within filebytes.
+	///		Attribute lookup is O(1) and never matches a name inside pixel data or inside another attribute value.
+	/// </summary>
+	class HeaderIndex
+	{
+		public:
+		/// <summary>
+		///		Tokenize the header attribute list.
+		/// </summary>
+		/// <param name="filebytes"> - view of bytes (uin8_t / unsigned char) of full input .exr file (must outlive this object) </param>
+		/// <param name="headerFirstByteIndex"> - index of first byte of first attribute name (8 for single-part file: right after magic number and version field) </param>
+		/// <param name="versionFieldBit10"> - bit 10 of Version Field of input .exr file </param>
+		HeaderIndex(const ui8view filebytes, const uint32_t headerFirstByteIndex, const bool versionFieldBit10)
+			: m_filebytes(filebytes), m_versionFieldBit10(versionFieldBit10), m_firstByteIndex(headerFirstByteIndex)
+		{
+			uint32_t currentByteIndex = headerFirstByteIndex;
+			while (true)
+			{
+				if (filebytes.size() <= currentByteIndex)
+				{
+					throw std::runtime_error("0x00 byte ending the header section is not found before the end of file. File is truncated or is not a valid .exr file.");
+				}
+				if (filebytes[currentByteIndex] == 0x00)
+				{
+					break;		// end of header
+				}
+				AttribEntry entry;
+				entry.name_firstByteIndex = currentByteIndex;
+				entry.name = exrTypes::readCString(filebytes, entry.name_firstByteIndex);
+				exrTypes::isValidExrAttributeNameLength(entry.name, versionFieldBit10);
+				entry.type_firstByteIndex = entry.name_firstByteIndex + entry.name.length() + 1;	// +1 considers '\0'
+				entry.type = exrTypes::readCString(filebytes, entry.type_firstByteIndex);
+				entry.valueSize_firstByteIndex = entry.type_firstByteIndex + entry.type.length() + 1;
+				entry.value_firstByteIndex = entry.valueSize_firstByteIndex + 4;	// int32_t is 4 bytes
+				if (filebytes.size() < entry.value_firstByteIndex)
+				{
+					throw std::runtime_error("attribute \'" + entry.name + "\' value size is out of file bytes range. File is truncated or is not a valid .exr file.");
+				}
+				entry.valueSizeBytes = exrTypes::readUint32(filebytes.data() + entry.valueSize_firstByteIndex);
+				if (filebytes.size() - entry.value_firstByteIndex < entry.valueSizeBytes)
+				{
+					throw std::runtime_error("attribute \'" + entry.name + "\' value (" + std::to_string(entry.valueSizeBytes) + " bytes) is out of file bytes range. File is truncated or is not a valid .exr file.");
+				}
+				if (not m_indexByName.emplace(entry.name, uint32_t(m_entries.size())).second)
+				{
+					throw std::runtime_error("attribute \'" + entry.name + "\' is found more than once in the header.");
+				}
+				currentByteIndex = entry.value_firstByteIndex + entry.valueSizeBytes;
+				m_entries.push_back(entry);
+			}
+			m_lastByteIndex = currentByteIndex;
+		}
+
+		/// <returns> pointer to attribute entry with (attribName) name, or nullptr if header has no such attribute </returns>
+		const AttribEntry* find(const std::string& attribName) const
+		{
+			const auto found = m_indexByName.find(attribName);
+			return (found == m_indexByName.end()) ? nullptr : &m_entries[found->second];
+		}
+		bool contains(const std::string& attribName) const { return find(attribName) != nullptr; }
+		/// <returns> attribute entry with (attribName) name, throws if header has no such attribute </returns>
+		const AttribEntry& at(const std::string& attribName) const
+		{
+			const AttribEntry* entry = find(attribName);
+			if (entry == nullptr)
+			{
+				throw std::runtime_error("attribute \'" + attribName + "\' not found in header");
+			}
+			return *entry;
+		}
+		/// <returns> all header attributes, ordered as in .exr file </returns>
+		const std::vector<AttribEntry>& entries() const { return m_entries; }
+		ui8view filebytes() const { return m_filebytes; }
+		bool versionFieldBit10() const { return m_versionFieldBit10; }
+		uint32_t firstByteIndex() const { return m_firstByteIndex; }
+		/// <returns> index of the 0x00 byte ending the header </returns>
+		uint32_t lastByteIndex() const { return m_lastByteIndex; }
+
+		private:
+		ui8view m_filebytes;
+		bool m_versionFieldBit10 = false;
+		uint32_t m_firstByteIndex = 0, m_lastByteIndex = 0;
+		std::vector<AttribEntry> m_entries;
+		std::unordered_map<std::string, uint32_t> m_indexByName;	// attribute name -> index in m_entries
+	};
+
 	/// <summary>
 	///		Class that stores data and provides methods specific to all and each OpenEXR attribute
 	///		(see source document at: https://openexr.com/en/latest/OpenEXRFileLayout.html#attribute-layout)
@@ -814,47 +1154,32 @@ namespace exrTypes
 		protected:
 		/// <summary>
 		///		Constructor initializes standard data members for OpenEXR attribute: name, value type, value size in bytes.
-		///		It does analysis of filebytes, searching for the specified attribute name, and if found, checks that name,
+		///		It looks up the specified attribute name in the header index, and if found,
 		///			saves the attribute value type (std::string of name of type) and number of bytes the value takes in .exr file and in filebytes byte vector.
 		///		The value itself is expected to be specified in the derived class.
 		///		Constructor is protected to prohibit creating an instance of this class by user.
 		/// </summary>
-		/// <param name="attribNameToAnalyse"> - name of the attribute to search for ana analyse </param>
-		/// <param name="filebytes"> - vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
-		/// <param name="versionFieldBit10"> - bit 10 of Version Field of input .exr file </param>
-		AttribBase(const std::string& attribNameToAnalyse, const std::vector<ui8>& filebytes, const bool versionFieldBit10)
-		{
-			// from filebytes, unpack common attrib parts: name, value type, value size in bytes
-			// read nameToAnalyse
-			m_name = attribNameToAnalyse;
-			std::vector<ui8> nameVec(m_name.cbegin(), m_name.cend());
-			std::vector<ui8>::const_iterator attribNameBegin = std::search(filebytes.cbegin(), filebytes.cend(), nameVec.cbegin(), nameVec.cend());
-			if (attribNameBegin == filebytes.cend())
-			{
-				throw std::runtime_error("attribute (attribute name) not found");
-			}
-			m_name_firstByteIndex = std::distance(filebytes.cbegin(), attribNameBegin);
+		/// <param name="attribNameToAnalyse"> - name of the attribute to look up in the header index and analyse </param>
+		/// <param name="header"> - index of header attributes of input .exr file </param>
+		AttribBase(const std::string& attribNameToAnalyse, const HeaderIndex& header)
+		{
+			// common attrib parts (name, value type, value size in bytes) are already located by the header index
+			const AttribEntry& entry = header.at(attribNameToAnalyse);
+			m_name = entry.name;
+			m_name_firstByteIndex = entry.name_firstByteIndex;
 			m_attrib_firstByteIndex = m_name_firstByteIndex;
-			// analyse attribute name found
-			// attribute name already saved (before looking for it in filebytes), checking the final '\0' left.
-			uint32_t attribNameLen = m_name.length();
-			exrTypes::isValidExrAttributeNameLength(m_name, versionFieldBit10);
-			if (filebytes[m_name_firstByteIndex + attribNameLen] != '\0')	// if attribNameString is not null-terminated
-			{
-				throw std::runtime_error("attribute name string is not null-terminated. Unable to continue analysis.");
-			}
-			m_name_lastByteIndex = m_name_firstByteIndex + attribNameLen;	// already considers '\0'
-			// read attribute type string
-			m_type_firstByteIndex = m_name_lastByteIndex + 1; // +1 considers '\0'
-			m_type = exrTypes::readCString(filebytes.cbegin()+m_type_firstByteIndex, filebytes.cend());
+			m_name_lastByteIndex = m_name_firstByteIndex + m_name.length();	// already considers '\0'
+			// attribute type string
+			m_type = entry.type;
+			m_type_firstByteIndex = entry.type_firstByteIndex;
 			m_type_lastByteIndex = m_type_firstByteIndex + m_type.length();
-			// read attribute value size (in bytes)
-			m_valueSize_firstByteIndex = m_type_lastByteIndex + 1;
+			// attribute value size (in bytes)
+			m_valueSize_firstByteIndex = entry.valueSize_firstByteIndex;
 			m_valueSize_lastByteIndex = m_valueSize_firstByteIndex + 3; // int32_t is 4 bytes => offset= 3
-			m_valueSizeBytes = exrTypes::readUint32((filebytes.cbegin()+m_valueSize_firstByteIndex)._Ptr);
+			m_valueSizeBytes = entry.valueSizeBytes;
 			// define value byte index area
-			m_value_firstByteIndex = m_valueSize_lastByteIndex + 1;
-			m_value_lastByteIndex = m_value_firstByteIndex + m_valueSizeBytes-1;
+			m_value_firstByteIndex = entry.value_firstByteIndex;
+			m_value_lastByteIndex = entry.value_lastByteIndex();
 			m_attrib_lastByteIndex = m_value_lastByteIndex;	// not true for chlist, because it ends with 0x00 terminator (+1 byte)
 		}
 		/// <summary>
@@ -894,25 +1219,36 @@ namespace exrTypes
 		///		analyse input .exr filebytes and initialize the attribute value of implemented type,
 		///		and check the type of attribute found in .exr filebytes is the same as the required value type of this attribute.
 		/// </summary>
-		/// <param name="attribName"> - name of the attribute to search for ana analyse </param>
-		/// <param name="filebytes"> - vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
-		/// <param name="versionFieldBit10"> - bit 10 of Version Field of input .exr file </param>
-		AttribChlist(const std::string& attribName, const std::vector<ui8>& filebytes, const bool versionFieldBit10)
+		/// <param name="attribName"> - name of the attribute to look up in the header index and analyse </param>
+		/// <param name="header"> - index of header attributes of input .exr file (also provides filebytes and Version Field bit 10) </param>
+		AttribChlist(const std::string& attribName, const HeaderIndex& header)
 			: 
-			AttribBase(attribName, filebytes, versionFieldBit10),
+			AttribBase(attribName, header),
 			// set attrib value from filebytes using attribValue_FirstByteIndex from base class, set base.attribValue_LastByteIndex
-			m_chlist(Chlist(filebytes, value_firstByteIndex(), versionFieldBit10))
+			m_chlist(Chlist(header.filebytes(), value_firstByteIndex(), header.versionFieldBit10()))
 		{
 			tryValidateTypeIs(exr::consta::Type::s_chlist);
 		}
 		
-		std::string channelName(const uint32_t const channelIndex)
+		std::string channelName(const uint32_t channelIndex) const
 		{
 			m_chlist.tryValidateChannelIndex(channelIndex);
 			return m_chlist.channelName(channelIndex);
 		}
 		
 		std::vector<std::string> channelsNames() const { return m_chlist.channelsNames(); }
+
+		std::vector<uint32_t> channelDataTypes() const { return m_chlist.channelDataTypes(); }
+
+		int32_t channelXSampling(const uint32_t channelIndex) const { return m_chlist.channelXSampling(channelIndex); }
+
+		int32_t channelYSampling(const uint32_t channelIndex) const { return m_chlist.channelYSampling(channelIndex); }
+
+		bool isAnyChannelSubsampled() const { return m_chlist.isAnyChannelSubsampled(); }
+
+		bool isAnyHalfChannelPerceptuallyLinear() const { return m_chlist.isAnyHalfChannelPerceptuallyLinear(); }
+
+		bool isAnyChannelPerceptuallyLinear() const { return m_chlist.isAnyChannelPerceptuallyLinear(); }
 		
 		uint32_t channelsNum() const { return m_chlist.channelsNum(); }
 
@@ -959,14 +1295,13 @@ namespace exrTypes
 		///		analyse input .exr filebytes and initialize the attribute value of implemented type,
 		///		and check the type of attribute found in .exr filebytes is the same as the required value type of this attribute.
 		/// </summary>
-		/// <param name="attribName"> - name of the attribute to search for ana analyse </param>
-		/// <param name="filebytes"> - vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
-		/// <param name="versionFieldBit10"> - bit 10 of Version Field of input .exr file </param>
-		AttribCompression(const std::string& attribName, const std::vector<ui8>& filebytes, const bool versionFieldBit10)
+		/// <param name="attribName"> - name of the attribute to look up in the header index and analyse </param>
+		/// <param name="header"> - index of header attributes of input .exr file (also provides filebytes and Version Field bit 10) </param>
+		AttribCompression(const std::string& attribName, const HeaderIndex& header)
 			: 
-			AttribBase(attribName, filebytes, versionFieldBit10),
+			AttribBase(attribName, header),
 			// set attrib value from filebytes using attribValue_FirstByteIndex from base class, set base.attribValue_LastByteIndex
-			m_compression(Compression(filebytes, value_firstByteIndex()))
+			m_compression(Compression(header.filebytes(), value_firstByteIndex()))
 		{
 			tryValidateTypeIs(exr::consta::Type::s_compression);
 		}
@@ -1011,14 +1346,13 @@ namespace exrTypes
 		///		analyse input .exr filebytes and initialize the attribute value of implemented type,
 		///		and check the type of attribute found in .exr filebytes is the same as the required value type of this attribute.
 		/// </summary>
-		/// <param name="attribName"> - name of the attribute to search for ana analyse </param>
-		/// <param name="filebytes"> - vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
-		/// <param name="versionFieldBit10"> - bit 10 of Version Field of input .exr file </param>
-		AttribBox2i(const std::string& attribName, const std::vector<ui8>& filebytes, const bool versionFieldBit10)
+		/// <param name="attribName"> - name of the attribute to look up in the header index and analyse </param>
+		/// <param name="header"> - index of header attributes of input .exr file (also provides filebytes and Version Field bit 10) </param>
+		AttribBox2i(const std::string& attribName, const HeaderIndex& header)
 			: 
-			AttribBase(attribName, filebytes, versionFieldBit10),
+			AttribBase(attribName, header),
 			// set attrib value from filebytes using attribValue_FirstByteIndex from base class, set base.attribValue_LastByteIndex
-			m_box2i(Box2i(filebytes, value_firstByteIndex()))
+			m_box2i(Box2i(header.filebytes(), value_firstByteIndex()))
 		{
 			tryValidateTypeIs(exr::consta::Type::s_box2i);
 		}
@@ -1053,13 +1387,12 @@ namespace exrTypes
 		///		analyse input .exr filebytes and initialize the attribute value of implemented type,
 		///		and check the type of attribute found in .exr filebytes is the same as the required value type of this attribute.
 		/// </summary>
-		/// <param name="attribName"> - name of the attribute to search for ana analyse </param>
-		/// <param name="filebytes"> - vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
-		/// <param name="versionFieldBit10"> - bit 10 of Version Field of input .exr file </param>
-		AttribLineorder(const std::string& attribName, const std::vector<ui8>& filebytes, const bool versionFieldBit10)
+		/// <param name="attribName"> - name of the attribute to look up in the header index and analyse </param>
+		/// <param name="header"> - index of header attributes of input .exr file (also provides filebytes and Version Field bit 10) </param>
+		AttribLineorder(const std::string& attribName, const HeaderIndex& header)
 			: 
-			AttribBase(attribName, filebytes, versionFieldBit10),
-			m_lineOrder(LineOrder(filebytes, value_firstByteIndex()))
+			AttribBase(attribName, header),
+			m_lineOrder(LineOrder(header.filebytes(), value_firstByteIndex()))
 		{
 			tryValidateTypeIs(exr::consta::Type::s_lineOrder);
 		}
@@ -1095,13 +1428,12 @@ namespace exrTypes
 		///		analyse input .exr filebytes and initialize the attribute value of implemented type,
 		///		and check the type of attribute found in .exr filebytes is the same as the required value type of this attribute.
 		/// </summary>
-		/// <param name="attribName"> - name of the attribute to search for ana analyse </param>
-		/// <param name="filebytes"> - vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
-		/// <param name="versionFieldBit10"> - bit 10 of Version Field of input .exr file </param>
-		AttribFloat32(const std::string& attribName, const std::vector<ui8>& filebytes, const bool versionFieldBit10)
+		/// <param name="attribName"> - name of the attribute to look up in the header index and analyse </param>
+		/// <param name="header"> - index of header attributes of input .exr file (also provides filebytes and Version Field bit 10) </param>
+		AttribFloat32(const std::string& attribName, const HeaderIndex& header)
 			: 
-			AttribBase(attribName, filebytes, versionFieldBit10),
-			m_float32(Float32(filebytes, value_firstByteIndex()))
+			AttribBase(attribName, header),
+			m_float32(Float32(header.filebytes(), value_firstByteIndex()))
 		{
 			tryValidateTypeIs(exr::consta::Type::s_float32);
 		}
@@ -1137,13 +1469,12 @@ namespace exrTypes
 		///		analyse input .exr filebytes and initialize the attribute value of implemented type,
 		///		and check the type of attribute found in .exr filebytes is the same as the required value type of this attribute.
 		/// </summary>
-		/// <param name="attribName"> - name of the attribute to search for ana analyse </param>
-		/// <param name="filebytes"> - vector of bytes (uin8_t / unsigned char) of full input .exr file </param>
-		/// <param name="versionFieldBit10"> - bit 10 of Version Field of input .exr file </param>
-		AttribV2f(const std::string& attribName, const std::vector<ui8>& filebytes, const bool versionFieldBit10)
+		/// <param name="attribName"> - name of the attribute to look up in the header index and analyse </param>
+		/// <param name="header"> - index of header attributes of input .exr file (also provides filebytes and Version Field bit 10) </param>
+		AttribV2f(const std::string& attribName, const HeaderIndex& header)
 			: 
-			AttribBase(attribName, filebytes, versionFieldBit10),
-			m_v2f(V2f(filebytes, value_firstByteIndex()))
+			AttribBase(attribName, header),
+			m_v2f(V2f(header.filebytes(), value_firstByteIndex()))
 		{
 			tryValidateTypeIs(exr::consta::Type::s_v2f);
 		}
@@ -1163,6 +1494,129 @@ namespace exrTypes
 		V2f m_v2f;
 	};
 
+	/// <summary>
+	///		Provides methods and stores data for comfortable workflow with OpenEXR .exr file attribute.
+	///		Inherits methods and data from interface that are common for attributes no matter their value type
+	///		+ implements those inherited methods that need implementation.
+	/// </summary>
+	class AttribTiledesc : public AttribBase
+	{
+		public:
+		/// <summary>
+		///		Initialize each attribute common data members by calling base class constructor,
+		///		analyse input .exr filebytes and initialize the attribute value of implemented type,
+		///		and check the type of attribute found in .exr filebytes is the same as the required value type of this attribute.
+		/// </summary>
+		/// <param name="attribName"> - name of the attribute to look up in the header index and analyse </param>
+		/// <param name="header"> - index of header attributes of input .exr file (also provides filebytes and Version Field bit 10) </param>
+		AttribTiledesc(const std::string& attribName, const HeaderIndex& header)
+			: 
+			AttribBase(attribName, header),
+			m_tileDesc(TileDesc(header.filebytes(), value_firstByteIndex()))
+		{
+			tryValidateTypeIs(exr::consta::Type::s_tiledesc);
+		}
+
+		TileDesc value() const { return m_tileDesc; }
+
+		/// <summary>
+		///		Warning: 
+		///		this does not override the toString() method from the base class, instead this method calls it specifying
+		///		the value to fetch data from to return the whole string containing data from both, base class and this derived class.
+		/// </summary>
+		/// <param name="tabsNum"> - the indent of each line inside the result string, use to indent the result </param>
+		/// <returns> std::string text containing data names and their values of OpenEXR attribute stored </returns>
+		std::string toString(const uint8_t tabsNum = 0) const
+		{
+			return AttribBase::toString(tabsNum, &m_tileDesc);
+		}
+
+		private:
+		TileDesc m_tileDesc;
+	};
+
+	/// <summary>
+	///		Provides methods and stores data for comfortable workflow with OpenEXR .exr file attribute.
+	///		Inherits methods and data from interface that are common for attributes no matter their value type
+	///		+ implements those inherited methods that need implementation.
+	/// </summary>
+	class AttribInt32 : public AttribBase
+	{
+		public:
+		/// <summary>
+		///		Initialize each attribute common data members by calling base class constructor,
+		///		analyse input .exr filebytes and initialize the attribute value of implemented type,
+		///		and check the type of attribute found in .exr filebytes is the same as the required value type of this attribute.
+		/// </summary>
+		/// <param name="attribName"> - name of the attribute to look up in the header index and analyse </param>
+		/// <param name="header"> - index of header attributes of input .exr file (also provides filebytes and Version Field bit 10) </param>
+		AttribInt32(const std::string& attribName, const HeaderIndex& header)
+			: 
+			AttribBase(attribName, header),
+			m_int32(Int32(header.filebytes(), value_firstByteIndex()))
+		{
+			tryValidateTypeIs(exr::consta::Type::s_int32);
+		}
+
+		int32_t value() const { return m_int32.value(); }
+
+		/// <summary>
+		///		Warning: 
+		///		this does not override the toString() method from the base class, instead this method calls it specifying
+		///		the value to fetch data from to return the whole string containing data from both, base class and this derived class.
+		/// </summary>
+		/// <param name="tabsNum"> - the indent of each line inside the result string, use to indent the result </param>
+		/// <returns> std::string text containing data names and their values of OpenEXR attribute stored </returns>
+		std::string toString(const uint8_t tabsNum = 0) const
+		{
+			return AttribBase::toString(tabsNum, &m_int32);
+		}
+
+		private:
+		Int32 m_int32;
+	};
+
+	/// <summary>
+	///		Provides methods and stores data for comfortable workflow with OpenEXR .exr file attribute.
+	///		Inherits methods and data from interface that are common for attributes no matter their value type
+	///		+ implements those inherited methods that need implementation.
+	/// </summary>
+	class AttribString : public AttribBase
+	{
+		public:
+		/// <summary>
+		///		Initialize each attribute common data members by calling base class constructor,
+		///		analyse input .exr filebytes and initialize the attribute value of implemented type,
+		///		and check the type of attribute found in .exr filebytes is the same as the required value type of this attribute.
+		/// </summary>
+		/// <param name="attribName"> - name of the attribute to look up in the header index and analyse </param>
+		/// <param name="header"> - index of header attributes of input .exr file (also provides filebytes and Version Field bit 10) </param>
+		AttribString(const std::string& attribName, const HeaderIndex& header)
+			: 
+			AttribBase(attribName, header),
+			m_string(String(header.filebytes(), value_firstByteIndex(), value_sizeInBytes()))
+		{
+			tryValidateTypeIs(exr::consta::Type::s_string);
+		}
+
+		const std::string& value() const { return m_string.value(); }
+
+		/// <summary>
+		///		Warning: 
+		///		this does not override the toString() method from the base class, instead this method calls it specifying
+		///		the value to fetch data from to return the whole string containing data from both, base class and this derived class.
+		/// </summary>
+		/// <param name="tabsNum"> - the indent of each line inside the result string, use to indent the result </param>
+		/// <returns> std::string text containing data names and their values of OpenEXR attribute stored </returns>
+		std::string toString(const uint8_t tabsNum = 0) const
+		{
+			return AttribBase::toString(tabsNum, &m_string);
+		}
+
+		private:
+		String m_string;
+	};
+
 	/// Extend Interface implementations: USER MANUAL - steps 2, 3.
 	/// 2. User implements AttribInterface_v2 storing the attribute value object of previously implemented class (MyV4F), 
 	///		and in constructor, initialize the base class, initialize the attribute value object (for ex., by creating your data type object, u_value(MyV4F(...input-params...)) )
@@ -1171,7 +1625,7 @@ namespace exrTypes
 	///		1| main()
 	///		2| {
 	///		3|		exrfile = exrRead("myfile.exr");
-	///		4|		exrTypes::AttribMyV4F myV4f = exrTypes::AttribMyV4F("myV4f", exrfile.filebytes, exrfile.versionfield.bit10);
+	///		4|		exrTypes::AttribMyV4F myV4f = exrTypes::AttribMyV4F("myV4f", exrfile.headerIndex);
 	///		5|		printf("%s \n", myV4f.toString().c_str());
 	///		6|		return 0;
 	///		7| }
@@ -1192,52 +1646,69 @@ namespace exrTypes
 
 		public:
 		/// <summary>
-		/// 
-		/// </summary>
-		/// <param name="filebytes"></param>
-		/// <param name="offsetTableFirstByteIndex"></param>
-		/// <param name="dataWindowYMax"></param>
-		/// <param name="versionFieldBit12_isMultipart"></param>
-		/// <param name="doesExrHas_chunkCount_Attribute"></param>
-		OffsetTable(const std::vector<ui8>& filebytes, const uint32_t offsetTableFirstByteIndex, const uint32_t dataWindowYMax, const bool versionFieldBit12_isMultipart = 0, const bool doesExrHas_chunkCount_Attribute = 0)
-		{
-			/// ReadMe!
-			// I didnt find explanation on how to calculate number or size of offsetTable 
-			// (what does it mean "computed based on dataWindow, tileDesc and compression"? - see OpenEXR document)
-			// so, I'm just trying & guessing the number of offsetTable entries.
-			// Nevertheless, OpenEXR documentation at "document tag [EXR-SCANLINES-01]" kinda gives a hint that (offsetTableLen = exrImage.rows).
-			// To set (offsetTableLen = exrImage.rows), you can use dataWindow attribute -> yMax value like this: offsetTableLen = dataWindow.yMax()+1;
-			/// For now, (offsetTableLen) equals number of image rows.
-			/// This works for "Regular scan line image block layout" + NO_COMPRESSION, but may be not fully correct calculation
-			const uint32_t offsetTableLen = dataWindowYMax+1;	// dataWindowYMax+1 = number of rows of exr image
-
-			// not yet implemented ------ v v v
-			if (!versionFieldBit12_isMultipart)
+		///		Number of offset table entries (= number of chunks) of scanline image: rows [yMin; yMax] of (dataWindow),
+		///		grouped into chunks of (scanlinesPerChunk) rows, starting from yMin (last chunk may have fewer rows).
+		///		Tiled image has one entry per tile of each level instead (see exrPixeldata::TileGrid).
+		///		Multi-part and deep files also store number of entries in chunkCount attribute, it must be the same.
+		/// </summary>
+		/// <param name="scanlinesPerChunk"> - number of scanlines in one chunk, depends on compression (see exr2::consta::scanlinesPerChunk) </param>
+		static uint32_t scanlineChunksNum(const Box2i& dataWindow, const uint32_t scanlinesPerChunk)
+		{
+			if (dataWindow.yMax() < dataWindow.yMin() or dataWindow.xMax() < dataWindow.xMin())
 			{
-				// if chunkCount is not present => number of entries = compute(dataWindow, tileDesc, compression);
-				if (!doesExrHas_chunkCount_Attribute)
-				{
-					// offsetTableLen = 
-				}
+				throw std::runtime_error("dataWindow [" + std::to_string(dataWindow.xMin()) + ", " + std::to_string(dataWindow.yMin()) + "] ~ [" + std::to_string(dataWindow.xMax()) + ", " + std::to_string(dataWindow.yMax()) + "] is empty.");
 			}
-			else
+			const uint64_t rowsNum = uint64_t(int64_t(dataWindow.yMax()) - dataWindow.yMin() + 1);
+			return uint32_t((rowsNum + scanlinesPerChunk - 1) / scanlinesPerChunk);
+		}
+		/// <summary>
+		///		Read offset table of known number of entries: scanlineChunksNum() of scanline image, one entry per tile of each level of tiled image.
+		/// </summary>
+		/// <param name="offsetTableLen"> - number of offset table entries (= number of chunks of the image) </param>
+		/// <param name="fileSizeInBytes"> - size of file, offsets point into; 0 = size of (filebytes). Streaming analysis gives only first bytes of file (headers and offset tables) as (filebytes). </param>
+		OffsetTable(const ui8view filebytes, const uint64_t offsetTableFirstByteIndex, const uint32_t offsetTableLen, const uint64_t fileSizeInBytes = 0)
+		{
+			const uint64_t filesize = (fileSizeInBytes == 0) ? filebytes.size() : fileSizeInBytes;
+			if (offsetTableLen == 0 or (filebytes.size() - std::min<uint64_t>(filebytes.size(), offsetTableFirstByteIndex)) / OffsetTable::offsetValueSizeInBytes < offsetTableLen)
 			{
-				// header must contain a chunkCount attribute, which indicates the size of the table and the number of chunks.
+				throw std::runtime_error("offset table of " + std::to_string(offsetTableLen) + " entries at 0x" + utils::hex64(offsetTableFirstByteIndex) + " is out of file bytes range. File is truncated or is not a valid .exr file.");
 			}
-
 			// read and save offset table
-			for (uint32_t i = offsetTableFirstByteIndex, offsetIndex = 0; offsetIndex < offsetTableLen; i += sizeof(uint64_t), offsetIndex++)
+			m_offsetTable.reserve(offsetTableLen);
+			for (uint32_t offsetIndex = 0; offsetIndex < offsetTableLen; offsetIndex++)
 			{
+				const uint64_t i = offsetTableFirstByteIndex + uint64_t(offsetIndex) * sizeof(uint64_t);
 				uint64_t offset = exrTypes::readUint64(filebytes.data()+i);
-				if(offset < 0 or filebytes.size()-1 < offset)	// if offset is out of valid range [0; filebytes.size-1]
+				if(filesize <= offset)	// if offset is out of valid range [0; filesize-1]
 				{
-					throw std::logic_error("Invalid (offset) value received: (offset=" + std::to_string(offset) + ") is out of valid range [0; filebytes.size()-1]");
+					throw std::logic_error("Invalid (offset) value received: (offset=" + std::to_string(offset) + ") is out of valid range [0; filesize-1]");
 				}
 				m_offsetTable.push_back(utils::IndexedValue(i, i+OffsetTable::offsetValueSizeInBytes-1, offset));
 			}
 		}
 		uint32_t length() const { return m_offsetTable.size(); }
-		uint32_t lastByteIndex() const { return m_offsetTable[length()-1].lastByteIndex(); }	// last byte of last offset in the table
+		/// <returns> offset (index of first byte of chunk within filebytes) stored by (tableEntryIndex) entry of the table </returns>
+		uint64_t offset(const uint32_t tableEntryIndex) const
+		{
+			if (length()-1 < tableEntryIndex)
+			{
+				throw std::invalid_argument("(tableEntryIndex) is out of valid range [0; tableEntryLength - 1]");
+			}
+			return m_offsetTable[tableEntryIndex].value();
+		}
+		/// <returns> all offsets of the table, ordered as in .exr file </returns>
+		std::vector<uint64_t> offsets() const
+		{
+			std::vector<uint64_t> result;
+			result.reserve(length());
+			for (const utils::IndexedValue<uint64_t>& entry : m_offsetTable)
+			{
+				result.push_back(entry.value());
+			}
+			return result;
+		}
+		uint64_t firstByteIndex() const { return m_offsetTable[0].firstByteIndex(); }		// first byte of first offset in the table
+		uint64_t lastByteIndex() const { return m_offsetTable[length()-1].lastByteIndex(); }	// last byte of last offset in the table
 		std::string toString(const uint32_t tableEntryIndex) const 
 		{
 			if (length()-1 < tableEntryIndex)
@@ -1248,7 +1719,7 @@ namespace exrTypes
 			utils::IndexedValue entry = m_offsetTable[tableEntryIndex];
 			return 
 				"i= " + std::to_string(tableEntryIndex) + 
-				": [0x" + utils::hex(entry.firstByteIndex(),4) + " ~ 0x" + utils::hex(entry.lastByteIndex(),4) + 
+				": [0x" + utils::hex64(entry.firstByteIndex(),4) + " ~ 0x" + utils::hex64(entry.lastByteIndex(),4) + 
 				"] offset= " + std::to_string(entry.value()) + " = 0x" + utils::hex64(entry.value());
 		}
 		std::string toStringAllEntries(const uint8_t tabsNum = 0, const std::string delim = "\n") const
@@ -1,13 +1,23 @@
 #pragma once
 
+#include <algorithm>
+#include <filesystem>
 #include <memory>
 #include <string>
 #include <vector>
+#include "exrData/ChunkStats.h"
+#include "exrData/Compression.h"
 #include "exrData/exrConsta.h"
 #include "exrData/exrTypes.h"
+#include "exrData/DeepPixeldata.h"
 #include "exrData/MagicNumber.h"
 #include "exrData/Pixeldata.h"
+#include "exrData/ScanlineWriter.h"
+#include "exrData/TiledPixeldata.h"
 #include "exrData/VersionField.h"
+#include "FileBytes.h"
+#include "JsonWriter.h"
+#include "ThreadPool.h"
 #include "types.h"
 
 std::string exrToUserChannelDataTypeName(const std::string exrStandardChannelDataTypeName)
@@ -22,16 +32,46 @@ class exrFileData
 {
 	public:
 
-	exrFileData(std::vector<ui8>& filebytes) 
+	exrFileData(const ui8view filebytes) 
 		: m_filebytes(filebytes)
 	{
 	}
 
+	/// <summary>
+	///		Decode pixel data lazily: scanline is decoded on first access to its pixels and kept in cache
+	///		of (cacheScanlinesNum) most recently used scanlines. Byte-by-byte pixel data printout is skipped in this mode.
+	///		Tiled images are always decoded on access; cache then keeps tiles covering (cacheScanlinesNum) rows of tiles.
+	/// </summary>
+	/// <param name="cacheScanlinesNum"> - max number of decoded scanlines kept in memory, 0 = decode all scanlines on load (default) </param>
+	void setLazyPixelDecoding(const uint32_t cacheScanlinesNum) { m_lazyCacheScanlinesNum = cacheScanlinesNum; }
+	/// <summary>
+	///		Set number of threads decoding pixel data, calling thread included (scanlines are decoded concurrently, output does not change).
+	/// </summary>
+	/// <param name="workersNum"> - 1 = decode on calling thread only (default), 0 = one thread per hardware thread </param>
+	void setDecodingWorkersNum(const uint32_t workersNum) { m_decodingWorkersNum = workersNum; }
+	/// <summary>
+	///		Decode and print pixels of (rows) x (columns) region only (both ranges inclusive, clamped to the image).
+	///		Pixel data is then decoded lazily (unless setLazyPixelDecoding() is set), so scanlines out of (rows) are not decoded.
+	/// </summary>
+	void setPixelRegion(const utils::Range<uint32_t>& rows, const utils::Range<uint32_t>& columns)
+	{
+		m_hasPixelRegion = true;
+		m_regionRows = rows;
+		m_regionCols = columns;
+	}
+	/// <summary>
+	///		Cross-check offset tables against chunks they point at, after pixel data is read: offsets of scanline (and deep scanline)
+	///		chunks follow lineOrder (increasing for INCREASING_Y, decreasing for DECREASING_Y, any order for RANDOM_Y),
+	///		chunks of all parts do not overlap and, together, exactly cover the file from the end of the last offset table to its last byte.
+	///		Detailed analysis prints the problems found, brief analysis fails on the first one.
+	/// </summary>
+	void setOffsetTableCrossCheck(const bool isEnabled) { m_isOffsetTableCrossCheck = isEnabled; }
+
 	/// <summary>
 	///		Read file byte-by-byte, verify its a valid .exr file and, if so, analyse it
 	///		and print the analysis results to the console.
 	/// </summary>
-	/// <param name="filename"> Vector of bytes retrieved from file </param>
+	/// <param name="filebytes"> View of bytes retrieved from file (must stay valid while this object is used) </param>
 	/// <returns> void </returns>
 	void exrAnalysisDetailed()
 	{
@@ -57,10 +97,16 @@ class exrFileData
 
 		/// OpenEXR header attributes
 		printf("-------- Header Attributes -------- \n");
-		// .exr header required (standard)
-		saveAndPrintExrHeaderRequiredAttribs();
-		// .exr header custom (optional) attributes
-		saveAndPrintExrHeaderCustomAttribs();
+		if (m_vf->bit12_IsMultipart())
+		{
+			saveAndPrintPartHeaders();
+		}
+		else
+		{
+			// walk the header attribute list once, all attributes are then looked up by name in the index
+			m_header = std::make_unique<exrTypes::HeaderIndex>(m_filebytes, exr2::consta::c_headerFirstByteIndex, m_vf->bit10_HasLongNames());
+			saveAndPrintExrHeaderAttribs();
+		}
 		if (m_filebytes[m_exrHeaderFinalNullIndex] == 0x00)
 		{
 			printf("[0x%s] byte = 0x%2.2X (end of .exr header section) \n\n", utils::hex(m_exrHeaderFinalNullIndex, 4).c_str(), 0x00);
@@ -69,9 +115,14 @@ class exrFileData
 		{
 			throw std::runtime_error("WARNING: 0x00 byte ending the header section with attributes is not found. Further analysis suspended (impossible).");
 		}
+		m_offsetTableFirstByteIndex = m_exrHeaderFinalNullIndex+1;
 
 		saveAndPrintExrPixeldata();
-		if (m_pixelData->lastByteIndex() == m_filebytes.size()-1)
+		if (m_isOffsetTableCrossCheck)
+		{
+			printOffsetTableCrossCheck();
+		}
+		if (pixelDataLastByteIndex() == m_filebytes.size()-1)
 			printf("-------- End of .exr file. --------\n\n");
 		else
 			printf("-------- End of file is not reached. Your file hmay have more than expected. Check file bytes above.\n\n");
@@ -80,9 +131,390 @@ class exrFileData
 
 	}
 
+	/// <summary>
+	///		Verify file is a valid .exr file and decode all its pixel data, without printing anything
+	///		(safe to call concurrently for different exrFileData objects). Throws if file is invalid or not supported.
+	/// </summary>
+	/// <returns> one-line description of the image, e.g. "4 x 4, channels A,B,G,R, ZIP_COMPRESSION, INCREASING_Y" </returns>
+	std::string exrAnalysisBrief()
+	{
+		readMagicNumberAndVersionField();
+		readHeaders();
+		utils::ThreadPool* threadPool = decodingThreadPool();
+		if (isMultipart())
+		{
+			// parts are independent, so they are decoded concurrently (each part also decodes its chunks on the same workers)
+			std::vector<std::string> partsDescriptions(m_parts.size());
+			forEachPart(threadPool, [&](const uint32_t partIndex)
+			{
+				partsDescriptions[partIndex] = "\'" + m_parts[partIndex]->m_partName->value() + "\' " + m_parts[partIndex]->readPixeldataBrief(threadPool);
+			});
+			std::string description = std::to_string(m_parts.size()) + " parts: ";
+			for (uint32_t i = 0; i < partsDescriptions.size(); i++)
+			{
+				description += (i == 0 ? "" : "; ") + partsDescriptions[i];
+			}
+			tryCrossCheckOffsetTables();
+			return description;
+		}
+		const std::string description = readPixeldataBrief(threadPool);
+		tryCrossCheckOffsetTables();
+		return description;
+	}
+	/// <returns> true if pixel data ends at the last byte of file (valid after analysis) </returns>
+	bool isEndOfFileReached() const { return hasPixelData() and pixelDataLastByteIndex() == m_filebytes.size()-1; }
+
+	/// <summary>
+	///		Streaming analysis of file, which does not have to fit into memory: headers and offset tables are read from the first bytes of file,
+	///		then chunks are read in file order, one chunk per thread at a time, each into its own buffer, decoded into per-channel statistics and dropped.
+	///		Progress and invalid chunks are printed as chunks are processed, statistics of each image (part) are printed at the end.
+	///		Memory used by pixel data (chunk bytes and their uncompressed data) is at most (memoryLimitBytes), split evenly between threads:
+	///		chunk larger than that is reported invalid. Statistics do not depend on number of threads.
+	/// </summary>
+	/// <param name="workersNum"> - threads reading and decoding chunks, 1 = calling thread only, 0 = one thread per hardware thread </param>
+	/// <returns> number of invalid chunks </returns>
+	static uint64_t exrAnalysisStream(const std::filesystem::path& filepath, const uint64_t memoryLimitBytes, const uint32_t workersNum)
+	{
+		utils::file::FileReader file(filepath);
+		printf("File size = %llu Bytes = %.6f MB \n", (unsigned long long)file.size(), double(file.size())/1024/1024);
+		std::vector<ui8> firstBytes;
+		const std::unique_ptr<exrFileData> exrFile = readStreamHeaders(file, memoryLimitBytes, firstBytes);
+		const uint64_t offsetTablesLastByteIndex = exrFile->isMultipart() ? exrFile->m_parts.back()->m_offsetTable->lastByteIndex() : exrFile->m_offsetTable->lastByteIndex();
+		printf("Headers and offset tables: bytes [0x0000; 0x%s] \n", utils::hex64(offsetTablesLastByteIndex, 4).c_str());
+
+		// chunks of all images (parts), in file order: file is read front to back
+		std::vector<const exrFileData*> images;
+		if (exrFile->isMultipart())
+		{
+			for (const std::unique_ptr<exrFileData>& part : exrFile->m_parts)
+			{
+				images.push_back(part.get());
+			}
+		}
+		else
+		{
+			images.push_back(exrFile.get());
+		}
+		std::vector<exrPixeldata::ChunkStatsDecoder> decoders;
+		std::vector<exrPixeldata::ImageStats> imagesStats;
+		std::vector<StreamChunk> chunks;
+		for (uint32_t imageIndex = 0; imageIndex < images.size(); imageIndex++)
+		{
+			decoders.push_back(images[imageIndex]->chunkStatsDecoder());
+			imagesStats.push_back(exrPixeldata::ImageStats(decoders.back().channelsNum()));
+			for (uint32_t i = 0; i < images[imageIndex]->m_offsetTable->length(); i++)
+			{
+				chunks.push_back(StreamChunk{ images[imageIndex]->m_offsetTable->offset(i), imageIndex, i });
+			}
+		}
+		std::stable_sort(chunks.begin(), chunks.end(), [](const StreamChunk& left, const StreamChunk& right) { return left.offset < right.offset; });
+
+		// one buffer slot per thread: each chunk of a batch is read and decoded by its own thread into its own slot
+		const uint32_t threadsNum = utils::ThreadPool::threadsNum(workersNum);
+		std::unique_ptr<utils::ThreadPool> threadPool = (threadsNum != 1) ? std::make_unique<utils::ThreadPool>(threadsNum - 1) : nullptr;		// calling thread processes chunks too
+		std::vector<StreamSlot> slots(threadsNum);
+		const uint64_t slotMemoryLimitBytes = memoryLimitBytes / slots.size();
+		printf("%u chunks, read by %u threads, up to %s MB of memory each \n\n", uint32_t(chunks.size()), uint32_t(slots.size()), utils::str(float(double(slotMemoryLimitBytes)/1024/1024), 3).c_str());
+		uint64_t invalidChunksNum = 0;
+		uint32_t progressTenths = 0;
+		for (std::size_t batchFirst = 0; batchFirst < chunks.size(); batchFirst += slots.size())
+		{
+			const std::size_t batchSize = std::min(slots.size(), chunks.size() - batchFirst);
+			const auto slotsRange = [&](const std::size_t firstSlot, const std::size_t lastSlot)
+			{
+				for (std::size_t slotIndex = firstSlot; slotIndex < lastSlot; slotIndex++)
+				{
+					const StreamChunk& chunk = chunks[batchFirst + slotIndex];
+					StreamSlot& slot = slots[slotIndex];
+					slot.stats = exrPixeldata::ImageStats(decoders[chunk.imageIndex].channelsNum());
+					slot.error.clear();
+					try
+					{
+						images[chunk.imageIndex]->streamChunk(file, chunk, decoders[chunk.imageIndex], slot, slotMemoryLimitBytes);
+					}
+					catch (const std::exception& e)
+					{
+						slot.error = e.what();
+					}
+				}
+			};
+			if (threadPool == nullptr)
+			{
+				slotsRange(std::size_t(0), batchSize);
+			}
+			else
+			{
+				threadPool->parallelFor(0, batchSize, 1, slotsRange);
+			}
+			// results are merged and printed in file order
+			for (std::size_t slotIndex = 0; slotIndex < batchSize; slotIndex++)
+			{
+				const StreamChunk& chunk = chunks[batchFirst + slotIndex];
+				if (slots[slotIndex].error.empty())
+				{
+					imagesStats[chunk.imageIndex].merge(slots[slotIndex].stats);
+					continue;
+				}
+				invalidChunksNum++;
+				const int32_t partIndex = images[chunk.imageIndex]->m_partIndex;
+				printf("INVALID: %schunk of offset table entry %u at 0x%s: %s \n", (partIndex < 0 ? "" : "part " + std::to_string(partIndex) + " ").c_str(), chunk.tableEntryIndex, utils::hex64(chunk.offset, 4).c_str(), slots[slotIndex].error.c_str());
+			}
+			const std::size_t chunksDone = batchFirst + batchSize;
+			if (progressTenths < chunksDone * 10 / chunks.size())
+			{
+				progressTenths = uint32_t(chunksDone * 10 / chunks.size());
+				printf("[%3u%%] %u / %u chunks, %s MB read, %llu invalid \n", progressTenths * 10, uint32_t(chunksDone), uint32_t(chunks.size()), utils::str(float(double(file.bytesRead())/1024/1024), 3).c_str(), (unsigned long long)invalidChunksNum);
+				fflush(stdout);
+			}
+		}
+		printf("\n");
+
+		for (uint32_t imageIndex = 0; imageIndex < images.size(); imageIndex++)
+		{
+			const exrFileData& image = *images[imageIndex];
+			if (image.isPart())
+			{
+				printf("======== Part %d: \'%s\' (%s) ======== \n", image.m_partIndex, image.m_partName->value().c_str(), image.m_partType->value().c_str());
+			}
+			image.printStreamStats(imagesStats[imageIndex]);
+		}
+		return invalidChunksNum;
+	}
+
+	/// <summary>
+	///		Write analysis results as members of the JSON object currently open in (json):
+	///		"fileSizeBytes", "magicNumber", "versionField", "header" (every attribute with byte ranges), "offsetTable", "pixelData", "summary".
+	///		Multi-part file has "parts" array instead, with "index", "name", "type", "header", "offsetTable", "pixelData", "summary" of each part.
+	///		Call after successful exrAnalysisBrief(). Byte ranges are [first; last] indexes of bytes within file.
+	/// </summary>
+	void writeJsonMembers(utils::JsonWriter& json) const
+	{
+		json.member("fileSizeBytes", uint64_t(m_filebytes.size()));
+		json.member("magicNumber", uint32_t(m_magicNumber));
+		json.key("versionField");
+		json.beginObject();
+		json.member("value", m_vf->value());
+		json.member("exrVersion", uint32_t(m_vf->exrVersion()));
+		json.member("bit09_isSinglePartTiled", m_vf->bit09_SinglePartTiled());
+		json.member("bit10_hasLongNames", m_vf->bit10_HasLongNames());
+		json.member("bit11_hasDeepData", m_vf->bit11_HasDeepData());
+		json.member("bit12_isMultipart", m_vf->bit12_IsMultipart());
+		json.endObject();
+
+		if (isMultipart())
+		{
+			writeJsonByteRange(json, "headersBytes", exr2::consta::c_headerFirstByteIndex, m_exrHeaderFinalNullIndex);
+			json.member("isEndOfFileReached", isEndOfFileReached());
+			json.key("parts");
+			json.beginArray();
+			for (const std::unique_ptr<exrFileData>& part : m_parts)
+			{
+				json.beginObject();
+				json.member("index", uint32_t(part->m_partIndex));
+				json.member("name", part->m_partName->value());
+				json.member("type", part->m_partType->value());
+				part->writeJsonPartMembers(json);
+				json.endObject();
+			}
+			json.endArray();
+			return;
+		}
+		writeJsonPartMembers(json);
+	}
+
+	/// <summary>
+	///		Write analysed image into (filepath) as single-part scanline .exr file of (compression). Header attributes are copied as they are,
+	///		except compression and lineOrder (written anew: DECREASING_Y is kept, other orders become INCREASING_Y) and attributes of tiled and
+	///		multi-part files (tiles, name, type, chunkCount, version). Pixel data is re-encoded from decoded samples (tiled image: full resolution level),
+	///		chunks are encoded concurrently on (setDecodingWorkersNum()) threads. Call after successful analysis; (filepath) must not be the analysed file.
+	///		Analysed in lazy mode (setLazyPixelDecoding()), rows of each window of chunks are decoded from file on access,
+	///		so memory use is bounded by the window and the scanline cache, not by image size.
+	/// </summary>
+	/// <returns> size of written file in bytes </returns>
+	uint64_t writeScanlineExr(const std::filesystem::path& filepath, const exr2::consta::s_compression::value compression) const
+	{
+		if (isMultipart() or isDeep() or not hasPixelData())
+		{
+			throw std::logic_error("ERROR: only analysed single-part scanline or tiled image can be written (multi-part and deep files are not supported).");
+		}
+		const bool isDwa = (compression == exr2::consta::s_compression::value::DWAA or compression == exr2::consta::s_compression::value::DWAB);
+		if (isDwa and m_chlist->isAnyChannelPerceptuallyLinear())
+		{
+			throw std::logic_error("ERROR: " + exr2::consta::compressionName(compression) + " of channels with pLinear = 1 can not be written.");
+		}
+		const exr2::consta::s_lineOrder::ctype lineOrder = (not isTiled() and m_lineOrder->value() == exr2::consta::s_lineOrder::value::DECREASING_Y) ? exr2::consta::s_lineOrder::value::DECREASING_Y : exr2::consta::s_lineOrder::value::INCREASING_Y;
+		exrPixeldata::ScanlineWriter writer(m_chlist->channelsNames(), m_chlist->channelDataTypes(), m_imageCols, m_imageRows, m_dataWindow->value().yMin(), compression, lineOrder);
+		for (const exrTypes::AttribEntry& entry : m_header->entries())
+		{
+			if (not isCopiedAttribName(entry.name))
+			{
+				continue;
+			}
+			writer.addAttribute(entry.name, entry.type, m_filebytes.subspan(entry.value_firstByteIndex, entry.valueSizeBytes));
+		}
+		const utils::Range<uint32_t> allColumns(0, m_imageCols - 1);
+		const exrPixeldata::ScanlineWriter::RowsSource fetchRows = [&](const utils::Range<uint32_t>& rows)
+		{
+			if (isTiled())
+			{
+				return m_tiledPixelData->region(rows, allColumns);
+			}
+			// rows are copied one by one: in lazy mode scanlines are decoded (and cached) on access, so each chunk is decoded once per window
+			exrPixeldata::ImageBuffer<float> buffer(rows.last() - rows.first() + 1, m_imageCols, m_chlist->channelsNum());
+			for (uint32_t row = rows.first(); row <= rows.last(); row++)
+			{
+				m_pixelData->copyRowInto(row, buffer, row - rows.first());
+			}
+			return buffer;
+		};
+		// UINT samples are decoded again, as uint32_t, so values above 2^24 are not rounded by float samples of pixel data
+		std::unique_ptr<exrPixeldata::PixelData<uint32_t>> uintPixelData = nullptr;
+		std::unique_ptr<exrPixeldata::TiledPixelData<uint32_t>> uintTiledPixelData = nullptr;
+		const std::vector<uint32_t> channelDataTypes = m_chlist->channelDataTypes();
+		const exr2::consta::s_compression::value sourceCompression = exr2::consta::s_compression::value(m_compression->value());
+		if (writer.uintChannelsNum() != 0 and isTiled())
+		{
+			const exrPixeldata::TileGrid grid(m_imageCols, m_imageRows, m_tiles->value());
+			uintTiledPixelData = std::make_unique<exrPixeldata::TiledPixelData<uint32_t>>(m_filebytes, chunkOffsets(), grid, m_chlist->channelsNames(), channelDataTypes, sourceCompression, grid.levels()[0].tilesX);
+		}
+		else if (writer.uintChannelsNum() != 0)
+		{
+			// rows are fetched in increasing order within a window: cache of one chunk decodes each chunk once per window
+			uintPixelData = std::make_unique<exrPixeldata::PixelData<uint32_t>>(m_filebytes, chunkOffsets(), m_imageRows, m_imageCols, m_chlist->channelsNames(), channelDataTypes, m_lineOrder->value(), sourceCompression, 1, m_dataWindow->value().yMin());
+		}
+		const exrPixeldata::ScanlineWriter::UintRowsSource fetchUintRows = [&](const utils::Range<uint32_t>& rows)
+		{
+			const exrPixeldata::ImageBuffer<uint32_t> tiledSamples = isTiled() ? uintTiledPixelData->region(rows, allColumns) : exrPixeldata::ImageBuffer<uint32_t>();
+			exrPixeldata::ImageBuffer<uint32_t> scanline = isTiled() ? exrPixeldata::ImageBuffer<uint32_t>() : exrPixeldata::ImageBuffer<uint32_t>(1, m_imageCols, uint32_t(channelDataTypes.size()));
+			exrPixeldata::ImageBuffer<uint32_t> buffer(rows.last() - rows.first() + 1, m_imageCols, writer.uintChannelsNum());
+			for (uint32_t row = rows.first(); row <= rows.last(); row++)
+			{
+				if (not isTiled())
+				{
+					uintPixelData->copyRowInto(row, scanline, 0);
+				}
+				uint32_t uintCh = 0;
+				for (uint32_t ch = 0; ch < uint32_t(channelDataTypes.size()); ch++)
+				{
+					if (channelDataTypes[ch] != exr2::consta::channel::datatype::UINT)
+					{
+						continue;
+					}
+					uint32_t* dst = buffer.rowData(uintCh++, row - rows.first());
+					std::copy_n(isTiled() ? tiledSamples.rowData(ch, row - rows.first()) : scanline.rowData(ch, 0), m_imageCols, dst);
+				}
+			}
+			return buffer;
+		};
+		return writer.write(filepath, fetchRows, fetchUintRows, decodingThreadPool());
+	}
+
 	private:
+	/// <summary>
+	///		Write "header", "offsetTable", "pixelData" and "summary" members of single-part file or of one part of multi-part file.
+	/// </summary>
+	void writeJsonPartMembers(utils::JsonWriter& json) const
+	{
+		json.key("header");
+		json.beginObject();
+		writeJsonByteRange(json, "bytes", m_header->firstByteIndex(), m_header->lastByteIndex());
+		json.key("attributes");
+		json.beginArray();
+		for (const exrTypes::AttribEntry& entry : m_header->entries())
+		{
+			json.beginObject();
+			json.member("name", entry.name);
+			json.member("type", entry.type);
+			json.member("valueSizeBytes", entry.valueSizeBytes);
+			writeJsonByteRange(json, "bytes", entry.name_firstByteIndex, entry.value_lastByteIndex());
+			writeJsonByteRange(json, "nameBytes", entry.name_firstByteIndex, entry.type_firstByteIndex - 1);
+			writeJsonByteRange(json, "typeBytes", entry.type_firstByteIndex, entry.valueSize_firstByteIndex - 1);
+			writeJsonByteRange(json, "valueSizeFieldBytes", entry.valueSize_firstByteIndex, entry.value_firstByteIndex - 1);
+			writeJsonByteRange(json, "valueBytes", entry.value_firstByteIndex, entry.value_lastByteIndex());
+			writeJsonAttribValue(json, entry);
+			json.endObject();
+		}
+		json.endArray();
+		json.endObject();
+
+		json.key("offsetTable");
+		json.beginObject();
+		writeJsonByteRange(json, "bytes", m_offsetTable->firstByteIndex(), m_offsetTable->lastByteIndex());
+		json.key("offsets");
+		json.beginArray();
+		for (uint32_t i = 0; i < m_offsetTable->length(); i++)
+		{
+			json.value(m_offsetTable->offset(i));
+		}
+		json.endArray();
+		json.endObject();
+
+		json.key("pixelData");
+		json.beginObject();
+		writeJsonByteRange(json, "bytes", pixelDataFirstByteIndex(), pixelDataLastByteIndex());
+		json.member("isEndOfFileReached", isEndOfFileReached());
+		json.endObject();
+
+		json.key("summary");
+		json.beginObject();
+		json.member("width", m_imageCols);
+		json.member("height", m_imageRows);
+		json.key("channels");
+		json.beginArray();
+		for (uint32_t i = 0; i < m_chlist->channelsNum(); i++)
+		{
+			json.beginObject();
+			json.member("name", m_chlist->channelName(i));
+			json.member("type", m_chlist->channelDataTypeName(i));
+			json.endObject();
+		}
+		json.endArray();
+		json.member("compression", m_compression->compressionName());
+		json.member("lineOrder", exr2::consta::lineOrderName(m_lineOrder->value()));
+		if (isTiled())
+		{
+			const exrPixeldata::TileGrid& grid = m_tiledPixelData->grid();
+			json.key("tiles");
+			json.beginObject();
+			json.member("xSize", grid.tileXSize());
+			json.member("ySize", grid.tileYSize());
+			json.member("levelMode", exr2::consta::levelModeName(grid.levelMode()));
+			json.member("roundingMode", exr2::consta::roundingModeName(grid.roundingMode()));
+			json.member("levelsNum", uint32_t(grid.levels().size()));
+			json.member("tilesNum", grid.chunksNum());
+			json.endObject();
+		}
+		if (isDeep())
+		{
+			json.key("deep");
+			json.beginObject();
+			json.member("samplesNum", m_deepPixelData->samplesNum());
+			json.member("maxSamplesPerPixel", m_deepPixelData->maxSamplesPerPixel());
+			json.member("meanSamplesPerPixel", m_deepPixelData->meanSamplesPerPixel());
+			json.member("emptyPixelsNum", m_deepPixelData->emptyPixelsNum());
+			json.endObject();
+		}
+		if (m_pixelAspectRatio != nullptr)
+		{
+			json.member("pixelAspectRatio", double(m_pixelAspectRatio->value()));
+		}
+		if (m_hasAttribute_xDensity)
+		{
+			json.member("xDensity", double(m_xDensity->value()));
+		}
+		json.member("exrVersion", uint32_t(m_vf->exrVersion()));
+		json.endObject();
+	}
+
 	// exr file header
-	std::vector<ui8>& m_filebytes;
+	ui8view m_filebytes;
+	uint32_t m_lazyCacheScanlinesNum = 0;		// 0 = eager pixel data decoding
+	uint32_t m_decodingWorkersNum = 1;			// threads decoding pixel data, calling thread included: 1 = serial pixel data decoding, 0 = one per hardware thread
+	mutable std::unique_ptr<utils::ThreadPool> m_decodingThreadPool = nullptr;		// created by decodingThreadPool() on first use
+	bool m_hasPixelRegion = false;				// false = whole image is decoded and printed
+	bool m_isOffsetTableCrossCheck = false;		// true = offset tables are cross-checked against chunks after pixel data is read
+	utils::Range<uint32_t> m_regionRows = utils::Range<uint32_t>(0, UINT32_MAX);
+	utils::Range<uint32_t> m_regionCols = utils::Range<uint32_t>(0, UINT32_MAX);
 	int32_t m_magicNumber = 0;
 	// brief example on unique_ptr: 
 	// {
@@ -92,6 +524,7 @@ class exrFileData
 	//	// no need to "delete" manually - it is automatically cleaned-up here
 	// }
 	std::unique_ptr<VersionField> m_vf = nullptr;
+	std::unique_ptr<exrTypes::HeaderIndex> m_header = nullptr;
 	std::unique_ptr<exrTypes::AttribChlist> m_chlist = nullptr;				// automatically deletes itself when out of scope
 	std::unique_ptr<exrTypes::AttribCompression> m_compression = nullptr;
 	std::unique_ptr<exrTypes::AttribBox2i> m_dataWindow = nullptr;
@@ -101,126 +534,1270 @@ class exrFileData
 	std::unique_ptr<exrTypes::AttribV2f> m_screenWindowCenter = nullptr;
 	std::unique_ptr<exrTypes::AttribFloat32> m_screenWindowWidth = nullptr;
 	std::unique_ptr<exrTypes::AttribFloat32> m_xDensity = nullptr;	bool m_hasAttribute_xDensity = false;
+	std::unique_ptr<exrTypes::AttribTiledesc> m_tiles = nullptr;	// set for tiled images only
+	std::unique_ptr<exrTypes::AttribString> m_partName = nullptr;	// required for multi-part files only
+	std::unique_ptr<exrTypes::AttribString> m_partType = nullptr;	// required for multi-part files only
+	std::unique_ptr<exrTypes::AttribInt32> m_chunkCount = nullptr;	// required for multi-part and deep files only
 	// additional analysis results
 	bool m_doesRequire_chunkCount_Attribute = false;
-	uint32_t m_exrHeaderFinalNullIndex = 0;
+	uint32_t m_exrHeaderFinalNullIndex = 0;		// multi-part file: 0x00 byte ending the list of part headers
+	uint64_t m_offsetTableFirstByteIndex = 0;
 	uint32_t m_imageRows = 0, m_imageCols = 0;
 	// image data
 	std::unique_ptr<exrTypes::OffsetTable> m_offsetTable = nullptr;
-	std::unique_ptr<exrPixeldata::PixelData<float>> m_pixelData = nullptr;
+	std::unique_ptr<exrPixeldata::PixelData<float>> m_pixelData = nullptr;				// scanline image
+	std::unique_ptr<exrPixeldata::TiledPixelData<float>> m_tiledPixelData = nullptr;	// tiled image
+	std::unique_ptr<exrPixeldata::DeepPixelData<float>> m_deepPixelData = nullptr;		// deep scanline image
+	// multi-part file: file object reads the list of part headers, each part (header, offset table, pixel data) is analysed by its own object
+	int32_t m_partIndex = -1;										// index of this part within multi-part file, -1 = not a part
+	std::vector<std::unique_ptr<exrFileData>> m_parts;
 
-	void saveAndPrintMagicNumber()
+	/// <summary>
+	///		Part of multi-part (file): indexes its header, analysis settings are the same as of (file).
+	/// </summary>
+	/// <param name="headerFirstByteIndex"> - index of first byte of first attribute name of part header </param>
+	exrFileData(const exrFileData& file, const uint32_t partIndex, const uint32_t headerFirstByteIndex)
+		: m_filebytes(file.m_filebytes), m_lazyCacheScanlinesNum(file.m_lazyCacheScanlinesNum), m_decodingWorkersNum(file.m_decodingWorkersNum),
+		m_hasPixelRegion(file.m_hasPixelRegion), m_regionRows(file.m_regionRows), m_regionCols(file.m_regionCols), m_magicNumber(file.m_magicNumber),
+		m_vf(std::make_unique<VersionField>(*file.m_vf)), m_partIndex(int32_t(partIndex))
 	{
-		/// OpenEXR magicNumber (.exr file validator)
-		m_magicNumber = exr::magicNumber(m_filebytes);
-		printf("[03~00] Magic number = 0x%8.8X = %i ", m_magicNumber, m_magicNumber);
-		if (m_magicNumber == exr2::consta::c_magicNumber)
+		m_header = std::make_unique<exrTypes::HeaderIndex>(m_filebytes, headerFirstByteIndex, m_vf->bit10_HasLongNames());
+		m_exrHeaderFinalNullIndex = m_header->lastByteIndex();
+	}
+
+	static inline const std::string s_c_xDensity = "xDensity";
+	static inline const std::string s_c_version = "version";			// multi-part and deep files only
+
+	/// <returns> true if attribute of (attribName) is copied by writeScanlineExr() (compression and lineOrder are written anew, the others do not apply to single-part scanline file) </returns>
+	static bool isCopiedAttribName(const std::string& attribName)
+	{
+		return not
+		(
+			attribName == exr::consta::StdAttribName::s_compression or
+			attribName == exr::consta::StdAttribName::s_lineOrder or
+			attribName == exr::consta::StdAttribName::s_tiles or
+			attribName == exr::consta::StdAttribName::s_name or
+			attribName == exr::consta::StdAttribName::s_type or
+			attribName == exr::consta::StdAttribName::s_chunkCount or
+			attribName == s_c_version
+		);
+	}
+
+	bool isTiled() const { return m_tiles != nullptr; }
+	bool isDeep() const { return m_partType != nullptr and m_partType->value() == exr2::consta::PartType::s_deepScanline; }
+	bool isMultipart() const { return not m_parts.empty(); }
+	bool isPart() const { return 0 <= m_partIndex; }
+	bool hasPixelData() const { return m_pixelData != nullptr or m_tiledPixelData != nullptr or m_deepPixelData != nullptr or isMultipart(); }
+	/// <returns> first byte of pixel data (of all parts of multi-part file), including part number of first chunk of a part </returns>
+	uint64_t pixelDataFirstByteIndex() const
+	{
+		if (isMultipart())
 		{
-			printf("(file is valid EXR). \n");
+			uint64_t firstByteIndex = UINT64_MAX;
+			for (const std::unique_ptr<exrFileData>& part : m_parts)
+			{
+				firstByteIndex = std::min(firstByteIndex, part->pixelDataFirstByteIndex());
+			}
+			return firstByteIndex;
 		}
-		else
+		const uint64_t firstByteIndex = isTiled() ? m_tiledPixelData->firstByteIndex() : isDeep() ? m_deepPixelData->firstByteIndex() : m_pixelData->firstByteIndex();
+		return isPart() ? firstByteIndex - exr2::consta::c_partNumberSizeInBytes : firstByteIndex;
+	}
+	/// <returns> last byte of pixel data (of all parts of multi-part file) </returns>
+	uint64_t pixelDataLastByteIndex() const
+	{
+		if (isMultipart())
 		{
-			throw std::runtime_error("ERROR: file is NOT VALID exr. Further analysis suspended.");
-			return;
+			uint64_t lastByteIndex = 0;
+			for (const std::unique_ptr<exrFileData>& part : m_parts)
+			{
+				lastByteIndex = std::max(lastByteIndex, part->pixelDataLastByteIndex());
+			}
+			return lastByteIndex;
 		}
+		return isTiled() ? m_tiledPixelData->lastByteIndex() : isDeep() ? m_deepPixelData->lastByteIndex() : m_pixelData->lastByteIndex();
 	}
-
-	void saveAndPrintExrHeaderRequiredAttribs()		// if exrFileData_asFunctions already outdated -> delete it and remove "Exr" form this method name
+	/// <returns> number of scanline chunks of the image: chunks of (scanlinesPerChunk) rows cover rows [dataWindow.yMin; dataWindow.yMax] </returns>
+	uint32_t scanlineChunksNum(const exr2::consta::s_compression::value compression) const
 	{
-		m_chlist = std::make_unique<exrTypes::AttribChlist>(exr::consta::StdAttribName::s_channels, m_filebytes, m_vf->bit10_HasLongNames());
-		printf("%s \n", m_chlist->toString().c_str());
-		m_compression = std::make_unique<exrTypes::AttribCompression>(exr::consta::StdAttribName::s_compression, m_filebytes, m_vf->bit10_HasLongNames());		// must read attribute => no try-catch
-		printf("%s \n", m_compression->toString().c_str());
-		m_dataWindow = std::make_unique<exrTypes::AttribBox2i>(exr::consta::StdAttribName::s_dataWindow, m_filebytes, m_vf->bit10_HasLongNames());
-		printf("%s \n", m_dataWindow->toString().c_str());
-		printCaughtException(
-			m_displayWindow = std::make_unique<exrTypes::AttribBox2i>(exr::consta::StdAttribName::s_displayWindow, m_filebytes, m_vf->bit10_HasLongNames());		// may not read attribute => enclosed in try-catch
-			printf("%s \n", m_displayWindow->toString().c_str());
-		);
-		m_lineOrder = std::make_unique<exrTypes::AttribLineorder>(exr::consta::StdAttribName::s_lineOrder, m_filebytes, m_vf->bit10_HasLongNames());				// must read attribute
-		printf("%s \n", m_lineOrder->toString().c_str());
-		printCaughtException(
-			m_pixelAspectRatio = std::make_unique<exrTypes::AttribFloat32>(exr::consta::StdAttribName::s_pixelAspectRatio, m_filebytes, m_vf->bit10_HasLongNames());
-			printf("%s \n", m_pixelAspectRatio->toString().c_str());
-		);
-		printCaughtException(
-			m_screenWindowCenter = std::make_unique<exrTypes::AttribV2f>(exr::consta::StdAttribName::s_screenWindowCenter, m_filebytes, m_vf->bit10_HasLongNames());
-			printf("%s \n", m_screenWindowCenter->toString().c_str());
-		);
-		m_screenWindowWidth = std::make_unique<exrTypes::AttribFloat32>(exr::consta::StdAttribName::s_screenWindowWidth, m_filebytes, m_vf->bit10_HasLongNames());	// must read attribute for code below => no try-catch
-		printf("%s \n", m_screenWindowWidth->toString().c_str());
+		return exrTypes::OffsetTable::scanlineChunksNum(m_dataWindow->value(), exr2::consta::scanlinesPerChunk(compression));
 	}
-
-	void saveAndPrintExrHeaderCustomAttribs()		// if exrFileData_asFunctions already outdated -> delete it and remove "Exr" form this method name
+	/// <summary>
+	///		Set image size from dataWindow: rows [yMin; yMax], columns [xMin; xMax]. Image row 0 is at y = yMin, column 0 at x = xMin.
+	/// </summary>
+	void readImageSize()
 	{
-		try
+		const exrTypes::Box2i dataWindow = m_dataWindow->value();
+		if (dataWindow.xMax() < dataWindow.xMin() or dataWindow.yMax() < dataWindow.yMin())
 		{
-			m_xDensity = std::make_unique<exrTypes::AttribFloat32>("xDensity", m_filebytes, m_vf->bit10_HasLongNames());
-			printf("%s \n", m_xDensity->toString().c_str());
-			m_hasAttribute_xDensity = true;
+			throw std::runtime_error("ERROR: dataWindow of the image is empty.");
 		}
-		catch(const std::exception e)
+		if (UINT32_MAX <= int64_t(dataWindow.yMax()) - dataWindow.yMin() or UINT32_MAX <= int64_t(dataWindow.xMax()) - dataWindow.xMin())
 		{
-			m_hasAttribute_xDensity = false;
+			throw std::runtime_error("ERROR: dataWindow of the image is larger than 2^32 - 1 pixels along x or y.");
 		}
-		if (m_hasAttribute_xDensity) m_exrHeaderFinalNullIndex = m_xDensity->value_lastByteIndex()+1;
-		else						 m_exrHeaderFinalNullIndex = m_screenWindowWidth->value_lastByteIndex()+1;
-
-		// if versionField.bit12==1 or versionField.bit11==1	=> then => attribute (name="chunkCount", type="int") must be in .exr
-		bool doesRequire_chunkCount_Attribute = m_vf->bit12_IsMultipart() and m_vf->bit11_HasDeepData();
-		/// to be implemented ...
-
+		m_imageRows = uint32_t(int64_t(dataWindow.yMax()) - dataWindow.yMin() + 1);
+		m_imageCols = uint32_t(int64_t(dataWindow.xMax()) - dataWindow.xMin() + 1);
 	}
-
-	void saveAndPrintExrPixeldata()		// if exrFileData_asFunctions already outdated -> delete it and remove "Exr" form this method name
+	/// <returns> (expectedChunksNum), after checking it equals chunkCount attribute value (if header has one) </returns>
+	uint32_t offsetTableLength(const uint32_t expectedChunksNum) const
+	{
+		if (m_chunkCount != nullptr and int64_t(m_chunkCount->value()) != int64_t(expectedChunksNum))
+		{
+			throw std::runtime_error("ERROR: chunkCount attribute value (" + std::to_string(m_chunkCount->value()) + ") differs from number of chunks of the image (" + std::to_string(expectedChunksNum) + ").\n");
+		}
+		return expectedChunksNum;
+	}
+	/// <summary>
+	///		Offset table values, pointing at chunk headers (y or tile coordinates).
+	///		In multi-part file each chunk starts with number of its part: it is checked to be this part and skipped.
+	/// </summary>
+	std::vector<uint64_t> chunkOffsets() const
 	{
-		bool isExrCompressed = (m_compression->value() != exr2::consta::s_compression::NO);
-		if (isExrCompressed)
+		std::vector<uint64_t> offsets = m_offsetTable->offsets();
+		if (not isPart())
+		{
+			return offsets;
+		}
+		for (uint64_t& offset : offsets)
 		{
-			throw std::logic_error("WARNING: [0x" + utils::hex(m_compression->value_firstByteIndex(), 2) + " ~ " + utils::hex(m_compression->value_lastByteIndex(), 2) + "] compression is not NO_COMPRESSION. OffsetTable & pixelData will not be read. Analysis stops here, after header section.\n\n");
+			if (m_filebytes.size() < exr2::consta::c_partNumberSizeInBytes or m_filebytes.size() - exr2::consta::c_partNumberSizeInBytes < offset)
+			{
+				throw std::runtime_error("offset table value 0x" + utils::hex64(offset) + " of part " + std::to_string(m_partIndex) + " is out of file bytes range. File is truncated or is not a valid .exr file.");
+			}
+			const int32_t partNumber = int32_t(exrTypes::readUint32(m_filebytes.data() + offset));
+			if (partNumber != m_partIndex)
+			{
+				throw std::runtime_error("chunk at 0x" + utils::hex64(offset) + " has part number " + std::to_string(partNumber) + ", but is listed in offset table of part " + std::to_string(m_partIndex) + ".");
+			}
+			offset += exr2::consta::c_partNumberSizeInBytes;
 		}
+		return offsets;
+	}
 
-		/// OpenEXR image data section
-		/* document tag [OPENEXR-OFFSET-TABLE-01] */
-		printf("-------- Offset Table -------- \n");
-		m_offsetTable = std::make_unique<exrTypes::OffsetTable>(m_filebytes, m_exrHeaderFinalNullIndex+1, m_dataWindow->value().yMax(), m_vf->bit12_IsMultipart(), m_doesRequire_chunkCount_Attribute);
-		printf("%s \n", m_offsetTable->toStringAllEntries().c_str());
+	/// <summary>
+	///		Bytes of one chunk (including part number in multi-part file) and offset table entry pointing at it.
+	/// </summary>
+	struct ChunkBytes
+	{
+		uint64_t firstByteIndex = 0;
+		uint64_t lastByteIndex = 0;
+		int32_t partIndex = -1;
+		uint32_t tableEntryIndex = 0;
 
-		/* document tag [OPENEXR-PIXEL-DATA-01] */
-		m_imageRows = uint32_t(m_dataWindow->value().yMax() + 1);
-		m_imageCols = uint32_t(m_dataWindow->value().xMax() + 1);
-		uint32_t imageChannelsNum = m_chlist->channelsNum();
-		std::vector<std::string> channelsNames = m_chlist->channelsNames();
-		printf("-------- Pixel Data -------- \n");
-		m_pixelData = std::make_unique<exrPixeldata::PixelData<float>>(m_filebytes, m_offsetTable->lastByteIndex()+1, m_imageRows, m_imageCols, imageChannelsNum, m_lineOrder->value());
-		printf("%s", m_pixelData->toStringAsExrPixeldata(channelsNames).c_str());
+		std::string toString() const
+		{
+			return (partIndex < 0 ? "" : "part " + std::to_string(partIndex) + " ") + "chunk of offset table entry " + std::to_string(tableEntryIndex)
+				+ " [0x" + utils::hex64(firstByteIndex, 4) + "; 0x" + utils::hex64(lastByteIndex, 4) + "]";
+		}
+	};
+	/// <summary>
+	///		Find bytes of each chunk of this image (part) by reading sizes from chunk header only (chunk data is not decoded):
+	///		scanline chunk is y, data size, data; tiled chunk is tile coordinates, data size, data; deep scanline chunk is
+	///		y, packed offset table size, packed sample data size, unpacked sample data size, offset table, sample data.
+	/// </summary>
+	/// <returns> bytes of chunks, ordered as offset table entries </returns>
+	std::vector<ChunkBytes> chunksBytes() const
+	{
+		const uint64_t partNumberSize = isPart() ? exr2::consta::c_partNumberSizeInBytes : 0;
+		const uint64_t headerSize = exrPixeldata::ChunkStatsDecoder::headerSizeInBytes(chunkKind());
+		std::vector<ChunkBytes> chunks(m_offsetTable->length());
+		for (uint32_t i = 0; i < m_offsetTable->length(); i++)
+		{
+			ChunkBytes& chunk = chunks[i];
+			chunk.firstByteIndex = m_offsetTable->offset(i);
+			chunk.partIndex = m_partIndex;
+			chunk.tableEntryIndex = i;
+			const uint64_t headerFirstByteIndex = chunk.firstByteIndex + partNumberSize;
+			if (m_filebytes.size() < headerFirstByteIndex + headerSize)
+			{
+				throw std::runtime_error("ERROR: header of " + chunk.toString() + " is out of file bytes range. File is truncated or is not a valid .exr file.");
+			}
+			const uint64_t chunkSize = exrPixeldata::ChunkStatsDecoder::sizeInBytes(chunkKind(), m_filebytes.data() + headerFirstByteIndex);
+			if (chunkSize > m_filebytes.size())
+			{
+				throw std::runtime_error("ERROR: data size of " + chunk.toString() + " is larger than the file. File is truncated or is not a valid .exr file.");
+			}
+			chunk.lastByteIndex = headerFirstByteIndex + chunkSize - 1;
+		}
+		return chunks;
 	}
-
-	void printAnalysisSummary() const
+	/// <summary>
+	///		Cross-check offset tables of the file (of all parts of multi-part file) against chunks they point at,
+	///		see setOffsetTableCrossCheck(). Tiles may be stored in any order, so order of tiled chunks is not checked.
+	/// </summary>
+	/// <returns> problems found, one line each, empty if offset tables are consistent </returns>
+	std::vector<std::string> offsetTableCrossCheckProblems() const
+	{
+		std::vector<std::string> problems;
+		std::vector<ChunkBytes> chunks;
+		const auto checkImage = [&](const exrFileData& image)
+		{
+			const std::vector<ChunkBytes> imageChunks = image.chunksBytes();
+			const exr2::consta::s_lineOrder::ctype lineOrder = image.m_lineOrder->value();
+			const bool isIncreasing = (lineOrder == exr2::consta::s_lineOrder::value::INCREASING_Y) and not image.isTiled();
+			const bool isDecreasing = (lineOrder == exr2::consta::s_lineOrder::value::DECREASING_Y) and not image.isTiled();
+			for (uint32_t i = 1; i < imageChunks.size(); i++)
+			{
+				const bool isOrdered = isIncreasing ? imageChunks[i-1].firstByteIndex < imageChunks[i].firstByteIndex : isDecreasing ? imageChunks[i].firstByteIndex < imageChunks[i-1].firstByteIndex : true;
+				if (not isOrdered)
+				{
+					problems.push_back(imageChunks[i].toString() + " is not " + (isIncreasing ? "after" : "before") + " chunk of previous entry, as lineOrder " + exr2::consta::lineOrderName(lineOrder) + " requires");
+				}
+			}
+			chunks.insert(chunks.end(), imageChunks.begin(), imageChunks.end());
+		};
+		if (isMultipart())
+		{
+			for (const std::unique_ptr<exrFileData>& part : m_parts)
+			{
+				checkImage(*part);
+			}
+		}
+		else
+		{
+			checkImage(*this);
+		}
+		// chunks, as ordered in file, must follow one another from the end of the last offset table
+		std::sort(chunks.begin(), chunks.end(), [](const ChunkBytes& left, const ChunkBytes& right) { return left.firstByteIndex < right.firstByteIndex; });
+		const uint64_t offsetTablesLastByteIndex = isMultipart() ? m_parts.back()->m_offsetTable->lastByteIndex() : m_offsetTable->lastByteIndex();
+		uint64_t expectedFirstByteIndex = offsetTablesLastByteIndex + 1;
+		for (uint32_t i = 0; i < chunks.size(); i++)
+		{
+			if (chunks[i].firstByteIndex < expectedFirstByteIndex)
+			{
+				problems.push_back(chunks[i].toString() + " overlaps " + (i == 0 ? "offset table" : chunks[i-1].toString()));
+			}
+			else if (expectedFirstByteIndex < chunks[i].firstByteIndex)
+			{
+				problems.push_back("bytes [0x" + utils::hex64(expectedFirstByteIndex, 4) + "; 0x" + utils::hex64(chunks[i].firstByteIndex - 1, 4) + "] before " + chunks[i].toString() + " are not part of any chunk");
+			}
+			expectedFirstByteIndex = std::max(expectedFirstByteIndex, chunks[i].lastByteIndex + 1);
+		}
+		if (expectedFirstByteIndex < m_filebytes.size())
+		{
+			problems.push_back("bytes [0x" + utils::hex64(expectedFirstByteIndex, 4) + "; 0x" + utils::hex64(m_filebytes.size() - 1, 4) + "] after the last chunk are not part of any chunk");
+		}
+		else if (m_filebytes.size() < expectedFirstByteIndex)
+		{
+			problems.push_back("last chunk ends at 0x" + utils::hex64(expectedFirstByteIndex - 1, 4) + ", beyond the end of file (0x" + utils::hex64(m_filebytes.size() - 1, 4) + ")");
+		}
+		return problems;
+	}
+	void printOffsetTableCrossCheck() const
 	{
+		printf("-------- Offset Table cross-check -------- \n");
+		const std::vector<std::string> problems = offsetTableCrossCheckProblems();
+		if (problems.empty())
+		{
+			printf("OK: chunk offsets follow lineOrder, chunks do not overlap and exactly cover bytes [0x%s; 0x%s] (end of file) \n\n", utils::hex64(pixelDataFirstByteIndex(), 4).c_str(), utils::hex64(m_filebytes.size() - 1, 4).c_str());
+			return;
+		}
+		for (const std::string& problem : problems)
+		{
+			printf("FAILED: %s \n", problem.c_str());
+		}
 		printf("\n");
-		printf("------------------------------------- \n");
-		printf("-------- Summary (user-view) -------- \n");
-		printf("------------------------------------- \n");
-		printf(".exr file info: \n");
-		printf("size: _______________ %u x %u \n", m_imageCols, m_imageRows);
-		printf("channels (ordered as in chlist header attribute): \n");
-		for (uint32_t i = 0; i < m_chlist->channelsNum(); i++)
+	}
+	/// <summary>
+	///		Throws if offset table cross-check is enabled (see setOffsetTableCrossCheck()) and finds a problem.
+	/// </summary>
+	void tryCrossCheckOffsetTables() const
+	{
+		if (not m_isOffsetTableCrossCheck)
 		{
-			printf("\t %s, %s \n", m_chlist->channelName(i).c_str(), exrToUserChannelDataTypeName(m_chlist->channelDataTypeName(i)).c_str());	
+			return;
 		}
-		printf("compression: ________ %s \n", m_compression->compressionName().c_str());
-		printf("pixel aspect ratio: _ %.6f \n", m_pixelAspectRatio->value());
-		if (m_hasAttribute_xDensity)
+		const std::vector<std::string> problems = offsetTableCrossCheckProblems();
+		if (not problems.empty())
 		{
-			printf("pixel density: ______ %.6f pixels / square inch (- unverified measurement unit - ) \n", m_xDensity->value());
+			throw std::runtime_error("ERROR: offset table cross-check: " + problems[0] + (problems.size() == 1 ? "" : " (and " + std::to_string(problems.size() - 1) + " more problems)") + ".");
 		}
-		printf("OpenEXR version: ____ OpenEXR version %u \n", m_vf->exrVersion());
+	}
 
-		printf("\n");
-		printf("Pixels values: \n");
-		printf("\t * note: pixel 0, 1 means pixel at first (0) row (from top) and second (1) column (from left) \n");
-		printf("%s \n", m_pixelData->toStringAsRGBAPixels(false, 5).c_str());
+	/// <summary>
+	///		Read and check magic number and version field. Throws if file is not a valid .exr file.
+	/// </summary>
+	void readMagicNumberAndVersionField()
+	{
+		m_magicNumber = exr::magicNumber(m_filebytes);
+		if (m_magicNumber != exr2::consta::c_magicNumber)
+		{
+			throw std::runtime_error("ERROR: file is NOT VALID exr.");
+		}
+		m_vf = std::make_unique<VersionField>(m_filebytes);
+		if (m_vf->exrVersion() == exr2::consta::c_versionNumber and not m_vf->isValidExr2_0())
+		{
+			throw std::runtime_error("ERROR: EXR file version field is NOT VALID.");
+		}
+	}
+	/// <summary>
+	///		Read header attributes (of all parts of multi-part file) and find where offset table(s) start, without printing anything.
+	/// </summary>
+	void readHeaders()
+	{
+		if (m_vf->bit12_IsMultipart())
+		{
+			readPartHeaders();
+			for (const std::unique_ptr<exrFileData>& part : m_parts)
+			{
+				part->readExrHeaderAttribs();
+			}
+			assignPartOffsetTables();
+			return;
+		}
+		m_header = std::make_unique<exrTypes::HeaderIndex>(m_filebytes, exr2::consta::c_headerFirstByteIndex, m_vf->bit10_HasLongNames());
+		readExrHeaderAttribs();
+		m_exrHeaderFinalNullIndex = m_header->lastByteIndex();
+		m_offsetTableFirstByteIndex = m_exrHeaderFinalNullIndex+1;
+	}
+
+	// streaming analysis: first bytes of file read, until headers and offset tables fit in
+	static inline const uint64_t s_c_streamFirstBytesNum = 1024 * 1024;
+	/// <summary>
+	///		Chunk of streaming analysis: offset table value, image (part) and offset table entry it belongs to.
+	/// </summary>
+	struct StreamChunk
+	{
+		uint64_t offset = 0;
+		uint32_t imageIndex = 0;
+		uint32_t tableEntryIndex = 0;
+	};
+	/// <summary>
+	///		Buffers of one thread of streaming analysis and result of the chunk it processed last.
+	/// </summary>
+	struct StreamSlot
+	{
+		std::vector<ui8> chunkBytes;
+		exrPixeldata::ChunkStatsDecoder::Scratch scratch;
+		exrPixeldata::ImageStats stats;
+		std::string error;		// empty if chunk is valid
+	};
+
+	/// <summary>
+	///		Read headers and offset tables of (file) from its first bytes, read into (firstBytes): 1 MB first, twice as many bytes
+	///		on each next try, up to the whole file or (memoryLimitBytes). Not supported features (logic_error) are reported on the first try.
+	/// </summary>
+	/// <returns> file data over (firstBytes), valid while (firstBytes) are not changed </returns>
+	static std::unique_ptr<exrFileData> readStreamHeaders(utils::file::FileReader& file, const uint64_t memoryLimitBytes, std::vector<ui8>& firstBytes)
+	{
+		uint64_t firstBytesNum = std::min(file.size(), s_c_streamFirstBytesNum);
+		while (true)
+		{
+			firstBytes.resize(std::size_t(firstBytesNum));
+			file.read(0, firstBytes.size(), firstBytes.data());
+			std::unique_ptr<exrFileData> exrFile = std::make_unique<exrFileData>(ui8view(firstBytes));
+			exrFile->readMagicNumberAndVersionField();
+			try
+			{
+				exrFile->readHeaders();
+				exrFile->readStreamOffsetTables(file.size());
+				return exrFile;
+			}
+			catch (const std::logic_error&)
+			{
+				throw;
+			}
+			catch (const std::exception&)
+			{
+				// headers or offset tables may continue after the bytes read
+				if (firstBytesNum == file.size() or memoryLimitBytes / 2 < firstBytesNum)
+				{
+					throw;
+				}
+			}
+			firstBytesNum = std::min(file.size(), 2 * firstBytesNum);
+		}
+	}
+	/// <summary>
+	///		Read offset table of the image (of each part of multi-part file). Offsets are checked against (fileSizeInBytes),
+	///		since (m_filebytes) are only the first bytes of file in streaming analysis.
+	/// </summary>
+	void readStreamOffsetTables(const uint64_t fileSizeInBytes)
+	{
+		if (isMultipart())
+		{
+			for (const std::unique_ptr<exrFileData>& part : m_parts)
+			{
+				part->readStreamOffsetTables(fileSizeInBytes);
+			}
+			return;
+		}
+		const exr2::consta::s_compression::value compression = exr2::consta::s_compression::value(m_compression->value());
+		tryValidateCompressionSupported(compression);
+		tryValidateChannelsNotSubsampled();
+		readImageSize();
+		const uint32_t chunksNum = isTiled() ? exrPixeldata::TileGrid(m_imageCols, m_imageRows, m_tiles->value()).chunksNum() : scanlineChunksNum(compression);
+		m_offsetTable = std::make_unique<exrTypes::OffsetTable>(m_filebytes, m_offsetTableFirstByteIndex, offsetTableLength(chunksNum), fileSizeInBytes);
+	}
+	exrPixeldata::ChunkKind chunkKind() const
+	{
+		return isTiled() ? exrPixeldata::ChunkKind::TILE : isDeep() ? exrPixeldata::ChunkKind::DEEP_SCANLINE : exrPixeldata::ChunkKind::SCANLINE;
+	}
+	exrPixeldata::ChunkStatsDecoder chunkStatsDecoder() const
+	{
+		const exr2::consta::s_compression::value compression = exr2::consta::s_compression::value(m_compression->value());
+		const exrPixeldata::TileGrid grid = isTiled() ? exrPixeldata::TileGrid(m_imageCols, m_imageRows, m_tiles->value()) : exrPixeldata::TileGrid();
+		return exrPixeldata::ChunkStatsDecoder(chunkKind(), m_imageRows, m_imageCols, m_dataWindow->value().yMin(), m_chlist->channelsNames(), m_chlist->channelDataTypes(), compression, grid);
+	}
+	/// <summary>
+	///		Read (chunk) of this image (part) from (file) into buffer of (slot) and decode it into statistics of (slot).
+	///		Throws if chunk is not valid or does not fit into (memoryLimitBytes).
+	/// </summary>
+	void streamChunk(utils::file::FileReader& file, const StreamChunk& chunk, const exrPixeldata::ChunkStatsDecoder& decoder, StreamSlot& slot, const uint64_t memoryLimitBytes) const
+	{
+		const std::size_t partNumberSize = isPart() ? exr2::consta::c_partNumberSizeInBytes : 0;
+		const std::size_t headerSize = exrPixeldata::ChunkStatsDecoder::headerSizeInBytes(decoder.kind());
+		ui8 header[exr2::consta::c_partNumberSizeInBytes + sizeof(int32_t) + 3 * sizeof(uint64_t)];
+		file.read(chunk.offset, partNumberSize + headerSize, header);
+		if (isPart() and int32_t(exrTypes::readUint32(header)) != m_partIndex)
+		{
+			throw std::runtime_error("chunk has part number " + std::to_string(int32_t(exrTypes::readUint32(header))) + ", but is listed in offset table of part " + std::to_string(m_partIndex) + ".");
+		}
+		const uint64_t chunkSize = exrPixeldata::ChunkStatsDecoder::sizeInBytes(decoder.kind(), header + partNumberSize);
+		if (memoryLimitBytes < chunkSize)
+		{
+			throw std::runtime_error("chunk is " + std::to_string(chunkSize) + " bytes, more than memory limit of one thread (" + std::to_string(memoryLimitBytes) + " bytes).");
+		}
+		// buffers keep their size between chunks, unless together they would outgrow the memory limit
+		if (memoryLimitBytes < std::max<uint64_t>(slot.chunkBytes.capacity(), chunkSize) + slot.scratch.rawBuffer.capacity())
+		{
+			std::vector<ui8>().swap(slot.chunkBytes);
+			std::vector<ui8>().swap(slot.scratch.rawBuffer);
+		}
+		slot.chunkBytes.resize(std::size_t(chunkSize));
+		file.read(chunk.offset + partNumberSize, slot.chunkBytes.size(), slot.chunkBytes.data());
+		decoder.decode(ui8view(slot.chunkBytes), chunk.tableEntryIndex, chunk.offset, slot.scratch, slot.stats, memoryLimitBytes);
+	}
+	void printStreamStats(const exrPixeldata::ImageStats& stats) const
+	{
+		printf("-------- Statistics -------- \n");
+		printf("image: %s \n", imageDescription().c_str());
+		printf("pixels decoded: %llu of %llu%s \n", (unsigned long long)stats.pixelsNum, (unsigned long long)(uint64_t(m_imageRows) * m_imageCols), isTiled() ? " (of full resolution level, all levels are validated)" : "");
+		if (isDeep())
+		{
+			const double meanSamplesPerPixel = (stats.pixelsNum == 0) ? 0.0 : double(stats.deepSamplesNum) / double(stats.pixelsNum);
+			printf("deep samples: %llu samples, max %llu per pixel, mean %s per pixel, %llu empty pixels \n", (unsigned long long)stats.deepSamplesNum, (unsigned long long)stats.deepMaxSamplesPerPixel, utils::str(float(meanSamplesPerPixel), 2).c_str(), (unsigned long long)stats.deepEmptyPixelsNum);
+		}
+		printf("channels (ordered as in chlist header attribute): \n");
+		for (uint32_t i = 0; i < m_chlist->channelsNum(); i++)
+		{
+			printf("\t %s, %s: %s \n", m_chlist->channelName(i).c_str(), m_chlist->channelDataTypeName(i).c_str(), stats.channels[i].toString().c_str());
+		}
+		printf("\n");
+	}
+
+	/// <summary>
+	///		Index headers of all parts of multi-part file. Part headers follow one another, each ends with 0x00 byte,
+	///		the list of part headers ends with one more 0x00 byte.
+	/// </summary>
+	void readPartHeaders()
+	{
+		uint32_t headerFirstByteIndex = exr2::consta::c_headerFirstByteIndex;
+		while (true)
+		{
+			if (m_filebytes.size() <= headerFirstByteIndex)
+			{
+				throw std::runtime_error("ERROR: 0x00 byte ending the list of part headers is not found before the end of file. File is truncated or is not a valid .exr file.");
+			}
+			if (m_filebytes[headerFirstByteIndex] == 0x00)
+			{
+				break;		// end of part headers
+			}
+			m_parts.push_back(std::unique_ptr<exrFileData>(new exrFileData(*this, uint32_t(m_parts.size()), headerFirstByteIndex)));
+			headerFirstByteIndex = m_parts.back()->m_exrHeaderFinalNullIndex + 1;
+		}
+		if (m_parts.empty())
+		{
+			throw std::runtime_error("ERROR: multi-part file has no part headers.");
+		}
+		m_exrHeaderFinalNullIndex = headerFirstByteIndex;
+	}
+	/// <summary>
+	///		Offset tables of parts follow the list of part headers, in part order. Offset table of each part has chunkCount entries.
+	/// </summary>
+	void assignPartOffsetTables()
+	{
+		uint64_t offsetTableFirstByteIndex = m_exrHeaderFinalNullIndex + 1;
+		for (const std::unique_ptr<exrFileData>& part : m_parts)
+		{
+			if (m_filebytes.size() < offsetTableFirstByteIndex)
+			{
+				throw std::runtime_error("ERROR: offset table of part " + std::to_string(part->m_partIndex) + " is out of file bytes range. File is truncated or is not a valid .exr file.");
+			}
+			part->m_offsetTableFirstByteIndex = offsetTableFirstByteIndex;
+			offsetTableFirstByteIndex += uint64_t(uint32_t(part->m_chunkCount->value())) * sizeof(uint64_t);
+		}
+	}
+	/// <summary>
+	///		Call (partFunc)(partIndex) for each part, concurrently on (threadPool) workers if it is provided.
+	/// </summary>
+	template <typename PartFunc>
+	void forEachPart(utils::ThreadPool* threadPool, PartFunc&& partFunc) const
+	{
+		const auto partsRange = [&](const std::size_t firstPart, const std::size_t lastPart)
+		{
+			for (std::size_t partIndex = firstPart; partIndex < lastPart; partIndex++)
+			{
+				partFunc(uint32_t(partIndex));
+			}
+		};
+		if (threadPool == nullptr)
+		{
+			partsRange(std::size_t(0), m_parts.size());
+			return;
+		}
+		threadPool->parallelFor(0, m_parts.size(), 1, partsRange);
+	}
+	/// <returns> e.g. "64 x 64, MIPMAP_LEVELS (ROUND_DOWN), 7 levels, 30 tiles" </returns>
+	std::string tilesDescription() const
+	{
+		const exrPixeldata::TileGrid grid(m_imageCols, m_imageRows, m_tiles->value());
+		return std::to_string(grid.tileXSize()) + " x " + std::to_string(grid.tileYSize()) + ", " + exr2::consta::levelModeName(grid.levelMode())
+			+ " (" + exr2::consta::roundingModeName(grid.roundingMode()) + "), " + std::to_string(grid.levels().size()) + " levels, " + std::to_string(grid.chunksNum()) + " tiles";
+	}
+
+	void saveAndPrintMagicNumber()
+	{
+		/// OpenEXR magicNumber (.exr file validator)
+		m_magicNumber = exr::magicNumber(m_filebytes);
+		printf("[03~00] Magic number = 0x%8.8X = %i ", m_magicNumber, m_magicNumber);
+		if (m_magicNumber == exr2::consta::c_magicNumber)
+		{
+			printf("(file is valid EXR). \n");
+		}
+		else
+		{
+			throw std::runtime_error("ERROR: file is NOT VALID exr. Further analysis suspended.");
+			return;
+		}
+	}
+
+	/// <summary>
+	///		Print header attributes in file (byte) order: attributes analysed by this program are saved and printed by their analysers,
+	///		other attributes are printed raw (byte layout of name, type, size and value). Missing required attributes are reported after that.
+	/// </summary>
+	void saveAndPrintExrHeaderAttribs()		// if exrFileData_asFunctions already outdated -> delete it and remove "Exr" form this method name
+	{
+		for (const exrTypes::AttribEntry& entry : m_header->entries())
+		{
+			saveAndPrintExrHeaderAttrib(entry);
+		}
+		// .exr header required (standard) attributes, constructors throw if attribute is not in header
+		if (m_chlist == nullptr)				m_chlist = std::make_unique<exrTypes::AttribChlist>(exr::consta::StdAttribName::s_channels, *m_header);
+		if (m_compression == nullptr)			m_compression = std::make_unique<exrTypes::AttribCompression>(exr::consta::StdAttribName::s_compression, *m_header);
+		if (m_dataWindow == nullptr)			m_dataWindow = std::make_unique<exrTypes::AttribBox2i>(exr::consta::StdAttribName::s_dataWindow, *m_header);
+		if (m_lineOrder == nullptr)				m_lineOrder = std::make_unique<exrTypes::AttribLineorder>(exr::consta::StdAttribName::s_lineOrder, *m_header);
+		if (m_screenWindowWidth == nullptr)		m_screenWindowWidth = std::make_unique<exrTypes::AttribFloat32>(exr::consta::StdAttribName::s_screenWindowWidth, *m_header);
+		if (m_tiles == nullptr and m_vf->bit09_SinglePartTiled())
+		{
+			m_tiles = std::make_unique<exrTypes::AttribTiledesc>(exr::consta::StdAttribName::s_tiles, *m_header);		// tiled image must have attribute
+		}
+		readExrHeaderPartAttribs();
+		m_exrHeaderFinalNullIndex = m_header->lastByteIndex();
+	}
+	/// <summary>
+	///		Save and print attribute of (entry) with its analyser, print it raw if it is not analysed by this program.
+	///		Required attributes must be read (exception stops analysis), optional ones may not: their exception is printed instead.
+	/// </summary>
+	void saveAndPrintExrHeaderAttrib(const exrTypes::AttribEntry& entry)
+	{
+		const std::string& name = entry.name;
+		if (name == exr::consta::StdAttribName::s_channels)
+		{
+			m_chlist = std::make_unique<exrTypes::AttribChlist>(name, *m_header);
+			printf("%s \n", m_chlist->toString().c_str());
+		}
+		else if (name == exr::consta::StdAttribName::s_compression)
+		{
+			m_compression = std::make_unique<exrTypes::AttribCompression>(name, *m_header);		// must read attribute => no try-catch
+			printf("%s \n", m_compression->toString().c_str());
+		}
+		else if (name == exr::consta::StdAttribName::s_dataWindow)
+		{
+			m_dataWindow = std::make_unique<exrTypes::AttribBox2i>(name, *m_header);
+			printf("%s \n", m_dataWindow->toString().c_str());
+		}
+		else if (name == exr::consta::StdAttribName::s_displayWindow)
+		{
+			printCaughtException(
+				m_displayWindow = std::make_unique<exrTypes::AttribBox2i>(name, *m_header);		// may not read attribute => enclosed in try-catch
+				printf("%s \n", m_displayWindow->toString().c_str());
+			);
+		}
+		else if (name == exr::consta::StdAttribName::s_lineOrder)
+		{
+			m_lineOrder = std::make_unique<exrTypes::AttribLineorder>(name, *m_header);				// must read attribute
+			printf("%s \n", m_lineOrder->toString().c_str());
+		}
+		else if (name == exr::consta::StdAttribName::s_pixelAspectRatio)
+		{
+			printCaughtException(
+				m_pixelAspectRatio = std::make_unique<exrTypes::AttribFloat32>(name, *m_header);
+				printf("%s \n", m_pixelAspectRatio->toString().c_str());
+			);
+		}
+		else if (name == exr::consta::StdAttribName::s_screenWindowCenter)
+		{
+			printCaughtException(
+				m_screenWindowCenter = std::make_unique<exrTypes::AttribV2f>(name, *m_header);
+				printf("%s \n", m_screenWindowCenter->toString().c_str());
+			);
+		}
+		else if (name == exr::consta::StdAttribName::s_screenWindowWidth)
+		{
+			m_screenWindowWidth = std::make_unique<exrTypes::AttribFloat32>(name, *m_header);	// must read attribute for code below => no try-catch
+			printf("%s \n", m_screenWindowWidth->toString().c_str());
+		}
+		else if (name == exr::consta::StdAttribName::s_tiles)
+		{
+			m_tiles = std::make_unique<exrTypes::AttribTiledesc>(name, *m_header);
+			printf("%s \n", m_tiles->toString().c_str());
+		}
+		else if (name == exr::consta::StdAttribName::s_name)
+		{
+			m_partName = std::make_unique<exrTypes::AttribString>(name, *m_header);
+			printf("%s \n", m_partName->toString().c_str());
+		}
+		else if (name == exr::consta::StdAttribName::s_type)
+		{
+			m_partType = std::make_unique<exrTypes::AttribString>(name, *m_header);
+			printf("%s \n", m_partType->toString().c_str());
+		}
+		else if (name == exr::consta::StdAttribName::s_chunkCount)
+		{
+			m_chunkCount = std::make_unique<exrTypes::AttribInt32>(name, *m_header);
+			printf("%s \n", m_chunkCount->toString().c_str());
+		}
+		else if (name == s_c_xDensity)
+		{
+			try
+			{
+				m_xDensity = std::make_unique<exrTypes::AttribFloat32>(name, *m_header);
+				printf("%s \n", m_xDensity->toString().c_str());
+				m_hasAttribute_xDensity = true;
+			}
+			catch(const std::exception& e)
+			{
+				m_hasAttribute_xDensity = false;
+			}
+		}
+		else
+		{
+			// attribute found in header, but not analysed by this program
+			printf("%s \n", entry.toString().c_str());
+		}
+	}
+
+	/// <summary>
+	///		Read attributes identifying a part of multi-part file: "name", "type" and "chunkCount".
+	///		They are required in multi-part files, "type" and "chunkCount" are required in deep files too, all are optional otherwise.
+	/// </summary>
+	void readExrHeaderPartAttribs()
+	{
+		// if versionField.bit12==1 or versionField.bit11==1	=> then => attribute (name="chunkCount", type="int") must be in .exr
+		m_doesRequire_chunkCount_Attribute = m_vf->bit12_IsMultipart() or m_vf->bit11_HasDeepData();
+		if (isPart() or m_header->contains(exr::consta::StdAttribName::s_name))
+		{
+			m_partName = std::make_unique<exrTypes::AttribString>(exr::consta::StdAttribName::s_name, *m_header);
+		}
+		if (isPart() or m_vf->bit11_HasDeepData() or m_header->contains(exr::consta::StdAttribName::s_type))
+		{
+			m_partType = std::make_unique<exrTypes::AttribString>(exr::consta::StdAttribName::s_type, *m_header);
+		}
+		if (m_doesRequire_chunkCount_Attribute or m_header->contains(exr::consta::StdAttribName::s_chunkCount))
+		{
+			m_chunkCount = std::make_unique<exrTypes::AttribInt32>(exr::consta::StdAttribName::s_chunkCount, *m_header);
+			if (m_chunkCount->value() < 0)
+			{
+				throw std::runtime_error("ERROR: chunkCount attribute value (" + std::to_string(m_chunkCount->value()) + ") is negative.\n");
+			}
+		}
+		if (m_partType == nullptr)
+		{
+			return;
+		}
+		const std::string& partType = m_partType->value();
+		if (partType == exr2::consta::PartType::s_deepTile)
+		{
+			throw std::logic_error("WARNING: part type \'" + partType + "\' (deep tiled data) is not supported. Analysis stops here, after header section.\n\n");
+		}
+		const bool isDeepType = (partType == exr2::consta::PartType::s_deepScanline);
+		if (isDeepType and not m_vf->bit11_HasDeepData())
+		{
+			throw std::runtime_error("ERROR: part type is \'" + partType + "\', but version field bit 11 (file has deep data) is 0.\n");
+		}
+		if (not isPart() and m_vf->bit11_HasDeepData() and not isDeepType)
+		{
+			throw std::runtime_error("ERROR: version field bit 11 (file has deep data) is 1, but image type is \'" + partType + "\'.\n");
+		}
+		if (partType != exr2::consta::PartType::s_scanlineImage and partType != exr2::consta::PartType::s_tiledImage and not isDeepType)
+		{
+			throw std::runtime_error("ERROR: part type \'" + partType + "\' is not valid (valid: " + exr2::consta::PartType::s_scanlineImage + ", " + exr2::consta::PartType::s_tiledImage + ", " + exr2::consta::PartType::s_deepScanline + ", " + exr2::consta::PartType::s_deepTile + ").\n");
+		}
+		if ((partType == exr2::consta::PartType::s_tiledImage) != isTiled())
+		{
+			throw std::runtime_error("ERROR: part of type \'" + partType + "\' " + (isTiled() ? "has" : "has no") + " tiles attribute.\n");
+		}
+	}
+	/// <summary>
+	///		Multi-part file: index headers of all parts and print attributes of each one.
+	/// </summary>
+	void saveAndPrintPartHeaders()
+	{
+		readPartHeaders();
+		for (const std::unique_ptr<exrFileData>& part : m_parts)
+		{
+			printf("-------- Part %d header -------- \n", part->m_partIndex);
+			part->saveAndPrintExrHeaderAttribs();
+			printf("[0x%s] byte = 0x%2.2X (end of part %d header) \n\n", utils::hex(part->m_exrHeaderFinalNullIndex, 4).c_str(), 0x00, part->m_partIndex);
+		}
+		assignPartOffsetTables();
+	}
+	/// <summary>
+	///		Read header attributes needed to decode pixel data and to write the summary, without printing anything.
+	/// </summary>
+	void readExrHeaderAttribs()
+	{
+		m_chlist = std::make_unique<exrTypes::AttribChlist>(exr::consta::StdAttribName::s_channels, *m_header);
+		m_compression = std::make_unique<exrTypes::AttribCompression>(exr::consta::StdAttribName::s_compression, *m_header);
+		m_dataWindow = std::make_unique<exrTypes::AttribBox2i>(exr::consta::StdAttribName::s_dataWindow, *m_header);
+		m_lineOrder = std::make_unique<exrTypes::AttribLineorder>(exr::consta::StdAttribName::s_lineOrder, *m_header);
+		if (m_vf->bit09_SinglePartTiled() or m_header->contains(exr::consta::StdAttribName::s_tiles))
+		{
+			m_tiles = std::make_unique<exrTypes::AttribTiledesc>(exr::consta::StdAttribName::s_tiles, *m_header);
+		}
+		readExrHeaderPartAttribs();
+		if (m_filebytes[m_header->lastByteIndex()] != 0x00)
+		{
+			throw std::runtime_error("ERROR: 0x00 byte ending the header section with attributes is not found.");
+		}
+		// optional attributes used by summary
+		if (m_header->contains(exr::consta::StdAttribName::s_pixelAspectRatio))
+		{
+			m_pixelAspectRatio = std::make_unique<exrTypes::AttribFloat32>(exr::consta::StdAttribName::s_pixelAspectRatio, *m_header);
+		}
+		if (m_header->contains(s_c_xDensity))
+		{
+			m_xDensity = std::make_unique<exrTypes::AttribFloat32>(s_c_xDensity, *m_header);
+			m_hasAttribute_xDensity = true;
+		}
+	}
+
+	void saveAndPrintExrPixeldata()		// if exrFileData_asFunctions already outdated -> delete it and remove "Exr" form this method name
+	{
+		utils::ThreadPool* threadPool = decodingThreadPool();
+		if (isMultipart())
+		{
+			// parts are independent: pixel data of all parts is read concurrently, then printed in part order
+			forEachPart(threadPool, [&](const uint32_t partIndex) { m_parts[partIndex]->readPixeldata(threadPool); });
+			for (const std::unique_ptr<exrFileData>& part : m_parts)
+			{
+				printf("======== Part %d: \'%s\' (%s) ======== \n", part->m_partIndex, part->m_partName->value().c_str(), part->m_partType->value().c_str());
+				part->printPixeldata();
+			}
+			return;
+		}
+		readPixeldata(threadPool);
+		printPixeldata();
+	}
+
+	/// <summary>
+	///		Read offset table and pixel data (decode it, unless it is decoded on access), without printing anything.
+	/// </summary>
+	/// <param name="threadPool"> - workers to decode chunks on, nullptr = decode on calling thread </param>
+	void readPixeldata(utils::ThreadPool* threadPool)
+	{
+		const exr2::consta::s_compression::value compression = exr2::consta::s_compression::value(m_compression->value());
+		tryValidateCompressionSupported(compression);
+		tryValidateChannelsNotSubsampled();
+		if (isTiled())
+		{
+			// tiles intersecting one row of tiles are decoded once when printed row by row, lazy mode bounds cache by its scanlines number
+			const uint32_t tileYSize = m_tiles->value().ySize();
+			const uint32_t cacheTileRowsNum = (m_lazyCacheScanlinesNum != 0) ? (m_lazyCacheScanlinesNum + tileYSize - 1) / tileYSize : 1;
+			readTiledPixeldata(compression, cacheTileRowsNum);
+			if (m_hasPixelRegion)
+			{
+				tryClampPixelRegion();
+			}
+			return;
+		}
+
+		if (isDeep())
+		{
+			// deep samples are decoded on load (lazy mode and region do not apply to decoding, only to printing)
+			readDeepPixeldata(compression, threadPool);
+			if (m_hasPixelRegion)
+			{
+				tryClampPixelRegion();
+			}
+			return;
+		}
+
+		/// OpenEXR image data section
+		/* document tag [OPENEXR-OFFSET-TABLE-01] */
+		m_offsetTable = std::make_unique<exrTypes::OffsetTable>(m_filebytes, m_offsetTableFirstByteIndex, offsetTableLength(scanlineChunksNum(compression)));
+
+		/* document tag [OPENEXR-PIXEL-DATA-01] */
+		readImageSize();
+		std::vector<uint32_t> channelDataTypes = m_chlist->channelDataTypes();
+		std::vector<std::string> channelsNames = m_chlist->channelsNames();
+		if (m_hasPixelRegion)
+		{
+			tryClampPixelRegion();
+			// region scanlines + scanlines of partially covered first and last chunks fit into the cache, so each chunk is decoded once
+			const uint32_t scanlinesPerChunk = exr2::consta::scanlinesPerChunk(compression);
+			const uint32_t cacheScanlinesNum = (m_lazyCacheScanlinesNum != 0) ? m_lazyCacheScanlinesNum : (m_regionRows.last() - m_regionRows.first() + 1) + 2 * scanlinesPerChunk;
+			m_pixelData = std::make_unique<exrPixeldata::PixelData<float>>(m_filebytes, chunkOffsets(), m_imageRows, m_imageCols, channelsNames, channelDataTypes, m_lineOrder->value(), compression, cacheScanlinesNum, m_dataWindow->value().yMin());
+			return;
+		}
+		if (m_lazyCacheScanlinesNum != 0)
+		{
+			m_pixelData = std::make_unique<exrPixeldata::PixelData<float>>(m_filebytes, chunkOffsets(), m_imageRows, m_imageCols, channelsNames, channelDataTypes, m_lineOrder->value(), compression, m_lazyCacheScanlinesNum, m_dataWindow->value().yMin());
+			return;
+		}
+		// chunks are found by offset table only: they may be stored in any order (RANDOM_Y) and, in multi-part file, interleaved with chunks of other parts
+		m_pixelData = std::make_unique<exrPixeldata::PixelData<float>>(m_filebytes, chunkOffsets(), m_imageRows, m_imageCols, channelsNames, channelDataTypes, m_lineOrder->value(), compression, threadPool, m_dataWindow->value().yMin());
+	}
+
+	/// <summary>
+	///		Print offset table and pixel data read by readPixeldata().
+	/// </summary>
+	void printPixeldata() const
+	{
+		printf("-------- Offset Table -------- \n");
+		printf("%s \n", m_offsetTable->toStringAllEntries().c_str());
+		if (isTiled())
+		{
+			printf("-------- Pixel Data (tiles %s) -------- \n", tilesDescription().c_str());
+			printPartNumberNote();
+			if (m_hasPixelRegion)
+			{
+				printf("tiles of all levels, pixels of rows [%u; %u], columns [%u; %u] only \n", m_regionRows.first(), m_regionRows.last(), m_regionCols.first(), m_regionCols.last());
+				printf("%s", m_tiledPixelData->toStringAsExrTiles(m_regionRows, m_regionCols).c_str());
+				return;
+			}
+			if (m_lazyCacheScanlinesNum != 0)
+			{
+				printf("[0x%s; 0x%s] pixel data is decoded on access (lazy mode, up to %u tiles cached) \n", utils::hex64(m_tiledPixelData->firstByteIndex(), 4).c_str(), utils::hex64(m_tiledPixelData->lastByteIndex(), 4).c_str(), m_tiledPixelData->cacheTilesNum());
+				return;
+			}
+			printf("%s", m_tiledPixelData->toStringAsExrTiles(utils::Range<uint32_t>(0, UINT32_MAX), utils::Range<uint32_t>(0, UINT32_MAX)).c_str());
+			return;
+		}
+		if (isDeep())
+		{
+			printf("-------- Pixel Data (deep scanline, %s) -------- \n", m_deepPixelData->statsString().c_str());
+			printPartNumberNote();
+			if (m_hasPixelRegion)
+			{
+				printf("pixels of rows [%u; %u], columns [%u; %u] only \n", m_regionRows.first(), m_regionRows.last(), m_regionCols.first(), m_regionCols.last());
+				printf("%s", m_deepPixelData->toStringAsExrDeepChunks(m_regionRows, m_regionCols).c_str());
+				return;
+			}
+			if (m_lazyCacheScanlinesNum != 0)
+			{
+				printf("[0x%s; 0x%s] deep pixel data printout is skipped (lazy mode) \n", utils::hex64(m_deepPixelData->firstByteIndex(), 4).c_str(), utils::hex64(m_deepPixelData->lastByteIndex(), 4).c_str());
+				return;
+			}
+			printf("%s", m_deepPixelData->toStringAsExrDeepChunks(utils::Range<uint32_t>(0, m_imageRows - 1), utils::Range<uint32_t>(0, m_imageCols - 1)).c_str());
+			return;
+		}
+		std::vector<std::string> channelsNames = m_chlist->channelsNames();
+		printf("-------- Pixel Data -------- \n");
+		printPartNumberNote();
+		if (m_hasPixelRegion)
+		{
+			printf("pixels of rows [%u; %u], columns [%u; %u] only \n", m_regionRows.first(), m_regionRows.last(), m_regionCols.first(), m_regionCols.last());
+			printf("%s", m_pixelData->toStringAsExrPixeldata(channelsNames, m_regionRows, m_regionCols).c_str());
+			return;
+		}
+		if (m_lazyCacheScanlinesNum != 0)
+		{
+			printf("[0x%s; 0x%s] pixel data is decoded on access (lazy mode, up to %u scanlines cached) \n", utils::hex64(m_pixelData->firstByteIndex(), 4).c_str(), utils::hex64(m_pixelData->lastByteIndex(), 4).c_str(), m_pixelData->cacheScanlinesNum());
+			return;
+		}
+		printf("%s", m_pixelData->toStringAsExrPixeldata(channelsNames).c_str());
+	}
+	void printPartNumberNote() const
+	{
+		if (isPart())
+		{
+			printf("each chunk starts with part number (%u bytes) = %d, byte ranges of chunks below start right after it \n", exr2::consta::c_partNumberSizeInBytes, m_partIndex);
+		}
+	}
+
+	/// <summary>
+	///		Read offset table and pixel data and decode all of it (concurrently on (threadPool) workers if it is provided).
+	///		In lazy mode (setLazyPixelDecoding()) decoded samples are not kept, scanlines are decoded again on access.
+	/// </summary>
+	/// <returns> one-line description of the image (part), e.g. "4 x 4, channels A,B,G,R, ZIP_COMPRESSION, INCREASING_Y" </returns>
+	std::string readPixeldataBrief(utils::ThreadPool* threadPool)
+	{
+		const exr2::consta::s_compression::value compression = exr2::consta::s_compression::value(m_compression->value());
+		tryValidateCompressionSupported(compression);
+		tryValidateChannelsNotSubsampled();
+		if (isTiled())
+		{
+			// all tiles of all levels are decoded (and validated), then dropped: tiles are decoded again on access
+			readTiledPixeldata(compression, 1);
+			m_tiledPixelData->decodeAllTiles(threadPool);
+			return imageDescription();
+		}
+		if (isDeep())
+		{
+			readDeepPixeldata(compression, threadPool);
+			return imageDescription() + ", deep: " + m_deepPixelData->statsString();
+		}
+		m_offsetTable = std::make_unique<exrTypes::OffsetTable>(m_filebytes, m_offsetTableFirstByteIndex, offsetTableLength(scanlineChunksNum(compression)));
+		readImageSize();
+		if (m_lazyCacheScanlinesNum != 0)
+		{
+			// all chunks are decoded (and validated), then dropped: scanlines are decoded again on access
+			m_pixelData = std::make_unique<exrPixeldata::PixelData<float>>(m_filebytes, chunkOffsets(), m_imageRows, m_imageCols, m_chlist->channelsNames(), m_chlist->channelDataTypes(), m_lineOrder->value(), compression, m_lazyCacheScanlinesNum, m_dataWindow->value().yMin());
+			m_pixelData->decodeAllChunks(threadPool, m_lineOrder->value());
+			return imageDescription();
+		}
+		m_pixelData = std::make_unique<exrPixeldata::PixelData<float>>(m_filebytes, chunkOffsets(), m_imageRows, m_imageCols, m_chlist->channelsNames(), m_chlist->channelDataTypes(), m_lineOrder->value(), compression, threadPool, m_dataWindow->value().yMin());
+		return imageDescription();
+	}
+	/// <returns> e.g. "4 x 4, channels A,B,G,R, ZIP_COMPRESSION, INCREASING_Y" (tiled image: tiles instead of lineOrder) </returns>
+	std::string imageDescription() const
+	{
+		std::string channelsStr;
+		for (const std::string& channelName : m_chlist->channelsNames())
+		{
+			channelsStr += (channelsStr.empty() ? "" : ",") + channelName;
+		}
+		return std::to_string(m_imageCols) + " x " + std::to_string(m_imageRows) + ", channels " + channelsStr + ", " + m_compression->compressionName() + ", "
+			+ (isTiled() ? "tiles " + tilesDescription() : exr2::consta::lineOrderName(m_lineOrder->value()));
+	}
+
+	/// <summary>
+	///		Read offset table of tiled image (one entry per tile of each level) and create tiled pixel data,
+	///		keeping up to (cacheTileRowsNum) rows of tiles of full resolution level decoded.
+	/// </summary>
+	void readTiledPixeldata(const exr2::consta::s_compression::value compression, const uint32_t cacheTileRowsNum)
+	{
+		readImageSize();
+		const exrPixeldata::TileGrid grid(m_imageCols, m_imageRows, m_tiles->value());
+		m_offsetTable = std::make_unique<exrTypes::OffsetTable>(m_filebytes, m_offsetTableFirstByteIndex, offsetTableLength(grid.chunksNum()));
+		const uint32_t cacheTilesNum = cacheTileRowsNum * grid.levels()[0].tilesX;
+		m_tiledPixelData = std::make_unique<exrPixeldata::TiledPixelData<float>>(m_filebytes, chunkOffsets(), grid, m_chlist->channelsNames(), m_chlist->channelDataTypes(), compression, cacheTilesNum);
+	}
+
+	/// <summary>
+	///		Read offset table of deep scanline image and decode all its samples (concurrently on (threadPool) workers if it is provided).
+	/// </summary>
+	void readDeepPixeldata(const exr2::consta::s_compression::value compression, utils::ThreadPool* threadPool)
+	{
+		m_offsetTable = std::make_unique<exrTypes::OffsetTable>(m_filebytes, m_offsetTableFirstByteIndex, offsetTableLength(scanlineChunksNum(compression)));
+		readImageSize();
+		m_deepPixelData = std::make_unique<exrPixeldata::DeepPixelData<float>>(m_filebytes, chunkOffsets(), m_imageRows, m_imageCols, m_chlist->channelsNames(), m_chlist->channelDataTypes(), compression, threadPool, m_dataWindow->value().yMin());
+	}
+
+	static void writeJsonByteRange(utils::JsonWriter& json, const std::string& name, const uint64_t firstByteIndex, const uint64_t lastByteIndex)
+	{
+		json.key(name);
+		json.beginArray();
+		json.value(firstByteIndex);
+		json.value(lastByteIndex);
+		json.endArray();
+	}
+
+	/// <summary>
+	///		Write "value" member with attribute value of (entry), if value type is known and value size is as expected by its type.
+	/// </summary>
+	void writeJsonAttribValue(utils::JsonWriter& json, const exrTypes::AttribEntry& entry) const
+	{
+		const ui8* value = m_filebytes.data() + entry.value_firstByteIndex;
+		const auto readInt32 = [value](const uint32_t i) { return int32_t(exrTypes::readUint32(value + 4*i)); };
+		const auto readFloat = [value](const uint32_t i) { return double(exrTypes::readFloat32(value + 4*i)); };
+		if (entry.type == "box2i" and entry.valueSizeBytes == 16)
+		{
+			json.key("value");
+			json.beginObject();
+			json.member("xMin", readInt32(0));
+			json.member("yMin", readInt32(1));
+			json.member("xMax", readInt32(2));
+			json.member("yMax", readInt32(3));
+			json.endObject();
+		}
+		else if ((entry.type == "v2i" or entry.type == "v2f") and entry.valueSizeBytes == 8)
+		{
+			json.key("value");
+			json.beginArray();
+			for (uint32_t i = 0; i < 2; i++)
+			{
+				if (entry.type == "v2i")
+				{
+					json.value(readInt32(i));
+				}
+				else
+				{
+					json.value(readFloat(i));
+				}
+			}
+			json.endArray();
+		}
+		else if (entry.type == "int" and entry.valueSizeBytes == 4)
+		{
+			json.member("value", readInt32(0));
+		}
+		else if (entry.type == "float" and entry.valueSizeBytes == 4)
+		{
+			json.member("value", readFloat(0));
+		}
+		else if (entry.type == "compression" and entry.valueSizeBytes == 1)
+		{
+			json.member("value", exr2::consta::compressionName(value[0]));
+		}
+		else if (entry.type == "lineOrder" and entry.valueSizeBytes == 1)
+		{
+			json.member("value", exr2::consta::lineOrderName(value[0]));
+		}
+		else if (entry.type == exr::consta::Type::s_tiledesc and entry.valueSizeBytes == exr::consta::TypeValueSizeBytes::s_tiledesc)
+		{
+			const exrTypes::TileDesc tileDesc(m_filebytes, entry.value_firstByteIndex);
+			json.key("value");
+			json.beginObject();
+			json.member("xSize", tileDesc.xSize());
+			json.member("ySize", tileDesc.ySize());
+			json.member("levelMode", exr2::consta::levelModeName(tileDesc.levelMode()));
+			json.member("roundingMode", exr2::consta::roundingModeName(tileDesc.roundingMode()));
+			json.endObject();
+		}
+		else if (entry.type == "string")
+		{
+			json.member("value", std::string((const char*)value, entry.valueSizeBytes));
+		}
+		else if (entry.type == "chlist" and entry.name == exr::consta::StdAttribName::s_channels)
+		{
+			json.key("value");
+			json.beginArray();
+			for (uint32_t i = 0; i < m_chlist->channelsNum(); i++)
+			{
+				json.beginObject();
+				json.member("name", m_chlist->channelName(i));
+				json.member("type", m_chlist->channelDataTypeName(i));
+				json.endObject();
+			}
+			json.endArray();
+		}
+	}
+
+	/// <summary>
+	///		Pixel data is decoded, summarised and written as one sample per pixel of every channel (ScanlineLayout),
+	///		so channels with xSampling or ySampling other than 1 (e.g. 4:2:0 RY/BY luminance-chroma) would be decoded wrong.
+	/// </summary>
+	void tryValidateChannelsNotSubsampled() const
+	{
+		if (not m_chlist->isAnyChannelSubsampled())
+		{
+			return;
+		}
+		for (uint32_t i = 0; i < m_chlist->channelsNum(); i++)
+		{
+			const int32_t xSampling = m_chlist->channelXSampling(i);
+			const int32_t ySampling = m_chlist->channelYSampling(i);
+			if (xSampling != 1 or ySampling != 1)
+			{
+				throw std::logic_error("WARNING: [0x" + utils::hex(m_chlist->value_firstByteIndex(), 2) + " ~ " + utils::hex(m_chlist->value_lastByteIndex(), 2) + "] subsampled channel \'" + m_chlist->channelName(i) + "\' (xSampling = " + std::to_string(xSampling) + ", ySampling = " + std::to_string(ySampling) + ") is not supported. OffsetTable & pixelData will not be read. Analysis stops here, after header section.\n\n");
+			}
+		}
+	}
+
+	void tryValidateCompressionSupported(const exr2::consta::s_compression::value compression) const
+	{
+		bool isCompressionSupported = exrCompression::isSupported(compression);
+		if (not isCompressionSupported)
+		{
+			throw std::logic_error("WARNING: [0x" + utils::hex(m_compression->value_firstByteIndex(), 2) + " ~ " + utils::hex(m_compression->value_lastByteIndex(), 2) + "] compression " + m_compression->compressionName() + " is not supported (supported: " + exrCompression::supportedNames() + "). OffsetTable & pixelData will not be read. Analysis stops here, after header section.\n\n");
+		}
+		const bool isB44 = (compression == exr2::consta::s_compression::value::B44 or compression == exr2::consta::s_compression::value::B44A);
+		if (isB44 and m_chlist->isAnyHalfChannelPerceptuallyLinear())
+		{
+			throw std::logic_error("WARNING: [0x" + utils::hex(m_compression->value_firstByteIndex(), 2) + " ~ " + utils::hex(m_compression->value_lastByteIndex(), 2) + "] compression " + m_compression->compressionName() + " of HALF channels with pLinear = 1 is not supported. OffsetTable & pixelData will not be read. Analysis stops here, after header section.\n\n");
+		}
+		const bool isDwa = (compression == exr2::consta::s_compression::value::DWAA or compression == exr2::consta::s_compression::value::DWAB);
+		if (isDwa and m_chlist->isAnyChannelPerceptuallyLinear())
+		{
+			throw std::logic_error("WARNING: [0x" + utils::hex(m_compression->value_firstByteIndex(), 2) + " ~ " + utils::hex(m_compression->value_lastByteIndex(), 2) + "] compression " + m_compression->compressionName() + " of channels with pLinear = 1 is not supported. OffsetTable & pixelData will not be read. Analysis stops here, after header section.\n\n");
+		}
+	}
+
+	/// <summary>
+	///		Pool decoding pixel data, created on first use and shared by analysis, summary and writing.
+	///		Calling thread decodes chunks too, so pool of (threads - 1) workers is started: --threads=N decodes on N threads.
+	/// </summary>
+	/// <returns> nullptr if pixel data is decoded on calling thread only </returns>
+	utils::ThreadPool* decodingThreadPool() const
+	{
+		const uint32_t threadsNum = utils::ThreadPool::threadsNum(m_decodingWorkersNum);
+		if (threadsNum != 1 and m_decodingThreadPool == nullptr)
+		{
+			m_decodingThreadPool = std::make_unique<utils::ThreadPool>(threadsNum - 1);
+		}
+		return m_decodingThreadPool.get();
+	}
+
+	void printAnalysisSummary() const
+	{
+		printf("\n");
+		printf("------------------------------------- \n");
+		printf("-------- Summary (user-view) -------- \n");
+		printf("------------------------------------- \n");
+		utils::ThreadPool* threadPool = decodingThreadPool();
+		if (isMultipart())
+		{
+			printf(".exr file of %u parts \n", uint32_t(m_parts.size()));
+			for (const std::unique_ptr<exrFileData>& part : m_parts)
+			{
+				printf("\n======== Part %d: \'%s\' (%s) ======== \n", part->m_partIndex, part->m_partName->value().c_str(), part->m_partType->value().c_str());
+				part->printImageSummary(threadPool);
+			}
+			return;
+		}
+		printImageSummary(threadPool);
+	}
+
+	/// <summary>
+	///		Statistics of each channel (ordered as in chlist): of all pixels of scanline image, of all samples of deep image,
+	///		of full resolution level of tiled image. Computed concurrently on (threadPool) workers if it is provided.
+	/// </summary>
+	/// <returns> statistics of channels, empty if pixels are decoded on access (lazy mode or pixel region) </returns>
+	std::vector<exrPixeldata::ChannelStats> channelsStats(utils::ThreadPool* threadPool) const
+	{
+		std::vector<exrPixeldata::ChannelStats> stats(m_chlist->channelsNum());
+		if (isDeep())
+		{
+			for (uint32_t ch = 0; ch < stats.size(); ch++)
+			{
+				stats[ch] = exrPixeldata::ChannelStats::of(m_deepPixelData->channelSamples(ch), std::size_t(m_deepPixelData->samplesNum()), threadPool);
+			}
+			return stats;
+		}
+		if (isTiled())
+		{
+			// rows of tiles of full resolution level are decoded concurrently, straight into statistics (not through tile cache),
+			// statistics of rows of tiles are merged in tile order
+			const exrPixeldata::TileGrid& grid = m_tiledPixelData->grid();
+			const exrPixeldata::TileGrid::Level& lvl = grid.levels()[0];
+			const exrPixeldata::ChunkStatsDecoder decoder = chunkStatsDecoder();
+			const std::vector<uint64_t> offsets = chunkOffsets();
+			std::vector<exrPixeldata::ImageStats> tileRowsStats(lvl.tilesY, exrPixeldata::ImageStats(uint32_t(stats.size())));
+			const auto tileRowsRange = [&](const std::size_t firstTileY, const std::size_t lastTileY)
+			{
+				exrPixeldata::ChunkStatsDecoder::Scratch scratch;
+				for (std::size_t tileY = firstTileY; tileY < lastTileY; tileY++)
+				{
+					for (uint32_t tileX = 0; tileX < lvl.tilesX; tileX++)
+					{
+						const uint32_t chunkIndex = grid.chunkIndex({ tileX, uint32_t(tileY), 0, 0 });
+						const uint64_t offset = offsets[chunkIndex];
+						const uint64_t chunkSize = std::min<uint64_t>(exrPixeldata::ChunkStatsDecoder::sizeInBytes(decoder.kind(), m_filebytes.data() + offset), m_filebytes.size() - offset);
+						decoder.decode(m_filebytes.subspan(std::size_t(offset), std::size_t(chunkSize)), chunkIndex, offset, scratch, tileRowsStats[tileY], UINT64_MAX);
+					}
+				}
+			};
+			if (threadPool == nullptr or lvl.tilesY < 2)
+			{
+				tileRowsRange(std::size_t(0), std::size_t(lvl.tilesY));
+			}
+			else
+			{
+				threadPool->parallelFor(0, lvl.tilesY, 1, tileRowsRange);
+			}
+			for (const exrPixeldata::ImageStats& tileRowStats : tileRowsStats)
+			{
+				for (uint32_t ch = 0; ch < stats.size(); ch++)
+				{
+					stats[ch].merge(tileRowStats.channels[ch]);
+				}
+			}
+			return stats;
+		}
+		if (m_pixelData->isLazy())
+		{
+			return {};
+		}
+		for (uint32_t ch = 0; ch < stats.size(); ch++)
+		{
+			stats[ch] = exrPixeldata::ChannelStats::of(m_pixelData->image().channelData(ch), std::size_t(m_imageRows) * m_imageCols, threadPool);
+		}
+		return stats;
+	}
+
+	void printImageSummary(utils::ThreadPool* threadPool) const
+	{
+		printf(".exr file info: \n");
+		printf("size: _______________ %u x %u \n", m_imageCols, m_imageRows);
+		printf("channels (ordered as in chlist header attribute): \n");
+		for (uint32_t i = 0; i < m_chlist->channelsNum(); i++)
+		{
+			printf("\t %s, %s \n", m_chlist->channelName(i).c_str(), exrToUserChannelDataTypeName(m_chlist->channelDataTypeName(i)).c_str());	
+		}
+		printf("compression: ________ %s \n", m_compression->compressionName().c_str());
+		if (isTiled())
+		{
+			printf("tiles: ______________ %s \n", tilesDescription().c_str());
+		}
+		if (isDeep())
+		{
+			printf("deep samples: _______ %s \n", m_deepPixelData->statsString().c_str());
+		}
+		printf("pixel aspect ratio: _ %.6f \n", m_pixelAspectRatio->value());
+		if (m_hasAttribute_xDensity)
+		{
+			printf("pixel density: ______ %.6f pixels / square inch (- unverified measurement unit - ) \n", m_xDensity->value());
+		}
+		printf("OpenEXR version: ____ OpenEXR version %u \n", m_vf->exrVersion());
+		printf("channel statistics (of finite samples: min, max, mean, stddev; %s): \n", isDeep() ? "all samples" : isTiled() ? "full resolution level" : "all pixels");
+		const std::vector<exrPixeldata::ChannelStats> stats = channelsStats(threadPool);
+		if (stats.empty())
+		{
+			printf("\t * note: not computed, pixel data is decoded on access \n");
+		}
+		for (uint32_t i = 0; i < stats.size(); i++)
+		{
+			printf("\t %s: %s \n", m_chlist->channelName(i).c_str(), stats[i].toString().c_str());
+		}
+
+		printf("\n");
+		printf("Pixels values: \n");
+		printf("\t * note: pixel 0, 1 means pixel at first (0) row (from top) and second (1) column (from left) \n");
+		if (isTiled())
+		{
+			printf("\t * note: values of full resolution level (0, 0) \n");
+			printf("%s \n", m_tiledPixelData->toStringAsRGBAPixels(m_hasPixelRegion ? m_regionRows : utils::Range<uint32_t>(0, m_imageRows - 1), m_hasPixelRegion ? m_regionCols : utils::Range<uint32_t>(0, m_imageCols - 1), 5).c_str());
+			return;
+		}
+		if (isDeep())
+		{
+			printf("\t * note: values of each channel of each sample of pixel, samples in file order \n");
+			printf("%s \n", m_deepPixelData->toStringAsDeepPixels(m_hasPixelRegion ? m_regionRows : utils::Range<uint32_t>(0, m_imageRows - 1), m_hasPixelRegion ? m_regionCols : utils::Range<uint32_t>(0, m_imageCols - 1), 5).c_str());
+			return;
+		}
+		if (m_hasPixelRegion)
+		{
+			printf("%s \n", m_pixelData->toStringAsRGBAPixels(m_regionRows, m_regionCols, false, 5).c_str());
+			return;
+		}
+		printf("%s \n", m_pixelData->toStringAsRGBAPixels(false, 5).c_str());
+	}
+
+	/// <summary>
+	///		Clamp pixel region to the image. Throws if region is out of the image entirely.
+	/// </summary>
+	void tryClampPixelRegion()
+	{
+		if (m_imageRows <= m_regionRows.first() or m_imageCols <= m_regionCols.first())
+		{
+			throw std::runtime_error("ERROR: pixel region rows [" + std::to_string(m_regionRows.first()) + "; ...], columns [" + std::to_string(m_regionCols.first()) + "; ...] is out of the image (" + std::to_string(m_imageCols) + " x " + std::to_string(m_imageRows) + ").\n");
+		}
+		m_regionRows = utils::Range<uint32_t>(m_regionRows.first(), std::min(m_regionRows.last(), m_imageRows - 1));
+		m_regionCols = utils::Range<uint32_t>(m_regionCols.first(), std::min(m_regionCols.last(), m_imageCols - 1));
 	}
 
 };
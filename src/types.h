@@ -1,5 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <span>
 
 using ui8 = uint8_t;	// project-scope alias for "byte"
+using ui8view = std::span<const ui8>;	// project-scope alias for read-only view of bytes (file bytes, chunk bytes, etc.)
@@ -1,5 +1,8 @@
 #pragma once
+#include <algorithm>
+#include <cctype>
 #include <exception>
+#include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -52,6 +55,7 @@ namespace utils
 		}
 		NumberT first() const { return m_first; }
 		NumberT last() const { return m_last; }
+		bool contains(const NumberT value) const { return m_first <= value and value <= m_last; }	// [first; last], both inclusive
 
 		private:
 		NumberT m_first = 0, m_last = 0;
@@ -62,8 +66,8 @@ namespace utils
 	class IndexedValue
 	{
 		public:
-		IndexedValue(const uint32_t valueFirstByteIndex, const uint32_t valueLastByteIndex, ValueType value)
-			: m_valueByteRange(utils::Range<uint32_t>(valueFirstByteIndex, valueLastByteIndex)), m_value(value)
+		IndexedValue(const uint64_t valueFirstByteIndex, const uint64_t valueLastByteIndex, ValueType value)
+			: m_valueByteRange(utils::Range<uint64_t>(valueFirstByteIndex, valueLastByteIndex)), m_value(value)
 		{
 		}
 		IndexedValue(const IndexedValue<ValueType>& other)
@@ -80,12 +84,12 @@ namespace utils
 			return *this;
 		}
 		ValueType value() const { return m_value; }
-		uint32_t firstByteIndex() const { return m_valueByteRange.first(); }
-		uint32_t lastByteIndex() const { return m_valueByteRange.last(); }
+		uint64_t firstByteIndex() const { return m_valueByteRange.first(); }
+		uint64_t lastByteIndex() const { return m_valueByteRange.last(); }
 
 		private:
 		ValueType m_value;
-		utils::Range<uint32_t> m_valueByteRange;
+		utils::Range<uint64_t> m_valueByteRange;
 	};
 
 	// static functions
@@ -207,7 +211,7 @@ namespace utils
 		static unsigned int fileSizeBytes(const char* filename)
 		{
 			std::ifstream file(filename, std::ifstream::ate | std::ifstream::binary);
-			unsigned int filesize = unsigned int(file.tellg());
+			unsigned int filesize = (unsigned int)file.tellg();
 			file.close();
 			return filesize;
 		}
@@ -256,33 +260,99 @@ namespace utils
 		}
 
 		/// <summary>
-		///		Read file in binary mode (byte by byte). 
-		///		The result std::vector<u8> should contain the same number of bytes as file size in bytes.
-		///		* C++ style function utilizes std::istreambuf_iterator, so reading performance may be better (untested).
-		///		** May be incompatible with C (unverified).
+		///		Match (name) against wildcard (pattern): '*' = any sequence of chars (including empty), '?' = any single char.
 		/// </summary>
-		/// <param name="filename">  - name, relative path or absolute path of the target file  </param>
-		/// <returns> Vector of bytes retrieved from file in binary mode </returns>
-		static std::vector<ui8> getFilebytes_v5_CppOnly(const char* filename)
+		static bool isWildcardMatch(const std::string& pattern, const std::string& name)
 		{
-			//if (filename.empty())
-			//{
-			//	throw std::invalid_argument("Filename is empty string. Please, provide existing file path.");
-			//}
-
-			unsigned int filesizeB = fileSizeBytes(filename);
-			std::ifstream file(filename, std::fstream::in | std::ifstream::binary);
-			if (!file)
+			std::size_t p = 0, n = 0;
+			std::size_t starP = std::string::npos, starN = 0;		// last '*' seen and name position it is matched up to
+			while (n < name.size())
 			{
-				throw std::runtime_error("Error opening file " + std::string(filename) + ". Check the file is in the same directory with .exe");
+				if (p < pattern.size() and (pattern[p] == '?' or pattern[p] == name[n]))
+				{
+					p++;
+					n++;
+				}
+				else if (p < pattern.size() and pattern[p] == '*')
+				{
+					starP = p++;
+					starN = n;
+				}
+				else if (starP != std::string::npos)
+				{
+					p = starP + 1;
+					n = ++starN;
+				}
+				else
+				{
+					return false;
+				}
 			}
-			std::vector<ui8> filebytesVec(std::istreambuf_iterator<char>(file), {});		// read file (copy all data into "filebytes")
-			file.close();
-			if (filebytesVec.size() != filesizeB)
+			while (p < pattern.size() and pattern[p] == '*')
 			{
-				throw std::runtime_error("Number of bytes read is different than file size in bytes. Reading may lost bytes or saved extra (false) bytes.");
+				p++;
 			}
-			return filebytesVec;
+			return p == pattern.size();
+		}
+
+		/// <summary>
+		///		Expand (inputs) into list of files. Each input is:
+		///			- file path, taken as is;
+		///			- directory path, replaced by its files with (extension) (case-insensitive, not recursive), sorted by name;
+		///			- path with wildcards ('*', '?') in its file name part, replaced by matching files of that directory, sorted by name.
+		///		Order of inputs is kept. Throws std::invalid_argument if input matches nothing.
+		/// </summary>
+		/// <param name="extension"> - extension with dot, e.g. ".exr" </param>
+		static std::vector<std::filesystem::path> expandInputPaths(const std::vector<std::string>& inputs, const std::string& extension)
+		{
+			namespace fs = std::filesystem;
+			const auto toLower = [](std::string str)
+			{
+				std::transform(str.begin(), str.end(), str.begin(), [](const unsigned char c) { return char(std::tolower(c)); });
+				return str;
+			};
+			std::vector<fs::path> files;
+			for (const std::string& input : inputs)
+			{
+				const fs::path inputPath = fs::path(input);
+				const std::string inputName = inputPath.filename().string();
+				std::vector<fs::path> inputFiles;
+				if (inputName.find_first_of("*?") != std::string::npos)
+				{
+					const fs::path directory = inputPath.has_parent_path() ? inputPath.parent_path() : fs::path(".");
+					if (fs::is_directory(directory))
+					{
+						for (const fs::directory_entry& entry : fs::directory_iterator(directory))
+						{
+							if (entry.is_regular_file() and isWildcardMatch(inputName, entry.path().filename().string()))
+							{
+								inputFiles.push_back(entry.path());
+							}
+						}
+					}
+				}
+				else if (fs::is_directory(inputPath))
+				{
+					for (const fs::directory_entry& entry : fs::directory_iterator(inputPath))
+					{
+						if (entry.is_regular_file() and toLower(entry.path().extension().string()) == toLower(extension))
+						{
+							inputFiles.push_back(entry.path());
+						}
+					}
+				}
+				else if (fs::exists(inputPath))
+				{
+					inputFiles.push_back(inputPath);
+				}
+				if (inputFiles.empty())
+				{
+					throw std::invalid_argument("\"" + input + "\" is not an existing file, a directory with " + extension + " files or a pattern matching existing files");
+				}
+				std::sort(inputFiles.begin(), inputFiles.end());
+				files.insert(files.end(), inputFiles.begin(), inputFiles.end());
+			}
+			return files;
 		}
 	}
 
@@ -336,16 +406,17 @@ namespace utils
 			}
 		}
 
-		static void asChar(const std::vector<ui8>& bytes, bool VIEW_TABLE=true)
+		// (firstByteOffset) = offset of bytes[0] within file, used for printed offsets
+		static void asChar(const ui8view bytes, bool VIEW_TABLE=true, const std::size_t firstByteOffset = 0)
 		{
 			if (VIEW_TABLE)
 			{
 				printf("___________ 0123456789abcdef \n");
-				for(unsigned int i = 0; i < bytes.size(); i++)
+				for(std::size_t i = 0; i < bytes.size(); i++)
 				{
 					if (i % 16 == 0)
 					{
-						printf("0x%8.8x: ", i); // print data offset within file
+						printf("0x%8.8llx: ", (unsigned long long)(firstByteOffset + i)); // print data offset within file
 					}
 					printf("%c", bytes[i]);
 					if ((i+1) % 16 == 0)
@@ -356,18 +427,19 @@ namespace utils
 			}
 			else
 			{
-				utils::printVector<ui8>(bytes, false, "");
+				std::cout.write((const char*)bytes.data(), bytes.size());
 			}
 		}
 
-		static void asBytes(const std::vector<ui8>& bytes)
+		// (firstByteOffset) = offset of bytes[0] within file, used for printed offsets
+		static void asBytes(const ui8view bytes, const std::size_t firstByteOffset = 0)
 		{
 			printf("___________ +0 +1 +2 +3 +4 +5 +6 +7 +8 +9 +a +b +c +d +e +f \n");
-			for(unsigned int i = 0; i < bytes.size(); i++)
+			for(std::size_t i = 0; i < bytes.size(); i++)
 			{
 				if (i % 16 == 0)
 				{
-					printf("0x%8.8x: ", i); // print data offset within file
+					printf("0x%8.8llx: ", (unsigned long long)(firstByteOffset + i)); // print data offset within file
 				}
 				printf("%2.2X ", bytes[i]);
 				if ((i+1) % 16 == 0)
@@ -377,7 +449,7 @@ namespace utils
 			}
 		}
 
-		static void asCharUint8Byte(const std::vector<ui8>& bytes)
+		static void asCharUint8Byte(const ui8view bytes)
 		{
 			for(unsigned int i = 0; i < bytes.size(); i++)
 			{